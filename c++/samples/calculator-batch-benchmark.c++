@@ -0,0 +1,104 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "calculator.capnp.h"
+#include <capnp/ez-rpc.h>
+#include <kj/debug.h>
+#include <chrono>
+#include <iostream>
+#include <stdlib.h>
+
+// Compares issuing evaluate() calls one round trip at a time against sending
+// them in batches with capnp::RequestBatch.  Each call evaluates a literal
+// and reads back the result via a pipelined read() call, so every batch of N
+// evaluations is 2N calls sent in one go.
+
+typedef capnp::RequestBatch<Calculator::EvaluateParams,
+                            Calculator::EvaluateResults> EvaluateBatch;
+typedef capnp::RequestBatch<Calculator::Value::ReadParams,
+                            Calculator::Value::ReadResults> ReadBatch;
+
+namespace {
+
+template <typename Func>
+double timeIterations(uint iterations, Func&& func) {
+  // Returns the average number of microseconds per iteration.
+  auto start = std::chrono::steady_clock::now();
+  for (uint i = 0; i < iterations; i++) {
+    func(i);
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::micro>(elapsed).count() / iterations;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+  if (argc < 2 || argc > 4) {
+    std::cerr << "usage: " << argv[0] << " HOST:PORT [EVALUATIONS [BATCH_SIZE]]\n"
+        "Connects to the Calculator server at the given address and compares "
+        "one-at-a-time evaluate() calls against batched ones." << std::endl;
+    return 1;
+  }
+
+  uint evaluations = argc > 2 ? strtoul(argv[2], nullptr, 0) : 10000;
+  uint batchSize = argc > 3 ? strtoul(argv[3], nullptr, 0) : 50;
+  KJ_REQUIRE(evaluations > 0 && batchSize > 0, "Arguments must be positive.");
+
+  capnp::EzRpcClient client(argv[1]);
+  Calculator::Client calculator = client.importCap<Calculator>("calculator");
+  auto& waitScope = client.getWaitScope();
+
+  double oneAtATime = timeIterations(evaluations, [&](uint i) {
+    auto request = calculator.evaluateRequest();
+    request.getExpression().setLiteral(i);
+    auto value = request.send().getValue().readRequest().send()
+        .wait(waitScope).getValue();
+    KJ_ASSERT(value == i);
+  });
+
+  uint batches = (evaluations + batchSize - 1) / batchSize;
+  double batched = timeIterations(batches, [&](uint batch) {
+    EvaluateBatch evaluateBatch(batchSize);
+    for (uint i = 0; i < batchSize; i++) {
+      evaluateBatch.add(calculator.evaluateRequest())
+          .getExpression().setLiteral(batch * batchSize + i);
+    }
+    auto evalPromises = evaluateBatch.send();
+
+    ReadBatch readBatch(batchSize);
+    for (auto& evalPromise: evalPromises) {
+      readBatch.add(evalPromise.getValue().readRequest());
+    }
+    auto readPromises = readBatch.send();
+
+    for (uint i = 0; i < batchSize; i++) {
+      KJ_ASSERT(readPromises[i].wait(waitScope).getValue() == batch * batchSize + i);
+    }
+  }) / batchSize;
+
+  std::cout << "one at a time: " << oneAtATime << " us/evaluation\n"
+            << "batches of " << batchSize << ": " << batched
+            << " us/evaluation" << std::endl;
+  return 0;
+}
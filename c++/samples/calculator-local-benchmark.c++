@@ -0,0 +1,86 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include "calculator.capnp.h"
+#include <capnp/capability.h>
+#include <kj/async.h>
+#include <kj/debug.h>
+#include <chrono>
+#include <iostream>
+#include <stdlib.h>
+
+// Measures the throughput of calling a trivial method on a capability
+// implemented in the same process, first through an ordinary local client
+// (which dispatches each call on a later turn of the event loop) and then
+// through one created with capnp::newDirectLocalClient().
+
+namespace {
+
+class ValueImpl final: public Calculator::Value::Server {
+public:
+  ValueImpl(double value): value(value) {}
+
+  kj::Promise<void> read(ReadContext context) override {
+    context.getResults().setValue(value);
+    return kj::READY_NOW;
+  }
+
+private:
+  double value;
+};
+
+double callsPerSecond(Calculator::Value::Client value, uint calls,
+                      kj::WaitScope& waitScope) {
+  auto start = std::chrono::steady_clock::now();
+  for (uint i = 0; i < calls; i++) {
+    KJ_ASSERT(value.readRequest().send().wait(waitScope).getValue() == 123);
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return calls / std::chrono::duration<double>(elapsed).count();
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+  if (argc > 2) {
+    std::cerr << "usage: " << argv[0] << " [CALLS]\n"
+        "Compares in-process Value.read() calls through a normal local client "
+        "against a direct one." << std::endl;
+    return 1;
+  }
+
+  uint calls = argc > 1 ? strtoul(argv[1], nullptr, 0) : 1000000;
+  KJ_REQUIRE(calls > 0, "Argument must be positive.");
+
+  kj::EventLoop loop;
+  kj::WaitScope waitScope(loop);
+
+  double deferred = callsPerSecond(
+      Calculator::Value::Client(kj::heap<ValueImpl>(123)), calls, waitScope);
+  double direct = callsPerSecond(
+      Calculator::Value::Client(capnp::newDirectLocalClient(kj::heap<ValueImpl>(123))),
+      calls, waitScope);
+
+  std::cout << "local client:  " << deferred << " calls/s\n"
+            << "direct client: " << direct << " calls/s" << std::endl;
+  return 0;
+}
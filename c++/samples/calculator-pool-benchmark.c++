@@ -0,0 +1,92 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "calculator.capnp.h"
+#include <capnp/ez-rpc.h>
+#include <kj/debug.h>
+#include <chrono>
+#include <iostream>
+#include <stdlib.h>
+
+// Measures how much connection setup costs when a program makes many short
+// sessions against the same server, and how much of it EzRpcClientPool
+// amortizes away.  Each iteration imports the calculator, evaluates a literal
+// and reads the result back, either through a brand new EzRpcClient (one
+// connection per iteration) or through a shared pool.
+
+namespace {
+
+double evaluateLiteral(Calculator::Client calculator, kj::WaitScope& waitScope,
+                       double value) {
+  auto request = calculator.evaluateRequest();
+  request.getExpression().setLiteral(value);
+  return request.send().getValue().readRequest().send()
+      .wait(waitScope).getValue();
+}
+
+template <typename Func>
+double timeIterations(uint iterations, Func&& func) {
+  // Returns the average number of microseconds per iteration.
+  auto start = std::chrono::steady_clock::now();
+  for (uint i = 0; i < iterations; i++) {
+    func(i);
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::micro>(elapsed).count() / iterations;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+  if (argc < 2 || argc > 4) {
+    std::cerr << "usage: " << argv[0] << " HOST:PORT [ITERATIONS [CONNECTIONS]]\n"
+        "Connects to the Calculator server at the given address and compares "
+        "per-session connections against a connection pool." << std::endl;
+    return 1;
+  }
+
+  uint iterations = argc > 2 ? strtoul(argv[2], nullptr, 0) : 1000;
+  uint connections = argc > 3 ? strtoul(argv[3], nullptr, 0) : 1;
+  KJ_REQUIRE(iterations > 0 && connections > 0, "Arguments must be positive.");
+
+  capnp::EzRpcClientPool pool(connections);
+  auto& waitScope = pool.getWaitScope();
+
+  double perSession = timeIterations(iterations, [&](uint i) {
+    capnp::EzRpcClient client(argv[1]);
+    KJ_ASSERT(evaluateLiteral(client.importCap<Calculator>("calculator"),
+                              waitScope, i) == i);
+  });
+
+  double pooled = timeIterations(iterations, [&](uint i) {
+    KJ_ASSERT(evaluateLiteral(pool.importCap<Calculator>(argv[1], "calculator"),
+                              waitScope, i) == i);
+  });
+
+  std::cout << "connection per session: " << perSession << " us/iteration\n"
+            << "pooled (" << connections << " connection(s)): "
+            << pooled << " us/iteration\n"
+            << "connections opened by pool: " << pool.getConnectAttempts()
+            << std::endl;
+  return 0;
+}
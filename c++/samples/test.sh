@@ -17,10 +17,19 @@ c++ -std=c++11 -Wall calculator-client.c++ calculator.capnp.c++ \
     $(pkg-config --cflags --libs capnp-rpc) -o calculator-client
 c++ -std=c++11 -Wall calculator-server.c++ calculator.capnp.c++ \
     $(pkg-config --cflags --libs capnp-rpc) -o calculator-server
+c++ -std=c++11 -Wall calculator-pool-benchmark.c++ calculator.capnp.c++ \
+    $(pkg-config --cflags --libs capnp-rpc) -o calculator-pool-benchmark
+c++ -std=c++11 -Wall calculator-batch-benchmark.c++ calculator.capnp.c++ \
+    $(pkg-config --cflags --libs capnp-rpc) -o calculator-batch-benchmark
+c++ -std=c++11 -Wall calculator-local-benchmark.c++ calculator.capnp.c++ \
+    $(pkg-config --cflags --libs capnp-rpc) -o calculator-local-benchmark
 rm -f /tmp/capnp-calculator-example-$$
 ./calculator-server unix:/tmp/capnp-calculator-example-$$ &
 sleep 0.1
 ./calculator-client unix:/tmp/capnp-calculator-example-$$
+./calculator-pool-benchmark unix:/tmp/capnp-calculator-example-$$ 100
+./calculator-batch-benchmark unix:/tmp/capnp-calculator-example-$$ 1000
+./calculator-local-benchmark 10000
 kill %+
 wait %+ || true
-rm calculator-client calculator-server calculator.capnp.c++ calculator.capnp.h /tmp/capnp-calculator-example-$$
+rm calculator-client calculator-server calculator-pool-benchmark calculator-batch-benchmark calculator-local-benchmark calculator.capnp.c++ calculator.capnp.h /tmp/capnp-calculator-example-$$
@@ -0,0 +1,131 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "carsales-common.h"
+#include <capnp/dynamic.h>
+#include <capnp/message.h>
+#include <kj/array.h>
+#include <kj/debug.h>
+#include <iostream>
+
+// Computes the total weight and the mean and variance of the fuel level over a large ParkingLot,
+// reading the fields one car at a time through the dynamic API and through the generated getters,
+// versus gathering each into a contiguous column with DynamicList::Reader::gather().
+
+namespace capnp {
+namespace benchmark {
+namespace capnp {
+
+int columnGatherMain(int argc, char* argv[]) {
+  if (argc > 2) {
+    std::cerr << "usage: " << argv[0] << " [CARS]" << std::endl;
+    return 1;
+  }
+
+  uint carCount = argc > 1 ? strtoul(argv[1], nullptr, 0) : 200000;
+  uint iterations = 20;
+
+  MallocMessageBuilder source;
+  for (auto car: source.initRoot<ParkingLot>().initCars(carCount)) {
+    randomCar(car);
+  }
+  auto cars = source.getRoot<ParkingLot>().asReader().getCars();
+  auto dynamicCars = toDynamic(cars);
+
+  StructSchema::Field weightField = Schema::from<Car>().getFieldByName("weight");
+  StructSchema::Field fuelField = Schema::from<Car>().getFieldByName("fuelLevel");
+  uint64_t weight0 = 0;
+  double mean0 = 0, variance0 = 0;
+  double dynamic = timeRuns(iterations, [&]() {
+    weight0 = 0;
+    double sum = 0;
+    for (auto car: dynamicCars) {
+      auto carStruct = car.as<DynamicStruct>();
+      weight0 += carStruct.get(weightField).as<uint32_t>();
+      sum += carStruct.get(fuelField).as<float>();
+    }
+    mean0 = sum / carCount;
+    double squares = 0;
+    for (auto car: dynamicCars) {
+      double delta = car.as<DynamicStruct>().get(fuelField).as<float>() - mean0;
+      squares += delta * delta;
+    }
+    variance0 = squares / carCount;
+  }) / carCount;
+
+  uint64_t weight1 = 0;
+  double mean1 = 0, variance1 = 0;
+  double perElement = timeRuns(iterations, [&]() {
+    weight1 = 0;
+    double sum = 0;
+    for (auto car: cars) {
+      weight1 += car.getWeight();
+      sum += car.getFuelLevel();
+    }
+    mean1 = sum / carCount;
+    double squares = 0;
+    for (auto car: cars) {
+      double delta = car.getFuelLevel() - mean1;
+      squares += delta * delta;
+    }
+    variance1 = squares / carCount;
+  }) / carCount;
+
+  auto weights = kj::heapArray<uint32_t>(carCount);
+  auto fuelLevels = kj::heapArray<float>(carCount);
+  uint64_t weight2 = 0;
+  double mean2 = 0, variance2 = 0;
+  double gathered = timeRuns(iterations, [&]() {
+    dynamicCars.gather<uint32_t>(weightField, weights);
+    dynamicCars.gather<float>(fuelField, fuelLevels);
+    weight2 = 0;
+    double sum = 0;
+    for (uint32_t weight: weights) weight2 += weight;
+    for (float fuel: fuelLevels) sum += fuel;
+    mean2 = sum / carCount;
+    double squares = 0;
+    for (float fuel: fuelLevels) {
+      double delta = fuel - mean2;
+      squares += delta * delta;
+    }
+    variance2 = squares / carCount;
+  }) / carCount;
+
+  KJ_ASSERT(weight0 == weight2 && weight1 == weight2);
+  KJ_ASSERT(mean0 == mean2 && mean1 == mean2);
+  KJ_ASSERT(variance0 == variance2 && variance1 == variance2);
+
+  std::cout << "total weight " << weight2 << ", fuel level mean " << mean2
+            << " variance " << variance2 << std::endl;
+  std::cout << "DynamicStruct::get(): " << dynamic << " ns/car, getters: " << perElement
+            << " ns/car, gather(): " << gathered << " ns/car" << std::endl;
+  return 0;
+}
+
+}  // namespace capnp
+}  // namespace benchmark
+}  // namespace capnp
+
+int main(int argc, char* argv[]) {
+  return capnp::benchmark::capnp::columnGatherMain(argc, argv);
+}
@@ -39,6 +39,7 @@
 #include <string.h>
 #include <string>
 #include <vector>
+#include <chrono>
 
 namespace capnp {
 namespace benchmark {
@@ -59,6 +60,18 @@ static inline double fastRandDouble(double range) {
   return nextFastRand() * range / std::numeric_limits<uint32_t>::max();
 }
 
+template <typename Func>
+double timeRuns(uint runs, Func&& func) {
+  // Calls `func` `runs` times and returns the average wall time per call, in nanoseconds.
+
+  auto start = std::chrono::steady_clock::now();
+  for (uint i = 0; i < runs; i++) {
+    func();
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::nano>(elapsed).count() / runs;
+}
+
 inline int32_t div(int32_t a, int32_t b) {
   if (b == 0) return std::numeric_limits<int32_t>::max();
   // INT_MIN / -1 => SIGFPE.  Who knew?
@@ -0,0 +1,112 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include "carsales-common.h"
+#include <capnp/dynamic.h>
+#include <capnp/message.h>
+#include <kj/debug.h>
+#include <iostream>
+
+// Compares reading a few fields out of many structs through the dynamic API in three ways:
+// looking fields up by name on every access, looking them up once and passing the
+// StructSchema::Field to get(), and compiling them once into DynamicStruct::Accessors.
+
+namespace capnp {
+namespace benchmark {
+namespace capnp {
+
+int dynamicAccessorMain(int argc, char* argv[]) {
+  if (argc > 3) {
+    std::cerr << "usage: " << argv[0] << " [CARS [RUNS]]" << std::endl;
+    return 1;
+  }
+
+  uint carCount = argc > 1 ? strtoul(argv[1], nullptr, 0) : 10000;
+  uint runs = argc > 2 ? strtoul(argv[2], nullptr, 0) : 100;
+
+  MallocMessageBuilder message;
+  for (auto car: message.initRoot<ParkingLot>().initCars(carCount)) {
+    car.setSeats(2 + fastRand(6));
+    car.setFuelLevel(fastRandDouble(30.0));
+    car.initEngine().setHorsepower(100 * fastRand(400));
+  }
+
+  auto cars = message.getRoot<ParkingLot>().asReader().getCars();
+  StructSchema schema = Schema::from<Car>();
+  uint64_t expected = 0;
+  for (auto car: cars) {
+    expected += car.getEngine().getHorsepower() + car.getSeats() + (uint64_t)car.getFuelLevel();
+  }
+
+  uint64_t sum;
+  auto check = [&]() { KJ_ASSERT(sum == expected, sum, expected); };
+
+  double byName = timeRuns(runs, [&]() {
+    sum = 0;
+    for (DynamicStruct::Reader car: cars) {
+      sum += car.get("engine").as<DynamicStruct>().get("horsepower").as<uint64_t>();
+      sum += car.get("seats").as<uint64_t>();
+      sum += (uint64_t)car.get("fuelLevel").as<double>();
+    }
+    check();
+  });
+
+  StructSchema::Field engineField = schema.getFieldByName("engine");
+  StructSchema::Field horsepowerField = Schema::from<Engine>().getFieldByName("horsepower");
+  StructSchema::Field seatsField = schema.getFieldByName("seats");
+  StructSchema::Field fuelLevelField = schema.getFieldByName("fuelLevel");
+  double byField = timeRuns(runs, [&]() {
+    sum = 0;
+    for (DynamicStruct::Reader car: cars) {
+      sum += car.get(engineField).as<DynamicStruct>().get(horsepowerField).as<uint64_t>();
+      sum += car.get(seatsField).as<uint64_t>();
+      sum += (uint64_t)car.get(fuelLevelField).as<double>();
+    }
+    check();
+  });
+
+  DynamicStruct::Accessor horsepower(schema, "engine.horsepower");
+  DynamicStruct::Accessor seats(schema, "seats");
+  DynamicStruct::Accessor fuelLevel(schema, "fuelLevel");
+  double byAccessor = timeRuns(runs, [&]() {
+    sum = 0;
+    for (DynamicStruct::Reader car: cars) {
+      sum += horsepower.get(car).as<uint64_t>();
+      sum += seats.get(car).as<uint64_t>();
+      sum += (uint64_t)fuelLevel.get(car).as<double>();
+    }
+    check();
+  });
+
+  std::cout << "get(name):  " << byName / carCount << " ns/car\n"
+            << "get(field): " << byField / carCount << " ns/car\n"
+            << "Accessor:   " << byAccessor / carCount << " ns/car" << std::endl;
+  return 0;
+}
+
+}  // namespace capnp
+}  // namespace benchmark
+}  // namespace capnp
+
+int main(int argc, char* argv[]) {
+  return capnp::benchmark::capnp::dynamicAccessorMain(argc, argv);
+}
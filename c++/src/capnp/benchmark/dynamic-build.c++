@@ -0,0 +1,112 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "carsales.capnp.h"
+#include "eval.capnp.h"
+#include "common.h"
+#include <capnp/dynamic.h>
+#include <capnp/message.h>
+#include <kj/debug.h>
+#include <iostream>
+
+// Measures how fast structs can be built through the dynamic API:  each round initializes a
+// ParkingLot with a list of cars, each with an engine, four wheels, and a few scalar fields, plus
+// an Expression orphan with a union member set for each car.  Fields are looked up by name once,
+// up front, so that the loop measures struct initialization rather than name lookup.
+
+namespace capnp {
+namespace benchmark {
+namespace capnp {
+
+int dynamicBuildMain(int argc, char* argv[]) {
+  if (argc > 2) {
+    std::cerr << "usage: " << argv[0] << " [STRUCTS]" << std::endl;
+    return 1;
+  }
+
+  uint total = argc > 1 ? strtoul(argv[1], nullptr, 0) : 1000000;
+  const uint CARS_PER_ROUND = 256;
+
+  StructSchema lotSchema = Schema::from<ParkingLot>();
+  StructSchema carSchema = Schema::from<Car>();
+  StructSchema engineSchema = Schema::from<Engine>();
+  StructSchema wheelSchema = Schema::from<Wheel>();
+  StructSchema exprSchema = Schema::from<Expression>();
+  StructSchema leftSchema = Schema::from<Expression::Left>();
+
+  auto carsField = lotSchema.getFieldByName("cars");
+  auto seatsField = carSchema.getFieldByName("seats");
+  auto doorsField = carSchema.getFieldByName("doors");
+  auto wheelsField = carSchema.getFieldByName("wheels");
+  auto engineField = carSchema.getFieldByName("engine");
+  auto horsepowerField = engineSchema.getFieldByName("horsepower");
+  auto diameterField = wheelSchema.getFieldByName("diameter");
+  auto opField = exprSchema.getFieldByName("op");
+  auto leftField = exprSchema.getFieldByName("left");
+  auto leftValueField = leftSchema.getFieldByName("value");
+  auto leftExpressionField = leftSchema.getFieldByName("expression");
+
+  uint built = 0;
+  double seconds = timeRuns(1, [&]() {
+    while (built < total) {
+      MallocMessageBuilder message;
+      auto lot = message.initRoot<DynamicStruct>(lotSchema);
+      auto cars = lot.init(carsField, CARS_PER_ROUND).as<DynamicList>();
+      for (uint i = 0; i < CARS_PER_ROUND; i++) {
+        auto car = cars[i].as<DynamicStruct>();
+        car.set(seatsField, i % 8);
+        car.set(doorsField, i % 5);
+        car.init(engineField).as<DynamicStruct>().set(horsepowerField, 100 + i);
+        auto wheels = car.init(wheelsField, 4).as<DynamicList>();
+        for (uint j = 0; j < 4; j++) {
+          wheels[j].as<DynamicStruct>().set(diameterField, 16);
+        }
+
+        auto expr = message.getOrphanage().newOrphan(exprSchema);
+        auto exprBuilder = expr.get();
+        exprBuilder.set(opField, "add");
+        auto left = exprBuilder.get(leftField).as<DynamicStruct>();
+        if (i % 2 == 0) {
+          left.set(leftValueField, i);
+        } else {
+          left.init(leftExpressionField).as<DynamicStruct>().set(opField, "multiply");
+        }
+        KJ_ASSERT(left.which() != nullptr);
+
+        built += 7 + i % 2;  // car, engine, four wheels, expression(s)
+      }
+    }
+  }) / 1e9;
+
+  std::cout << built << " structs: " << seconds << " s, "
+            << built / seconds / 1e6 << " M structs/s" << std::endl;
+  return 0;
+}
+
+}  // namespace capnp
+}  // namespace benchmark
+}  // namespace capnp
+
+int main(int argc, char* argv[]) {
+  return capnp::benchmark::capnp::dynamicBuildMain(argc, argv);
+}
@@ -0,0 +1,91 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include "carsales-common.h"
+#include <capnp/json.h>
+#include <capnp/message.h>
+#include <kj/debug.h>
+#include <iostream>
+
+// Compares converting a carsales-sized ParkingLot to text with stringify() against encoding it
+// as JSON, and measures decoding the JSON back into a message.
+
+namespace capnp {
+namespace benchmark {
+namespace capnp {
+
+int jsonMain(int argc, char* argv[]) {
+  if (argc > 3) {
+    std::cerr << "usage: " << argv[0] << " [CARS [RUNS]]" << std::endl;
+    return 1;
+  }
+
+  uint carCount = argc > 1 ? strtoul(argv[1], nullptr, 0) : 200;
+  uint runs = argc > 2 ? strtoul(argv[2], nullptr, 0) : 1000;
+
+  MallocMessageBuilder message;
+  for (auto car: message.initRoot<ParkingLot>().initCars(carCount)) {
+    randomCar(car);
+  }
+  auto lot = message.getRoot<ParkingLot>().asReader();
+
+  size_t textSize = 0;
+  double stringified = timeRuns(runs, [&]() {
+    textSize = kj::str(lot).size();
+  });
+
+  size_t jsonSize = 0;
+  double toJsonTime = timeRuns(runs, [&]() {
+    jsonSize = toJson(lot).size();
+  });
+
+  // Writing into a reused stream buffer, as a server writing responses would.
+  auto buffer = kj::heapArray<byte>(jsonSize);
+  double writeJsonTime = timeRuns(runs, [&]() {
+    kj::ArrayOutputStream output(buffer);
+    writeJson(output, lot);
+    KJ_ASSERT(output.getArray().size() == jsonSize);
+  });
+
+  auto json = toJson(lot);
+  double readJsonTime = timeRuns(runs, [&]() {
+    MallocMessageBuilder decoded;
+    auto root = readJson(json, decoded, Schema::from<ParkingLot>());
+    KJ_ASSERT(root.as<ParkingLot>().getCars().size() == carCount);
+  });
+
+  std::cout << carCount << " cars: " << textSize << " bytes of text, "
+            << jsonSize << " bytes of JSON\n"
+            << "stringify():          " << stringified / 1000 << " us\n"
+            << "toJson():             " << toJsonTime / 1000 << " us\n"
+            << "writeJson() (reused): " << writeJsonTime / 1000 << " us\n"
+            << "readJson():           " << readJsonTime / 1000 << " us" << std::endl;
+  return 0;
+}
+
+}  // namespace capnp
+}  // namespace benchmark
+}  // namespace capnp
+
+int main(int argc, char* argv[]) {
+  return capnp::benchmark::capnp::jsonMain(argc, argv);
+}
@@ -0,0 +1,116 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "carsales.capnp.h"
+#include "common.h"
+#include <capnp/schema.h>
+#include <capnp/schema-loader.h>
+#include <kj/debug.h>
+#include <kj/vector.h>
+#include <iostream>
+
+// Measures StructSchema::findFieldByName() and EnumSchema::findEnumerantByName(), for compiled-in
+// schemas and for the same schemas loaded at runtime through a SchemaLoader, as a gateway
+// resolving field names from request paths with the dynamic API would.
+
+namespace capnp {
+namespace benchmark {
+namespace capnp {
+
+template <typename Func>
+double timeLookups(const kj::Vector<kj::String>& names, uint iterations, Func&& find) {
+  // Returns nanoseconds per lookup.
+  uint found = 0;
+  double nanos = timeRuns(iterations, [&]() {
+    for (auto& name: names) {
+      found += find(name);
+    }
+  });
+  KJ_ASSERT(found == iterations * (names.size() - 2), found);
+  return nanos / names.size();
+}
+
+template <typename MemberList>
+kj::Vector<kj::String> namesOf(MemberList&& members) {
+  // All of the members' names plus two which aren't members.
+  kj::Vector<kj::String> names;
+  for (auto member: members) {
+    names.add(kj::heapString(member.getProto().getName()));
+  }
+  names.add(kj::heapString("noSuchMember"));
+  names.add(kj::heapString("a"));
+  return names;
+}
+
+void report(const char* label, StructSchema compiled, StructSchema loaded, uint iterations) {
+  auto names = namesOf(compiled.getFields());
+  std::cout << label << " (" << names.size() << " names): compiled "
+            << timeLookups(names, iterations, [&](kj::StringPtr name) {
+                 return compiled.findFieldByName(name) != nullptr;
+               })
+            << " ns, loaded "
+            << timeLookups(names, iterations, [&](kj::StringPtr name) {
+                 return loaded.findFieldByName(name) != nullptr;
+               })
+            << " ns per lookup" << std::endl;
+}
+
+void report(const char* label, EnumSchema compiled, EnumSchema loaded, uint iterations) {
+  auto names = namesOf(compiled.getEnumerants());
+  std::cout << label << " (" << names.size() << " names): compiled "
+            << timeLookups(names, iterations, [&](kj::StringPtr name) {
+                 return compiled.findEnumerantByName(name) != nullptr;
+               })
+            << " ns, loaded "
+            << timeLookups(names, iterations, [&](kj::StringPtr name) {
+                 return loaded.findEnumerantByName(name) != nullptr;
+               })
+            << " ns per lookup" << std::endl;
+}
+
+int nameLookupMain(int argc, char* argv[]) {
+  if (argc > 2) {
+    std::cerr << "usage: " << argv[0] << " [ITERATIONS]" << std::endl;
+    return 1;
+  }
+
+  uint iterations = argc > 1 ? strtoul(argv[1], nullptr, 0) : 1000000;
+
+  // Load the schemas from their encoded nodes, as if they had arrived over the wire, rather than
+  // with loadCompiledTypeAndDependencies(), which would reuse the compiled-in tables.
+  SchemaLoader loader;
+  auto load = [&](Schema schema) { return loader.load(schema.getProto()); };
+
+  report("Car", Schema::from<Car>(), load(Schema::from<Car>()).asStruct(), iterations);
+  report("Engine", Schema::from<Engine>(), load(Schema::from<Engine>()).asStruct(), iterations);
+  report("Color", Schema::from<Color>(), load(Schema::from<Color>()).asEnum(), iterations);
+  return 0;
+}
+
+}  // namespace capnp
+}  // namespace benchmark
+}  // namespace capnp
+
+int main(int argc, char* argv[]) {
+  return capnp::benchmark::capnp::nameLookupMain(argc, argv);
+}
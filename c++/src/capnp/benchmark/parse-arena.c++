@@ -0,0 +1,172 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "common.h"
+#include <capnp/compiler/lexer.h>
+#include <capnp/compiler/parser.h>
+#include <capnp/message.h>
+#include <kj/debug.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// Parses schema files with parseFile() allocating straight into the result message, and with it
+// parsing into a scratch message whose finished tree is then copied into the result, reporting the
+// size of the resulting message and the time taken per parse.
+//
+// The copy leaves out the garbage the parsers create while backtracking, so the result is about a
+// quarter smaller, but the copy itself makes parsing 20% to 50% slower.  Parsing each top-level
+// statement in its own reusable scratch arena costs the same: re-zeroing the arena is cheap, the
+// copy is not.  That is why parseFile() allocates straight into its result.  The compiler's
+// parse-ahead and cache paths copy the tree once anyway, which drops the garbage for free.
+
+namespace capnp {
+namespace benchmark {
+namespace capnp {
+
+using compiler::LexedStatements;
+using compiler::ParsedFile;
+using compiler::Statement;
+
+class FailingErrorReporter: public compiler::ErrorReporter {
+public:
+  void addError(uint32_t startByte, uint32_t endByte, kj::StringPtr message) override {
+    KJ_FAIL_ASSERT("parse error", startByte, endByte, message);
+  }
+  bool hadErrors() override { return false; }
+};
+
+struct Result {
+  double microseconds = 0;
+  size_t words = 0;
+  size_t segments = 0;
+};
+
+template <typename Func>
+Result measure(List<Statement>::Reader statements, uint iterations, Func&& parse) {
+  Result result;
+  FailingErrorReporter errorReporter;
+  bool first = true;
+  result.microseconds = timeRuns(iterations, [&]() {
+    MallocMessageBuilder message;
+    parse(statements, message, errorReporter);
+    if (first) {
+      auto segments = message.getSegmentsForOutput();
+      result.segments = segments.size();
+      for (auto segment: segments) {
+        result.words += segment.size();
+      }
+      first = false;
+    }
+  }) / 1000;
+  return result;
+}
+
+void report(const char* label, const std::string& text, uint iterations) {
+  MallocMessageBuilder lexed;
+  FailingErrorReporter errorReporter;
+  KJ_ASSERT(compiler::lex(kj::arrayPtr(text.data(), text.size()),
+                          lexed.initRoot<LexedStatements>(), errorReporter));
+  auto statements = lexed.getRoot<LexedStatements>().asReader().getStatements();
+
+  Result direct = measure(statements, iterations,
+      [](List<Statement>::Reader statements, MallocMessageBuilder& result,
+         compiler::ErrorReporter& errorReporter) {
+    compiler::parseFile(statements, result.initRoot<ParsedFile>(), errorReporter);
+  });
+  Result arena = measure(statements, iterations,
+      [](List<Statement>::Reader statements, MallocMessageBuilder& result,
+         compiler::ErrorReporter& errorReporter) {
+    MallocMessageBuilder scratch;
+    compiler::parseFile(statements, scratch.initRoot<ParsedFile>(), errorReporter);
+    result.setRoot(scratch.getRoot<ParsedFile>().asReader());
+  });
+
+  std::cout << label << " (" << text.size() << " bytes):" << std::endl;
+  std::cout << "  direct:        " << direct.microseconds << " us, "
+            << direct.words * sizeof(word) << " bytes in " << direct.segments << " segments"
+            << std::endl;
+  std::cout << "  copied:        " << arena.microseconds << " us, "
+            << arena.words * sizeof(word) << " bytes in " << arena.segments << " segments"
+            << std::endl;
+}
+
+std::string syntheticSchema(uint structCount) {
+  std::ostringstream out;
+  out << "@0xd508eebdc2dc42b8;\n\n";
+  for (uint i = 0; i < structCount; i++) {
+    out << "struct Struct" << i << " $annot(\"struct " << i << "\") {\n"
+           "  # Documentation for struct " << i << ".\n"
+           "  id @0 :UInt64 = " << i << ";\n"
+           "  name @1 :Text = \"struct" << i << "\";\n"
+           "  values @2 :List(Float64) = [1.5, 2.5, -3e10];\n"
+           "  child @3 :Struct" << (i + 1) % structCount << ";\n"
+           "  union {\n"
+           "    none @4 :Void;\n"
+           "    some @5 :List(List(Text));\n"
+           "    other :group {\n"
+           "      x @6 :Int32 = -" << i << ";\n"
+           "      y @7 :Data = \"0123456789abcdef\";\n"
+           "    }\n"
+           "  }\n"
+           "  enum Kind { a @0; b @1; c @2 $annot(\"c\"); }\n"
+           "  const default" << i << " :Struct" << i << " = (id = " << i << ", name = \"x\");\n"
+           "}\n\n"
+           "interface Interface" << i << " {\n"
+           "  call @0 (a :Int32, b :Struct" << i << ") -> (c :List(Struct" << i << "));\n"
+           "  stream @1 () -> ();\n"
+           "}\n\n";
+  }
+  out << "annotation annot(*) :Text;\n";
+  return out.str();
+}
+
+int parseArenaMain(int argc, char* argv[]) {
+  if (argc > 3) {
+    std::cerr << "usage: " << argv[0] << " [SCHEMA_FILE [SYNTHETIC_STRUCTS]]" << std::endl;
+    return 1;
+  }
+
+  const char* path = argc > 1 ? argv[1] : "capnp/schema.capnp";
+  uint structCount = argc > 2 ? strtoul(argv[2], nullptr, 0) : 2000;
+
+  std::ifstream file(path);
+  if (!file) {
+    std::cerr << "can't open " << path << std::endl;
+    return 1;
+  }
+  std::stringstream content;
+  content << file.rdbuf();
+
+  report(path, content.str(), 200);
+  report("synthetic", syntheticSchema(structCount), 5);
+  return 0;
+}
+
+}  // namespace capnp
+}  // namespace benchmark
+}  // namespace capnp
+
+int main(int argc, char* argv[]) {
+  return capnp::benchmark::capnp::parseArenaMain(argc, argv);
+}
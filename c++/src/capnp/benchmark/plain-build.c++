@@ -0,0 +1,172 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "carsales-common.h"
+#include <capnp/message.h>
+#include <kj/array.h>
+#include <kj/debug.h>
+#include <iostream>
+
+// Fills a large ParkingLot from an array of in-memory Car::Plain objects, once with the
+// individual generated setters and once with Car::Builder::setFrom(), then reads it back with the
+// individual getters and with Car::Reader::toPlain().
+
+namespace capnp {
+namespace benchmark {
+namespace capnp {
+
+void setFields(Car::Builder car, const Car::Plain& plain) {
+  // What callers had to write by hand before setFrom().
+  car.setMake(plain.make);
+  car.setModel(plain.model);
+  car.setColor(plain.color);
+  car.setSeats(plain.seats);
+  car.setDoors(plain.doors);
+  auto wheels = car.initWheels(plain.wheels.size());
+  for (uint i = 0; i < plain.wheels.size(); i++) {
+    wheels[i].setDiameter(plain.wheels[i].diameter);
+    wheels[i].setAirPressure(plain.wheels[i].airPressure);
+    wheels[i].setSnowTires(plain.wheels[i].snowTires);
+  }
+  car.setLength(plain.length);
+  car.setWidth(plain.width);
+  car.setHeight(plain.height);
+  car.setWeight(plain.weight);
+  auto engine = car.initEngine();
+  engine.setHorsepower(plain.engine->horsepower);
+  engine.setCylinders(plain.engine->cylinders);
+  engine.setCc(plain.engine->cc);
+  engine.setUsesGas(plain.engine->usesGas);
+  engine.setUsesElectric(plain.engine->usesElectric);
+  car.setFuelCapacity(plain.fuelCapacity);
+  car.setFuelLevel(plain.fuelLevel);
+  car.setHasPowerWindows(plain.hasPowerWindows);
+  car.setHasPowerSteering(plain.hasPowerSteering);
+  car.setHasCruiseControl(plain.hasCruiseControl);
+  car.setCupHolders(plain.cupHolders);
+  car.setHasNavSystem(plain.hasNavSystem);
+}
+
+Car::Plain getFields(Car::Reader car) {
+  Car::Plain plain;
+  plain.make = kj::heapString(car.getMake());
+  plain.model = kj::heapString(car.getModel());
+  plain.color = car.getColor();
+  plain.seats = car.getSeats();
+  plain.doors = car.getDoors();
+  plain.wheels = KJ_MAP(wheel, car.getWheels()) {
+    Wheel::Plain result;
+    result.diameter = wheel.getDiameter();
+    result.airPressure = wheel.getAirPressure();
+    result.snowTires = wheel.getSnowTires();
+    return result;
+  };
+  plain.length = car.getLength();
+  plain.width = car.getWidth();
+  plain.height = car.getHeight();
+  plain.weight = car.getWeight();
+  auto engine = car.getEngine();
+  plain.engine = kj::heap<Engine::Plain>();
+  plain.engine->horsepower = engine.getHorsepower();
+  plain.engine->cylinders = engine.getCylinders();
+  plain.engine->cc = engine.getCc();
+  plain.engine->usesGas = engine.getUsesGas();
+  plain.engine->usesElectric = engine.getUsesElectric();
+  plain.fuelCapacity = car.getFuelCapacity();
+  plain.fuelLevel = car.getFuelLevel();
+  plain.hasPowerWindows = car.getHasPowerWindows();
+  plain.hasPowerSteering = car.getHasPowerSteering();
+  plain.hasCruiseControl = car.getHasCruiseControl();
+  plain.cupHolders = car.getCupHolders();
+  plain.hasNavSystem = car.getHasNavSystem();
+  return plain;
+}
+
+int plainBuildMain(int argc, char* argv[]) {
+  if (argc > 2) {
+    std::cerr << "usage: " << argv[0] << " [CARS]" << std::endl;
+    return 1;
+  }
+
+  uint carCount = argc > 1 ? strtoul(argv[1], nullptr, 0) : 100000;
+  uint iterations = 10;
+
+  auto plains = kj::heapArray<Car::Plain>(carCount);
+  for (auto& plain: plains) {
+    MallocMessageBuilder message;
+    auto car = message.initRoot<Car>();
+    randomCar(car);
+    plain = getFields(car.asReader());
+  }
+
+  MallocMessageBuilder setterMessage;
+  double setters = timeRuns(iterations, [&]() {
+    auto cars = setterMessage.initRoot<ParkingLot>().initCars(carCount);
+    for (uint i = 0; i < carCount; i++) {
+      setFields(cars[i], plains[i]);
+    }
+  }) / carCount;
+
+  MallocMessageBuilder setFromMessage;
+  double setFrom = timeRuns(iterations, [&]() {
+    auto cars = setFromMessage.initRoot<ParkingLot>().initCars(carCount);
+    for (uint i = 0; i < carCount; i++) {
+      cars[i].setFrom(plains[i]);
+    }
+  }) / carCount;
+
+  auto cars = setFromMessage.getRoot<ParkingLot>().asReader().getCars();
+  auto setterCars = setterMessage.getRoot<ParkingLot>().asReader().getCars();
+  for (uint i = 0; i < carCount; i++) {
+    KJ_ASSERT(kj::str(cars[i]) == kj::str(setterCars[i]), i);
+  }
+
+  uint64_t sum0 = 0;
+  double getters = timeRuns(iterations, [&]() {
+    for (auto car: cars) {
+      sum0 += getFields(car).wheels.size();
+    }
+  }) / carCount;
+
+  uint64_t sum1 = 0;
+  double toPlain = timeRuns(iterations, [&]() {
+    for (auto car: cars) {
+      sum1 += car.toPlain().wheels.size();
+    }
+  }) / carCount;
+  KJ_ASSERT(sum0 == sum1);
+
+  std::cout << "build: setters " << setters << " ns/car, setFrom() " << setFrom << " ns/car"
+            << std::endl;
+  std::cout << "read: getters " << getters << " ns/car, toPlain() " << toPlain << " ns/car"
+            << std::endl;
+  return 0;
+}
+
+}  // namespace capnp
+}  // namespace benchmark
+}  // namespace capnp
+
+int main(int argc, char* argv[]) {
+  return capnp::benchmark::capnp::plainBuildMain(argc, argv);
+}
@@ -0,0 +1,186 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "carsales-common.h"
+#include "catrank.capnp.h"
+#include <capnp/dynamic.h>
+#include <capnp/message.h>
+#include <kj/debug.h>
+#include <iostream>
+
+// Forwards a few fields of each element of a large list as a message of its own, comparing
+// DynamicStruct::Projection against copying the whole element (and, for cars, against setting the
+// same fields one by one through the dynamic API):
+//
+// - Three fields of each Car in a ParkingLot ("make", "engine.horsepower", "fuelLevel").  A Car
+//   is small, so this mostly measures the per-message overhead.
+// - "url" and "score" of each catrank SearchResult, whose snippet is a few kilobytes of text.
+//   This is the case Projection is for:  the whole-struct copy spends its time on the snippet.
+
+namespace capnp {
+namespace benchmark {
+namespace capnp {
+
+size_t messageWords(MessageBuilder& message) {
+  size_t total = 0;
+  for (auto segment: message.getSegmentsForOutput()) {
+    total += segment.size();
+  }
+  return total;
+}
+
+template <typename ListReader, typename Func>
+double timeForward(ListReader items, size_t& words, Func&& forward) {
+  // Calls forward(item, message) on a fresh message for each item.  Returns nanoseconds per item.
+  return timeRuns(1, [&]() {
+    for (auto item: items) {
+      MallocMessageBuilder message(64);
+      forward(item, message);
+      words += messageWords(message);
+    }
+  }) / items.size();
+}
+
+void report(const char* label, double nanos, size_t words, uint count) {
+  std::cout << label << nanos << " ns, " << words * 8.0 / count << " bytes" << std::endl;
+}
+
+void forwardCars(uint carCount) {
+  MallocMessageBuilder source;
+  for (auto car: source.initRoot<ParkingLot>().initCars(carCount)) {
+    randomCar(car);
+  }
+  auto cars = source.getRoot<ParkingLot>().asReader().getCars();
+
+  StructSchema schema = Schema::from<Car>();
+  DynamicStruct::Projection projection(schema, {"make", "engine.horsepower", "fuelLevel"});
+  auto make = schema.getFieldByName("make");
+  auto engine = schema.getFieldByName("engine");
+  auto horsepower = Schema::from<Engine>().getFieldByName("horsepower");
+  auto fuelLevel = schema.getFieldByName("fuelLevel");
+
+  size_t fullWords = 0;
+  double full = timeForward(cars, fullWords, [&](Car::Reader car, MessageBuilder& message) {
+    message.setRoot(car);
+  });
+
+  size_t dynamicWords = 0;
+  double dynamic = timeForward(cars, dynamicWords, [&](Car::Reader car, MessageBuilder& message) {
+    auto from = toDynamic(car);
+    auto to = message.initRoot<DynamicStruct>(schema);
+    to.set(make, from.get(make));
+    to.init(engine).as<DynamicStruct>().set(
+        horsepower, from.get(engine).as<DynamicStruct>().get(horsepower));
+    to.set(fuelLevel, from.get(fuelLevel));
+  });
+
+  size_t projectedWords = 0;
+  double projected = timeForward(cars, projectedWords,
+                                 [&](Car::Reader car, MessageBuilder& message) {
+    projection.copy(toDynamic(car), message);
+  });
+
+  for (uint i = 0; i < carCount; i += 997) {
+    MallocMessageBuilder message;
+    projection.copy(toDynamic(cars[i]), message);
+    auto car = message.getRoot<Car>().asReader();
+    KJ_ASSERT(car.getMake() == cars[i].getMake());
+    KJ_ASSERT(car.getEngine().getHorsepower() == cars[i].getEngine().getHorsepower());
+    KJ_ASSERT(car.getFuelLevel() == cars[i].getFuelLevel());
+    KJ_ASSERT(car.getWheels().size() == 0);
+  }
+
+  std::cout << carCount << " cars, per car:" << std::endl;
+  report("  whole car:    ", full, fullWords, carCount);
+  report("  get/set:      ", dynamic, dynamicWords, carCount);
+  report("  Projection:   ", projected, projectedWords, carCount);
+}
+
+void forwardSearchResults(uint resultCount, uint snippetWords) {
+  MallocMessageBuilder source;
+  for (auto result: source.initRoot<SearchResultList>().initResults(resultCount)) {
+    std::string url = "http://example.com/";
+    for (uint i = fastRand(100); i > 0; i--) {
+      url.push_back('a' + fastRand(26));
+    }
+    result.setUrl(url);
+    result.setScore(fastRandDouble(1000));
+
+    std::string snippet;
+    for (uint i = 0; i < snippetWords; i++) {
+      snippet.append(WORDS[fastRand(WORDS_COUNT)]);
+    }
+    result.setSnippet(snippet);
+  }
+  auto results = source.getRoot<SearchResultList>().asReader().getResults();
+
+  DynamicStruct::Projection projection(Schema::from<SearchResult>(), {"url", "score"});
+
+  size_t fullWords = 0;
+  double full = timeForward(results, fullWords,
+                            [&](SearchResult::Reader result, MessageBuilder& message) {
+    message.setRoot(result);
+  });
+
+  size_t projectedWords = 0;
+  double projected = timeForward(results, projectedWords,
+                                 [&](SearchResult::Reader result, MessageBuilder& message) {
+    projection.copy(toDynamic(result), message);
+  });
+
+  for (uint i = 0; i < resultCount; i += 997) {
+    MallocMessageBuilder message;
+    projection.copy(toDynamic(results[i]), message);
+    auto result = message.getRoot<SearchResult>().asReader();
+    KJ_ASSERT(result.getUrl() == results[i].getUrl());
+    KJ_ASSERT(result.getScore() == results[i].getScore());
+    KJ_ASSERT(!result.hasSnippet());
+  }
+
+  std::cout << resultCount << " search results with " << snippetWords
+            << "-word snippets, per result:" << std::endl;
+  report("  whole result: ", full, fullWords, resultCount);
+  report("  Projection:   ", projected, projectedWords, resultCount);
+}
+
+int projectionMain(int argc, char* argv[]) {
+  if (argc > 3) {
+    std::cerr << "usage: " << argv[0] << " [COUNT [SNIPPET_WORDS]]" << std::endl;
+    return 1;
+  }
+
+  uint count = argc > 1 ? strtoul(argv[1], nullptr, 0) : 200000;
+  uint snippetWords = argc > 2 ? strtoul(argv[2], nullptr, 0) : 500;
+
+  forwardCars(count);
+  forwardSearchResults(count, snippetWords);
+  return 0;
+}
+
+}  // namespace capnp
+}  // namespace benchmark
+}  // namespace capnp
+
+int main(int argc, char* argv[]) {
+  return capnp::benchmark::capnp::projectionMain(argc, argv);
+}
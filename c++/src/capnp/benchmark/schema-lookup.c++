@@ -0,0 +1,87 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "carsales.capnp.h"
+#include "catrank.capnp.h"
+#include "eval.capnp.h"
+#include "common.h"
+#include <capnp/schema-loader.h>
+#include <kj/thread.h>
+#include <kj/vector.h>
+#include <kj/debug.h>
+#include <iostream>
+
+// Measures SchemaLoader::get() throughput for already-loaded types, from one or more threads at
+// once, as a schema registry resolving type IDs for concurrent requests would.
+
+namespace capnp {
+namespace benchmark {
+namespace capnp {
+
+int schemaLookupMain(int argc, char* argv[]) {
+  if (argc > 3) {
+    std::cerr << "usage: " << argv[0] << " [THREADS [LOOKUPS]]" << std::endl;
+    return 1;
+  }
+
+  uint threadCount = argc > 1 ? strtoul(argv[1], nullptr, 0) : 4;
+  uint lookups = argc > 2 ? strtoul(argv[2], nullptr, 0) : 10000000;
+
+  SchemaLoader loader;
+  loader.loadCompiledTypeAndDependencies<ParkingLot>();
+  loader.loadCompiledTypeAndDependencies<TotalValue>();
+  loader.loadCompiledTypeAndDependencies<SearchResultList>();
+  loader.loadCompiledTypeAndDependencies<Expression>();
+  loader.loadCompiledTypeAndDependencies<EvaluationResult>();
+
+  kj::Vector<uint64_t> ids;
+  for (auto schema: loader.getAllLoaded()) {
+    ids.add(schema.getProto().getId());
+  }
+
+  double seconds = timeRuns(1, [&]() {
+    kj::Vector<kj::Own<kj::Thread>> threads;
+    for (uint t = 0; t < threadCount; t++) {
+      threads.add(kj::heap<kj::Thread>([&]() {
+        uint64_t sum = 0;
+        for (uint i = 0; i < lookups; i++) {
+          sum += loader.get(ids[i % ids.size()]).getProto().getId() & 1;
+        }
+        KJ_ASSERT(sum > 0);
+      }));
+    }
+  }) / 1e9;
+
+  std::cout << threadCount << " threads x " << lookups << " lookups of " << ids.size()
+            << " types: " << seconds << " s, "
+            << threadCount * (double)lookups / seconds / 1e6 << " M lookups/s" << std::endl;
+  return 0;
+}
+
+}  // namespace capnp
+}  // namespace benchmark
+}  // namespace capnp
+
+int main(int argc, char* argv[]) {
+  return capnp::benchmark::capnp::schemaLookupMain(argc, argv);
+}
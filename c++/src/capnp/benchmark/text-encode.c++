@@ -0,0 +1,151 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "carsales-common.h"
+#include <capnp/text-parser.h>
+#include <capnp/compiler/lexer.h>
+#include <capnp/compiler/parser.h>
+#include <capnp/compiler/node-translator.h>
+#include <capnp/schema-loader.h>
+#include <capnp/message.h>
+#include <capnp/serialize.h>
+#include <kj/debug.h>
+#include <iostream>
+
+// Compares encoding a file of text-format Car records -- one message per record, as
+// `capnp encode` does -- using TextParser against the schema-language lexer, parser, and
+// ValueTranslator.
+
+namespace capnp {
+namespace benchmark {
+namespace capnp {
+
+class CountingOutputStream: public kj::OutputStream {
+public:
+  size_t count = 0;
+  void write(const void* buffer, size_t size) override { count += size; }
+};
+
+class NullErrorReporter: public compiler::ErrorReporter {
+public:
+  void addError(uint32_t startByte, uint32_t endByte, kj::StringPtr message) override {
+    KJ_FAIL_ASSERT("unexpected error", startByte, message);
+  }
+  bool hadErrors() override { return false; }
+};
+
+class LoaderResolver: public compiler::ValueTranslator::Resolver {
+public:
+  explicit LoaderResolver(const SchemaLoader& loader): loader(loader) {}
+  kj::Maybe<Schema> resolveType(uint64_t id) override { return loader.get(id); }
+  kj::Maybe<DynamicValue::Reader> resolveConstant(compiler::DeclName::Reader name) override {
+    return nullptr;
+  }
+
+private:
+  const SchemaLoader& loader;
+};
+
+int textEncodeMain(int argc, char* argv[]) {
+  if (argc > 3) {
+    std::cerr << "usage: " << argv[0] << " [RECORDS [fast|slow|both]]" << std::endl;
+    return 1;
+  }
+
+  uint recordCount = argc > 1 ? strtoul(argv[1], nullptr, 0) : 1000000;
+  kj::StringPtr mode = argc > 2 ? kj::StringPtr(argv[2]) : "both";
+
+  kj::Vector<char> input;
+  for (uint i = 0; i < recordCount; i++) {
+    MallocMessageBuilder message;
+    auto car = message.initRoot<Car>();
+    randomCar(car);
+    auto text = kj::str(car.asReader(), '\n');
+    input.addAll(text.begin(), text.end());
+  }
+  std::cout << recordCount << " records, " << input.size() << " bytes of text" << std::endl;
+
+  if (mode == "fast" || mode == "both") {
+    CountingOutputStream output;
+    uint count = 0;
+    double seconds = timeRuns(1, [&]() {
+      TextParser parser(input);
+      while (!parser.atEnd()) {
+        MallocMessageBuilder message;
+        parser.parseStruct(message.initRoot<DynamicStruct>(Schema::from<Car>()));
+        writeMessage(output, message);
+        ++count;
+      }
+    }) / 1e9;
+    KJ_ASSERT(count == recordCount);
+    std::cout << "TextParser:       " << seconds << " s, "
+              << input.size() / seconds / 1e6 << " MB/s" << std::endl;
+  }
+
+  if (mode == "slow" || mode == "both") {
+    SchemaLoader loader;
+    loader.loadCompiledTypeAndDependencies<Car>();
+    LoaderResolver resolver(loader);
+    NullErrorReporter errorReporter;
+
+    CountingOutputStream output;
+    uint count = 0;
+    double seconds = timeRuns(1, [&]() {
+      MallocMessageBuilder arena;
+      auto lexedTokens = arena.initRoot<compiler::LexedTokens>();
+      compiler::lex(input, lexedTokens, errorReporter);
+
+      compiler::CapnpParser parser(arena.getOrphanage(), errorReporter);
+      auto tokens = lexedTokens.asReader().getTokens();
+      compiler::CapnpParser::ParserInput parserInput(tokens.begin(), tokens.end());
+
+      auto type = arena.getOrphanage().newOrphan<schema::Type>();
+      type.get().initStruct().setTypeId(typeId<Car>());
+
+      while (parserInput.getPosition() != tokens.end()) {
+        auto maybeExpression = parser.getParsers().parenthesizedValueExpression(parserInput);
+        auto& expression = KJ_ASSERT_NONNULL(maybeExpression);
+        MallocMessageBuilder message;
+        compiler::ValueTranslator translator(resolver, errorReporter, message.getOrphanage());
+        auto maybeValue = translator.compileValue(expression.getReader(), type.getReader());
+        auto& value = KJ_ASSERT_NONNULL(maybeValue);
+        message.adoptRoot(value.releaseAs<DynamicStruct>());
+        writeMessage(output, message);
+        ++count;
+      }
+    }) / 1e9;
+    KJ_ASSERT(count == recordCount);
+    std::cout << "lexer + parser:   " << seconds << " s, "
+              << input.size() / seconds / 1e6 << " MB/s" << std::endl;
+  }
+
+  return 0;
+}
+
+}  // namespace capnp
+}  // namespace benchmark
+}  // namespace capnp
+
+int main(int argc, char* argv[]) {
+  return capnp::benchmark::capnp::textEncodeMain(argc, argv);
+}
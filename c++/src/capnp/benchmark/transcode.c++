@@ -0,0 +1,167 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "carsales-common.h"
+#include <capnp/dynamic.h>
+#include <capnp/message.h>
+#include <capnp/schema-loader.h>
+#include <kj/debug.h>
+#include <iostream>
+
+// Migrates a large ParkingLot to a newer version of Car (one extra field, same type ID), and to
+// a variant whose layout no longer matches (two fields swap offsets), comparing
+// DynamicStruct::Transcoder against the obvious get()/set() loop.
+
+namespace capnp {
+namespace benchmark {
+namespace capnp {
+
+StructSchema loadCarVariant(SchemaLoader& loader, bool swapSeatsAndDoors) {
+  // Car plus `mileage @18 :UInt32` in a new data word, optionally with seats and doors swapped.
+
+  auto car = Schema::from<Car>().getProto();
+  MallocMessageBuilder message;
+  message.setRoot(car);
+  auto node = message.getRoot<schema::Node>().getStruct();
+
+  auto oldFields = node.disownFields();
+  uint count = oldFields.get().size();
+  auto fields = node.initFields(count + 1);
+  for (uint i = 0; i < count; i++) {
+    fields.setWithCaveats(i, oldFields.get()[i]);
+  }
+
+  auto mileage = fields[count];
+  mileage.setName("mileage");
+  mileage.setCodeOrder(count);
+  mileage.setDiscriminantValue(schema::Field::NO_DISCRIMINANT);
+  mileage.initOrdinal().setExplicit(count);
+  auto slot = mileage.initSlot();
+  slot.setOffset(node.getDataWordCount() * 2);
+  slot.initType().setUint32();
+  slot.initDefaultValue().setUint32(0);
+  node.setDataWordCount(node.getDataWordCount() + 1);
+
+  if (swapSeatsAndDoors) {
+    auto seats = fields[3].getSlot();
+    auto doors = fields[4].getSlot();
+    uint offset = seats.getOffset();
+    seats.setOffset(doors.getOffset());
+    doors.setOffset(offset);
+  }
+
+  loader.loadCompiledTypeAndDependencies<Engine>();
+  loader.loadCompiledTypeAndDependencies<Wheel>();
+  loader.load(Schema::from<Color>().getProto());
+  return loader.load(message.getRoot<schema::Node>().asReader()).asStruct();
+}
+
+void naiveCopy(DynamicStruct::Reader from, DynamicStruct::Builder to) {
+  // What migration code typically does:  set each field of the target from the same-named field
+  // of the source, recursing into structs and re-typing enums since set() requires identical
+  // schemas for those.
+
+  for (auto field: to.getSchema().getFields()) {
+    KJ_IF_MAYBE(fromField, from.getSchema().findFieldByName(field.getProto().getName())) {
+      if (!from.has(*fromField)) continue;
+      auto value = from.get(*fromField);
+      if (value.getType() == DynamicValue::STRUCT) {
+        naiveCopy(value.as<DynamicStruct>(), to.init(field).as<DynamicStruct>());
+      } else if (value.getType() == DynamicValue::LIST &&
+                 value.as<DynamicList>().getSchema().whichElementType() ==
+                     schema::Type::STRUCT) {
+        auto fromList = value.as<DynamicList>();
+        auto toList = to.init(field, fromList.size()).as<DynamicList>();
+        for (uint i = 0; i < fromList.size(); i++) {
+          naiveCopy(fromList[i].as<DynamicStruct>(), toList[i].as<DynamicStruct>());
+        }
+      } else if (value.getType() == DynamicValue::ENUM) {
+        EnumSchema enumSchema = to.get(field).as<DynamicEnum>().getSchema();
+        to.set(field, DynamicEnum(enumSchema, value.as<DynamicEnum>().getRaw()));
+      } else {
+        to.set(field, value);
+      }
+    }
+  }
+}
+
+int transcodeMain(int argc, char* argv[]) {
+  if (argc > 2) {
+    std::cerr << "usage: " << argv[0] << " [CARS]" << std::endl;
+    return 1;
+  }
+
+  uint carCount = argc > 1 ? strtoul(argv[1], nullptr, 0) : 200000;
+
+  MallocMessageBuilder source;
+  for (auto car: source.initRoot<ParkingLot>().initCars(carCount)) {
+    randomCar(car);
+  }
+  auto cars = toDynamic(source.getRoot<ParkingLot>().asReader().getCars());
+
+  for (bool swap: {false, true}) {
+    SchemaLoader loader;
+    StructSchema target = loadCarVariant(loader, swap);
+    DynamicStruct::Transcoder transcoder(Schema::from<Car>(), target);
+    KJ_ASSERT(transcoder.isSectionCopy() == !swap);
+
+    MallocMessageBuilder naiveMessage;
+    auto naiveOrphan = naiveMessage.getOrphanage().newOrphan(ListSchema::of(target), carCount);
+    auto naiveCars = naiveOrphan.get();
+    double naive = timeRuns(1, [&]() {
+      for (uint i = 0; i < carCount; i++) {
+        naiveCopy(cars[i].as<DynamicStruct>(), naiveCars[i].as<DynamicStruct>());
+      }
+    }) / carCount;
+
+    MallocMessageBuilder message;
+    auto orphan = message.getOrphanage().newOrphan(ListSchema::of(target), carCount);
+    auto newCars = orphan.get();
+    double transcoded = timeRuns(1, [&]() {
+      for (uint i = 0; i < carCount; i++) {
+        transcoder.copy(cars[i].as<DynamicStruct>(), newCars[i].as<DynamicStruct>());
+      }
+    }) / carCount;
+
+    for (uint i = 0; i < carCount; i += 997) {
+      auto a = naiveCars[i].as<DynamicStruct>();
+      auto b = newCars[i].as<DynamicStruct>();
+      KJ_ASSERT(a.get("doors").as<uint>() == b.get("doors").as<uint>());
+      KJ_ASSERT(a.get("engine").as<DynamicStruct>().get("cc").as<uint>() ==
+                b.get("engine").as<DynamicStruct>().get("cc").as<uint>());
+    }
+
+    std::cout << (swap ? "moved fields (by name): " : "new version (sections): ")
+              << "get/set " << naive << " ns/car, Transcoder " << transcoded << " ns/car"
+              << std::endl;
+  }
+  return 0;
+}
+
+}  // namespace capnp
+}  // namespace benchmark
+}  // namespace capnp
+
+int main(int argc, char* argv[]) {
+  return capnp::benchmark::capnp::transcodeMain(argc, argv);
+}
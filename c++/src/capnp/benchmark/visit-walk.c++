@@ -0,0 +1,161 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "carsales-common.h"
+#include <capnp/dynamic.h>
+#include <capnp/message.h>
+#include <kj/debug.h>
+#include <iostream>
+
+// Walks every field of every car in a large ParkingLot, counting the fields and summing the
+// numbers and text sizes found, once recursively through DynamicStruct and once with the
+// generated visit() templates.
+
+namespace capnp {
+namespace benchmark {
+namespace capnp {
+
+struct Totals {
+  uint64_t fields = 0;
+  uint64_t textBytes = 0;
+  double sum = 0;
+
+  inline bool operator==(const Totals& other) const {
+    return fields == other.fields && textBytes == other.textBytes && sum == other.sum;
+  }
+};
+
+void dynamicWalk(DynamicValue::Reader value, Totals& totals) {
+  switch (value.getType()) {
+    case DynamicValue::STRUCT: {
+      auto reader = value.as<DynamicStruct>();
+      auto visitField = [&](StructSchema::Field field) {
+        auto proto = field.getProto();
+        if (proto.isSlot()) {
+          switch (proto.getSlot().getType().which()) {
+            case schema::Type::INTERFACE:
+              return;
+            case schema::Type::TEXT:
+            case schema::Type::DATA:
+            case schema::Type::LIST:
+            case schema::Type::STRUCT:
+            case schema::Type::ANY_POINTER:
+              if (!reader.has(field)) return;
+              break;
+            default:
+              break;
+          }
+        }
+        ++totals.fields;
+        dynamicWalk(reader.get(field), totals);
+      };
+      for (auto field: reader.getSchema().getNonUnionFields()) {
+        visitField(field);
+      }
+      KJ_IF_MAYBE(field, reader.which()) {
+        visitField(*field);
+      }
+      break;
+    }
+    case DynamicValue::LIST:
+      for (auto element: value.as<DynamicList>()) {
+        dynamicWalk(element, totals);
+      }
+      break;
+    case DynamicValue::INT:
+    case DynamicValue::UINT:
+    case DynamicValue::FLOAT:
+      totals.sum += value.as<double>();
+      break;
+    case DynamicValue::TEXT:
+      totals.textBytes += value.as<Text>().size();
+      break;
+    default:
+      break;
+  }
+}
+
+struct TotalsVisitor {
+  Totals totals;
+
+  template <typename Field, typename T>
+  inline void operator()(Field, T value) { ++totals.fields; }
+
+  template <typename Field>
+  inline void operator()(Field, uint8_t value) { ++totals.fields; totals.sum += value; }
+  template <typename Field>
+  inline void operator()(Field, uint16_t value) { ++totals.fields; totals.sum += value; }
+  template <typename Field>
+  inline void operator()(Field, uint32_t value) { ++totals.fields; totals.sum += value; }
+  template <typename Field>
+  inline void operator()(Field, float value) { ++totals.fields; totals.sum += value; }
+  template <typename Field>
+  inline void operator()(Field, Text::Reader value) {
+    ++totals.fields;
+    totals.textBytes += value.size();
+  }
+};
+
+int visitWalkMain(int argc, char* argv[]) {
+  if (argc > 2) {
+    std::cerr << "usage: " << argv[0] << " [CARS]" << std::endl;
+    return 1;
+  }
+
+  uint carCount = argc > 1 ? strtoul(argv[1], nullptr, 0) : 100000;
+  uint iterations = 10;
+
+  MallocMessageBuilder source;
+  for (auto car: source.initRoot<ParkingLot>().initCars(carCount)) {
+    randomCar(car);
+  }
+  auto lot = source.getRoot<ParkingLot>().asReader();
+
+  Totals totals0;
+  double dynamic = timeRuns(iterations, [&]() {
+    totals0 = Totals();
+    dynamicWalk(DynamicStruct::Reader(lot), totals0);
+  }) / carCount;
+
+  TotalsVisitor visitor;
+  double generated = timeRuns(iterations, [&]() {
+    visitor.totals = Totals();
+    visit(lot, visitor);
+  }) / carCount;
+
+  KJ_ASSERT(totals0 == visitor.totals);
+
+  std::cout << visitor.totals.fields << " fields, " << visitor.totals.textBytes
+            << " text bytes, sum " << visitor.totals.sum << std::endl;
+  std::cout << "DynamicStruct walk: " << dynamic << " ns/car, visit(): " << generated
+            << " ns/car" << std::endl;
+  return 0;
+}
+
+}  // namespace capnp
+}  // namespace benchmark
+}  // namespace capnp
+
+int main(int argc, char* argv[]) {
+  return capnp::benchmark::capnp::visitWalkMain(argc, argv);
+}
@@ -28,7 +28,62 @@ static const ::capnp::_::AlignedData<19> b_b9c6f99ebf805f2c = {
 };
 const ::capnp::_::RawSchema s_b9c6f99ebf805f2c = {
   0xb9c6f99ebf805f2c, b_b9c6f99ebf805f2c.words, 19, nullptr, nullptr,
-  0, 0, nullptr, nullptr, nullptr
+  0, 0, nullptr, nullptr, nullptr,
+  { 0, 0, 0, false, 0, 0, false },
+  0, nullptr, nullptr
+};
+static const ::capnp::_::AlignedData<18> b_c8e61dc22850ec3d = {
+  {   0,   0,   0,   0,   5,   0,   5,   0,
+     61, 236,  80,  40, 194,  29, 230, 200,
+      0,   0,   0,   0,   5,   0,  17,   0,
+    129,  78,  48, 184, 123, 125, 248, 189,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+     17,   0,   0,   0, 178,   0,   0,   0,
+     25,   0,   0,   0,   7,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+     20,   0,   0,   0,   2,   0,   1,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+     99,  97, 112, 110, 112,  47,  99,  43,
+     43,  46,  99,  97, 112, 110, 112,  58,
+    112, 108,  97, 105, 110,   0,   0,   0,
+      0,   0,   0,   0,   1,   0,   1,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0, }
+};
+const ::capnp::_::RawSchema s_c8e61dc22850ec3d = {
+  0xc8e61dc22850ec3d, b_c8e61dc22850ec3d.words, 18, nullptr, nullptr,
+  0, 0, nullptr, nullptr, nullptr,
+  { 0, 0, 0, false, 0, 0, false },
+  0, nullptr, nullptr
+};
+static const ::capnp::_::AlignedData<19> b_ecad350bbc4e3cc8 = {
+  {   0,   0,   0,   0,   5,   0,   5,   0,
+    200,  60,  78, 188,  11,  53, 173, 236,
+      0,   0,   0,   0,   5,   0,  17,   0,
+    129,  78,  48, 184, 123, 125, 248, 189,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+     17,   0,   0,   0, 210,   0,   0,   0,
+     29,   0,   0,   0,   7,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+     24,   0,   0,   0,   2,   0,   1,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+     99,  97, 112, 110, 112,  47,  99,  43,
+     43,  46,  99,  97, 112, 110, 112,  58,
+    102, 105, 101, 108, 100,  73, 110, 102,
+    111,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   1,   0,   1,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0, }
+};
+const ::capnp::_::RawSchema s_ecad350bbc4e3cc8 = {
+  0xecad350bbc4e3cc8, b_ecad350bbc4e3cc8.words, 19, nullptr, nullptr,
+  0, 0, nullptr, nullptr, nullptr,
+  { 0, 0, 0, false, 0, 0, false },
+  0, nullptr, nullptr
 };
 }  // namespace schemas
 namespace _ {  // private
@@ -23,6 +23,8 @@ namespace capnp {
 namespace schemas {
 
 extern const ::capnp::_::RawSchema s_b9c6f99ebf805f2c;
+extern const ::capnp::_::RawSchema s_c8e61dc22850ec3d;
+extern const ::capnp::_::RawSchema s_ecad350bbc4e3cc8;
 
 }  // namespace schemas
 namespace _ {  // private
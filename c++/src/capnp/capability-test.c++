@@ -110,6 +110,32 @@ TEST(Capability, Inheritance) {
   EXPECT_EQ(2, callCount);
 }
 
+TEST(Capability, RequestBatch) {
+  kj::EventLoop loop;
+  kj::WaitScope waitScope(loop);
+
+  int callCount = 0;
+  test::TestInterface::Client client(kj::heap<TestInterfaceImpl>(callCount));
+
+  RequestBatch<test::TestInterface::FooParams, test::TestInterface::FooResults> batch(3);
+  for (uint i = 0; i < 3; i++) {
+    auto params = batch.add(client.fooRequest());
+    params.setI(123);
+    params.setJ(true);
+  }
+  EXPECT_EQ(3u, batch.size());
+
+  auto promises = batch.send();
+  EXPECT_EQ(0u, batch.size());
+  ASSERT_EQ(3u, promises.size());
+  EXPECT_EQ(0, callCount);
+
+  for (auto& promise: promises) {
+    EXPECT_EQ("foo", promise.wait(waitScope).getX());
+  }
+  EXPECT_EQ(3, callCount);
+}
+
 TEST(Capability, Pipelining) {
   kj::EventLoop loop;
   kj::WaitScope waitScope(loop);
@@ -146,6 +172,74 @@ TEST(Capability, Pipelining) {
   EXPECT_EQ(1, chainedCallCount);
 }
 
+TEST(Capability, DirectLocalClient) {
+  kj::EventLoop loop;
+  kj::WaitScope waitScope(loop);
+
+  int callCount = 0;
+  test::TestInterface::Client client(newDirectLocalClient(kj::heap<TestInterfaceImpl>(callCount)));
+
+  auto request1 = client.fooRequest();
+  request1.setI(123);
+  request1.setJ(true);
+  auto promise1 = request1.send();
+
+  // Dispatched immediately, without waiting for the event loop.
+  EXPECT_EQ(1, callCount);
+
+  auto request2 = client.bazRequest();
+  initTestMessage(request2.initS());
+  auto promise2 = request2.send();
+
+  EXPECT_EQ(2, callCount);
+
+  bool barFailed = false;
+  auto request3 = client.barRequest();
+  auto promise3 = request3.send().then(
+      [](Response<test::TestInterface::BarResults>&& response) {
+        ADD_FAILURE() << "Expected bar() call to fail.";
+      }, [&](kj::Exception&& e) {
+        barFailed = true;
+      });
+
+  auto response1 = promise1.wait(waitScope);
+  EXPECT_EQ("foo", response1.getX());
+
+  auto response2 = promise2.wait(waitScope);
+
+  promise3.wait(waitScope);
+
+  EXPECT_EQ(2, callCount);
+  EXPECT_TRUE(barFailed);
+}
+
+TEST(Capability, DirectLocalClientPipelining) {
+  kj::EventLoop loop;
+  kj::WaitScope waitScope(loop);
+
+  int callCount = 0;
+  int chainedCallCount = 0;
+  test::TestPipeline::Client client(newDirectLocalClient(kj::heap<TestPipelineImpl>(callCount)));
+
+  auto request = client.getCapRequest();
+  request.setN(234);
+  request.setInCap(test::TestInterface::Client(kj::heap<TestInterfaceImpl>(chainedCallCount)));
+
+  auto promise = request.send();
+
+  auto pipelineRequest = promise.getOutBox().getCap().fooRequest();
+  pipelineRequest.setI(321);
+  auto pipelinePromise = pipelineRequest.send();
+
+  promise = nullptr;
+
+  auto response = pipelinePromise.wait(waitScope);
+  EXPECT_EQ("bar", response.getX());
+
+  EXPECT_EQ(2, callCount);
+  EXPECT_EQ(1, chainedCallCount);
+}
+
 TEST(Capability, TailCall) {
   kj::EventLoop loop;
   kj::WaitScope waitScope(loop);
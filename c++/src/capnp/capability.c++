@@ -455,8 +455,8 @@ private:
 
 class LocalClient final: public ClientHook, public kj::Refcounted {
 public:
-  LocalClient(kj::Own<Capability::Server>&& server)
-      : server(kj::mv(server)) {}
+  LocalClient(kj::Own<Capability::Server>&& server, bool direct = false)
+      : server(kj::mv(server)), direct(direct) {}
 
   Request<AnyPointer, AnyPointer> newCall(
       uint64_t interfaceId, uint16_t methodId, kj::Maybe<MessageSize> sizeHint) override {
@@ -478,10 +478,24 @@ public:
     //
     // Note also that QueuedClient depends on this evalLater() to ensure that pipelined calls don't
     // complete before 'whenMoreResolved()' promises resolve.
-    auto promise = kj::evalLater([this,interfaceId,methodId,contextPtr]() {
-      return server->dispatchCall(interfaceId, methodId,
-                                  CallContext<AnyPointer, AnyPointer>(*contextPtr));
-    }).attach(kj::addRef(*this));
+    //
+    // In direct mode (see newDirectLocalClient()), the caller has waived this, so we skip the
+    // extra trip through the event loop and dispatch right away.
+    kj::Promise<void> promise = nullptr;
+    if (direct) {
+      KJ_IF_MAYBE(exception, kj::runCatchingExceptions([&]() {
+        promise = server->dispatchCall(interfaceId, methodId,
+                                       CallContext<AnyPointer, AnyPointer>(*contextPtr));
+      })) {
+        promise = kj::mv(*exception);
+      }
+      promise = promise.attach(kj::addRef(*this));
+    } else {
+      promise = kj::evalLater([this,interfaceId,methodId,contextPtr]() {
+        return server->dispatchCall(interfaceId, methodId,
+                                    CallContext<AnyPointer, AnyPointer>(*contextPtr));
+      }).attach(kj::addRef(*this));
+    }
 
     // We have to fork this promise for the pipeline to receive a copy of the answer.
     auto forked = promise.fork();
@@ -523,12 +537,17 @@ public:
 
 private:
   kj::Own<Capability::Server> server;
+  bool direct;
 };
 
 kj::Own<ClientHook> Capability::Client::makeLocalClient(kj::Own<Capability::Server>&& server) {
   return kj::refcounted<LocalClient>(kj::mv(server));
 }
 
+kj::Own<ClientHook> newDirectLocalClient(kj::Own<Capability::Server>&& server) {
+  return kj::refcounted<LocalClient>(kj::mv(server), true);
+}
+
 kj::Own<ClientHook> newLocalPromiseClient(kj::Promise<kj::Own<ClientHook>>&& promise) {
   return kj::refcounted<QueuedClient>(kj::mv(promise));
 }
@@ -585,7 +604,7 @@ public:
 
   VoidPromiseAndPipeline call(uint64_t interfaceId, uint16_t methodId,
                               kj::Own<CallContextHook>&& context) override {
-    return VoidPromiseAndPipeline { kj::cp(exception), kj::heap<BrokenPipeline>(exception) };
+    return VoidPromiseAndPipeline { kj::cp(exception), kj::refcounted<BrokenPipeline>(exception) };
   }
 
   kj::Maybe<ClientHook&> getResolved() {
@@ -25,6 +25,7 @@
 #define CAPNP_CAPABILITY_H_
 
 #include <kj/async.h>
+#include <kj/vector.h>
 #include "any.h"
 #include "pointer-helpers.h"
 
@@ -104,6 +105,41 @@ private:
   friend class Request;
 };
 
+template <typename Params, typename Results>
+class RequestBatch {
+  // A set of calls to the same method, built up front and then sent all at once.  Example:
+  //
+  //     RequestBatch<Calculator::EvaluateParams, Calculator::EvaluateResults> batch;
+  //     for (double value: values) {
+  //       batch.add(calculator.evaluateRequest()).getExpression().setLiteral(value);
+  //     }
+  //     auto promises = batch.send();
+  //
+  // The calls need not all target the same capability.  `send()` sends them back-to-back, in
+  // order, without yielding to the event loop, so a network transport sees them all before it
+  // gets a chance to write anything.  `TwoPartyVatNetwork` takes advantage of this by writing all
+  // of the resulting Call messages to the socket in a single system call.  The calls are still
+  // independent:  each has its own RemotePromise, and pipelining on any of them works as usual.
+
+public:
+  RequestBatch() = default;
+  explicit RequestBatch(size_t expectedSize): requests(expectedSize) {}
+  // `expectedSize` is the number of calls you intend to add, to avoid reallocation.
+
+  typename Params::Builder add(Request<Params, Results>&& request);
+  // Add a call to the batch, returning its params for you to fill in.  The params may be filled
+  // in any time before `send()`.
+
+  inline size_t size() const { return requests.size(); }
+
+  kj::Array<RemotePromise<Results>> send();
+  // Send all of the calls, in the order in which they were added, and empty the batch.  The
+  // returned promises are in the same order.
+
+private:
+  kj::Vector<Request<Params, Results>> requests;
+};
+
 class Capability::Client {
   // Base type for capability clients.
 
@@ -412,6 +448,19 @@ kj::Own<ClientHook> newLocalPromiseClient(kj::Promise<kj::Own<ClientHook>>&& pro
 // the new client.  This hook's `getResolved()` and `whenMoreResolved()` methods will reflect the
 // redirection to the eventual replacement client.
 
+kj::Own<ClientHook> newDirectLocalClient(kj::Own<Capability::Server>&& server);
+// Like converting `server` to a `Capability::Client` directly, except that calls to the returned
+// client are dispatched synchronously, from within `send()`, rather than on a later turn of the
+// event loop.  This saves an event loop round trip per call, which can dominate the cost of
+// calling a trivial method in the same process.  Wrap the result in the appropriate client type:
+//
+//     MyInterface::Client client(newDirectLocalClient(kj::heap<MyInterfaceImpl>()));
+//
+// The price is that the method runs -- and has its side effects -- before `send()` returns, and
+// possibly while the caller is in the middle of something.  Only use this when neither the caller
+// nor the server depends on the usual ordering, e.g. for a stateless leaf service.  (Results are
+// still delivered asynchronously, through the returned promise.)
+
 kj::Own<ClientHook> newBrokenCap(kj::StringPtr reason);
 kj::Own<ClientHook> newBrokenCap(kj::Exception&& reason);
 // Helper function that creates a capability which simply throws exceptions when called.
@@ -589,6 +638,22 @@ inline Request<Params, Results> Capability::Client::newCall(
   return Request<Params, Results>(typeless.template getAs<Params>(), kj::mv(typeless.hook));
 }
 
+template <typename Params, typename Results>
+inline typename Params::Builder RequestBatch<Params, Results>::add(
+    Request<Params, Results>&& request) {
+  requests.add(kj::mv(request));
+  return requests.back();
+}
+template <typename Params, typename Results>
+kj::Array<RemotePromise<Results>> RequestBatch<Params, Results>::send() {
+  auto batch = requests.releaseAsArray();
+  auto builder = kj::heapArrayBuilder<RemotePromise<Results>>(batch.size());
+  for (auto& request: batch) {
+    builder.add(request.send());
+  }
+  return builder.finish();
+}
+
 template <typename Params, typename Results>
 inline CallContext<Params, Results>::CallContext(CallContextHook& hook): hook(&hook) {}
 template <typename Params, typename Results>
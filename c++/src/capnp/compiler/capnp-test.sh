@@ -37,6 +37,12 @@ else
   CAPNP=${CAPNP:-capnp}
 fi
 
+if test -f ./capnpc-c++; then
+  CAPNPC_CXX=${CAPNPC_CXX:-./capnpc-c++}
+else
+  CAPNPC_CXX=${CAPNPC_CXX:-capnpc-c++}
+fi
+
 SCHEMA=`dirname "$0"`/../test.capnp
 TESTDATA=`dirname "$0"`/../testdata
 
@@ -53,6 +59,19 @@ $CAPNP decode --short $SCHEMA TestAllTypes < $TESTDATA/binary | cmp $TESTDATA/sh
 $CAPNP decode $SCHEMA TestAllTypes < $TESTDATA/segmented | cmp $TESTDATA/pretty.txt - || fail decode segmented
 $CAPNP decode --packed $SCHEMA TestAllTypes < $TESTDATA/segmented-packed | cmp $TESTDATA/pretty.txt - || fail decode segmented-packed
 
+$CAPNP convert binary:text $SCHEMA TestAllTypes < $TESTDATA/binary | cmp $TESTDATA/pretty.txt - || fail convert binary:text
+$CAPNP convert packed:text --short $SCHEMA TestAllTypes < $TESTDATA/packed | cmp $TESTDATA/short.txt - || fail convert packed:text
+$CAPNP convert flat:text $SCHEMA TestAllTypes < $TESTDATA/flat | cmp $TESTDATA/pretty.txt - || fail convert flat:text
+$CAPNP convert text:binary $SCHEMA TestAllTypes < $TESTDATA/pretty.txt | cmp $TESTDATA/binary - || fail convert text:binary
+$CAPNP convert text:packed $SCHEMA TestAllTypes < $TESTDATA/short.txt | cmp $TESTDATA/packed - || fail convert text:packed
+$CAPNP convert text:flat $SCHEMA TestAllTypes < $TESTDATA/short.txt | cmp $TESTDATA/flat - || fail convert text:flat
+$CAPNP convert --mmap packed:binary $SCHEMA TestAllTypes < $TESTDATA/segmented-packed | cmp $TESTDATA/binary - || fail convert mmap
+$CAPNP convert binary:json $SCHEMA TestAllTypes < $TESTDATA/segmented | $CAPNP convert json:binary $SCHEMA TestAllTypes |
+    cmp $TESTDATA/binary - || fail convert json round trip
+test "`cat $TESTDATA/binary $TESTDATA/segmented $TESTDATA/binary |
+    $CAPNP convert -j3 binary:text --short $SCHEMA TestAllTypes | uniq -c | sed -e 's/^ *//'`" = \
+    "3 `cat $TESTDATA/short.txt`" || fail convert parallel
+
 test_eval() {
   test "x`$CAPNP eval $SCHEMA $1`" = "x$2" || fail eval "$1 == $2"
 }
@@ -65,5 +84,44 @@ test_eval globalPrintableStruct '(someText = "foo")'
 test_eval TestConstants.enumConst corge
 test_eval 'TestListDefaults.lists.int32ListList[2][0]' 12341234
 
+$CAPNP compile -obundle $SCHEMA | $CAPNP decode --short `dirname "$0"`/../schema.capnp CodeGeneratorRequest |
+    grep -q 'displayName = "[^"]*test.capnp:TestAllTypes"' || fail compile bundle
+
+$CAPNP compile --profile -obundle:/dev/null $SCHEMA 2>&1 | grep -q '^  translate  ' || fail compile profile
+
 $CAPNP compile -ofoo $TESTDATA/errors.capnp.nobuild 2>&1 | sed -e "s,^.*/errors[.]capnp[.]nobuild,file,g" |
     cmp $TESTDATA/errors.txt - || fail error output
+
+WORKDIR=`mktemp -d`
+trap 'rm -rf "$WORKDIR"' EXIT
+
+# Each file's parse errors come before its compile errors and after those of the previous file,
+# whether or not the files are parsed ahead on worker threads.
+for n in 1 2; do
+  printf '@0xf0e1d2c3b4a5968%d;\nstruct Bad { x @0 :NoSuchType; }\nstruct Syntax { y @0 :Int32 = ; }\n' \
+      $n > $WORKDIR/errors$n.capnp
+done
+ERROR_ORDER="errors1.capnp:3:30: error: Parse error.
+errors1.capnp:2:20-30: error: Not defined: NoSuchType
+errors2.capnp:3:30: error: Parse error.
+errors2.capnp:2:20-30: error: Not defined: NoSuchType"
+for jobs in 1 2; do
+  test "`$CAPNP compile -j$jobs -ofoo $WORKDIR/errors1.capnp $WORKDIR/errors2.capnp 2>&1 |
+      sed -e "s,^$WORKDIR/,,"`" = "$ERROR_ORDER" || fail compile error order -j$jobs
+done
+
+# Output must not depend on whether the parse trees came from the cache.
+mkdir $WORKDIR/cache
+$CAPNP compile -obundle $SCHEMA > $WORKDIR/uncached
+$CAPNP compile --cache-dir=$WORKDIR/cache -obundle $SCHEMA > $WORKDIR/cold
+test -n "`ls $WORKDIR/cache`" || fail compile cache not written
+$CAPNP compile --cache-dir=$WORKDIR/cache -obundle $SCHEMA > $WORKDIR/warm
+cmp $WORKDIR/uncached $WORKDIR/cold || fail compile cache cold
+cmp $WORKDIR/uncached $WORKDIR/warm || fail compile cache warm
+
+# A Plain mirror can't hold a struct that has none of its own.
+printf '@0xf0e1d2c3b4a59690;\nusing Cxx = import "/capnp/c++.capnp";\n%s\n%s\n' \
+    'struct Outer $Cxx.plain { inner @0 :Inner; }' 'struct Inner { x @0 :Int32; }' \
+    > $WORKDIR/plain.capnp
+$CAPNP compile -I`dirname "$0"`/../.. -o$CAPNPC_CXX:$WORKDIR $WORKDIR/plain.capnp 2>&1 |
+    grep -q 'Outer[.]inner: field type .*:Inner has no Plain mirror' || fail compile plain missing
@@ -27,9 +27,13 @@
 #include "module-loader.h"
 #include "node-translator.h"
 #include <capnp/pretty-print.h>
+#include <capnp/schema-bundle.h>
+#include <capnp/text-parser.h>
+#include <capnp/json.h>
 #include <capnp/schema.capnp.h>
 #include <kj/vector.h>
 #include <kj/io.h>
+#include <kj/thread.h>
 #include <unistd.h>
 #include <kj/debug.h>
 #include "../message.h"
@@ -39,10 +43,14 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include <capnp/serialize.h>
 #include <capnp/serialize-packed.h>
 #include <errno.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 #if HAVE_CONFIG_H
 #include "config.h"
@@ -57,6 +65,30 @@ namespace compiler {
 
 static const char VERSION_STRING[] = "Cap'n Proto version " VERSION;
 
+namespace {
+
+class MmapDisposer: public kj::ArrayDisposer {
+protected:
+  void disposeImpl(void* firstElement, size_t elementSize, size_t elementCount,
+                   size_t capacity, void (*destroyElement)(void*)) const {
+    munmap(firstElement, elementSize * elementCount);
+  }
+};
+
+constexpr MmapDisposer mmapDisposer = MmapDisposer();
+
+constexpr size_t CONVERT_READ_BUFFER_BYTES = 1 << 20;
+// Size of reads from standard input for the "convert" command.
+
+constexpr size_t CONVERT_BATCH_BYTES = 4 << 20;
+// The "convert" command splits its input into batches of about this many bytes.  The reader,
+// worker, and writer stages each work on a different batch at once.
+
+constexpr uint CONVERT_CHUNK_MESSAGES = 64;
+// Workers claim this many messages of a batch at a time.
+
+}  // namespace
+
 class CompilerMain final: public GlobalErrorReporter {
 public:
   explicit CompilerMain(kj::ProcessContext& context)
@@ -84,13 +116,18 @@ public:
              .addSubCommand("encode", KJ_BIND_METHOD(*this, getEncodeMain),
                             "Encode text Cap'n Proto message to binary.")
              .addSubCommand("eval", KJ_BIND_METHOD(*this, getEvalMain),
-                            "Evaluate a const from a schema file.");
+                            "Evaluate a const from a schema file.")
+             .addSubCommand("convert", KJ_BIND_METHOD(*this, getConvertMain),
+                            "Convert messages between binary, packed, text, and JSON.");
       addGlobalOptions(builder);
       return builder.build();
     }
   }
 
   kj::MainFunc getCompileMain() {
+    // Sources are compiled together once all of them are known.  See compileSources().
+    batchCompile = true;
+
     kj::MainBuilder builder(context, VERSION_STRING,
           "Compiles Cap'n Proto schema files and generates corresponding source code in one or "
           "more languages.");
@@ -180,6 +217,48 @@ public:
     return builder.build();
   }
 
+  kj::MainFunc getConvertMain() {
+    // Only parse the schemas we actually need for decoding.
+    compileEagerness = Compiler::NODE;
+
+    // Drop annotations since we don't need them.  This avoids importing files like c++.capnp.
+    annotationFlag = Compiler::DROP_ANNOTATIONS;
+
+    kj::MainBuilder builder(context, VERSION_STRING,
+          "Converts a stream of messages with root type <type>, defined in <schema-file>, from "
+          "one encoding to another.  Messages are read from standard input and written to "
+          "standard output in the same order.  <from>:<to> names the input and output "
+          "encodings, each of which is one of:\n"
+          "    binary: standard serialization, as written by capnp::writeMessage()\n"
+          "    packed: packed serialization, as written by capnp::writePackedMessage()\n"
+          "    flat: a single segment with no framing (only one message)\n"
+          "    text: struct literals, as printed by \"capnp decode\"\n"
+          "    json: JSON objects, as written by capnp::writeJson()\n"
+          "For example:\n"
+          "    capnp convert packed:json myschema.capnp MyType < in.bin > out.json",
+
+          "The input is split into batches of whole messages on a reader thread, the messages of "
+          "each batch are converted on --jobs threads, and the results are written by a writer "
+          "thread, so that reading, converting, and writing overlap.");
+    addGlobalOptions(builder);
+    builder.addOptionWithArg({'j', "jobs"}, KJ_BIND_METHOD(*this, setJobs), "<n>",
+                             "Convert messages on <n> threads, in addition to the threads which "
+                             "read and write.  Output is identical for any <n>.")
+           .addOption({"mmap"}, KJ_BIND_METHOD(*this, setMmap),
+                      "If standard input is a regular file, map it into memory rather than "
+                      "reading it.")
+           .addOption({"short"}, KJ_BIND_METHOD(*this, printShort),
+                      "Write text output in short (non-pretty) format, one message per line.")
+           .addOption({"stats"}, KJ_BIND_METHOD(*this, setPrintStats),
+                      "When done, print the number of messages and bytes converted and the "
+                      "throughput in MB/s to standard error.")
+           .expectArg("<from>:<to>", KJ_BIND_METHOD(*this, setConversion))
+           .expectArg("<schema-file>", KJ_BIND_METHOD(*this, addSource))
+           .expectArg("<type>", KJ_BIND_METHOD(*this, setRootType))
+           .callAfterParsing(KJ_BIND_METHOD(*this, convert));
+    return builder.build();
+  }
+
   kj::MainFunc getEvalMain() {
     // Only parse the schemas we actually need for decoding.
     compileEagerness = Compiler::NODE;
@@ -230,7 +309,11 @@ public:
            .addOption({"no-standard-import"}, KJ_BIND_METHOD(*this, noStandardImport),
                       "Do not add any default import paths; use only those specified by -I.  "
                       "Otherwise, typically /usr/include and /usr/local/include are added by "
-                      "default.");
+                      "default.")
+           .addOptionWithArg({"cache-dir"}, KJ_BIND_METHOD(*this, setCacheDir), "<dir>",
+                             "Cache the parse trees of schema files in <dir>, and reuse them on "
+                             "later runs for files whose content has not changed.  Several "
+                             "compilers may share one cache directory.");
   }
 
   void addCompileOptions(kj::MainBuilder& builder) {
@@ -240,13 +323,25 @@ public:
                              "to use.  If <lang> is a simple word, the compiler for a plugin "
                              "called 'capnpc-<lang>' in $PATH.  If <lang> is a file path "
                              "containing slashes, it is interpreted as the exact plugin "
-                             "executable file name, and $PATH is not searched.")
+                             "executable file name, and $PATH is not searched.  The special "
+                             "output 'bundle:<file>' instead writes all compiled schema nodes to "
+                             "<file> (or to stdout, if omitted) as a bundle which "
+                             "capnp::SchemaBundle can load at runtime without a compiler.")
            .addOptionWithArg({"src-prefix"}, KJ_BIND_METHOD(*this, addSourcePrefix), "<prefix>",
                              "If a file specified for compilation starts with <prefix>, remove "
                              "the prefix for the purpose of deciding the names of output files.  "
                              "For example, the following command:\n"
                              "    capnp --src-prefix=foo/bar -oc++:corge foo/bar/baz/qux.capnp\n"
                              "would generate the files corge/baz/qux.capnp.{h,c++}.")
+           .addOptionWithArg({'j', "jobs"}, KJ_BIND_METHOD(*this, setJobs), "<n>",
+                             "Lex and parse the source files on <n> threads.  This helps when "
+                             "compiling many files at once; cross-linking and code generation "
+                             "still happen on one thread.  Output is identical for any <n>.")
+           .addOption({"profile"}, KJ_BIND_METHOD(*this, enableProfiling),
+                      "When done, print to stderr how much time was spent, and how many bytes "
+                      "were allocated, lexing, parsing, translating, and validating each file, "
+                      "and generating each output.  Plugins run in their own processes, so only "
+                      "their wall time is measured.")
            .expectOneOrMoreArgs("<source>", KJ_BIND_METHOD(*this, addSource))
            .callAfterParsing(KJ_BIND_METHOD(*this, generateOutput));
   }
@@ -259,6 +354,15 @@ public:
     return true;
   }
 
+  kj::MainBuilder::Validity setCacheDir(kj::StringPtr dir) {
+    struct stat stats;
+    if (stat(dir.cStr(), &stats) < 0 || !S_ISDIR(stats.st_mode)) {
+      return "cache location is inaccessible or is not a directory";
+    }
+    loader.setCacheDir(kj::heapString(dir), VERSION_STRING);
+    return true;
+  }
+
   kj::MainBuilder::Validity noStandardImport() {
     addStandardImportPaths = false;
     return true;
@@ -287,9 +391,14 @@ public:
     }
 
     KJ_IF_MAYBE(module, loadModule(file)) {
-      uint64_t id = compiler->add(*module);
-      compiler->eagerlyCompile(id, compileEagerness);
-      sourceFiles.add(SourceFile { id, module->getSourceName(), &*module });
+      if (batchCompile) {
+        // The ID is filled in by compileSources().
+        sourceFiles.add(SourceFile { 0, module->getSourceName(), &*module });
+      } else {
+        uint64_t id = compiler->add(*module);
+        compiler->eagerlyCompile(id, compileEagerness);
+        sourceFiles.add(SourceFile { id, module->getSourceName(), &*module });
+      }
     } else {
       return "no such file";
     }
@@ -326,6 +435,11 @@ public:
   kj::MainBuilder::Validity addOutput(kj::StringPtr spec) {
     KJ_IF_MAYBE(split, spec.findFirst(':')) {
       kj::StringPtr dir = spec.slice(*split + 1);
+      if (spec.slice(0, *split) == kj::StringPtr("bundle").asArray()) {
+        // Not a directory, but the bundle file name.
+        outputs.add(OutputDirective { spec.slice(0, *split), dir });
+        return true;
+      }
       struct stat stats;
       if (stat(dir.cStr(), &stats) < 0 || !S_ISDIR(stats.st_mode)) {
         return "output location is inaccessible or is not a directory";
@@ -338,6 +452,31 @@ public:
     return true;
   }
 
+  kj::MainBuilder::Validity setJobs(kj::StringPtr count) {
+    char* end;
+    jobs = strtoul(count.cStr(), &end, 0);
+    if (count.size() == 0 || *end != '\0' || jobs == 0) {
+      return "not a positive integer";
+    }
+    return true;
+  }
+
+  kj::MainBuilder::Validity enableProfiling() {
+    if (profiler.get() == nullptr) {
+      profiler = kj::heap<Profiler>();
+      loader.setProfiler(*profiler);
+    }
+    return true;
+  }
+
+  kj::Maybe<Profiler&> getProfiler() {
+    if (profiler.get() == nullptr) {
+      return nullptr;
+    } else {
+      return *profiler;
+    }
+  }
+
   kj::MainBuilder::Validity addSourcePrefix(kj::StringPtr prefix) {
     // Strip redundant "./" prefixes to make src-prefix matching more lenient.
     while (prefix.startsWith("./")) {
@@ -357,7 +496,34 @@ public:
     return true;
   }
 
+  void compileSources() {
+    // Parse all the sources (in parallel, with --jobs), then compile them as one batch so that
+    // the files they have in common are only traversed once.
+
+    KJ_IF_MAYBE(p, getProfiler()) {
+      compiler->setProfiler(*p);
+    }
+
+    auto modules = KJ_MAP(file, sourceFiles) { return file.module; };
+    if (jobs > 1) {
+      loader.parseAhead(modules, jobs);
+    }
+
+    auto ids = compiler->add(modules, compileEagerness);
+    for (uint i = 0; i < sourceFiles.size(); i++) {
+      sourceFiles[i].id = ids[i];
+    }
+  }
+
   kj::MainBuilder::Validity generateOutput() {
+    KJ_DEFER({
+      KJ_IF_MAYBE(p, getProfiler()) {
+        context.warning(p->summarize());
+      }
+    });
+
+    compileSources();
+
     if (hadErrors()) {
       // Skip output if we had any errors.
       return true;
@@ -374,22 +540,34 @@ public:
     MallocMessageBuilder message;
     auto request = message.initRoot<schema::CodeGeneratorRequest>();
 
-    auto schemas = compiler->getLoader().getAllLoaded();
-    auto nodes = request.initNodes(schemas.size());
-    for (size_t i = 0; i < schemas.size(); i++) {
-      nodes.setWithCaveats(i, schemas[i].getProto());
-    }
+    {
+      Profiler::Scope scope(getProfiler(), Profiler::Phase::GENERATE, "CodeGeneratorRequest");
+
+      auto schemas = compiler->getLoader().getAllLoaded();
+      auto nodes = request.initNodes(schemas.size());
+      for (size_t i = 0; i < schemas.size(); i++) {
+        nodes.setWithCaveats(i, schemas[i].getProto());
+      }
 
-    auto requestedFiles = request.initRequestedFiles(sourceFiles.size());
-    for (size_t i = 0; i < sourceFiles.size(); i++) {
-      auto requestedFile = requestedFiles[i];
-      requestedFile.setId(sourceFiles[i].id);
-      requestedFile.setFilename(sourceFiles[i].name);
-      requestedFile.adoptImports(compiler->getFileImportTable(
-          *sourceFiles[i].module, Orphanage::getForMessageContaining(requestedFile)));
+      auto requestedFiles = request.initRequestedFiles(sourceFiles.size());
+      for (size_t i = 0; i < sourceFiles.size(); i++) {
+        auto requestedFile = requestedFiles[i];
+        requestedFile.setId(sourceFiles[i].id);
+        requestedFile.setFilename(sourceFiles[i].name);
+        requestedFile.adoptImports(compiler->getFileImportTable(
+            *sourceFiles[i].module, Orphanage::getForMessageContaining(requestedFile)));
+      }
     }
 
     for (auto& output: outputs) {
+      kj::String outputName = kj::heapString(output.name);
+      Profiler::Scope scope(getProfiler(), Profiler::Phase::GENERATE, outputName);
+
+      if (output.name == kj::StringPtr("bundle").asArray()) {
+        writeBundle(request.asReader(), output.dir);
+        continue;
+      }
+
       int pipeFds[2];
       KJ_SYSCALL(pipe(pipeFds));
 
@@ -462,6 +640,18 @@ public:
     return true;
   }
 
+  void writeBundle(schema::CodeGeneratorRequest::Reader request, kj::StringPtr path) {
+    if (path == nullptr) {
+      kj::FdOutputStream output(STDOUT_FILENO);
+      writeSchemaBundle(output, request);
+    } else {
+      int fd;
+      KJ_SYSCALL(fd = open(path.cStr(), O_WRONLY | O_CREAT | O_TRUNC, 0666), path);
+      kj::FdOutputStream output((kj::AutoCloseFd(fd)));
+      writeSchemaBundle(output, request);
+    }
+  }
+
   // =====================================================================================
   // "decode" command
 
@@ -616,22 +806,19 @@ private:
     options.traversalLimitInWords = kj::maxValue;
 
     MessageReaderType reader(input, options);
-    kj::String text;
     kj::Maybe<kj::Exception> exception;
 
     {
+      // Stream the text straight to stdout rather than building it in memory first, so that
+      // decoding a huge message doesn't need several times its size in RAM.
       ParseErrorCatcher catcher;
       auto root = reader.template getRoot<DynamicStruct>(rootType);
-      if (pretty) {
-        text = kj::str(prettyPrint(root), '\n');
-      } else {
-        text = kj::str(root, '\n');
-      }
+      kj::FdOutputStream output(STDOUT_FILENO);
+      writeText(output, root, pretty);
+      output.write("\n", 1);
       exception = kj::mv(catcher.exception);
     }
 
-    kj::FdOutputStream(STDOUT_FILENO).write(text.begin(), text.size());
-
     KJ_IF_MAYBE(e, exception) {
       context.error(kj::str(
           "*** ERROR DECODING PREVIOUS MESSAGE ***\n"
@@ -990,12 +1177,51 @@ public:
       }
     }
 
-    EncoderErrorReporter errorReporter(*this, allText);
+    // Set up output stream.
+    kj::FdOutputStream rawOutput(STDOUT_FILENO);
+    kj::BufferedOutputStreamWrapper output(rawOutput);
+
+    // Parse each message directly into a builder with the fast text parser.
+    TextParser parser(allText);
+    while (!parser.atEnd()) {
+      size_t start = parser.getPosition();
+      MallocMessageBuilder item(
+          segmentSize == 0 ? SUGGESTED_FIRST_SEGMENT_WORDS : segmentSize,
+          segmentSize == 0 ? SUGGESTED_ALLOCATION_STRATEGY : AllocationStrategy::FIXED_SIZE);
+      auto root = item.initRoot<DynamicStruct>(rootType);
+
+      KJ_IF_MAYBE(exception, kj::runCatchingExceptions([&]() { parser.parseStruct(root); })) {
+        // The fast parser only understands literal values.  Hand the rest of the input to the
+        // full schema-language parser, which reports errors in the same way as for schema files.
+        encodeWithCompiler(allText, start, output);
+      }
+
+      if (segmentSize == 0) {
+        writeFlat(root.asReader(), output);
+      } else if (packed) {
+        writePackedMessage(output, item);
+      } else {
+        writeMessage(output, item);
+      }
+    }
+
+    output.flush();
+    context.exit();
+    KJ_CLANG_KNOWS_THIS_IS_UNREACHABLE_BUT_GCC_DOESNT;
+  }
+
+  void encodeWithCompiler(kj::ArrayPtr<const char> allText, size_t start,
+                          kj::BufferedOutputStreamWrapper& output) {
+    // Encodes the input starting at byte `start` by lexing it and running it through the
+    // schema-language parser and value translator.  Exits when done.
+
+    auto text = allText.slice(start, allText.size());
+    EncoderErrorReporter errorReporter(*this, allText, start);
     MallocMessageBuilder arena;
 
     // Lex the input.
     auto lexedTokens = arena.initRoot<LexedTokens>();
-    lex(allText, lexedTokens, errorReporter);
+    lex(text, lexedTokens, errorReporter);
 
     // Set up the parser.
     CapnpParser parser(arena.getOrphanage(), errorReporter);
@@ -1007,10 +1233,6 @@ public:
     auto type = arena.getOrphanage().newOrphan<schema::Type>();
     type.get().initStruct().setTypeId(rootType.getProto().getId());
 
-    // Set up output stream.
-    kj::FdOutputStream rawOutput(STDOUT_FILENO);
-    kj::BufferedOutputStreamWrapper output(rawOutput);
-
     while (parserInput.getPosition() != tokens.end()) {
       KJ_IF_MAYBE(expression, parser.getParsers().parenthesizedValueExpression(parserInput)) {
         MallocMessageBuilder item(
@@ -1045,7 +1267,6 @@ public:
 
     output.flush();
     context.exit();
-    KJ_CLANG_KNOWS_THIS_IS_UNREACHABLE_BUT_GCC_DOESNT;
   }
 
   kj::MainBuilder::Validity evalConst(kj::StringPtr name) {
@@ -1215,12 +1436,13 @@ private:
   class EncoderErrorReporter final: public ErrorReporter {
   public:
     EncoderErrorReporter(GlobalErrorReporter& globalReporter,
-                         kj::ArrayPtr<const char> content)
-      : globalReporter(globalReporter), lineBreaks(content) {}
+                         kj::ArrayPtr<const char> content, uint32_t offset)
+      : globalReporter(globalReporter), lineBreaks(content), offset(offset) {}
+    // `offset` is added to all positions, for when only part of `content` was lexed.
 
     void addError(uint32_t startByte, uint32_t endByte, kj::StringPtr message) override {
-      globalReporter.addError("<stdin>", lineBreaks.toSourcePos(startByte),
-                              lineBreaks.toSourcePos(endByte), message);
+      globalReporter.addError("<stdin>", lineBreaks.toSourcePos(startByte + offset),
+                              lineBreaks.toSourcePos(endByte + offset), message);
     }
 
     bool hadErrors() override {
@@ -1230,6 +1452,7 @@ private:
   private:
     GlobalErrorReporter& globalReporter;
     LineBreakTable lineBreaks;
+    uint32_t offset;
   };
 
   class ValueResolverGlue final: public ValueTranslator::Resolver {
@@ -1269,6 +1492,613 @@ private:
     ErrorReporter& errorReporter;
   };
 
+public:
+  // =====================================================================================
+  // "convert" command
+
+  enum class Format {
+    BINARY,
+    PACKED,
+    FLAT,
+    TEXT,
+    JSON
+  };
+
+  static kj::Maybe<Format> parseFormat(kj::StringPtr name) {
+    if (name == "binary") return Format::BINARY;
+    if (name == "packed") return Format::PACKED;
+    if (name == "flat") return Format::FLAT;
+    if (name == "text") return Format::TEXT;
+    if (name == "json") return Format::JSON;
+    return nullptr;
+  }
+
+  kj::MainBuilder::Validity setConversion(kj::StringPtr conversion) {
+    KJ_IF_MAYBE(colon, conversion.findFirst(':')) {
+      KJ_IF_MAYBE(from, parseFormat(kj::heapString(conversion.slice(0, *colon)))) {
+        convertFrom = *from;
+      } else {
+        return "unknown input format";
+      }
+      KJ_IF_MAYBE(to, parseFormat(conversion.slice(*colon + 1))) {
+        convertTo = *to;
+      } else {
+        return "unknown output format";
+      }
+    } else {
+      return "expected <from>:<to>";
+    }
+
+    // writeFlat() chooses the binary framing from these.
+    flat = convertTo == Format::FLAT;
+    packed = convertTo == Format::PACKED;
+    return true;
+  }
+  kj::MainBuilder::Validity setMmap() {
+    useMmap = true;
+    return true;
+  }
+  kj::MainBuilder::Validity setPrintStats() {
+    printStats = true;
+    return true;
+  }
+
+  kj::MainBuilder::Validity convert() {
+    struct timespec startTime;
+    KJ_SYSCALL(clock_gettime(CLOCK_MONOTONIC, &startTime));
+
+    kj::Array<const byte> mapping = useMmap ? mmapStandardInput() : nullptr;
+    kj::FdInputStream fdInput(STDIN_FILENO);
+    CountingInputStream rawInput(fdInput);
+    kj::Array<byte> readBuffer;
+    kj::Own<kj::BufferedInputStream> input;
+    if (mapping == nullptr) {
+      readBuffer = kj::heapArray<byte>(CONVERT_READ_BUFFER_BYTES);
+      input = kj::heap<kj::BufferedInputStreamWrapper>(rawInput, readBuffer);
+    } else {
+      input = kj::heap<kj::ArrayInputStream>(mapping);
+    }
+
+    ConvertReader reader(convertFrom, *input);
+    uint64_t messageCount = 0;
+    uint64_t outputBytes = 0;
+
+    // Three stages overlap:  while the workers convert one batch, a reader thread splits the next
+    // batch out of the input and a writer thread writes the previous batch's output.  Each batch
+    // is written only after all of it is converted, so output order matches input order.
+    kj::Own<ConvertBatch> converting = reader.read();
+    kj::Own<ConvertBatch> writing;
+    while (converting.get() != nullptr) {
+      kj::Own<ConvertBatch> next;
+      {
+        kj::Own<kj::Thread> readerThread;
+        kj::Own<kj::Thread> writerThread;
+        if (!reader.atEnd()) {
+          readerThread = kj::heap<kj::Thread>([&]() { next = reader.read(); });
+        }
+        if (writing.get() != nullptr) {
+          writerThread = kj::heap<kj::Thread>([&]() {
+            outputBytes += writeBatch(*writing, writing->chunks.size());
+          });
+        }
+        convertBatch(*converting);
+        // Destroying the threads joins them.
+      }
+
+      messageCount += converting->messages.size();
+
+      for (size_t i = 0; i < converting->chunks.size(); i++) {
+        KJ_IF_MAYBE(error, converting->chunks[i].error) {
+          // Write everything before the bad message, then stop.
+          writeBatch(*converting, i + 1);
+          context.exitError(*error);
+        }
+      }
+      KJ_IF_MAYBE(error, converting->inputError) {
+        writeBatch(*converting, converting->chunks.size());
+        context.exitError(*error);
+      }
+
+      writing = kj::mv(converting);
+      converting = kj::mv(next);
+    }
+    if (writing.get() != nullptr) {
+      outputBytes += writeBatch(*writing, writing->chunks.size());
+    }
+
+    if (printStats) {
+      struct timespec endTime;
+      KJ_SYSCALL(clock_gettime(CLOCK_MONOTONIC, &endTime));
+      uint64_t nanos = (endTime.tv_sec - startTime.tv_sec) * 1000000000ull
+                     + endTime.tv_nsec - startTime.tv_nsec;
+      uint64_t inputBytes = mapping == nullptr ? rawInput.getCount() : mapping.size();
+      uint64_t tenthsOfMBps = nanos == 0 ? 0 : inputBytes * 10000 / nanos;
+      context.warning(kj::str(
+          "converted ", messageCount, " messages, ", inputBytes, " bytes in, ", outputBytes,
+          " bytes out, in ", nanos / 1000000, " ms (", tenthsOfMBps / 10, '.', tenthsOfMBps % 10,
+          " MB/s)"));
+    }
+
+    context.exit();
+    KJ_CLANG_KNOWS_THIS_IS_UNREACHABLE_BUT_GCC_DOESNT;
+  }
+
+private:
+  class CountingInputStream final: public kj::InputStream {
+    // Counts the bytes read from `inner`, for --stats.
+
+  public:
+    explicit CountingInputStream(kj::InputStream& inner): inner(inner) {}
+
+    uint64_t getCount() { return count; }
+
+    size_t tryRead(void* buffer, size_t minBytes, size_t maxBytes) override {
+      size_t n = inner.tryRead(buffer, minBytes, maxBytes);
+      count += n;
+      return n;
+    }
+
+  private:
+    kj::InputStream& inner;
+    uint64_t count = 0;
+  };
+
+  class GrowableOutputStream final: public kj::BufferedOutputStream {
+    // Collects output in a heap buffer which grows as needed, so that workers can encode messages
+    // before the writer is ready for them.
+
+  public:
+    kj::ArrayPtr<const byte> getArray() { return buffer.slice(0, fill); }
+    size_t size() { return fill; }
+    void truncate(size_t size) { fill = size; }
+
+    kj::ArrayPtr<byte> getWriteBuffer() override {
+      if (fill == buffer.size()) grow(1);
+      return buffer.slice(fill, buffer.size());
+    }
+
+    void write(const void* data, size_t size) override {
+      if (data != buffer.begin() + fill) {
+        if (buffer.size() - fill < size) grow(size);
+        memcpy(buffer.begin() + fill, data, size);
+      }
+      fill += size;
+    }
+
+  private:
+    kj::Array<byte> buffer;
+    size_t fill = 0;
+
+    void grow(size_t minimum) {
+      size_t newSize = kj::max(buffer.size() * 2, fill + minimum);
+      auto newBuffer = kj::heapArray<byte>(kj::max(newSize, size_t(4096)));
+      if (fill > 0) memcpy(newBuffer.begin(), buffer.begin(), fill);
+      buffer = kj::mv(newBuffer);
+    }
+  };
+
+  struct ConvertChunk {
+    GrowableOutputStream output;
+    // The converted messages.
+
+    kj::Maybe<kj::String> error;
+    // If set, the message after those in `output` could not be converted and the chunk stopped
+    // there.
+  };
+
+  struct ConvertBatch {
+    kj::Array<word> storage;
+    size_t size = 0;
+    // Input bytes.  Word-aligned, so that binary messages can be read in place.
+
+    struct Message {
+      size_t begin;
+      size_t end;
+    };
+    kj::Vector<Message> messages;
+    // Byte ranges of each message within `storage`.
+
+    uint64_t firstMessage = 0;
+    // Number of messages in earlier batches, for error reports.
+
+    kj::Maybe<kj::String> inputError;
+    // Set if the input could not be split after the last of `messages`.
+
+    kj::Array<ConvertChunk> chunks;
+    // Output, for each run of CONVERT_CHUNK_MESSAGES messages.
+
+    kj::ArrayPtr<const byte> getBytes(const Message& message) {
+      return kj::arrayPtr(reinterpret_cast<const byte*>(storage.begin()) + message.begin,
+                          message.end - message.begin);
+    }
+
+    byte* reserve(size_t bytes) {
+      // Makes room for `bytes` more bytes of input and returns where they go.
+
+      size_t words = (size + bytes + sizeof(word) - 1) / sizeof(word);
+      if (words > storage.size()) {
+        auto newStorage = kj::heapArray<word>(kj::max(words, storage.size() * 2));
+        if (size > 0) memcpy(newStorage.begin(), storage.begin(), size);
+        storage = kj::mv(newStorage);
+      }
+      return reinterpret_cast<byte*>(storage.begin()) + size;
+    }
+  };
+
+  class ConvertReader {
+    // Splits the input into batches of about CONVERT_BATCH_BYTES worth of whole messages.  This
+    // only finds message boundaries; it doesn't validate anything, except that packed input is
+    // unpacked here since there's no other way to find where its messages end.
+
+  public:
+    ConvertReader(Format format, kj::BufferedInputStream& input)
+        : format(format), input(input) {
+      if (format == Format::PACKED) {
+        packedInput = kj::heap<_::PackedInputStream>(input);
+      }
+    }
+
+    bool atEnd() { return eof; }
+
+    kj::Own<ConvertBatch> read() {
+      auto batch = kj::heap<ConvertBatch>();
+      batch->firstMessage = messageCount;
+      batch->storage = kj::heapArray<word>(CONVERT_BATCH_BYTES / sizeof(word));
+
+      KJ_IF_MAYBE(exception, kj::runCatchingExceptions([&]() {
+        switch (format) {
+          case Format::BINARY:
+            readFramed(*batch, input);
+            break;
+          case Format::PACKED:
+            readFramed(*batch, *packedInput);
+            break;
+          case Format::FLAT:
+            readFlat(*batch);
+            break;
+          case Format::TEXT:
+          case Format::JSON:
+            readDelimited(*batch);
+            break;
+        }
+      })) {
+        batch->inputError = kj::str(
+            "message ", messageCount + batch->messages.size() + 1, ": ",
+            exception->getDescription());
+        eof = true;
+      }
+
+      messageCount += batch->messages.size();
+      return kj::mv(batch);
+    }
+
+  private:
+    Format format;
+    kj::BufferedInputStream& input;
+    kj::Own<_::PackedInputStream> packedInput;
+
+    kj::Vector<byte> carry;
+    // For text and JSON: the start of a message which didn't fit in the last batch.
+
+    uint64_t messageCount = 0;
+    bool eof = false;
+
+    void readFramed(ConvertBatch& batch, kj::InputStream& in) {
+      // Reads messages in standard serialization format the same way InputStreamMessageReader
+      // does, which is also what PackedInputStream requires.
+
+      while (batch.size < CONVERT_BATCH_BYTES) {
+        if (input.tryGetReadBuffer().size() == 0) {
+          eof = true;
+          return;
+        }
+
+        _::WireValue<uint32_t> firstWord[2];
+        KJ_REQUIRE(in.tryRead(firstWord, sizeof(firstWord), sizeof(firstWord)) ==
+                       sizeof(firstWord), "Premature EOF.");
+
+        uint segmentCount = firstWord[0].get() + 1;
+        KJ_REQUIRE(segmentCount > 0 && segmentCount < 512, "Message has too many segments.");
+
+        _::WireValue<uint32_t> moreSizes[512];
+        size_t moreBytes = (segmentCount & ~1) * sizeof(moreSizes[0]);
+        if (moreBytes > 0) {
+          KJ_REQUIRE(in.tryRead(moreSizes, moreBytes, moreBytes) == moreBytes, "Premature EOF.");
+        }
+
+        uint64_t totalWords = firstWord[1].get();
+        for (uint i = 0; i < segmentCount - 1; i++) {
+          totalWords += moreSizes[i].get();
+        }
+
+        size_t tableBytes = sizeof(firstWord) + moreBytes;
+        size_t segmentBytes = totalWords * sizeof(word);
+        byte* pos = batch.reserve(tableBytes + segmentBytes);
+        memcpy(pos, firstWord, sizeof(firstWord));
+        memcpy(pos + sizeof(firstWord), moreSizes, moreBytes);
+        if (segmentBytes > 0) {
+          KJ_REQUIRE(in.tryRead(pos + tableBytes, segmentBytes, segmentBytes) == segmentBytes,
+                     "Premature EOF.");
+        }
+
+        size_t messageBytes = tableBytes + segmentBytes;
+        batch.messages.add(ConvertBatch::Message { batch.size, batch.size + messageBytes });
+        batch.size += messageBytes;
+      }
+    }
+
+    void readFlat(ConvertBatch& batch) {
+      // The whole input is one message.
+
+      appendAll(batch, kj::maxValue);
+      eof = true;
+
+      // Chop off any straggler bytes, as "decode --flat" does.
+      size_t end = batch.size / sizeof(word) * sizeof(word);
+      if (end > 0) {
+        batch.messages.add(ConvertBatch::Message { 0, end });
+      }
+    }
+
+    void readDelimited(ConvertBatch& batch) {
+      if (carry.size() > 0) {
+        memcpy(batch.reserve(carry.size()), carry.begin(), carry.size());
+        batch.size += carry.size();
+        carry.resize(0);
+      }
+
+      size_t scanned = 0;
+      for (;;) {
+        // Split off all the complete messages we have.
+        for (;;) {
+          auto text = kj::arrayPtr(reinterpret_cast<const char*>(batch.storage.begin()) + scanned,
+                                   batch.size - scanned);
+          size_t begin, end;
+          Scan scan = scanMessage(text, format == Format::TEXT, begin, end);
+          if (scan == Scan::COMPLETE) {
+            batch.messages.add(ConvertBatch::Message { scanned + begin, scanned + end });
+            scanned += end;
+          } else {
+            scanned += begin;
+            break;
+          }
+        }
+
+        if (eof || (batch.messages.size() > 0 && batch.size >= CONVERT_BATCH_BYTES)) break;
+
+        // If a message is incomplete, at least double what we have of it before scanning it
+        // again, so that a huge message doesn't take quadratic time.
+        appendAll(batch, kj::max(CONVERT_BATCH_BYTES, batch.size + (batch.size - scanned)));
+      }
+
+      if (eof) {
+        if (scanned < batch.size) {
+          // Whatever is left isn't a complete value.  Let the parser complain about it.
+          batch.messages.add(ConvertBatch::Message { scanned, batch.size });
+        }
+      } else {
+        carry.addAll(reinterpret_cast<const byte*>(batch.storage.begin()) + scanned,
+                     reinterpret_cast<const byte*>(batch.storage.begin()) + batch.size);
+        batch.size = scanned;
+      }
+    }
+
+    void appendAll(ConvertBatch& batch, size_t limit) {
+      // Appends input to `batch` until it holds at least `limit` bytes or the input runs out.
+
+      while (batch.size < limit) {
+        auto buffer = input.tryGetReadBuffer();
+        if (buffer.size() == 0) {
+          eof = true;
+          return;
+        }
+        memcpy(batch.reserve(buffer.size()), buffer.begin(), buffer.size());
+        batch.size += buffer.size();
+        input.skip(buffer.size());
+      }
+    }
+
+    enum class Scan {
+      INCOMPLETE,
+      COMPLETE
+    };
+
+    static Scan scanMessage(kj::ArrayPtr<const char> text, bool allowComments,
+                            size_t& begin, size_t& end) {
+      // Finds the extent of the first value in `text` -- a parenthesized struct literal or a JSON
+      // object -- by matching brackets outside of strings and comments.  `begin` is set to skip
+      // any leading whitespace and comments, even if the value is incomplete.
+
+      size_t i = 0;
+      for (;;) {
+        if (i == text.size()) {
+          begin = i;
+          return Scan::INCOMPLETE;
+        }
+        char c = text[i];
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+          ++i;
+        } else if (c == '#' && allowComments) {
+          // Only skip the comment once we've seen all of it, lest it continue with brackets.
+          size_t start = i;
+          while (i < text.size() && text[i] != '\n') ++i;
+          if (i == text.size()) {
+            begin = start;
+            return Scan::INCOMPLETE;
+          }
+        } else {
+          break;
+        }
+      }
+
+      begin = i;
+      uint depth = 0;
+      for (; i < text.size(); i++) {
+        switch (text[i]) {
+          case '(':
+          case '[':
+          case '{':
+            ++depth;
+            break;
+          case ')':
+          case ']':
+          case '}':
+            if (depth > 0 && --depth == 0) {
+              end = i + 1;
+              return Scan::COMPLETE;
+            }
+            break;
+          case '"':
+            for (++i; i < text.size() && text[i] != '"'; i++) {
+              if (text[i] == '\\') ++i;
+            }
+            break;
+          case '#':
+            if (allowComments) {
+              while (i < text.size() && text[i] != '\n') ++i;
+            }
+            break;
+        }
+      }
+      return Scan::INCOMPLETE;
+    }
+  };
+
+  static kj::Array<const byte> mmapStandardInput() {
+    // Maps standard input into memory if it is a non-empty regular file; returns null otherwise.
+
+    struct stat stats;
+    KJ_SYSCALL(fstat(STDIN_FILENO, &stats));
+    if (!S_ISREG(stats.st_mode) || stats.st_size == 0) {
+      return nullptr;
+    }
+
+    const void* mapping = mmap(NULL, stats.st_size, PROT_READ, MAP_SHARED, STDIN_FILENO, 0);
+    if (mapping == MAP_FAILED) {
+      KJ_FAIL_SYSCALL("mmap", errno);
+    }
+    return kj::Array<const byte>(
+        reinterpret_cast<const byte*>(mapping), stats.st_size, mmapDisposer);
+  }
+
+  void convertBatch(ConvertBatch& batch) {
+    // Converts the batch's messages on `jobs` threads, including this one.  Like parseAhead(),
+    // each thread repeatedly claims the next chunk, since message sizes vary.
+
+    batch.chunks = kj::heapArray<ConvertChunk>(
+        (batch.messages.size() + CONVERT_CHUNK_MESSAGES - 1) / CONVERT_CHUNK_MESSAGES);
+
+    uint next = 0;
+    auto work = [&]() {
+      for (;;) {
+        uint i = __atomic_fetch_add(&next, 1, __ATOMIC_RELAXED);
+        if (i >= batch.chunks.size()) break;
+        convertChunk(batch, i);
+      }
+    };
+
+    kj::Vector<kj::Own<kj::Thread>> threads(jobs);
+    for (uint i = 1; i < jobs && i < batch.chunks.size(); i++) {
+      threads.add(kj::heap<kj::Thread>(work));
+    }
+    work();
+    // Destroying `threads` joins them.
+  }
+
+  void convertChunk(ConvertBatch& batch, uint index) {
+    auto& chunk = batch.chunks[index];
+    size_t begin = index * CONVERT_CHUNK_MESSAGES;
+    size_t end = kj::min(begin + CONVERT_CHUNK_MESSAGES, batch.messages.size());
+
+    for (size_t i = begin; i < end; i++) {
+      size_t outputSize = chunk.output.size();
+
+      ParseErrorCatcher catcher;
+      kj::Maybe<kj::Exception> exception = kj::runCatchingExceptions([&]() {
+        convertMessage(batch.getBytes(batch.messages[i]), chunk.output);
+      });
+      if (exception == nullptr) {
+        exception = kj::mv(catcher.exception);
+      }
+
+      KJ_IF_MAYBE(e, exception) {
+        chunk.output.truncate(outputSize);
+        chunk.error = kj::str("message ", batch.firstMessage + i + 1, ": ", e->getDescription());
+        return;
+      }
+    }
+  }
+
+  void convertMessage(kj::ArrayPtr<const byte> input, kj::BufferedOutputStream& output) {
+    // Since this is a debug tool, lift the usual security limits.  Worse case is the process
+    // crashes or has to be killed.
+    ReaderOptions options;
+    options.nestingLimit = kj::maxValue;
+    options.traversalLimitInWords = kj::maxValue;
+
+    auto words = kj::arrayPtr(reinterpret_cast<const word*>(input.begin()),
+                              input.size() / sizeof(word));
+    auto chars = kj::arrayPtr(reinterpret_cast<const char*>(input.begin()), input.size());
+
+    switch (convertFrom) {
+      case Format::BINARY:
+      case Format::PACKED: {
+        // ConvertReader already unpacked packed input.
+        FlatArrayMessageReader reader(words, options);
+        writeConverted(reader.getRoot<DynamicStruct>(rootType), output);
+        break;
+      }
+      case Format::FLAT: {
+        SegmentArrayMessageReader reader(kj::arrayPtr(&words, 1), options);
+        writeConverted(reader.getRoot<DynamicStruct>(rootType), output);
+        break;
+      }
+      case Format::TEXT: {
+        MallocMessageBuilder message;
+        writeConverted(readText(chars, message, rootType).asReader(), output);
+        break;
+      }
+      case Format::JSON: {
+        MallocMessageBuilder message;
+        writeConverted(readJson(chars, message, rootType).asReader(), output);
+        break;
+      }
+    }
+  }
+
+  void writeConverted(DynamicStruct::Reader root, kj::BufferedOutputStream& output) {
+    switch (convertTo) {
+      case Format::BINARY:
+      case Format::PACKED:
+      case Format::FLAT:
+        writeFlat(root, output);
+        break;
+      case Format::TEXT:
+        writeText(output, root, pretty);
+        output.write("\n", 1);
+        break;
+      case Format::JSON:
+        writeJson(output, root);
+        output.write("\n", 1);
+        break;
+    }
+  }
+
+  static uint64_t writeBatch(ConvertBatch& batch, size_t chunkCount) {
+    // Writes the output of the first `chunkCount` chunks to stdout.  Returns the byte count.
+
+    kj::FdOutputStream output(STDOUT_FILENO);
+    uint64_t total = 0;
+    for (auto& chunk: batch.chunks.slice(0, chunkCount)) {
+      auto bytes = chunk.output.getArray();
+      if (bytes.size() > 0) {
+        output.write(bytes.begin(), bytes.size());
+        total += bytes.size();
+      }
+    }
+    return total;
+  }
+
 public:
   // =====================================================================================
 
@@ -1314,6 +2144,11 @@ private:
   kj::Vector<kj::String> sourcePrefixes;
   bool addStandardImportPaths = true;
 
+  bool batchCompile = false;
+  uint jobs = 1;
+  kj::Own<Profiler> profiler;
+  // For the "compile" command.
+
   bool binary = false;
   bool flat = false;
   bool packed = false;
@@ -1323,6 +2158,12 @@ private:
   StructSchema rootType;
   // For the "decode" and "encode" commands.
 
+  Format convertFrom = Format::BINARY;
+  Format convertTo = Format::TEXT;
+  bool useMmap = false;
+  bool printStats = false;
+  // For the "convert" command.
+
   struct SourceFile {
     uint64_t id;
     kj::StringPtr name;
@@ -37,6 +37,7 @@
 #include <set>
 #include <kj/main.h>
 #include <algorithm>
+#include <cmath>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -54,6 +55,8 @@ namespace capnp {
 namespace {
 
 static constexpr uint64_t NAMESPACE_ANNOTATION_ID = 0xb9c6f99ebf805f2cull;
+static constexpr uint64_t PLAIN_ANNOTATION_ID = 0xc8e61dc22850ec3dull;
+static constexpr uint64_t FIELD_INFO_ANNOTATION_ID = 0xecad350bbc4e3cc8ull;
 
 static constexpr const char* FIELD_SIZE_NAMES[] = {
   "VOID", "BIT", "BYTE", "TWO_BYTES", "FOUR_BYTES", "EIGHT_BYTES", "POINTER", "INLINE_COMPOSITE"
@@ -131,6 +134,11 @@ kj::Array<uint> makeMembersByName(MemberList&& members) {
   return KJ_MAP(member, sorted) { return member.getIndex(); };
 }
 
+template <typename MemberList>
+kj::Array<kj::StringPtr> makeMemberNames(MemberList&& members) {
+  return KJ_MAP(member, members) -> kj::StringPtr { return member.getProto().getName(); };
+}
+
 kj::StringPtr baseName(kj::StringPtr path) {
   KJ_IF_MAYBE(slashPos, path.findLast('/')) {
     return path.slice(*slashPos + 1);
@@ -239,8 +247,7 @@ private:
         return kj::strTree(" ::capnp::List<", typeName(type.getList().getElementType()), ">");
 
       case schema::Type::ANY_POINTER:
-        // Not used.
-        return kj::strTree();
+        return kj::strTree(" ::capnp::AnyPointer");
     }
     KJ_UNREACHABLE;
   }
@@ -372,6 +379,55 @@ private:
     KJ_UNREACHABLE;
   }
 
+  static kj::String makeDefaultMask(schema::Value::Reader defaultValue) {
+    // Returns the literal which a data field's stored bits are XORed with to produce its value, or
+    // an empty string if the default is zero (so no mask is needed).
+
+    switch (defaultValue.which()) {
+#define HANDLE_PRIMITIVE(discrim, defaultName, suffix) \
+      case schema::Value::discrim: \
+        if (defaultValue.get##defaultName() != 0) { \
+          return kj::str(defaultValue.get##defaultName(), #suffix); \
+        } \
+        return nullptr;
+
+      HANDLE_PRIMITIVE(BOOL, Bool, );
+      HANDLE_PRIMITIVE(INT8 , Int8 , );
+      HANDLE_PRIMITIVE(INT16, Int16, );
+      HANDLE_PRIMITIVE(INT32, Int32, );
+      HANDLE_PRIMITIVE(INT64, Int64, ll);
+      HANDLE_PRIMITIVE(UINT8 , Uint8 , u);
+      HANDLE_PRIMITIVE(UINT16, Uint16, u);
+      HANDLE_PRIMITIVE(UINT32, Uint32, u);
+      HANDLE_PRIMITIVE(UINT64, Uint64, ull);
+      HANDLE_PRIMITIVE(ENUM, Enum, u);
+#undef HANDLE_PRIMITIVE
+
+      case schema::Value::FLOAT32:
+        if (defaultValue.getFloat32() != 0) {
+          uint32_t mask;
+          float value = defaultValue.getFloat32();
+          static_assert(sizeof(mask) == sizeof(value), "bug");
+          memcpy(&mask, &value, sizeof(mask));
+          return kj::str(mask, "u");
+        }
+        return nullptr;
+
+      case schema::Value::FLOAT64:
+        if (defaultValue.getFloat64() != 0) {
+          uint64_t mask;
+          double value = defaultValue.getFloat64();
+          static_assert(sizeof(mask) == sizeof(value), "bug");
+          memcpy(&mask, &value, sizeof(mask));
+          return kj::str(mask, "ull");
+        }
+        return nullptr;
+
+      default:
+        return nullptr;
+    }
+  }
+
   struct Slot {
     schema::Type::Which whichType;
     uint offset;
@@ -631,45 +687,20 @@ private:
         setterDefault = " = ::capnp::VOID";
         break;
 
-#define HANDLE_PRIMITIVE(discrim, typeName, defaultName, suffix) \
-      case schema::Type::discrim: \
-        kind = FieldKind::PRIMITIVE; \
-        if (defaultBody.get##defaultName() != 0) { \
-          defaultMask = kj::str(defaultBody.get##defaultName(), #suffix); \
-        } \
-        break;
-
-      HANDLE_PRIMITIVE(BOOL, bool, Bool, );
-      HANDLE_PRIMITIVE(INT8 , ::int8_t , Int8 , );
-      HANDLE_PRIMITIVE(INT16, ::int16_t, Int16, );
-      HANDLE_PRIMITIVE(INT32, ::int32_t, Int32, );
-      HANDLE_PRIMITIVE(INT64, ::int64_t, Int64, ll);
-      HANDLE_PRIMITIVE(UINT8 , ::uint8_t , Uint8 , u);
-      HANDLE_PRIMITIVE(UINT16, ::uint16_t, Uint16, u);
-      HANDLE_PRIMITIVE(UINT32, ::uint32_t, Uint32, u);
-      HANDLE_PRIMITIVE(UINT64, ::uint64_t, Uint64, ull);
-#undef HANDLE_PRIMITIVE
-
+      case schema::Type::BOOL:
+      case schema::Type::INT8:
+      case schema::Type::INT16:
+      case schema::Type::INT32:
+      case schema::Type::INT64:
+      case schema::Type::UINT8:
+      case schema::Type::UINT16:
+      case schema::Type::UINT32:
+      case schema::Type::UINT64:
       case schema::Type::FLOAT32:
-        kind = FieldKind::PRIMITIVE;
-        if (defaultBody.getFloat32() != 0) {
-          uint32_t mask;
-          float value = defaultBody.getFloat32();
-          static_assert(sizeof(mask) == sizeof(value), "bug");
-          memcpy(&mask, &value, sizeof(mask));
-          defaultMask = kj::str(mask, "u");
-        }
-        break;
-
       case schema::Type::FLOAT64:
+      case schema::Type::ENUM:
         kind = FieldKind::PRIMITIVE;
-        if (defaultBody.getFloat64() != 0) {
-          uint64_t mask;
-          double value = defaultBody.getFloat64();
-          static_assert(sizeof(mask) == sizeof(value), "bug");
-          memcpy(&mask, &value, sizeof(mask));
-          defaultMask = kj::str(mask, "ull");
-        }
+        defaultMask = makeDefaultMask(defaultBody);
         break;
 
       case schema::Type::TEXT:
@@ -687,13 +718,6 @@ private:
         }
         break;
 
-      case schema::Type::ENUM:
-        kind = FieldKind::PRIMITIVE;
-        if (defaultBody.getEnum() != 0) {
-          defaultMask = kj::str(defaultBody.getEnum(), "u");
-        }
-        break;
-
       case schema::Type::STRUCT:
         kind = FieldKind::STRUCT;
         if (defaultBody.hasStruct()) {
@@ -1029,6 +1053,409 @@ private:
     }
   }
 
+  // -----------------------------------------------------------------
+  // Plain mirrors (see the `plain` annotation in c++.capnp).
+
+  bool inAnnotatedScope(Schema schema, uint64_t annotationId) {
+    // Whether the node, or any scope enclosing it, carries the given annotation.
+
+    for (;;) {
+      auto proto = schema.getProto();
+      for (auto annotation: proto.getAnnotations()) {
+        if (annotation.getId() == annotationId) {
+          return true;
+        }
+      }
+      if (proto.getScopeId() == 0) {
+        return false;
+      }
+      schema = schemaLoader.get(proto.getScopeId());
+    }
+  }
+
+  bool hasPlain(Schema schema) {
+    // A struct gets a Plain mirror if it, or any scope enclosing it, is annotated with `plain`.
+    return inAnnotatedScope(schema, PLAIN_ANNOTATION_ID);
+  }
+
+  kj::Maybe<kj::String> plainType(StructSchema::Field field, schema::Type::Reader type,
+                                  bool isElement) {
+    // The type of the Plain member mirroring `field` (or an element of it) of the given type, or
+    // null if the field has no mirror.  Nested structs are held by Own so that a struct can contain
+    // itself; list elements are held by value.  A struct type without a Plain of its own is an
+    // error, since dropping the field would make setFrom() silently lose data.
+
+    switch (type.which()) {
+      case schema::Type::VOID:
+        if (isElement) {
+          return kj::str(" ::capnp::Void");
+        } else {
+          return nullptr;
+        }
+
+      case schema::Type::BOOL:
+      case schema::Type::INT8:
+      case schema::Type::INT16:
+      case schema::Type::INT32:
+      case schema::Type::INT64:
+      case schema::Type::UINT8:
+      case schema::Type::UINT16:
+      case schema::Type::UINT32:
+      case schema::Type::UINT64:
+      case schema::Type::FLOAT32:
+      case schema::Type::FLOAT64:
+      case schema::Type::ENUM:
+        return typeName(type).flatten();
+
+      case schema::Type::TEXT:
+        return kj::str(" ::kj::String");
+      case schema::Type::DATA:
+        return kj::str(" ::kj::Array< ::kj::byte>");
+
+      case schema::Type::STRUCT: {
+        Schema schema = schemaLoader.get(type.getStruct().getTypeId());
+        if (!hasPlain(schema)) {
+          context.exitError(kj::str(
+              field.getContainingStruct().getProto().getDisplayName(), ".",
+              field.getProto().getName(), ": field type ", schema.getProto().getDisplayName(),
+              " has no Plain mirror; annotate it with $Cxx.plain as well."));
+        } else if (isElement) {
+          return kj::str(cppFullName(schema), "::Plain");
+        } else {
+          return kj::str(" ::kj::Own<", cppFullName(schema), "::Plain>");
+        }
+      }
+
+      case schema::Type::LIST:
+        KJ_IF_MAYBE(element, plainType(field, type.getList().getElementType(), true)) {
+          return kj::str(" ::kj::Array<", *element, ">");
+        } else {
+          return nullptr;
+        }
+
+      case schema::Type::INTERFACE:
+      case schema::Type::ANY_POINTER:
+        return nullptr;
+    }
+    KJ_UNREACHABLE;
+  }
+
+  kj::StringTree plainDefault(schema::Type::Reader type, schema::Value::Reader value) {
+    // Initializer for a Plain data member, so that a default-constructed Plain matches an empty
+    // struct.
+
+    double floatValue;
+    switch (value.which()) {
+      case schema::Value::FLOAT32: floatValue = value.getFloat32(); break;
+      case schema::Value::FLOAT64: floatValue = value.getFloat64(); break;
+      default:
+        return literalValue(type, value);
+    }
+
+    if (std::isnan(floatValue)) {
+      return kj::strTree(" ::kj::nan()");
+    } else if (std::isinf(floatValue)) {
+      return kj::strTree(floatValue < 0 ? "-::kj::inf()" : " ::kj::inf()");
+    } else if (value.isFloat32()) {
+      return kj::strTree(value.getFloat32());
+    } else {
+      return kj::strTree(value.getFloat64());
+    }
+  }
+
+  kj::String cppStringLiteral(kj::ArrayPtr<const char> bytes) {
+    // A C++ string literal holding exactly `bytes`.  Octal escapes are used for anything that is
+    // not printable ASCII because, unlike hex escapes, they cannot swallow a following digit.
+
+    kj::Vector<char> result(bytes.size() + 3);
+    result.add('"');
+    for (char c: bytes) {
+      if (c == '"' || c == '\\' || c == '?') {
+        result.add('\\');
+        result.add(c);
+      } else if (c >= 0x20 && c < 0x7f) {
+        result.add(c);
+      } else {
+        uint8_t b = c;
+        result.add('\\');
+        result.add('0' + (b >> 6));
+        result.add('0' + ((b >> 3) & 7));
+        result.add('0' + (b & 7));
+      }
+    }
+    result.add('"');
+    result.add('\0');
+    return kj::String(result.releaseAsArray());
+  }
+
+  kj::StringTree plainBlobDefault(schema::Value::Reader value) {
+    // Initializer for the Plain member mirroring a Text or Data field whose schema default is
+    // `value`, or an empty tree if the default is empty.
+
+    if (value.isText() && value.hasText()) {
+      auto text = value.getText();
+      return kj::strTree(" = ::kj::heapString(", cppStringLiteral(text), ", ", text.size(), ")");
+    } else if (value.isData() && value.hasData()) {
+      auto bytes = value.getData();
+      auto data = kj::arrayPtr(reinterpret_cast<const char*>(bytes.begin()), bytes.size());
+      return kj::strTree(
+          " = ::kj::heapArray(reinterpret_cast<const ::kj::byte*>(", cppStringLiteral(data), "), ",
+          data.size(), ")");
+    } else {
+      return kj::strTree();
+    }
+  }
+
+  kj::StringTree plainFromReader(kj::StringPtr expr, schema::Type::Reader type, uint depth) {
+    // Expression converting `expr`, a value of the given type read from a message, to its Plain
+    // mirror as a list element.
+
+    switch (type.which()) {
+      case schema::Type::TEXT:
+        return kj::strTree(" ::kj::heapString(", expr, ")");
+      case schema::Type::DATA:
+        return kj::strTree(" ::kj::heapArray< ::kj::byte>(", expr, ")");
+      case schema::Type::STRUCT:
+        return kj::strTree(expr, ".toPlain()");
+      case schema::Type::LIST: {
+        auto element = kj::str("_e", depth);
+        return kj::strTree(
+            "KJ_MAP(", element, ", ", expr, ") { return ",
+            plainFromReader(element, type.getList().getElementType(), depth + 1), "; }");
+      }
+      default:
+        return kj::strTree(expr);
+    }
+  }
+
+  kj::StringTree plainListSetter(kj::StringPtr indent, kj::StringPtr list, kj::StringPtr array,
+                                 schema::Type::Reader elementType, uint depth) {
+    // Statements copying the Plain array `array` into `list`, which has already been initialized
+    // to the right size.
+
+    auto i = kj::str("_i", depth);
+    auto element = kj::str(array, "[", i, "]");
+    kj::StringTree body;
+    switch (elementType.which()) {
+      case schema::Type::VOID:
+        return kj::strTree();
+      case schema::Type::STRUCT:
+        body = kj::strTree(indent, "  ", list, "[", i, "].setFrom(", element, ");\n");
+        break;
+      case schema::Type::LIST: {
+        auto subList = kj::str("_list", depth + 1);
+        body = kj::strTree(
+            indent, "  auto ", subList, " = ", list, ".init(", i, ", ", element, ".size());\n",
+            plainListSetter(kj::str(indent, "  "), subList, element,
+                            elementType.getList().getElementType(), depth + 1));
+        break;
+      }
+      default:
+        body = kj::strTree(indent, "  ", list, ".set(", i, ", ", element, ");\n");
+        break;
+    }
+
+    return kj::strTree(
+        indent, "for (unsigned int ", i, " = 0; ", i, " < ", array, ".size(); ", i, "++) {\n",
+        kj::mv(body),
+        indent, "}\n");
+  }
+
+  struct PlainText {
+    kj::StringTree def;
+    kj::StringTree readerDecl;
+    kj::StringTree builderDecl;
+    kj::StringTree inlineDefs;
+  };
+
+  PlainText makePlainText(kj::StringPtr fullName, StructSchema schema) {
+    // setFrom() writes the data section in a single pass in offset order, then the pointers, then
+    // any groups (which share the parent's sections but are filled in by their own setFrom()).
+
+    enum Pass { DATA_PASS, POINTER_PASS, GROUP_PASS, NO_PASS };
+
+    struct Write {
+      Pass pass;
+      uint offset;  // bits for data, pointers for pointers
+      kj::StringTree code;
+
+      inline bool operator<(const Write& other) const {
+        return pass < other.pass || (pass == other.pass && offset < other.offset);
+      }
+    };
+
+    auto structNode = schema.getProto().getStruct();
+    bool isUnion = structNode.getDiscriminantCount() != 0;
+
+    kj::Vector<kj::StringTree> members(schema.getFields().size() + 1);
+    kj::Vector<kj::StringTree> reads(schema.getFields().size());
+    kj::Vector<kj::StringTree> unionReads(schema.getFields().size());
+    kj::Vector<Write> writes(schema.getFields().size() + 1);
+    uint groupCount = 0;
+
+    if (isUnion) {
+      members.add(kj::strTree("  Which which = static_cast<Which>(0);\n"));
+      writes.add(Write { DATA_PASS, structNode.getDiscriminantOffset() * 16, kj::strTree(
+          "  _builder.setDataField<", fullName, "::Which>(\n"
+          "      ", structNode.getDiscriminantOffset(), " * ::capnp::ELEMENTS, plain.which);\n") });
+    }
+
+    for (auto field: schema.getFields()) {
+      auto proto = field.getProto();
+      kj::StringPtr name = proto.getName();
+      kj::String titleCase = toTitleCase(name);
+      bool inUnion = hasDiscriminantValue(proto);
+      kj::StringPtr indent = inUnion ? "  " : "";
+
+      Pass pass = NO_PASS;
+      uint writeOffset = 0;
+      kj::StringTree read;
+      kj::StringTree write;
+
+      switch (proto.which()) {
+        case schema::Field::GROUP:
+          members.add(kj::strTree("  ", fullName, "::", titleCase, "::Plain ", name, ";\n"));
+          read = kj::strTree(
+              indent, "  result.", name, " = get", titleCase, "().toPlain();\n");
+          write = kj::strTree(
+              indent, "  ", inUnion ? "init" : "get", titleCase, "().setFrom(plain.", name, ");\n");
+          pass = GROUP_PASS;
+          writeOffset = groupCount++;
+          break;
+
+        case schema::Field::SLOT: {
+          auto slot = proto.getSlot();
+          auto type = slot.getType();
+          uint offset = slot.getOffset();
+
+          KJ_IF_MAYBE(memberType, plainType(field, type, false)) {
+            if (sectionFor(type.which()) == Section::DATA) {
+              members.add(kj::strTree(
+                  "  ", *memberType, " ", name, " = ",
+                  plainDefault(type, slot.getDefaultValue()), ";\n"));
+              read = kj::strTree(indent, "  result.", name, " = get", titleCase, "();\n");
+              write = kj::strTree(indent, "  set", titleCase, "(plain.", name, ");\n");
+              pass = DATA_PASS;
+              writeOffset = offset * typeSizeBits(type.which());
+            } else {
+              members.add(kj::strTree(
+                  "  ", *memberType, " ", name, plainBlobDefault(slot.getDefaultValue()), ";\n"));
+              bool isStruct = type.isStruct();
+              kj::String plainField = kj::str("plain.", name);
+
+              // If the field has a default, toPlain() must read it even when the pointer is null,
+              // and setFrom() must not turn an empty value into null (which would read back as the
+              // default).
+              auto defaultValue = slot.getDefaultValue();
+              bool hasDefault = defaultValue.hasText() || defaultValue.hasData() ||
+                                defaultValue.hasList() || defaultValue.hasStruct();
+
+              kj::StringTree set;
+              if (isStruct) {
+                set = kj::strTree(
+                    indent, "    init", titleCase, "().setFrom(*", plainField, ");\n");
+              } else if (type.isList() &&
+                         sectionFor(type.getList().getElementType().which()) != Section::POINTERS) {
+                // Lists of primitives can be copied in bulk.
+                set = kj::strTree(indent, "    set", titleCase, "(", plainField, ");\n");
+              } else if (type.isList()) {
+                auto innerIndent = kj::str(indent, "    ");
+                set = kj::strTree(
+                    innerIndent, "auto _list0 = init", titleCase, "(", plainField, ".size());\n",
+                    plainListSetter(innerIndent, "_list0", plainField,
+                                    type.getList().getElementType(), 0));
+              } else {
+                set = kj::strTree(indent, "    set", titleCase, "(", plainField, ");\n");
+              }
+
+              auto convert = isStruct
+                  ? kj::strTree(" ::kj::heap(get", titleCase, "().toPlain())")
+                  : plainFromReader(kj::str("get", titleCase, "()"), type, 0);
+              if (hasDefault) {
+                read = kj::strTree(indent, "  result.", name, " = ", kj::mv(convert), ";\n");
+              } else {
+                read = kj::strTree(
+                    indent, "  if (has", titleCase, "()) {\n",
+                    indent, "    result.", name, " = ", kj::mv(convert), ";\n",
+                    indent, "  }\n");
+              }
+
+              if (hasDefault && !isStruct) {
+                write = kj::strTree(
+                    indent, "  {\n",
+                    kj::mv(set),
+                    indent, "  }\n");
+              } else {
+                write = kj::strTree(
+                    indent, "  if (", plainField, isStruct ? ".get() == nullptr" : ".size() == 0",
+                        ") {\n",
+                    indent, "    _builder.getPointerField(", offset,
+                        " * ::capnp::POINTERS).clear();\n",
+                    indent, "  } else {\n",
+                    kj::mv(set),
+                    indent, "  }\n");
+              }
+              pass = POINTER_PASS;
+              writeOffset = offset;
+            }
+          }
+          break;
+        }
+      }
+
+      if (inUnion) {
+        kj::String upperCase = toUpperCase(name);
+        unionReads.add(kj::strTree(
+            "    case ", fullName, "::", upperCase, ":\n",
+            kj::mv(read),
+            "      break;\n"));
+        if (pass != NO_PASS) {
+          writes.add(Write { pass, writeOffset, kj::strTree(
+              "  if (plain.which == ", fullName, "::", upperCase, ") {\n",
+              kj::mv(write),
+              "  }\n") });
+        }
+      } else if (pass != NO_PASS) {
+        reads.add(kj::mv(read));
+        writes.add(Write { pass, writeOffset, kj::mv(write) });
+      }
+    }
+
+    std::stable_sort(writes.begin(), writes.end());
+
+    return PlainText {
+      kj::strTree(
+          "struct ", fullName, "::Plain {\n"
+          "  // Plain C++ mirror of ", fullName, ", for use with Reader::toPlain() and\n"
+          "  // Builder::setFrom().\n"
+          "\n",
+          members.releaseAsArray(),
+          "};\n"
+          "\n"),
+
+      kj::strTree("  inline Plain toPlain() const;\n\n"),
+      kj::strTree("  inline void setFrom(const Plain& plain);\n\n"),
+
+      kj::strTree(
+          "inline ", fullName, "::Plain ", fullName, "::Reader::toPlain() const {\n"
+          "  ", fullName, "::Plain result;\n",
+          reads.releaseAsArray(),
+          isUnion ? kj::strTree(
+              "  result.which = which();\n"
+              "  switch (result.which) {\n",
+              unionReads.releaseAsArray(),
+              "    default:\n"
+              "      break;\n"
+              "  }\n") : kj::strTree(),
+          "  return result;\n"
+          "}\n"
+          "inline void ", fullName, "::Builder::setFrom(const ", fullName, "::Plain& plain) {\n",
+          KJ_MAP(write, writes) { return kj::mv(write.code); },
+          "}\n"
+          "\n")
+    };
+  }
+
   // -----------------------------------------------------------------
 
   struct StructText {
@@ -1036,6 +1463,7 @@ private:
     kj::StringTree outerTypeDef;
     kj::StringTree readerBuilderDefs;
     kj::StringTree inlineMethodDefs;
+    kj::StringTree plainDefs;
   };
 
   kj::StringTree makeReaderDef(kj::StringPtr fullName, kj::StringPtr unqualifiedParentType,
@@ -1135,6 +1563,21 @@ private:
     auto structNode = proto.getStruct();
     uint discrimOffset = structNode.getDiscriminantOffset();
 
+    PlainText plainText;
+    bool plain = hasPlain(schema);
+    if (plain) {
+      plainText = makePlainText(fullName, schema);
+    }
+
+    auto readerDecls = kj::heapArrayBuilder<kj::StringTree>(fieldTexts.size() + 1);
+    auto builderDecls = kj::heapArrayBuilder<kj::StringTree>(fieldTexts.size() + 1);
+    for (auto& f: fieldTexts) {
+      readerDecls.add(kj::mv(f.readerMethodDecls));
+      builderDecls.add(kj::mv(f.builderMethodDecls));
+    }
+    readerDecls.add(kj::mv(plainText.readerDecl));
+    builderDecls.add(kj::mv(plainText.builderDecl));
+
     return StructText {
       kj::strTree(
           "  struct ", name, ";\n"),
@@ -1146,6 +1589,7 @@ private:
           "  class Reader;\n"
           "  class Builder;\n"
           "  class Pipeline;\n",
+          plain ? kj::strTree("  struct Plain;\n") : kj::strTree(),
           structNode.getDiscriminantCount() == 0 ? kj::strTree() : kj::strTree(
               "  enum Which: uint16_t {\n",
               KJ_MAP(f, structNode.getFields()) {
@@ -1162,9 +1606,9 @@ private:
 
       kj::strTree(
           makeReaderDef(fullName, name, structNode.getDiscriminantCount() != 0,
-                        KJ_MAP(f, fieldTexts) { return kj::mv(f.readerMethodDecls); }),
+                        readerDecls.finish()),
           makeBuilderDef(fullName, name, structNode.getDiscriminantCount() != 0,
-                         KJ_MAP(f, fieldTexts) { return kj::mv(f.builderMethodDecls); }),
+                         builderDecls.finish()),
           makePipelineDef(fullName, name, structNode.getDiscriminantCount() != 0,
                           KJ_MAP(f, fieldTexts) { return kj::mv(f.pipelineMethodDecls); })),
 
@@ -1177,7 +1621,10 @@ private:
               "  return _builder.getDataField<Which>(", discrimOffset, " * ::capnp::ELEMENTS);\n"
               "}\n"
               "\n"),
-          KJ_MAP(f, fieldTexts) { return kj::mv(f.inlineMethodDefs); })
+          KJ_MAP(f, fieldTexts) { return kj::mv(f.inlineMethodDefs); },
+          kj::mv(plainText.inlineDefs)),
+
+      kj::mv(plainText.def)
     };
   }
 
@@ -1498,6 +1945,10 @@ private:
     kj::StringTree capnpPrivateDecls;
     kj::StringTree capnpPrivateDefs;
     kj::StringTree sourceFileDefs;
+    kj::StringTree plainDefs;
+    kj::StringTree fieldInfoDecls;
+    // Goes after all other capnpPrivateDecls in the file, since naming a field's type (e.g. as
+    // List<T>) requires T's Kind_ to have been declared already.
   };
 
   struct NodeTextNoSchema {
@@ -1508,6 +1959,8 @@ private:
     kj::StringTree capnpPrivateDecls;
     kj::StringTree capnpPrivateDefs;
     kj::StringTree sourceFileDefs;
+    kj::StringTree plainDefs;
+    kj::StringTree fieldInfoDecls;
   };
 
   NodeText makeNodeText(kj::StringPtr namespace_, kj::StringPtr scope,
@@ -1571,11 +2024,13 @@ private:
     enumerateDeps(proto, deps);
 
     kj::Array<uint> membersByName;
+    kj::Array<kj::StringPtr> memberNames;
     kj::Array<uint> membersByDiscrim;
     switch (proto.which()) {
       case schema::Node::STRUCT: {
         auto structSchema = schema.asStruct();
         membersByName = makeMembersByName(structSchema.getFields());
+        memberNames = makeMemberNames(structSchema.getFields());
         auto builder = kj::heapArrayBuilder<uint>(structSchema.getFields().size());
         for (auto field: structSchema.getUnionFields()) {
           builder.add(field.getIndex());
@@ -1588,14 +2043,42 @@ private:
       }
       case schema::Node::ENUM:
         membersByName = makeMembersByName(schema.asEnum().getEnumerants());
+        memberNames = makeMemberNames(schema.asEnum().getEnumerants());
         break;
       case schema::Node::INTERFACE:
         membersByName = makeMembersByName(schema.asInterface().getMethods());
+        memberNames = makeMemberNames(schema.asInterface().getMethods());
         break;
       default:
         break;
     }
 
+    uint32_t memberHashSeed = 0;
+    kj::Array<uint32_t> memberHashDisplacements;
+    kj::Array<uint16_t> membersByHash;
+    if (memberNames.size() > 0) {
+      auto displacements =
+          kj::heapArray<uint32_t>(_::memberHashBucketCount(memberNames.size()));
+      auto byHash = kj::heapArray<uint16_t>(memberNames.size());
+      if (_::makeMemberHash(memberNames, memberHashSeed, displacements, byHash)) {
+        memberHashDisplacements = kj::mv(displacements);
+        membersByHash = kj::mv(byHash);
+      }
+    }
+
+    kj::StringTree structLayout;
+    if (proto.isStruct()) {
+      auto structProto = proto.getStruct();
+      structLayout = kj::strTree(
+          "{ ", structProto.getDataWordCount(), ", ", structProto.getPointerCount(), ", ",
+          static_cast<uint>(structProto.getPreferredListEncoding()), ", ",
+          structProto.getIsGroup() ? "true" : "false", ", ",
+          structProto.getDiscriminantCount(), ", ", structProto.getDiscriminantOffset(),
+          ", true }");
+    } else {
+      structLayout = kj::strTree("{ 0, 0, 0, false, 0, 0, false }");
+    }
+
     auto schemaDef = kj::strTree(
         "static const ::capnp::_::AlignedData<", rawSchema.size(), "> b_", hexId, " = {\n"
         "  {", kj::mv(schemaLiteral), " }\n"
@@ -1614,13 +2097,26 @@ private:
             "static const uint16_t i_", hexId, "[] = {",
             kj::StringTree(KJ_MAP(index, membersByDiscrim) { return kj::strTree(index); }, ", "),
             "};\n"),
+        membersByHash.size() == 0 ? kj::strTree() : kj::strTree(
+            "static const uint32_t p_", hexId, "[] = {",
+            kj::StringTree(KJ_MAP(displacement, memberHashDisplacements) {
+              return kj::strTree(displacement);
+            }, ", "),
+            "};\n"
+            "static const uint16_t h_", hexId, "[] = {",
+            kj::StringTree(KJ_MAP(index, membersByHash) { return kj::strTree(index); }, ", "),
+            "};\n"),
         "const ::capnp::_::RawSchema s_", hexId, " = {\n"
         "  0x", hexId, ", b_", hexId, ".words, ", rawSchema.size(), ", ",
         deps.size() == 0 ? kj::strTree("nullptr") : kj::strTree("d_", hexId), ", ",
         membersByName.size() == 0 ? kj::strTree("nullptr") : kj::strTree("m_", hexId), ",\n",
         "  ", deps.size(), ", ", membersByName.size(), ", ",
         membersByDiscrim.size() == 0 ? kj::strTree("nullptr") : kj::strTree("i_", hexId),
-        ", nullptr, nullptr\n"
+        ", nullptr, nullptr,\n"
+        "  ", kj::mv(structLayout), ",\n"
+        "  ", memberHashSeed, ", ",
+        membersByHash.size() == 0 ? kj::strTree("nullptr") : kj::strTree("p_", hexId), ", ",
+        membersByHash.size() == 0 ? kj::strTree("nullptr") : kj::strTree("h_", hexId), "\n"
         "};\n");
 
     NodeTextNoSchema top = makeNodeTextWithoutNested(
@@ -1661,9 +2157,137 @@ private:
       kj::strTree(
           kj::mv(top.sourceFileDefs),
           KJ_MAP(n, nestedTexts) { return kj::mv(n.sourceFileDefs); }),
+
+      // Nested first, since a Plain holds its groups' Plains by value.
+      kj::strTree(
+          KJ_MAP(n, nestedTexts) { return kj::mv(n.plainDefs); },
+          kj::mv(top.plainDefs)),
+
+      kj::strTree(
+          kj::mv(top.fieldInfoDecls),
+          KJ_MAP(n, nestedTexts) { return kj::mv(n.fieldInfoDecls); }),
     };
   }
 
+  struct FieldInfoText {
+    kj::StringTree decls;
+    kj::StringTree defs;
+  };
+
+  static kj::String unpadded(kj::StringTree typeName) {
+    // Type names start with a space so that they can follow a '<'; not needed in macro arguments.
+    auto result = typeName.flatten();
+    return result.startsWith(" ") ? kj::str(result.slice(1)) : kj::mv(result);
+  }
+
+  FieldInfoText makeFieldInfoText(kj::StringPtr qualifiedName, StructSchema schema) {
+    // Specializations of FieldInfo_ describing each field's layout; see generated-header-support.h.
+
+    auto fields = schema.getFields();
+    return FieldInfoText {
+      kj::strTree(
+          "CAPNP_DECLARE_FIELDS(", qualifiedName, ", ", fields.size(), ");\n",
+          KJ_MAP(field, fields) {
+            auto proto = field.getProto();
+            auto name = proto.getName();
+            auto common = kj::strTree(
+                "\n    ", qualifiedName, ", ", field.getIndex(), ", ", name, ", ",
+                toTitleCase(name), ", ", proto.getDiscriminantValue());
+
+            if (proto.isGroup()) {
+              return kj::strTree(
+                  "CAPNP_DECLARE_GROUP_FIELD(", kj::mv(common), ",\n"
+                  "    ", qualifiedName, "::", toTitleCase(name), ");\n");
+            }
+
+            auto slot = proto.getSlot();
+            auto type = slot.getType();
+            switch (sectionFor(type.which())) {
+              case Section::NONE:
+                return kj::strTree("CAPNP_DECLARE_VOID_FIELD(", kj::mv(common), ");\n");
+              case Section::DATA: {
+                // Same as _::Mask<Type>, which can't be named before all enums are declared.
+                auto maskTypeName = type.isFloat32() || type.isFloat64() || type.isEnum()
+                    ? kj::str(maskType(type.which()).slice(1)) : unpadded(typeName(type));
+                auto mask = makeDefaultMask(slot.getDefaultValue());
+                return kj::strTree(
+                    "CAPNP_DECLARE_DATA_FIELD(", kj::mv(common), ",\n"
+                    "    ", slot.getOffset(), ", ", maskTypeName, ", ",
+                    mask.size() == 0 ? kj::StringPtr("0") : kj::StringPtr(mask), ", ",
+                    unpadded(typeName(type)), ");\n");
+              }
+              case Section::POINTERS:
+                return kj::strTree(
+                    "CAPNP_DECLARE_POINTER_FIELD(", kj::mv(common), ",\n"
+                    "    ", slot.getOffset(), ", ", unpadded(typeName(type)), ");\n");
+            }
+            KJ_UNREACHABLE;
+          }),
+      kj::strTree(
+          "CAPNP_DEFINE_FIELDS(", qualifiedName, ");\n",
+          KJ_MAP(field, fields) {
+            auto proto = field.getProto();
+            bool isData = proto.isSlot() &&
+                sectionFor(proto.getSlot().getType().which()) == Section::DATA;
+            return kj::strTree(
+                isData ? "CAPNP_DEFINE_DATA_FIELD(" : "CAPNP_DEFINE_FIELD(",
+                qualifiedName, ", ", field.getIndex(), ");\n");
+          })
+    };
+  }
+
+  kj::StringTree makeVisitText(kj::StringPtr qualifiedName, StructSchema schema) {
+    // Specialization of Visit_, which walks the struct's fields with static types; see visit() in
+    // generated-header-support.h.
+
+    auto visitField = [this](StructSchema::Field field, kj::StringPtr indent) {
+      auto proto = field.getProto();
+      auto titleCase = toTitleCase(proto.getName());
+      auto call = kj::strTree(
+          "visitField<FieldInfo_<S, ", field.getIndex(), ">>(reader.get", titleCase,
+          "(), visitor);\n");
+
+      if (proto.isSlot()) {
+        switch (proto.getSlot().getType().which()) {
+          case schema::Type::INTERFACE:
+            // Getting a capability has side effects, so don't.
+            return kj::strTree();
+          case schema::Type::TEXT:
+          case schema::Type::DATA:
+          case schema::Type::LIST:
+          case schema::Type::STRUCT:
+          case schema::Type::ANY_POINTER:
+            return kj::strTree(
+                indent, "if (reader.has", titleCase, "()) ", kj::mv(call));
+          default:
+            break;
+        }
+      }
+      return kj::strTree(indent, kj::mv(call));
+    };
+
+    auto unionFields = schema.getUnionFields();
+    return kj::strTree(
+        "template <> struct Visit_< ", qualifiedName, "> {\n"
+        "  typedef ", qualifiedName, " S;\n"
+        "  template <typename Reader, typename Visitor>\n"
+        "  static void apply(Reader reader, Visitor& visitor) {\n",
+        KJ_MAP(field, schema.getNonUnionFields()) { return visitField(field, "    "); },
+        unionFields.size() == 0 ? kj::strTree() : kj::strTree(
+            "    switch (reader.which()) {\n",
+            KJ_MAP(field, unionFields) {
+              return kj::strTree(
+                  "      case S::", toUpperCase(field.getProto().getName()), ":\n",
+                  visitField(field, "        "),
+                  "        break;\n");
+            },
+            "      default:\n"
+            "        break;\n"
+            "    }\n"),
+        "  }\n"
+        "};\n");
+  }
+
   NodeTextNoSchema makeNodeTextWithoutNested(kj::StringPtr namespace_, kj::StringPtr scope,
                                              kj::StringPtr name, Schema schema,
                                              kj::Array<kj::StringTree> nestedTypeDecls) {
@@ -1679,6 +2303,12 @@ private:
         StructText structText =
             makeStructText(scope, name, schema.asStruct(), kj::mv(nestedTypeDecls));
         auto structNode = proto.getStruct();
+        auto qualifiedName = kj::str(namespace_, "::", fullName);
+        // FieldInfo_ and Visit_ (which is written in terms of FieldInfo_) are opt-in.
+        bool fieldInfoWanted = inAnnotatedScope(schema, FIELD_INFO_ANNOTATION_ID);
+        FieldInfoText fieldInfo = fieldInfoWanted
+            ? makeFieldInfoText(qualifiedName, schema.asStruct())
+            : FieldInfoText { kj::strTree(), kj::strTree() };
 
         return NodeTextNoSchema {
           kj::mv(structText.outerTypeDecl),
@@ -1695,9 +2325,15 @@ private:
                       ");\n"),
           kj::strTree(
               "CAPNP_DEFINE_STRUCT(\n"
-              "    ", namespace_, "::", fullName, ");\n"),
+              "    ", namespace_, "::", fullName, ");\n",
+              kj::mv(fieldInfo.defs)),
 
           kj::strTree(),
+
+          kj::mv(structText.plainDefs),
+          kj::strTree(
+              kj::mv(fieldInfo.decls),
+              fieldInfoWanted ? makeVisitText(qualifiedName, schema.asStruct()) : kj::strTree()),
         };
       }
 
@@ -1888,12 +2524,14 @@ private:
           "namespace _ {  // private\n"
           "\n",
           KJ_MAP(n, nodeTexts) { return kj::mv(n.capnpPrivateDecls); },
+          KJ_MAP(n, nodeTexts) { return kj::mv(n.fieldInfoDecls); },
           "\n"
           "}  // namespace _ (private)\n"
           "}  // namespace capnp\n"
 
           "\n", separator, "\n",
           KJ_MAP(n, namespaceParts) { return kj::strTree("namespace ", n, " {\n"); }, "\n",
+          KJ_MAP(n, nodeTexts) { return kj::mv(n.plainDefs); },
           KJ_MAP(n, nodeTexts) { return kj::mv(n.readerBuilderDefs); },
           separator, "\n",
           KJ_MAP(n, nodeTexts) { return kj::mv(n.inlineMethodDefs); },
@@ -249,6 +249,8 @@ public:
   Orphan<List<schema::CodeGeneratorRequest::RequestedFile::Import>>
       getFileImportTable(Module& module, Orphanage orphanage);
   void eagerlyCompile(uint64_t id, uint eagerness, const SchemaLoader& loader);
+  kj::Array<uint64_t> add(kj::ArrayPtr<Module* const> modules, uint eagerness,
+                          const SchemaLoader& loader);
   CompiledModule& addInternal(Module& parsedModule);
 
   struct Workspace {
@@ -288,6 +290,9 @@ public:
     return annotationFlag == AnnotationFlag::COMPILE_ANNOTATIONS;
   }
 
+  void setProfiler(Profiler& profiler) { this->profiler = profiler; }
+  kj::Maybe<Profiler&> getProfiler() { return profiler; }
+
   void clearWorkspace();
   // Reset the temporary workspace.
 
@@ -309,6 +314,8 @@ public:
 private:
   AnnotationFlag annotationFlag;
 
+  kj::Maybe<Profiler&> profiler;
+
   kj::Arena nodeArena;
   // Arena used to allocate nodes and other permanent objects.
 
@@ -483,6 +490,9 @@ kj::Maybe<Compiler::Node::Content&> Compiler::Node::getContent(Content::State mi
 
       // Construct the NodeTranslator.
       auto& workspace = module->getCompiler().getWorkspace();
+      auto profiler = module->getCompiler().getProfiler();
+      Profiler::Scope translateScope(profiler, Profiler::Phase::TRANSLATE,
+                                     module->getSourceName());
 
       auto schemaNode = workspace.orphanage.newOrphan<schema::Node>();
       auto builder = schemaNode.get();
@@ -505,6 +515,8 @@ kj::Maybe<Compiler::Node::Content&> Compiler::Node::getContent(Content::State mi
           module->getCompiler().shouldCompileAnnotations());
       KJ_IF_MAYBE(exception, kj::runCatchingExceptions([&](){
         auto nodeSet = content.translator->getBootstrapNode();
+        Profiler::Scope validateScope(profiler, Profiler::Phase::VALIDATE,
+                                      module->getSourceName());
         for (auto& auxNode: nodeSet.auxNodes) {
           workspace.bootstrapLoader.loadOnce(auxNode);
         }
@@ -536,6 +548,8 @@ kj::Maybe<Compiler::Node::Content&> Compiler::Node::getContent(Content::State mi
       if (minimumState <= Content::BOOTSTRAP) break;
 
       // Create the final schema.
+      Profiler::Scope scope(module->getCompiler().getProfiler(), Profiler::Phase::TRANSLATE,
+                            module->getSourceName());
       auto nodeSet = content.translator->finish();
       content.finalSchema = nodeSet.node;
       content.auxSchemas = kj::mv(nodeSet.auxNodes);
@@ -676,6 +690,8 @@ void Compiler::Node::loadFinalSchema(const SchemaLoader& loader) {
   KJ_IF_MAYBE(content, getContent(Content::FINISHED)) {
     KJ_IF_MAYBE(exception, kj::runCatchingExceptions([&](){
       KJ_IF_MAYBE(finalSchema, content->finalSchema) {
+        Profiler::Scope scope(module->getCompiler().getProfiler(), Profiler::Phase::VALIDATE,
+                              module->getSourceName());
         KJ_MAP(auxSchema, content->auxSchemas) {
           return loader.loadOnce(auxSchema);
         };
@@ -1083,6 +1099,18 @@ void Compiler::Impl::eagerlyCompile(uint64_t id, uint eagerness,
   }
 }
 
+kj::Array<uint64_t> Compiler::Impl::add(kj::ArrayPtr<Module* const> modules, uint eagerness,
+                                        const SchemaLoader& finalLoader) {
+  std::unordered_map<Node*, uint> seen;
+  return KJ_MAP(module, modules) {
+    // Add each module just before traversing it, so that its parse errors are reported before
+    // its compile errors and after those of the previous module.
+    Node& node = addInternal(*module).getRootNode();
+    node.traverse(eagerness, seen, finalLoader);
+    return node.getId();
+  };
+}
+
 void Compiler::Impl::load(const SchemaLoader& loader, uint64_t id) const {
   // We know that this load() is only called from the bootstrap loader which is already protected
   // by our mutex, so we can drop thread-safety.
@@ -1123,6 +1151,14 @@ void Compiler::eagerlyCompile(uint64_t id, uint eagerness) const {
   impl.lockExclusive()->get()->eagerlyCompile(id, eagerness, loader);
 }
 
+kj::Array<uint64_t> Compiler::add(kj::ArrayPtr<Module* const> modules, uint eagerness) const {
+  return impl.lockExclusive()->get()->add(modules, eagerness, loader);
+}
+
+void Compiler::setProfiler(Profiler& profiler) const {
+  impl.lockExclusive()->get()->setProfiler(profiler);
+}
+
 void Compiler::clearWorkspace() const {
   impl.lockExclusive()->get()->clearWorkspace();
 }
@@ -28,6 +28,7 @@
 #include <capnp/schema.capnp.h>
 #include <capnp/schema-loader.h>
 #include "error-reporter.h"
+#include "profiler.h"
 
 namespace capnp {
 namespace compiler {
@@ -161,10 +162,22 @@ public:
   // If this returns and no errors have been reported, then it is guaranteed that the compiled
   // nodes can be found in the SchemaLoader returned by `getLoader()`.
 
+  kj::Array<uint64_t> add(kj::ArrayPtr<Module* const> modules, uint eagerness) const;
+  // Add several modules (e.g. all the files passed on a command line) and eagerly compile each
+  // one, returning their file IDs.  This is equivalent to calling `add()` and `eagerlyCompile()`
+  // on each module in turn -- in particular, errors are reported in the same order -- except that
+  // nodes related to more than one of the modules, such as the contents of a file imported by all
+  // of them, are only traversed once.  The loop re-traverses everything reachable from each
+  // module, which is quadratic for long chains of imports.
+
   const SchemaLoader& getLoader() const { return loader; }
   // Get a SchemaLoader backed by this compiler.  Schema nodes will be lazily constructed as you
   // traverse them using this loader.
 
+  void setProfiler(Profiler& profiler) const;
+  // Charge the time and allocations spent translating and validating each node to `profiler`,
+  // under the node's module.
+
   void clearWorkspace() const;
   // The compiler builds a lot of temporary tables and data structures while it works.  It's
   // useful to keep these around if more work is expected (especially if you are using lazy
@@ -71,9 +71,13 @@ static const ::capnp::_::AlignedData<62> b_e75816b56529d464 = {
 };
 static const uint16_t m_e75816b56529d464[] = {2, 1, 0};
 static const uint16_t i_e75816b56529d464[] = {0, 1, 2};
+static const uint32_t p_e75816b56529d464[] = {327680};
+static const uint16_t h_e75816b56529d464[] = {0, 1, 2};
 const ::capnp::_::RawSchema s_e75816b56529d464 = {
   0xe75816b56529d464, b_e75816b56529d464.words, 62, nullptr, m_e75816b56529d464,
-  0, 3, i_e75816b56529d464, nullptr, nullptr
+  0, 3, i_e75816b56529d464, nullptr, nullptr,
+  { 1, 1, 7, false, 0, 0, true },
+  0, p_e75816b56529d464, h_e75816b56529d464
 };
 static const ::capnp::_::AlignedData<62> b_991c7a3693d62cf2 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -141,9 +145,13 @@ static const ::capnp::_::AlignedData<62> b_991c7a3693d62cf2 = {
 };
 static const uint16_t m_991c7a3693d62cf2[] = {2, 1, 0};
 static const uint16_t i_991c7a3693d62cf2[] = {0, 1, 2};
+static const uint32_t p_991c7a3693d62cf2[] = {327680};
+static const uint16_t h_991c7a3693d62cf2[] = {0, 1, 2};
 const ::capnp::_::RawSchema s_991c7a3693d62cf2 = {
   0x991c7a3693d62cf2, b_991c7a3693d62cf2.words, 62, nullptr, m_991c7a3693d62cf2,
-  0, 3, i_991c7a3693d62cf2, nullptr, nullptr
+  0, 3, i_991c7a3693d62cf2, nullptr, nullptr,
+  { 2, 0, 7, false, 0, 0, true },
+  0, p_991c7a3693d62cf2, h_991c7a3693d62cf2
 };
 static const ::capnp::_::AlignedData<62> b_90f2a60678fd2367 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -211,9 +219,13 @@ static const ::capnp::_::AlignedData<62> b_90f2a60678fd2367 = {
 };
 static const uint16_t m_90f2a60678fd2367[] = {2, 1, 0};
 static const uint16_t i_90f2a60678fd2367[] = {0, 1, 2};
+static const uint32_t p_90f2a60678fd2367[] = {327680};
+static const uint16_t h_90f2a60678fd2367[] = {0, 1, 2};
 const ::capnp::_::RawSchema s_90f2a60678fd2367 = {
   0x90f2a60678fd2367, b_90f2a60678fd2367.words, 62, nullptr, m_90f2a60678fd2367,
-  0, 3, i_90f2a60678fd2367, nullptr, nullptr
+  0, 3, i_90f2a60678fd2367, nullptr, nullptr,
+  { 2, 0, 7, false, 0, 0, true },
+  0, p_90f2a60678fd2367, h_90f2a60678fd2367
 };
 static const ::capnp::_::AlignedData<73> b_ce5c2afd239fe34e = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -296,9 +308,13 @@ static const ::capnp::_::RawSchema* const d_ce5c2afd239fe34e[] = {
 };
 static const uint16_t m_ce5c2afd239fe34e[] = {0, 3, 1, 2};
 static const uint16_t i_ce5c2afd239fe34e[] = {0, 1, 2, 3};
+static const uint32_t p_ce5c2afd239fe34e[] = {589824};
+static const uint16_t h_ce5c2afd239fe34e[] = {2, 3, 0, 1};
 const ::capnp::_::RawSchema s_ce5c2afd239fe34e = {
   0xce5c2afd239fe34e, b_ce5c2afd239fe34e.words, 73, d_ce5c2afd239fe34e, m_ce5c2afd239fe34e,
-  2, 4, i_ce5c2afd239fe34e, nullptr, nullptr
+  2, 4, i_ce5c2afd239fe34e, nullptr, nullptr,
+  { 2, 2, 7, false, 0, 0, true },
+  0, p_ce5c2afd239fe34e, h_ce5c2afd239fe34e
 };
 static const ::capnp::_::AlignedData<63> b_c42df56830922111 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -371,9 +387,13 @@ static const ::capnp::_::RawSchema* const d_c42df56830922111[] = {
 };
 static const uint16_t m_c42df56830922111[] = {0, 2, 1};
 static const uint16_t i_c42df56830922111[] = {0, 1, 2};
+static const uint32_t p_c42df56830922111[] = {10354688};
+static const uint16_t h_c42df56830922111[] = {2, 0, 1};
 const ::capnp::_::RawSchema s_c42df56830922111 = {
   0xc42df56830922111, b_c42df56830922111.words, 63, d_c42df56830922111, m_c42df56830922111,
-  2, 3, i_c42df56830922111, nullptr, nullptr
+  2, 3, i_c42df56830922111, nullptr, nullptr,
+  { 2, 2, 7, true, 3, 0, true },
+  0, p_c42df56830922111, h_c42df56830922111
 };
 static const ::capnp::_::AlignedData<79> b_8751968764a2e298 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -462,9 +482,13 @@ static const ::capnp::_::RawSchema* const d_8751968764a2e298[] = {
 };
 static const uint16_t m_8751968764a2e298[] = {3, 0, 1, 2};
 static const uint16_t i_8751968764a2e298[] = {0, 1, 2, 3};
+static const uint32_t p_8751968764a2e298[] = {1114112};
+static const uint16_t h_8751968764a2e298[] = {2, 1, 3, 0};
 const ::capnp::_::RawSchema s_8751968764a2e298 = {
   0x8751968764a2e298, b_8751968764a2e298.words, 79, d_8751968764a2e298, m_8751968764a2e298,
-  2, 4, i_8751968764a2e298, nullptr, nullptr
+  2, 4, i_8751968764a2e298, nullptr, nullptr,
+  { 1, 2, 7, false, 0, 0, true },
+  0, p_8751968764a2e298, h_8751968764a2e298
 };
 static const ::capnp::_::AlignedData<172> b_9ca8b2acb16fc545 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -647,9 +671,13 @@ static const ::capnp::_::RawSchema* const d_9ca8b2acb16fc545[] = {
 };
 static const uint16_t m_9ca8b2acb16fc545[] = {9, 3, 6, 5, 2, 1, 8, 4, 7, 0};
 static const uint16_t i_9ca8b2acb16fc545[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+static const uint32_t p_9ca8b2acb16fc545[] = {2097154, 65536};
+static const uint16_t h_9ca8b2acb16fc545[] = {3, 9, 4, 2, 7, 1, 8, 5, 0, 6};
 const ::capnp::_::RawSchema s_9ca8b2acb16fc545 = {
   0x9ca8b2acb16fc545, b_9ca8b2acb16fc545.words, 172, d_9ca8b2acb16fc545, m_9ca8b2acb16fc545,
-  3, 10, i_9ca8b2acb16fc545, nullptr, nullptr
+  3, 10, i_9ca8b2acb16fc545, nullptr, nullptr,
+  { 3, 1, 7, false, 8, 0, true },
+  0, p_9ca8b2acb16fc545, h_9ca8b2acb16fc545
 };
 static const ::capnp::_::AlignedData<50> b_b6b57cf8b27fba0e = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -709,9 +737,13 @@ static const ::capnp::_::RawSchema* const d_b6b57cf8b27fba0e[] = {
 };
 static const uint16_t m_b6b57cf8b27fba0e[] = {0, 1};
 static const uint16_t i_b6b57cf8b27fba0e[] = {0, 1};
+static const uint32_t p_b6b57cf8b27fba0e[] = {0};
+static const uint16_t h_b6b57cf8b27fba0e[] = {0, 1};
 const ::capnp::_::RawSchema s_b6b57cf8b27fba0e = {
   0xb6b57cf8b27fba0e, b_b6b57cf8b27fba0e.words, 50, d_b6b57cf8b27fba0e, m_b6b57cf8b27fba0e,
-  2, 2, i_b6b57cf8b27fba0e, nullptr, nullptr
+  2, 2, i_b6b57cf8b27fba0e, nullptr, nullptr,
+  { 0, 2, 7, false, 0, 0, true },
+  0, p_b6b57cf8b27fba0e, h_b6b57cf8b27fba0e
 };
 static const ::capnp::_::AlignedData<553> b_96efe787c17e83bb = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1283,9 +1315,13 @@ static const ::capnp::_::RawSchema* const d_96efe787c17e83bb[] = {
 };
 static const uint16_t m_96efe787c17e83bb[] = {18, 3, 37, 22, 34, 31, 32, 24, 25, 26, 23, 35, 36, 33, 28, 29, 30, 27, 21, 9, 6, 5, 10, 11, 13, 7, 15, 1, 16, 17, 20, 19, 0, 2, 4, 12, 14, 8};
 static const uint16_t i_96efe787c17e83bb[] = {7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 0, 1, 2, 3, 4, 5, 6};
+static const uint32_t p_96efe787c17e83bb[] = {65545, 65540, 0, 458766, 1507338, 65546, 7536642, 0};
+static const uint16_t h_96efe787c17e83bb[] = {19, 3, 26, 30, 17, 2, 36, 25, 14, 4, 32, 16, 10, 20, 35, 15, 37, 28, 7, 24, 27, 13, 22, 34, 11, 33, 21, 29, 23, 1, 12, 8, 6, 5, 9, 18, 0, 31};
 const ::capnp::_::RawSchema s_96efe787c17e83bb = {
   0x96efe787c17e83bb, b_96efe787c17e83bb.words, 553, d_96efe787c17e83bb, m_96efe787c17e83bb,
-  11, 38, i_96efe787c17e83bb, nullptr, nullptr
+  11, 38, i_96efe787c17e83bb, nullptr, nullptr,
+  { 2, 7, 7, false, 31, 1, true },
+  0, p_96efe787c17e83bb, h_96efe787c17e83bb
 };
 static const ::capnp::_::AlignedData<43> b_d00489d473826290 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1338,9 +1374,13 @@ static const ::capnp::_::RawSchema* const d_d00489d473826290[] = {
 };
 static const uint16_t m_d00489d473826290[] = {0, 1};
 static const uint16_t i_d00489d473826290[] = {0, 1};
+static const uint32_t p_d00489d473826290[] = {65536};
+static const uint16_t h_d00489d473826290[] = {1, 0};
 const ::capnp::_::RawSchema s_d00489d473826290 = {
   0xd00489d473826290, b_d00489d473826290.words, 43, d_d00489d473826290, m_d00489d473826290,
-  2, 2, i_d00489d473826290, nullptr, nullptr
+  2, 2, i_d00489d473826290, nullptr, nullptr,
+  { 1, 2, 7, false, 0, 0, true },
+  0, p_d00489d473826290, h_d00489d473826290
 };
 static const ::capnp::_::AlignedData<50> b_fb5aeed95cdf6af9 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1400,9 +1440,13 @@ static const ::capnp::_::RawSchema* const d_fb5aeed95cdf6af9[] = {
 };
 static const uint16_t m_fb5aeed95cdf6af9[] = {1, 0};
 static const uint16_t i_fb5aeed95cdf6af9[] = {0, 1};
+static const uint32_t p_fb5aeed95cdf6af9[] = {0};
+static const uint16_t h_fb5aeed95cdf6af9[] = {0, 1};
 const ::capnp::_::RawSchema s_fb5aeed95cdf6af9 = {
   0xfb5aeed95cdf6af9, b_fb5aeed95cdf6af9.words, 50, d_fb5aeed95cdf6af9, m_fb5aeed95cdf6af9,
-  2, 2, i_fb5aeed95cdf6af9, nullptr, nullptr
+  2, 2, i_fb5aeed95cdf6af9, nullptr, nullptr,
+  { 1, 2, 7, true, 2, 0, true },
+  0, p_fb5aeed95cdf6af9, h_fb5aeed95cdf6af9
 };
 static const ::capnp::_::AlignedData<81> b_b3f66e7a79d81bcd = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1493,9 +1537,13 @@ static const ::capnp::_::RawSchema* const d_b3f66e7a79d81bcd[] = {
 };
 static const uint16_t m_b3f66e7a79d81bcd[] = {3, 0, 2, 1};
 static const uint16_t i_b3f66e7a79d81bcd[] = {0, 1, 2, 3};
+static const uint32_t p_b3f66e7a79d81bcd[] = {1245184};
+static const uint16_t h_b3f66e7a79d81bcd[] = {0, 2, 1, 3};
 const ::capnp::_::RawSchema s_b3f66e7a79d81bcd = {
   0xb3f66e7a79d81bcd, b_b3f66e7a79d81bcd.words, 81, d_b3f66e7a79d81bcd, m_b3f66e7a79d81bcd,
-  2, 4, i_b3f66e7a79d81bcd, nullptr, nullptr
+  2, 4, i_b3f66e7a79d81bcd, nullptr, nullptr,
+  { 2, 1, 7, false, 2, 0, true },
+  0, p_b3f66e7a79d81bcd, h_b3f66e7a79d81bcd
 };
 static const ::capnp::_::AlignedData<103> b_fffe08a9a697d2a5 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1610,9 +1658,13 @@ static const ::capnp::_::RawSchema* const d_fffe08a9a697d2a5[] = {
 };
 static const uint16_t m_fffe08a9a697d2a5[] = {2, 3, 5, 0, 4, 1};
 static const uint16_t i_fffe08a9a697d2a5[] = {0, 1, 2, 3, 4, 5};
+static const uint32_t p_fffe08a9a697d2a5[] = {131072, 65538};
+static const uint16_t h_fffe08a9a697d2a5[] = {0, 5, 2, 4, 3, 1};
 const ::capnp::_::RawSchema s_fffe08a9a697d2a5 = {
   0xfffe08a9a697d2a5, b_fffe08a9a697d2a5.words, 103, d_fffe08a9a697d2a5, m_fffe08a9a697d2a5,
-  4, 6, i_fffe08a9a697d2a5, nullptr, nullptr
+  4, 6, i_fffe08a9a697d2a5, nullptr, nullptr,
+  { 2, 4, 7, false, 0, 0, true },
+  0, p_fffe08a9a697d2a5, h_fffe08a9a697d2a5
 };
 static const ::capnp::_::AlignedData<48> b_e5104515fd88ea47 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1670,9 +1722,13 @@ static const ::capnp::_::RawSchema* const d_e5104515fd88ea47[] = {
 };
 static const uint16_t m_e5104515fd88ea47[] = {0, 1};
 static const uint16_t i_e5104515fd88ea47[] = {0, 1};
+static const uint32_t p_e5104515fd88ea47[] = {0};
+static const uint16_t h_e5104515fd88ea47[] = {0, 1};
 const ::capnp::_::RawSchema s_e5104515fd88ea47 = {
   0xe5104515fd88ea47, b_e5104515fd88ea47.words, 48, d_e5104515fd88ea47, m_e5104515fd88ea47,
-  2, 2, i_e5104515fd88ea47, nullptr, nullptr
+  2, 2, i_e5104515fd88ea47, nullptr, nullptr,
+  { 2, 4, 7, true, 2, 0, true },
+  0, p_e5104515fd88ea47, h_e5104515fd88ea47
 };
 static const ::capnp::_::AlignedData<61> b_89f0c973c103ae96 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1743,9 +1799,13 @@ static const ::capnp::_::RawSchema* const d_89f0c973c103ae96[] = {
 };
 static const uint16_t m_89f0c973c103ae96[] = {2, 1, 0};
 static const uint16_t i_89f0c973c103ae96[] = {0, 1, 2};
+static const uint32_t p_89f0c973c103ae96[] = {0};
+static const uint16_t h_89f0c973c103ae96[] = {2, 1, 0};
 const ::capnp::_::RawSchema s_89f0c973c103ae96 = {
   0x89f0c973c103ae96, b_89f0c973c103ae96.words, 61, d_89f0c973c103ae96, m_89f0c973c103ae96,
-  2, 3, i_89f0c973c103ae96, nullptr, nullptr
+  2, 3, i_89f0c973c103ae96, nullptr, nullptr,
+  { 2, 7, 7, true, 3, 0, true },
+  0, p_89f0c973c103ae96, h_89f0c973c103ae96
 };
 static const ::capnp::_::AlignedData<32> b_e93164a80bfe2ccf = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1787,9 +1847,13 @@ static const ::capnp::_::RawSchema* const d_e93164a80bfe2ccf[] = {
 };
 static const uint16_t m_e93164a80bfe2ccf[] = {0};
 static const uint16_t i_e93164a80bfe2ccf[] = {0};
+static const uint32_t p_e93164a80bfe2ccf[] = {0};
+static const uint16_t h_e93164a80bfe2ccf[] = {0};
 const ::capnp::_::RawSchema s_e93164a80bfe2ccf = {
   0xe93164a80bfe2ccf, b_e93164a80bfe2ccf.words, 32, d_e93164a80bfe2ccf, m_e93164a80bfe2ccf,
-  2, 1, i_e93164a80bfe2ccf, nullptr, nullptr
+  2, 1, i_e93164a80bfe2ccf, nullptr, nullptr,
+  { 2, 7, 7, true, 0, 0, true },
+  0, p_e93164a80bfe2ccf, h_e93164a80bfe2ccf
 };
 static const ::capnp::_::AlignedData<46> b_b348322a8dcf0d0c = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1846,9 +1910,13 @@ static const ::capnp::_::RawSchema* const d_b348322a8dcf0d0c[] = {
 };
 static const uint16_t m_b348322a8dcf0d0c[] = {0, 1};
 static const uint16_t i_b348322a8dcf0d0c[] = {0, 1};
+static const uint32_t p_b348322a8dcf0d0c[] = {0};
+static const uint16_t h_b348322a8dcf0d0c[] = {0, 1};
 const ::capnp::_::RawSchema s_b348322a8dcf0d0c = {
   0xb348322a8dcf0d0c, b_b348322a8dcf0d0c.words, 46, d_b348322a8dcf0d0c, m_b348322a8dcf0d0c,
-  3, 2, i_b348322a8dcf0d0c, nullptr, nullptr
+  3, 2, i_b348322a8dcf0d0c, nullptr, nullptr,
+  { 2, 7, 7, true, 0, 0, true },
+  0, p_b348322a8dcf0d0c, h_b348322a8dcf0d0c
 };
 static const ::capnp::_::AlignedData<41> b_8f2622208fb358c8 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1900,9 +1968,13 @@ static const ::capnp::_::RawSchema* const d_8f2622208fb358c8[] = {
 };
 static const uint16_t m_8f2622208fb358c8[] = {1, 0};
 static const uint16_t i_8f2622208fb358c8[] = {0, 1};
+static const uint32_t p_8f2622208fb358c8[] = {0};
+static const uint16_t h_8f2622208fb358c8[] = {0, 1};
 const ::capnp::_::RawSchema s_8f2622208fb358c8 = {
   0x8f2622208fb358c8, b_8f2622208fb358c8.words, 41, d_8f2622208fb358c8, m_8f2622208fb358c8,
-  3, 2, i_8f2622208fb358c8, nullptr, nullptr
+  3, 2, i_8f2622208fb358c8, nullptr, nullptr,
+  { 2, 7, 7, true, 0, 0, true },
+  0, p_8f2622208fb358c8, h_8f2622208fb358c8
 };
 static const ::capnp::_::AlignedData<48> b_d0d1a21de617951f = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1960,9 +2032,13 @@ static const ::capnp::_::RawSchema* const d_d0d1a21de617951f[] = {
 };
 static const uint16_t m_d0d1a21de617951f[] = {0, 1};
 static const uint16_t i_d0d1a21de617951f[] = {0, 1};
+static const uint32_t p_d0d1a21de617951f[] = {0};
+static const uint16_t h_d0d1a21de617951f[] = {0, 1};
 const ::capnp::_::RawSchema s_d0d1a21de617951f = {
   0xd0d1a21de617951f, b_d0d1a21de617951f.words, 48, d_d0d1a21de617951f, m_d0d1a21de617951f,
-  2, 2, i_d0d1a21de617951f, nullptr, nullptr
+  2, 2, i_d0d1a21de617951f, nullptr, nullptr,
+  { 2, 7, 7, true, 2, 6, true },
+  0, p_d0d1a21de617951f, h_d0d1a21de617951f
 };
 static const ::capnp::_::AlignedData<36> b_992a90eaf30235d3 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -2008,9 +2084,13 @@ static const ::capnp::_::RawSchema* const d_992a90eaf30235d3[] = {
 };
 static const uint16_t m_992a90eaf30235d3[] = {0};
 static const uint16_t i_992a90eaf30235d3[] = {0};
+static const uint32_t p_992a90eaf30235d3[] = {0};
+static const uint16_t h_992a90eaf30235d3[] = {0};
 const ::capnp::_::RawSchema s_992a90eaf30235d3 = {
   0x992a90eaf30235d3, b_992a90eaf30235d3.words, 36, d_992a90eaf30235d3, m_992a90eaf30235d3,
-  2, 1, i_992a90eaf30235d3, nullptr, nullptr
+  2, 1, i_992a90eaf30235d3, nullptr, nullptr,
+  { 2, 7, 7, true, 0, 0, true },
+  0, p_992a90eaf30235d3, h_992a90eaf30235d3
 };
 static const ::capnp::_::AlignedData<40> b_eb971847d617c0b9 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -2061,9 +2141,13 @@ static const ::capnp::_::RawSchema* const d_eb971847d617c0b9[] = {
 };
 static const uint16_t m_eb971847d617c0b9[] = {0, 1};
 static const uint16_t i_eb971847d617c0b9[] = {0, 1};
+static const uint32_t p_eb971847d617c0b9[] = {0};
+static const uint16_t h_eb971847d617c0b9[] = {0, 1};
 const ::capnp::_::RawSchema s_eb971847d617c0b9 = {
   0xeb971847d617c0b9, b_eb971847d617c0b9.words, 40, d_eb971847d617c0b9, m_eb971847d617c0b9,
-  3, 2, i_eb971847d617c0b9, nullptr, nullptr
+  3, 2, i_eb971847d617c0b9, nullptr, nullptr,
+  { 2, 7, 7, true, 0, 0, true },
+  0, p_eb971847d617c0b9, h_eb971847d617c0b9
 };
 static const ::capnp::_::AlignedData<48> b_c6238c7d62d65173 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -2121,9 +2205,13 @@ static const ::capnp::_::RawSchema* const d_c6238c7d62d65173[] = {
 };
 static const uint16_t m_c6238c7d62d65173[] = {1, 0};
 static const uint16_t i_c6238c7d62d65173[] = {0, 1};
+static const uint32_t p_c6238c7d62d65173[] = {0};
+static const uint16_t h_c6238c7d62d65173[] = {0, 1};
 const ::capnp::_::RawSchema s_c6238c7d62d65173 = {
   0xc6238c7d62d65173, b_c6238c7d62d65173.words, 48, d_c6238c7d62d65173, m_c6238c7d62d65173,
-  2, 2, i_c6238c7d62d65173, nullptr, nullptr
+  2, 2, i_c6238c7d62d65173, nullptr, nullptr,
+  { 2, 7, 7, true, 2, 6, true },
+  0, p_c6238c7d62d65173, h_c6238c7d62d65173
 };
 static const ::capnp::_::AlignedData<216> b_9cb9e86e3198037f = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -2349,9 +2437,13 @@ static const ::capnp::_::RawSchema* const d_9cb9e86e3198037f[] = {
 };
 static const uint16_t m_9cb9e86e3198037f[] = {12, 2, 3, 4, 6, 1, 8, 9, 10, 11, 5, 7, 0};
 static const uint16_t i_9cb9e86e3198037f[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+static const uint32_t p_9cb9e86e3198037f[] = {2228224, 131077, 196620};
+static const uint16_t h_9cb9e86e3198037f[] = {1, 3, 7, 0, 12, 9, 11, 5, 4, 8, 6, 2, 10};
 const ::capnp::_::RawSchema s_9cb9e86e3198037f = {
   0x9cb9e86e3198037f, b_9cb9e86e3198037f.words, 216, d_9cb9e86e3198037f, m_9cb9e86e3198037f,
-  2, 13, i_9cb9e86e3198037f, nullptr, nullptr
+  2, 13, i_9cb9e86e3198037f, nullptr, nullptr,
+  { 2, 7, 7, true, 0, 0, true },
+  0, p_9cb9e86e3198037f, h_9cb9e86e3198037f
 };
 static const ::capnp::_::AlignedData<32> b_84e4f3f5a807605c = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -2392,9 +2484,13 @@ static const ::capnp::_::RawSchema* const d_84e4f3f5a807605c[] = {
 };
 static const uint16_t m_84e4f3f5a807605c[] = {0};
 static const uint16_t i_84e4f3f5a807605c[] = {0};
+static const uint32_t p_84e4f3f5a807605c[] = {0};
+static const uint16_t h_84e4f3f5a807605c[] = {0};
 const ::capnp::_::RawSchema s_84e4f3f5a807605c = {
   0x84e4f3f5a807605c, b_84e4f3f5a807605c.words, 32, d_84e4f3f5a807605c, m_84e4f3f5a807605c,
-  1, 1, i_84e4f3f5a807605c, nullptr, nullptr
+  1, 1, i_84e4f3f5a807605c, nullptr, nullptr,
+  { 0, 1, 6, false, 0, 0, true },
+  0, p_84e4f3f5a807605c, h_84e4f3f5a807605c
 };
 }  // namespace schemas
 namespace _ {  // private
@@ -23,7 +23,10 @@
 
 #include "lexer.h"
 #include "../message.h"
+#include <kj/debug.h>
+#include <kj/vector.h>
 #include <gtest/gtest.h>
+#include <time.h>
 
 namespace capnp {
 namespace compiler {
@@ -62,6 +65,13 @@ kj::String doLex(kj::StringPtr constText) {
   TestFailingErrorReporter errorReporter;
   EXPECT_TRUE(lex(text, file, errorReporter));
   kj::String result = kj::str(file);
+
+  // The parser-combinator implementation must produce exactly the same result.
+  MallocMessageBuilder message2;
+  auto file2 = message2.initRoot<LexResult>();
+  EXPECT_TRUE(lex(text, file2, errorReporter, LexerImplementation::PARSER_COMBINATORS));
+  EXPECT_EQ(result, kj::str(file2));
+
   for (char& c: result) {
     // Make it easier to write golden strings below.
     if (c == '\"') c = '\'';
@@ -347,6 +357,149 @@ TEST(Lexer, DocComments) {
       doLex<LexedStatements>("foo {bar; baz;}\n# late comment\nqux;").cStr());
 }
 
+class TestRecordingErrorReporter: public ErrorReporter {
+public:
+  void addError(uint32_t startByte, uint32_t endByte, kj::StringPtr message) override {
+    errors.add(kj::str(startByte, "-", endByte, ": ", message));
+  }
+
+  bool hadErrors() override {
+    return errors.size() > 0;
+  }
+
+  kj::String toString() {
+    return kj::strArray(errors, "\n");
+  }
+
+  kj::Vector<kj::String> errors;
+};
+
+template <typename LexResult>
+void expectSameLex(kj::StringPtr text) {
+  // Lex `text` with both implementations and check that they agree on the result and on any
+  // errors reported.
+
+  SCOPED_TRACE(text.cStr());
+
+  MallocMessageBuilder message1;
+  auto file1 = message1.initRoot<LexResult>();
+  TestRecordingErrorReporter errors1;
+  bool ok1 = lex(text, file1, errors1, LexerImplementation::TABLE_DRIVEN);
+
+  MallocMessageBuilder message2;
+  auto file2 = message2.initRoot<LexResult>();
+  TestRecordingErrorReporter errors2;
+  bool ok2 = lex(text, file2, errors2, LexerImplementation::PARSER_COMBINATORS);
+
+  EXPECT_EQ(ok2, ok1);
+  EXPECT_EQ(errors2.toString(), errors1.toString());
+  if (ok1 && ok2) {
+    EXPECT_EQ(kj::str(file2), kj::str(file1));
+  }
+}
+
+TEST(Lexer, TableDrivenMatchesParserCombinators) {
+  const char* inputs[] = {
+    // Numbers.
+    "0 00 07 09 0x 0x1F 0xfF 123 18446744073709551615 18446744073709551616",
+    "1. 1.5 .5 1e 1e+ 1e-3 1E10 2.75e+4 0.0 01.5",
+    "1a", "0x1g", "1.5.3", "1_", "0x1.", "1e5x",
+
+    // Strings.
+    "\"\"", "\"foo\" \"bar\"",
+    "\"\\a\\b\\f\\n\\r\\t\\v\\'\\\"\\\\\\?\"",
+    "\"\\x41\\x4a\\x4A\\0\\7\\101\\1011\\377\"",
+    "\"\\x4\"", "\"\\q\"", "\"unterminated", "\"new\nline\"", "\"\\",
+    "\"\r\t\\\n\"",
+
+    // Operators and names.
+    "foo bar_baz _qux a1b2 -+= !$%&*+-./:<=>?@^|~ a.b.c",
+    "foo'", "a ` b", "\xff",
+
+    // Lists.
+    "()", "( )", "(,)", "(a,)", "(,a)", "[a, [b, (c, d)], e] f", "[(])", "(a", "a)", "[a,",
+
+    // Comments and whitespace.
+    "", "   ", "# only a comment", "a # comment\n b #\n#\n c", "a\r\nb\r\n",
+  };
+  for (auto input: inputs) {
+    expectSameLex<LexedTokens>(input);
+  }
+
+  const char* statementInputs[] = {
+    "", ";", ";;", "foo;", "foo {}", "foo {} bar;", "foo { bar { baz; } }",
+    "foo", "foo {", "foo }", "}", "foo { bar; ", "foo ) bar;", "foo bar; }",
+    "foo; # comment", "foo; #comment\r\n# second\r\nbar;",
+    "foo;\r# comment", "foo;\r\n\r\n# not a doc comment",
+    "foo;\n  \t# indented\n\t#\n# third\nbar;",
+    "foo { # early\n bar; } # late\nbaz;",
+    "foo { bar; } # late\nbaz;",
+    "foo { bar; # inner\n } #late",
+    "foo;   \n  ",
+    "foo(a, b) [c] \"d\" 1 2.0 -> e { f; g { h; } }  # trailing",
+  };
+  for (auto input: statementInputs) {
+    expectSameLex<LexedStatements>(input);
+  }
+}
+
+double secondsSince(const struct timespec& start) {
+  struct timespec now;
+  KJ_SYSCALL(clock_gettime(CLOCK_MONOTONIC, &now));
+  return (now.tv_sec - start.tv_sec) + (now.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+TEST(Lexer, Throughput) {
+  // Lexes a large schema-like text with both implementations, checking that they agree and
+  // reporting each one's throughput.  Not a rigorous benchmark, but enough to notice if the fast
+  // path stops being fast.
+
+  kj::Vector<kj::String> chunks;
+  for (uint i = 0; i < 1000; i++) {
+    chunks.add(kj::str(
+        "# Comment before struct ", i, ".\n"
+        "struct Foo", i, " {  # Doc comment for Foo", i, ".\n"
+        "  # More documentation.\n"
+        "  name @0 :Text = \"foo\\x20bar\\n\";\n"
+        "  id @1 :UInt64 = 0x", kj::hex(i), ";  # trailing\n"
+        "  weights @2 :List(Float64) = [1.5, -2.25e3, ", i, ".0];\n"
+        "  union {\n"
+        "    a @3 :Void;\n"
+        "    b @4 :Data = 0\"616263\";\n"
+        "  }\n"
+        "  method @5 (x :Int32, y :List(Text)) -> (z :Bool);\n"
+        "}\n\n"));
+  }
+  kj::String text = kj::strArray(chunks, "");
+
+  const uint iterations = 5;
+  kj::String results[2];
+  for (auto implementation: {LexerImplementation::TABLE_DRIVEN,
+                             LexerImplementation::PARSER_COMBINATORS}) {
+    TestFailingErrorReporter errorReporter;
+    {
+      MallocMessageBuilder message;
+      auto file = message.initRoot<LexedStatements>();
+      ASSERT_TRUE(lex(text, file, errorReporter, implementation));
+      results[static_cast<uint>(implementation)] = kj::str(file);
+    }
+
+    struct timespec start;
+    KJ_SYSCALL(clock_gettime(CLOCK_MONOTONIC, &start));
+    for (uint i = 0; i < iterations; i++) {
+      MallocMessageBuilder message;
+      lex(text, message.initRoot<LexedStatements>(), errorReporter, implementation);
+    }
+    double seconds = secondsSince(start);
+
+    std::cout << (implementation == LexerImplementation::TABLE_DRIVEN ?
+                      "table-driven:       " : "parser combinators: ")
+              << (text.size() * iterations / seconds / 1048576) << " MB/s" << std::endl;
+  }
+
+  EXPECT_TRUE(results[0] == results[1]);
+}
+
 }  // namespace
 }  // namespace compiler
 }  // namespace capnp
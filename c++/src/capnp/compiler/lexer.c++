@@ -24,14 +24,446 @@
 #include "lexer.h"
 #include <kj/parse/char.h>
 #include <kj/debug.h>
+#include <kj/vector.h>
+#include <stdlib.h>
+#include <string.h>
 
 namespace capnp {
 namespace compiler {
 
 namespace p = kj::parse;
 
+namespace {
+
+enum CharClass: uint16_t {
+  WHITESPACE = 1 << 0,
+  LINE_WHITESPACE = 1 << 1,  // whitespace other than newlines
+  NAME_START = 1 << 2,
+  NAME_CHAR = 1 << 3,
+  DIGIT = 1 << 4,
+  OCT_DIGIT = 1 << 5,
+  HEX_DIGIT = 1 << 6,
+  OPERATOR = 1 << 7,
+  NUMBER_TERMINATOR = 1 << 8  // may not directly follow a number: alpha, '_', or '.'
+};
+
+class CharTable {
+public:
+  CharTable() {
+    memset(classes, 0, sizeof(classes));
+    add(" \f\n\r\t\v", WHITESPACE);
+    add(" \f\t\v", LINE_WHITESPACE);
+    add("!$%&*+-./:<=>?@^|~", OPERATOR);
+    add("_", NAME_START | NAME_CHAR | NUMBER_TERMINATOR);
+    add(".", NUMBER_TERMINATOR);
+    addRange('a', 'z', NAME_START | NAME_CHAR | NUMBER_TERMINATOR);
+    addRange('A', 'Z', NAME_START | NAME_CHAR | NUMBER_TERMINATOR);
+    addRange('0', '9', NAME_CHAR | DIGIT | HEX_DIGIT);
+    addRange('0', '7', OCT_DIGIT);
+    addRange('a', 'f', HEX_DIGIT);
+    addRange('A', 'F', HEX_DIGIT);
+  }
+
+  inline bool is(char c, uint16_t mask) const {
+    return classes[static_cast<unsigned char>(c)] & mask;
+  }
+
+private:
+  uint16_t classes[256];
+
+  void add(const char* chars, uint16_t mask) {
+    for (; *chars != '\0'; ++chars) {
+      classes[static_cast<unsigned char>(*chars)] |= mask;
+    }
+  }
+  void addRange(char first, char last, uint16_t mask) {
+    for (char c = first; c <= last; ++c) {
+      classes[static_cast<unsigned char>(c)] |= mask;
+    }
+  }
+};
+
+const CharTable CHARS;
+
+inline char parseDigit(char c) {
+  if (c < 'A') return c - '0';
+  if (c < 'a') return c - 'A' + 10;
+  return c - 'a' + 10;
+}
+
+void setText(Text::Builder builder, kj::ArrayPtr<const char> text) {
+  memcpy(builder.begin(), text.begin(), text.size());
+}
+
+class TableDrivenLexer {
+  // Single-pass equivalent of the parsers built by class Lexer.  Each method below mirrors one of
+  // those parsers, consuming exactly the same input and building the same Token and Statement
+  // orphans, but without backtracking or allocating per-token temporaries.  Wherever the parsers
+  // would fail, the method just returns false; the caller then re-runs the parsers to report the
+  // error.
+
+public:
+  TableDrivenLexer(kj::ArrayPtr<const char> input, Orphanage orphanage)
+      : begin(input.begin()), pos(input.begin()), end(input.end()), orphanage(orphanage) {}
+
+  bool lex(LexedStatements::Builder result) {
+    if (!statementSequence() || pos != end) return false;
+    auto list = result.initStatements(statements.size());
+    for (uint i = 0; i < statements.size(); i++) {
+      list.adoptWithCaveats(i, kj::mv(statements[i]));
+    }
+    return true;
+  }
+
+  bool lex(LexedTokens::Builder result) {
+    if (!tokenSequence() || pos != end) return false;
+    auto list = result.initTokens(tokens.size());
+    for (uint i = 0; i < tokens.size(); i++) {
+      list.adoptWithCaveats(i, kj::mv(tokens[i]));
+    }
+    return true;
+  }
+
+private:
+  const char* begin;
+  const char* pos;
+  const char* end;
+  Orphanage orphanage;
+
+  // Stacks holding the output of every sequence currently being lexed.  A sequence pushes its
+  // items and, once they have been adopted into their final list, truncates the stack back to
+  // where it started.
+  kj::Vector<Orphan<Token>> tokens;
+  kj::Vector<Orphan<Statement>> statements;
+  kj::Vector<uint> itemSizes;  // token counts of parenthesized / bracketed list items
+  kj::Vector<kj::ArrayPtr<const char>> commentLines;
+
+  kj::Vector<char> scratch;  // unescaped string literal
+
+  inline bool at(uint16_t mask) { return pos < end && CHARS.is(*pos, mask); }
+  inline uint32_t offset(const char* ptr) { return ptr - begin; }
+
+  void skipCommentsAndWhitespace() {
+    for (;;) {
+      while (at(WHITESPACE)) ++pos;
+      if (pos == end || *pos != '#') return;
+      const char* newline = reinterpret_cast<const char*>(memchr(pos, '\n', end - pos));
+      pos = newline == nullptr ? end : newline + 1;
+    }
+  }
+
+  Token::Builder addToken(const char* start) {
+    auto& orphan = tokens.add(orphanage.newOrphan<Token>());
+    auto builder = orphan.get();
+    builder.setStartByte(offset(start));
+    builder.setEndByte(offset(pos));
+    return builder;
+  }
+
+  bool tokenSequence() {
+    skipCommentsAndWhitespace();
+    while (pos < end) {
+      char c = *pos;
+      // Any character which can't start a token can't follow one either, so failing to lex a
+      // token is always an error.
+      if (CHARS.is(c, NAME_START)) {
+        identifier();
+      } else if (CHARS.is(c, DIGIT)) {
+        if (!number()) return false;
+      } else if (CHARS.is(c, OPERATOR)) {
+        operator_();
+      } else if (c == '"') {
+        if (!stringLiteral()) return false;
+      } else if (c == '(' || c == '[') {
+        if (!listToken()) return false;
+      } else {
+        return true;
+      }
+      skipCommentsAndWhitespace();
+    }
+    return true;
+  }
+
+  void identifier() {
+    const char* start = pos++;
+    while (at(NAME_CHAR)) ++pos;
+    setText(addToken(start).initIdentifier(pos - start), kj::arrayPtr(start, pos));
+  }
+
+  void operator_() {
+    const char* start = pos++;
+    while (at(OPERATOR)) ++pos;
+    setText(addToken(start).initOperator(pos - start), kj::arrayPtr(start, pos));
+  }
+
+  bool number() {
+    const char* start = pos;
+
+    // Like p::integer: hex, octal (so "09" is two tokens), or decimal, not followed by a letter,
+    // '_', or '.'.
+    uint64_t value = 0;
+    if (*pos == '0' && pos + 1 < end && pos[1] == 'x') {
+      pos += 2;
+      for (; at(HEX_DIGIT); ++pos) value = value * 16 + parseDigit(*pos);
+    } else if (*pos == '0') {
+      for (++pos; at(OCT_DIGIT); ++pos) value = value * 8 + parseDigit(*pos);
+    } else {
+      for (; at(DIGIT); ++pos) value = value * 10 + parseDigit(*pos);
+    }
+    if (!at(NUMBER_TERMINATOR)) {
+      addToken(start).setIntegerLiteral(value);
+      return true;
+    }
+
+    // Like p::number.
+    pos = start;
+    while (at(DIGIT)) ++pos;
+    if (pos < end && *pos == '.') {
+      ++pos;
+      while (at(DIGIT)) ++pos;
+    }
+    if (pos < end && (*pos == 'e' || *pos == 'E')) {
+      ++pos;
+      if (pos < end && (*pos == '+' || *pos == '-')) ++pos;
+      while (at(DIGIT)) ++pos;
+    }
+    if (at(NUMBER_TERMINATOR)) return false;
+
+    size_t size = pos - start;
+    KJ_STACK_ARRAY(char, buf, size + 1, 128, 128);
+    memcpy(buf.begin(), start, size);
+    buf[size] = '\0';
+    addToken(start).setFloatLiteral(strtod(buf.begin(), nullptr));
+    return true;
+  }
+
+  bool stringLiteral() {
+    const char* start = pos++;
+    const char* chunk = pos;  // start of the text not yet copied to `scratch`
+    bool escaped = false;
+    scratch.resize(0);
+
+    for (;;) {
+      if (pos == end) return false;
+      char c = *pos;
+      if (c == '"') break;
+      if (c == '\n') return false;
+      if (c != '\\') {
+        ++pos;
+        continue;
+      }
+
+      for (const char* p = chunk; p < pos; ++p) scratch.add(*p);
+      escaped = true;
+      if (++pos == end) return false;
+      c = *pos++;
+      switch (c) {
+        case 'a': scratch.add('\a'); break;
+        case 'b': scratch.add('\b'); break;
+        case 'f': scratch.add('\f'); break;
+        case 'n': scratch.add('\n'); break;
+        case 'r': scratch.add('\r'); break;
+        case 't': scratch.add('\t'); break;
+        case 'v': scratch.add('\v'); break;
+        case '\'': case '"': case '\\': case '?': scratch.add(c); break;
+        default:
+          if (c == 'x' && end - pos >= 2 &&
+              CHARS.is(pos[0], HEX_DIGIT) && CHARS.is(pos[1], HEX_DIGIT)) {
+            scratch.add((parseDigit(pos[0]) << 4) | parseDigit(pos[1]));
+            pos += 2;
+          } else if (CHARS.is(c, OCT_DIGIT)) {
+            char result = c - '0';
+            if (at(OCT_DIGIT)) {
+              result = (result << 3) | (*pos++ - '0');
+              if (at(OCT_DIGIT)) {
+                result = (result << 3) | (*pos++ - '0');
+              }
+            }
+            scratch.add(result);
+          } else {
+            return false;
+          }
+      }
+      chunk = pos;
+    }
+
+    kj::ArrayPtr<const char> text = kj::arrayPtr(chunk, pos);
+    if (escaped) {
+      for (char c: text) scratch.add(c);
+      text = scratch.asPtr();
+    }
+    ++pos;  // closing quote
+    setText(addToken(start).initStringLiteral(text.size()), text);
+    return true;
+  }
+
+  bool listToken() {
+    // Like the parenthesized / bracketed list token: a comma-delimited list of token sequences.
+
+    const char* start = pos;
+    char close = *pos++ == '(' ? ')' : ']';
+    size_t tokenStart = tokens.size();
+    size_t itemStart = itemSizes.size();
+
+    for (;;) {
+      size_t before = tokens.size();
+      if (!tokenSequence()) return false;
+      itemSizes.add(tokens.size() - before);
+      if (pos == end || *pos != ',') break;
+      ++pos;
+    }
+    if (pos == end || *pos != close) return false;
+    ++pos;
+
+    auto items = itemSizes.asPtr().slice(itemStart, itemSizes.size());
+    if (items.size() == 1 && items[0] == 0) {
+      // Completely empty list.
+      items = nullptr;
+    }
+
+    auto orphan = orphanage.newOrphan<Token>();
+    auto builder = orphan.get();
+    builder.setStartByte(offset(start));
+    builder.setEndByte(offset(pos));
+    auto listBuilder = close == ')' ? builder.initParenthesizedList(items.size())
+                                    : builder.initBracketedList(items.size());
+    Orphan<Token>* token = tokens.begin() + tokenStart;
+    for (uint i = 0; i < items.size(); i++) {
+      auto itemBuilder = listBuilder.init(i, items[i]);
+      for (uint j = 0; j < items[i]; j++) {
+        itemBuilder.adoptWithCaveats(j, kj::mv(*token++));
+      }
+    }
+
+    tokens.resize(tokenStart);
+    itemSizes.resize(itemStart);
+    tokens.add(kj::mv(orphan));
+    return true;
+  }
+
+  bool statementSequence() {
+    skipCommentsAndWhitespace();
+    while (pos < end && *pos != '}') {
+      if (!statement()) return false;
+      skipCommentsAndWhitespace();
+    }
+    return true;
+  }
+
+  bool statement() {
+    const char* start = pos;
+    size_t tokenStart = tokens.size();
+    size_t commentStart = commentLines.size();
+
+    if (!tokenSequence() || pos == end) return false;
+
+    auto orphan = orphanage.newOrphan<Statement>();
+    auto builder = orphan.get();
+
+    if (*pos == ';') {
+      ++pos;
+      docComment();
+      builder.setLine();
+    } else if (*pos == '{') {
+      ++pos;
+      bool hasComment = docComment();
+      size_t statementStart = statements.size();
+      if (!statementSequence() || pos == end || *pos != '}') return false;
+      ++pos;
+      if (hasComment) {
+        // A late comment is still consumed, but ignored.
+        size_t count = commentLines.size();
+        docComment();
+        commentLines.resize(count);
+      } else {
+        docComment();
+      }
+
+      auto list = builder.initBlock(statements.size() - statementStart);
+      for (uint i = 0; i < list.size(); i++) {
+        list.adoptWithCaveats(i, kj::mv(statements[statementStart + i]));
+      }
+      statements.resize(statementStart);
+    } else {
+      return false;
+    }
+
+    if (commentLines.size() > commentStart) {
+      attachDocComment(builder, commentLines.asPtr().slice(commentStart, commentLines.size()));
+      commentLines.resize(commentStart);
+    }
+
+    auto tokensBuilder = builder.initTokens(tokens.size() - tokenStart);
+    for (uint i = 0; i < tokensBuilder.size(); i++) {
+      tokensBuilder.adoptWithCaveats(i, kj::mv(tokens[tokenStart + i]));
+    }
+    tokens.resize(tokenStart);
+
+    builder.setStartByte(offset(start));
+    builder.setEndByte(offset(pos));
+    statements.add(kj::mv(orphan));
+    return true;
+  }
+
+  bool docComment() {
+    // Like the docComment parser: comment lines preceded by at most one newline and with no
+    // intervening blank lines.  Pushes the lines onto `commentLines` and returns true if any.
+
+    const char* p = pos;
+    while (p < end && CHARS.is(*p, LINE_WHITESPACE)) ++p;
+    if (p < end && *p == '\n') {
+      ++p;
+    } else if (p < end && *p == '\r') {
+      ++p;
+      if (p < end && *p == '\n') ++p;
+    }
+
+    bool found = false;
+    while (p < end) {
+      const char* q = p;
+      while (q < end && CHARS.is(*q, LINE_WHITESPACE)) ++q;
+      if (q == end || *q != '#') break;
+      ++q;
+      if (q < end && *q == ' ') ++q;
+      const char* lineEnd = reinterpret_cast<const char*>(memchr(q, '\n', end - q));
+      if (lineEnd == nullptr) lineEnd = end;
+      commentLines.add(kj::arrayPtr(q, lineEnd));
+      p = lineEnd == end ? end : lineEnd + 1;
+      found = true;
+    }
+
+    if (found) pos = p;
+    return found;
+  }
+
+  static void attachDocComment(Statement::Builder statement,
+                               kj::ArrayPtr<const kj::ArrayPtr<const char>> lines) {
+    size_t size = 0;
+    for (auto& line: lines) {
+      size += line.size() + 1;  // include newline
+    }
+    Text::Builder builder = statement.initDocComment(size);
+    char* out = builder.begin();
+    for (auto& line: lines) {
+      memcpy(out, line.begin(), line.size());
+      out += line.size();
+      *out++ = '\n';
+    }
+  }
+};
+
+}  // namespace
+
 bool lex(kj::ArrayPtr<const char> input, LexedStatements::Builder result,
-         ErrorReporter& errorReporter) {
+         ErrorReporter& errorReporter, LexerImplementation implementation) {
+  if (implementation == LexerImplementation::TABLE_DRIVEN) {
+    TableDrivenLexer lexer(input, Orphanage::getForMessageContaining(result));
+    if (lexer.lex(result)) {
+      return true;
+    }
+    // Otherwise, fall back to the parsers to report the error.
+  }
+
   Lexer lexer(Orphanage::getForMessageContaining(result), errorReporter);
 
   auto parser = p::sequence(lexer.getParsers().statementSequence, p::endOfInput);
@@ -53,7 +485,15 @@ bool lex(kj::ArrayPtr<const char> input, LexedStatements::Builder result,
 }
 
 bool lex(kj::ArrayPtr<const char> input, LexedTokens::Builder result,
-         ErrorReporter& errorReporter) {
+         ErrorReporter& errorReporter, LexerImplementation implementation) {
+  if (implementation == LexerImplementation::TABLE_DRIVEN) {
+    TableDrivenLexer lexer(input, Orphanage::getForMessageContaining(result));
+    if (lexer.lex(result)) {
+      return true;
+    }
+    // Otherwise, fall back to the parsers to report the error.
+  }
+
   Lexer lexer(Orphanage::getForMessageContaining(result), errorReporter);
 
   auto parser = p::sequence(lexer.getParsers().tokenSequence, p::endOfInput);
@@ -177,9 +177,13 @@ static const ::capnp::_::RawSchema* const d_91cc55cd57de5419[] = {
 };
 static const uint16_t m_91cc55cd57de5419[] = {6, 8, 3, 0, 2, 4, 5, 7, 1};
 static const uint16_t i_91cc55cd57de5419[] = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+static const uint32_t p_91cc55cd57de5419[] = {3080192, 4};
+static const uint16_t h_91cc55cd57de5419[] = {0, 3, 6, 8, 1, 5, 2, 7, 4};
 const ::capnp::_::RawSchema s_91cc55cd57de5419 = {
   0x91cc55cd57de5419, b_91cc55cd57de5419.words, 165, d_91cc55cd57de5419, m_91cc55cd57de5419,
-  1, 9, i_91cc55cd57de5419, nullptr, nullptr
+  1, 9, i_91cc55cd57de5419, nullptr, nullptr,
+  { 3, 1, 7, false, 7, 0, true },
+  0, p_91cc55cd57de5419, h_91cc55cd57de5419
 };
 static const ::capnp::_::AlignedData<110> b_c6725e678d60fa37 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -299,9 +303,13 @@ static const ::capnp::_::RawSchema* const d_c6725e678d60fa37[] = {
 };
 static const uint16_t m_c6725e678d60fa37[] = {2, 3, 5, 1, 4, 0};
 static const uint16_t i_c6725e678d60fa37[] = {1, 2, 0, 3, 4, 5};
+static const uint32_t p_c6725e678d60fa37[] = {458752, 0};
+static const uint16_t h_c6725e678d60fa37[] = {1, 0, 3, 2, 4, 5};
 const ::capnp::_::RawSchema s_c6725e678d60fa37 = {
   0xc6725e678d60fa37, b_c6725e678d60fa37.words, 110, d_c6725e678d60fa37, m_c6725e678d60fa37,
-  2, 6, i_c6725e678d60fa37, nullptr, nullptr
+  2, 6, i_c6725e678d60fa37, nullptr, nullptr,
+  { 2, 3, 7, false, 2, 0, true },
+  0, p_c6725e678d60fa37, h_c6725e678d60fa37
 };
 static const ::capnp::_::AlignedData<35> b_9e69a92512b19d18 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -345,9 +353,13 @@ static const ::capnp::_::RawSchema* const d_9e69a92512b19d18[] = {
 };
 static const uint16_t m_9e69a92512b19d18[] = {0};
 static const uint16_t i_9e69a92512b19d18[] = {0};
+static const uint32_t p_9e69a92512b19d18[] = {0};
+static const uint16_t h_9e69a92512b19d18[] = {0};
 const ::capnp::_::RawSchema s_9e69a92512b19d18 = {
   0x9e69a92512b19d18, b_9e69a92512b19d18.words, 35, d_9e69a92512b19d18, m_9e69a92512b19d18,
-  1, 1, i_9e69a92512b19d18, nullptr, nullptr
+  1, 1, i_9e69a92512b19d18, nullptr, nullptr,
+  { 0, 1, 6, false, 0, 0, true },
+  0, p_9e69a92512b19d18, h_9e69a92512b19d18
 };
 static const ::capnp::_::AlignedData<37> b_a11f97b9d6c73dd4 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -393,9 +405,13 @@ static const ::capnp::_::RawSchema* const d_a11f97b9d6c73dd4[] = {
 };
 static const uint16_t m_a11f97b9d6c73dd4[] = {0};
 static const uint16_t i_a11f97b9d6c73dd4[] = {0};
+static const uint32_t p_a11f97b9d6c73dd4[] = {0};
+static const uint16_t h_a11f97b9d6c73dd4[] = {0};
 const ::capnp::_::RawSchema s_a11f97b9d6c73dd4 = {
   0xa11f97b9d6c73dd4, b_a11f97b9d6c73dd4.words, 37, d_a11f97b9d6c73dd4, m_a11f97b9d6c73dd4,
-  1, 1, i_a11f97b9d6c73dd4, nullptr, nullptr
+  1, 1, i_a11f97b9d6c73dd4, nullptr, nullptr,
+  { 0, 1, 6, false, 0, 0, true },
+  0, p_a11f97b9d6c73dd4, h_a11f97b9d6c73dd4
 };
 }  // namespace schemas
 namespace _ {  // private
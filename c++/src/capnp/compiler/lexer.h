@@ -32,9 +32,21 @@
 namespace capnp {
 namespace compiler {
 
+enum class LexerImplementation {
+  TABLE_DRIVEN,
+  // A hand-written, single-pass tokenizer dispatching on a character class table.  This is the
+  // default.  It accepts exactly the same input as PARSER_COMBINATORS and produces the same
+  // tokens; on input it can't lex it re-runs PARSER_COMBINATORS, so that errors are identical too.
+
+  PARSER_COMBINATORS
+  // The kj::parse-based parsers exposed by class Lexer, below.
+};
+
 bool lex(kj::ArrayPtr<const char> input, LexedStatements::Builder result,
-         ErrorReporter& errorReporter);
-bool lex(kj::ArrayPtr<const char> input, LexedTokens::Builder result, ErrorReporter& errorReporter);
+         ErrorReporter& errorReporter,
+         LexerImplementation implementation = LexerImplementation::TABLE_DRIVEN);
+bool lex(kj::ArrayPtr<const char> input, LexedTokens::Builder result, ErrorReporter& errorReporter,
+         LexerImplementation implementation = LexerImplementation::TABLE_DRIVEN);
 // Lex the given source code, placing the results in `result`.  Returns true if there
 // were no errors, false if there were.  Even when errors are present, the file may have partial
 // content which can be fed into later stages of parsing in order to find more errors.
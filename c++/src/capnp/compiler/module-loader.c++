@@ -24,18 +24,23 @@
 #include "module-loader.h"
 #include "lexer.h"
 #include "parser.h"
+#include "md5.h"
 #include <kj/vector.h>
 #include <kj/mutex.h>
 #include <kj/debug.h>
 #include <kj/io.h>
+#include <kj/thread.h>
 #include <capnp/message.h>
+#include <capnp/serialize.h>
 #include <map>
+#include <set>
 #include <unistd.h>
 #include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <stdio.h>
 
 namespace capnp {
 namespace compiler {
@@ -193,6 +198,38 @@ kj::String catPath(kj::StringPtr base, kj::StringPtr add) {
   return kj::str(base.slice(0, pos - base.begin()), add);
 }
 
+struct CachedParse {
+  // A parse tree read back from the cache directory.  See ModuleLoader::setCacheDir().
+
+  kj::Array<const char> bytes;
+  FlatArrayMessageReader message;
+
+  explicit CachedParse(kj::Array<const char> bytesParam)
+      : bytes(kj::mv(bytesParam)),
+        message(kj::arrayPtr(reinterpret_cast<const word*>(bytes.begin()),
+                             bytes.size() / sizeof(word))) {}
+
+  ParsedFile::Reader getParsed() { return message.getRoot<ParsedFile>(); }
+};
+
+constexpr uint PARSE_CACHE_FORMAT = 1;
+// Part of every parse cache key.  Bump this whenever a change to the lexer or parser changes the
+// ParsedFile produced for some input, so that entries written by older builds -- which may well
+// report the same version string -- are never read back.  Changes to grammar.capnp itself are
+// covered by hashGrammarSchema().
+
+void hashGrammarSchema(Md5& md5, const _::RawSchema* schema,
+                       std::set<const _::RawSchema*>& seen) {
+  // Feed the compiled-in schema nodes reachable from `schema` into `md5`, in a fixed order.
+
+  if (!seen.insert(schema).second) return;
+  md5.update(kj::arrayPtr(reinterpret_cast<const kj::byte*>(schema->encodedNode),
+                          schema->encodedSize * sizeof(word)));
+  for (uint i = 0; i < schema->dependencyCount; i++) {
+    hashGrammarSchema(md5, schema->dependencies[i], seen);
+  }
+}
+
 }  // namespace
 
 
@@ -204,14 +241,39 @@ public:
     searchPath.add(kj::heapString(kj::mv(path)));
   }
 
+  void setCacheDir(kj::String path, kj::StringPtr version) {
+    Md5 md5;
+    std::set<const _::RawSchema*> seen;
+    hashGrammarSchema(md5, &_::rawSchema<ParsedFile>(), seen);
+
+    cacheDir = kj::mv(path);
+    cacheVersion = kj::str(version, " parse-format-", PARSE_CACHE_FORMAT, " ", md5.finishAsHex());
+  }
+
   kj::Maybe<Module&> loadModule(kj::StringPtr localName, kj::StringPtr sourceName);
   kj::Maybe<Module&> loadModuleFromSearchPath(kj::StringPtr sourceName);
+  void parseAhead(kj::ArrayPtr<Module* const> modules, uint threadCount);
   GlobalErrorReporter& getErrorReporter() { return errorReporter; }
 
+  void setProfiler(Profiler& profiler) { this->profiler = profiler; }
+  kj::Maybe<Profiler&> getProfiler() { return profiler; }
+
+  kj::Maybe<kj::Own<CachedParse>> readCache(kj::ArrayPtr<const char> content) const;
+  void writeCache(kj::ArrayPtr<const char> content, ParsedFile::Reader parsed) const;
+  // Look up or store the parse tree of a file with the given content.  Both do nothing if no
+  // cache directory was set.  Both may be called from parseAhead()'s worker threads.
+
 private:
   GlobalErrorReporter& errorReporter;
   kj::Vector<kj::String> searchPath;
   std::map<kj::StringPtr, kj::Own<Module>> modules;
+
+  kj::Maybe<kj::String> cacheDir;
+  kj::String cacheVersion;
+  kj::Maybe<Profiler&> profiler;
+  mutable uint tempCounter = 0;
+
+  kj::String cachePath(kj::StringPtr dir, kj::ArrayPtr<const char> content) const;
 };
 
 class ModuleLoader::ModuleImpl final: public Module {
@@ -228,20 +290,79 @@ public:
   }
 
   Orphan<ParsedFile> loadContent(Orphanage orphanage) override {
+    KJ_IF_MAYBE(p, preparsed) {
+      kj::Own<Preparsed> ahead = kj::mv(*p);
+      preparsed = nullptr;
+
+      lineBreaks = nullptr;
+      lineBreaks = lineBreaksSpace.construct(ahead->content);
+
+      for (auto& error: ahead->errors) {
+        addError(error.startByte, error.endByte, error.message);
+      }
+      return orphanage.newOrphanCopy(ahead->getParsed());
+    }
+
     kj::Array<const char> content = mmapForRead(localName);
 
     lineBreaks = nullptr;  // In case loadContent() is called multiple times.
     lineBreaks = lineBreaksSpace.construct(content);
 
+    KJ_IF_MAYBE(cached, loader.readCache(content)) {
+      return orphanage.newOrphanCopy((*cached)->getParsed());
+    }
+
+    uint errorsBefore = errorCount;
+
     MallocMessageBuilder lexedBuilder;
     auto statements = lexedBuilder.initRoot<LexedStatements>();
-    lex(content, statements, *this);
+    {
+      Profiler::Scope scope(loader.getProfiler(), Profiler::Phase::LEX, sourceName);
+      lex(content, statements, *this);
+    }
 
     auto parsed = orphanage.newOrphan<ParsedFile>();
-    parseFile(statements.getStatements(), parsed.get(), *this);
+    {
+      Profiler::Scope scope(loader.getProfiler(), Profiler::Phase::PARSE, sourceName);
+      parseFile(statements.getStatements(), parsed.get(), *this);
+    }
+
+    if (errorCount == errorsBefore) {
+      // Don't cache files with errors; they need to be reported again next time.
+      loader.writeCache(content, parsed.getReader());
+    }
     return parsed;
   }
 
+  void parseAhead() {
+    // Lex and parse the file for a later loadContent().  This runs on a worker thread, so it must
+    // not touch anything but this object -- in particular, errors are buffered rather than sent
+    // to the loader's GlobalErrorReporter.
+
+    auto ahead = kj::heap<Preparsed>();
+    ahead->content = mmapForRead(localName);
+
+    ahead->cached = loader.readCache(ahead->content);
+    if (ahead->cached == nullptr) {
+      MallocMessageBuilder lexedBuilder;
+      auto statements = lexedBuilder.initRoot<LexedStatements>();
+      {
+        Profiler::Scope scope(loader.getProfiler(), Profiler::Phase::LEX, sourceName);
+        lex(ahead->content, statements, *ahead);
+      }
+      {
+        Profiler::Scope scope(loader.getProfiler(), Profiler::Phase::PARSE, sourceName);
+        parseFile(statements.getStatements(), ahead->parsed.initRoot<ParsedFile>(), *ahead);
+      }
+
+      if (ahead->errors.size() == 0) {
+        loader.writeCache(ahead->content, ahead->getParsed());
+      }
+    }
+
+    preparsed = kj::mv(ahead);
+  }
+
   kj::Maybe<Module&> importRelative(kj::StringPtr importPath) override {
     if (importPath.size() > 0 && importPath[0] == '/') {
       return loader.loadModuleFromSearchPath(importPath.slice(1));
@@ -254,6 +375,7 @@ public:
     auto& lines = *KJ_REQUIRE_NONNULL(lineBreaks,
         "Can't report errors until loadContent() is called.");
 
+    ++errorCount;
     loader.getErrorReporter().addError(
         localName, lines.toSourcePos(startByte), lines.toSourcePos(endByte), message);
   }
@@ -269,6 +391,42 @@ private:
 
   kj::SpaceFor<LineBreakTable> lineBreaksSpace;
   kj::Maybe<kj::Own<LineBreakTable>> lineBreaks;
+
+  uint errorCount = 0;
+  // Errors reported against this file so far.
+
+  struct Preparsed final: public ErrorReporter {
+    kj::Array<const char> content;
+    kj::Maybe<kj::Own<CachedParse>> cached;
+    MallocMessageBuilder parsed;
+    // The parse tree is in `cached` if it was found in the cache, otherwise in `parsed`.
+
+    ParsedFile::Reader getParsed() {
+      KJ_IF_MAYBE(c, cached) {
+        return (*c)->getParsed();
+      } else {
+        return parsed.getRoot<ParsedFile>().asReader();
+      }
+    }
+
+    struct Error {
+      uint32_t startByte;
+      uint32_t endByte;
+      kj::String message;
+    };
+    kj::Vector<Error> errors;
+
+    void addError(uint32_t startByte, uint32_t endByte, kj::StringPtr message) override {
+      errors.add(Error { startByte, endByte, kj::heapString(message) });
+    }
+
+    bool hadErrors() override {
+      return errors.size() > 0;
+    }
+  };
+
+  kj::Maybe<kj::Own<Preparsed>> preparsed;
+  // Set by parseAhead() and consumed by the next loadContent().
 };
 
 // =======================================================================================
@@ -309,6 +467,124 @@ kj::Maybe<Module&> ModuleLoader::Impl::loadModuleFromSearchPath(kj::StringPtr so
   return nullptr;
 }
 
+void ModuleLoader::Impl::parseAhead(kj::ArrayPtr<Module* const> modules, uint threadCount) {
+  // Each thread repeatedly claims the next unparsed module.  Files vary a lot in size, so this
+  // balances better than splitting the list up front.
+  // A module listed twice must only be parsed once, or two threads would race on it.
+  std::set<Module*> seen;
+  kj::Vector<ModuleImpl*> todo(modules.size());
+  for (Module* module: modules) {
+    if (seen.insert(module).second) {
+      todo.add(static_cast<ModuleImpl*>(module));
+    }
+  }
+
+  // Each worker catches its own exception.  If several fail, letting kj::Thread's destructor
+  // rethrow them would throw while already unwinding from the first, so only the first is
+  // rethrown, after every thread has been joined.
+  uint workerCount = kj::max(1u, kj::min(threadCount, todo.size()));
+  auto failures = kj::heapArray<kj::Maybe<kj::Exception>>(workerCount);
+
+  uint next = 0;
+  auto work = [&](uint worker) {
+    failures[worker] = kj::runCatchingExceptions([&]() {
+      for (;;) {
+        uint i = __atomic_fetch_add(&next, 1, __ATOMIC_RELAXED);
+        if (i >= todo.size()) break;
+        todo[i]->parseAhead();
+      }
+    });
+  };
+
+  {
+    kj::Vector<kj::Own<kj::Thread>> threads(workerCount);
+    for (uint i = 1; i < workerCount; i++) {
+      threads.add(kj::heap<kj::Thread>([&work, i]() { work(i); }));
+    }
+    work(0);
+    // Destroying `threads` joins them.
+  }
+
+  for (auto& failure: failures) {
+    KJ_IF_MAYBE(exception, failure) {
+      kj::throwFatalException(kj::mv(*exception));
+    }
+  }
+}
+
+kj::String ModuleLoader::Impl::cachePath(
+    kj::StringPtr dir, kj::ArrayPtr<const char> content) const {
+  // The parser's output depends only on the file's content and on the parser itself, which
+  // `cacheVersion` identifies.
+  Md5 md5;
+  md5.update(kj::StringPtr(cacheVersion));
+  md5.update(kj::arrayPtr("\0", 1));
+  md5.update(content);
+  return kj::str(dir, "/", md5.finishAsHex(), ".parsed");
+}
+
+kj::Maybe<kj::Own<CachedParse>> ModuleLoader::Impl::readCache(
+    kj::ArrayPtr<const char> content) const {
+  KJ_IF_MAYBE(dir, cacheDir) {
+    kj::String path = cachePath(*dir, content);
+    if (access(path.cStr(), F_OK) < 0) {
+      // Not cached yet.
+      return nullptr;
+    }
+
+    kj::Maybe<kj::Own<CachedParse>> result;
+    auto exception = kj::runCatchingExceptions([&]() {
+      auto bytes = mmapForRead(path);
+      KJ_REQUIRE(bytes.size() % sizeof(word) == 0, "Parse cache entry is truncated.", path) {
+        return;
+      }
+      auto entry = kj::heap<CachedParse>(kj::mv(bytes));
+
+      // Traverse the whole tree once so that a damaged entry is detected here, rather than
+      // halfway through compilation.
+      entry->getParsed().totalSize();
+
+      result = kj::mv(entry);
+    });
+    if (exception != nullptr) {
+      // A damaged entry is treated as a miss, and is replaced once the file has been parsed.
+      return nullptr;
+    }
+    return kj::mv(result);
+  } else {
+    return nullptr;
+  }
+}
+
+void ModuleLoader::Impl::writeCache(
+    kj::ArrayPtr<const char> content, ParsedFile::Reader parsed) const {
+  KJ_IF_MAYBE(dir, cacheDir) {
+    // Write to a temporary file and rename it into place, so that other compilers sharing the
+    // directory never see a partial entry.
+    kj::String path = cachePath(*dir, content);
+    kj::String tempPath = kj::str(path, ".", getpid(), ".",
+        __atomic_fetch_add(&tempCounter, 1, __ATOMIC_RELAXED));
+
+    auto exception = kj::runCatchingExceptions([&]() {
+      MallocMessageBuilder builder(parsed.totalSize().wordCount + 1);
+      builder.setRoot(parsed);
+
+      {
+        int fd;
+        KJ_SYSCALL(fd = open(tempPath.cStr(), O_WRONLY | O_CREAT | O_EXCL, 0666), tempPath);
+        kj::AutoCloseFd closer(fd);
+        writeMessageToFd(fd, builder);
+      }
+      KJ_SYSCALL(rename(tempPath.cStr(), path.cStr()), tempPath, path);
+    });
+    if (exception != nullptr) {
+      // The cache is only an optimization, so failing to write it (e.g. because the directory is
+      // read-only) is not an error.
+      unlink(tempPath.cStr());
+    }
+  }
+}
+
 // =======================================================================================
 
 ModuleLoader::ModuleLoader(GlobalErrorReporter& errorReporter)
@@ -321,5 +597,17 @@ kj::Maybe<Module&> ModuleLoader::loadModule(kj::StringPtr localName, kj::StringP
   return impl->loadModule(localName, sourceName);
 }
 
+void ModuleLoader::setCacheDir(kj::String path, kj::StringPtr version) {
+  impl->setCacheDir(kj::mv(path), version);
+}
+
+void ModuleLoader::setProfiler(Profiler& profiler) {
+  impl->setProfiler(profiler);
+}
+
+void ModuleLoader::parseAhead(kj::ArrayPtr<Module* const> modules, uint threadCount) {
+  impl->parseAhead(modules, threadCount);
+}
+
 }  // namespace compiler
 }  // namespace capnp
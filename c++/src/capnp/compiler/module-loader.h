@@ -45,11 +45,29 @@ public:
   void addImportPath(kj::String path);
   // Add a directory to the list of paths that is searched for imports that start with a '/'.
 
+  void setCacheDir(kj::String path, kj::StringPtr version);
+  // Keep parse trees in the directory `path`, keyed by the MD5 of each file's content, of
+  // `version` (which should identify the compiler build), and of the parse tree format, so that a
+  // changed parser never reads a stale entry.  A file whose content is unchanged since some
+  // earlier run is then read back from the cache instead of being lexed and parsed again.  Files
+  // with errors are never cached.  Entries are written atomically, so several compilers may share
+  // one directory.
+
+  void setProfiler(Profiler& profiler);
+  // Charge the time and allocations spent lexing and parsing each file to `profiler`.
+
   kj::Maybe<Module&> loadModule(kj::StringPtr localName, kj::StringPtr sourceName);
   // Tries to load the module with the given filename.  `localName` is the path to the file on
   // disk (as you'd pass to open(2)), and `sourceName` is the canonical name it should be given
   // in the schema (this is used e.g. to decide output file locations).  Often, these are the same.
 
+  void parseAhead(kj::ArrayPtr<Module* const> modules, uint threadCount);
+  // Lex and parse the given modules, which must have been returned by loadModule(), using
+  // `threadCount` threads (including the calling one).  Each module holds on to its parse tree
+  // until the next call to its loadContent(), which then only has to copy it.  Errors found while
+  // parsing are reported by loadContent(), in the same order as if it had done the parsing itself,
+  // so the output does not depend on thread scheduling.
+
 private:
   class Impl;
   kj::Own<Impl> impl;
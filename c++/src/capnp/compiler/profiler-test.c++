@@ -0,0 +1,98 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "profiler.h"
+#include <kj/array.h>
+#include <gtest/gtest.h>
+
+namespace capnp {
+namespace compiler {
+namespace {
+
+kj::Maybe<kj::String> findRow(kj::StringPtr summary, kj::StringPtr module, kj::StringPtr phase) {
+  // Returns the summary's row for `phase` of `module`.
+
+  bool inModule = false;
+  size_t start = 0;
+  for (size_t i = 0; i < summary.size(); i++) {
+    if (summary[i] == '\n') {
+      auto line = kj::heapString(summary.slice(start, i));
+      start = i + 1;
+
+      if (!line.startsWith(" ")) {
+        inModule = line == module;
+      } else if (inModule && line.startsWith(kj::str("  ", phase, " "))) {
+        return kj::mv(line);
+      }
+    }
+  }
+  return nullptr;
+}
+
+TEST(Profiler, NestedScopes) {
+  Profiler profiler;
+
+  {
+    Profiler::Scope outer(profiler, Profiler::Phase::TRANSLATE, "foo.capnp");
+    auto a = kj::heapArray<byte>(100);
+    {
+      // Allocations in a nested scope are only charged to the nested scope.
+      Profiler::Scope inner(profiler, Profiler::Phase::VALIDATE, "bar.capnp");
+      auto b = kj::heapArray<byte>(1000);
+      auto c = kj::heapArray<byte>(10);
+    }
+  }
+
+  {
+    // Scopes without a profiler do nothing.
+    Profiler::Scope scope(nullptr, Profiler::Phase::LEX, "baz.capnp");
+    auto a = kj::heapArray<byte>(10);
+  }
+
+  kj::String summary = profiler.summarize();
+
+  KJ_IF_MAYBE(row, findRow(summary, "foo.capnp", "translate")) {
+    EXPECT_TRUE(row->endsWith("             1             100")) << row->cStr();
+  } else {
+    ADD_FAILURE() << summary.cStr();
+  }
+
+  KJ_IF_MAYBE(row, findRow(summary, "bar.capnp", "validate")) {
+    EXPECT_TRUE(row->endsWith("             2            1010")) << row->cStr();
+  } else {
+    ADD_FAILURE() << summary.cStr();
+  }
+
+  KJ_IF_MAYBE(row, findRow(summary, "all modules", "total")) {
+    EXPECT_TRUE(row->endsWith("             3            1110")) << row->cStr();
+  } else {
+    ADD_FAILURE() << summary.cStr();
+  }
+
+  EXPECT_TRUE(findRow(summary, "foo.capnp", "validate") == nullptr);
+  EXPECT_TRUE(findRow(summary, "baz.capnp", "lex") == nullptr);
+}
+
+}  // namespace
+}  // namespace compiler
+}  // namespace capnp
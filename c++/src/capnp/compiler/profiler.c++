@@ -0,0 +1,181 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "profiler.h"
+#include <kj/debug.h>
+#include <string.h>
+#include <time.h>
+
+namespace capnp {
+namespace compiler {
+
+namespace {
+
+static __thread Profiler::Scope* currentScope = nullptr;
+// The innermost active Scope on this thread.
+
+uint64_t now() {
+  struct timespec ts;
+  KJ_SYSCALL(clock_gettime(CLOCK_MONOTONIC, &ts));
+  return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+kj::StringPtr phaseName(Profiler::Phase phase) {
+  switch (phase) {
+    case Profiler::Phase::LEX: return "lex";
+    case Profiler::Phase::PARSE: return "parse";
+    case Profiler::Phase::TRANSLATE: return "translate";
+    case Profiler::Phase::VALIDATE: return "validate";
+    case Profiler::Phase::GENERATE: return "generate";
+  }
+  KJ_UNREACHABLE;
+}
+
+kj::String formatMillis(uint64_t nanos) {
+  uint64_t micros = nanos / 1000;
+  uint fraction = micros % 1000;
+  return kj::str(micros / 1000, '.', fraction / 100, fraction / 10 % 10, fraction % 10);
+}
+
+kj::String spaces(size_t count) {
+  kj::String result = kj::heapString(count);
+  memset(result.begin(), ' ', count);
+  return result;
+}
+
+kj::String padLeft(kj::StringPtr text, size_t width) {
+  return kj::str(spaces(text.size() < width ? width - text.size() : 0), text);
+}
+
+kj::String padRight(kj::StringPtr text, size_t width) {
+  return kj::str(text, spaces(text.size() < width ? width - text.size() : 0));
+}
+
+}  // namespace
+
+Profiler::Profiler(): startNanos(now()) {
+  kj::enableAllocationCounting();
+}
+
+Profiler::Scope::Scope(kj::Maybe<Profiler&> profilerParam, Phase phase, kj::StringPtr module)
+    : profiler(nullptr), phase(phase), module(module), parent(nullptr) {
+  KJ_IF_MAYBE(p, profilerParam) {
+    profiler = p;
+    parent = currentScope;
+    currentScope = this;
+    startAllocations = kj::getAllocationCounts();
+    startNanos = now();
+  }
+}
+
+Profiler::Scope::~Scope() noexcept(false) {
+  if (profiler == nullptr) return;
+
+  uint64_t nanos = now() - startNanos;
+  kj::AllocationCounts allocations = kj::getAllocationCounts();
+  uint64_t allocationCount = allocations.count - startAllocations.count;
+  uint64_t allocationBytes = allocations.bytes - startAllocations.bytes;
+
+  Totals self;
+  self.nanos = nanos - childNanos;
+  self.allocations = allocationCount - childAllocations;
+  self.bytes = allocationBytes - childBytes;
+  profiler->add(module, phase, self);
+
+  currentScope = parent;
+  if (parent != nullptr) {
+    // Also hide our own bookkeeping in add() from the parent.
+    kj::AllocationCounts end = kj::getAllocationCounts();
+    parent->childNanos += now() - startNanos;
+    parent->childAllocations += end.count - startAllocations.count;
+    parent->childBytes += end.bytes - startAllocations.bytes;
+  }
+}
+
+void Profiler::add(kj::StringPtr module, Phase phase, const Totals& totals) {
+  auto lock = state.lockExclusive();
+
+  auto iter = lock->totals.find(std::make_pair(module, phase));
+  if (iter == lock->totals.end()) {
+    // Copy the name, since `module` might not outlive us.
+    kj::StringPtr name;
+    auto nameIter = lock->totals.lower_bound(std::make_pair(module, Phase::LEX));
+    if (nameIter != lock->totals.end() && nameIter->first.first == module) {
+      name = nameIter->first.first;
+    } else {
+      lock->moduleNames.add(kj::heapString(module));
+      name = lock->moduleNames.back();
+    }
+    iter = lock->totals.insert(std::make_pair(std::make_pair(name, phase), Totals())).first;
+  }
+
+  iter->second.nanos += totals.nanos;
+  iter->second.allocations += totals.allocations;
+  iter->second.bytes += totals.bytes;
+}
+
+kj::String Profiler::summarize() const {
+  auto lock = state.lockShared();
+
+  kj::Vector<kj::String> lines;
+  auto addLine = [&](kj::StringPtr name, const Totals& totals) {
+    lines.add(kj::str(
+        padRight(name, 40), padLeft(formatMillis(totals.nanos), 12),
+        padLeft(kj::str(totals.allocations), 14), padLeft(kj::str(totals.bytes), 16), '\n'));
+  };
+
+  lines.add(kj::str(padRight("module / phase", 40), padLeft("time (ms)", 12),
+                    padLeft("allocations", 14), padLeft("bytes", 16), '\n'));
+
+  Totals byPhase[static_cast<uint>(Phase::GENERATE) + 1];
+  Totals all;
+  kj::StringPtr lastModule;
+  bool first = true;
+  for (auto& entry: lock->totals) {
+    if (first || entry.first.first != lastModule) {
+      first = false;
+      lastModule = entry.first.first;
+      lines.add(kj::str(entry.first.first, '\n'));
+    }
+    addLine(kj::str("  ", phaseName(entry.first.second)), entry.second);
+
+    for (Totals* sum: {&byPhase[static_cast<uint>(entry.first.second)], &all}) {
+      sum->nanos += entry.second.nanos;
+      sum->allocations += entry.second.allocations;
+      sum->bytes += entry.second.bytes;
+    }
+  }
+
+  lines.add(kj::str("all modules\n"));
+  for (uint i = 0; i < kj::size(byPhase); i++) {
+    addLine(kj::str("  ", phaseName(static_cast<Phase>(i))), byPhase[i]);
+  }
+  addLine("  total", all);
+
+  lines.add(kj::str("elapsed: ", formatMillis(now() - startNanos), " ms\n"));
+
+  return kj::strArray(lines, "");
+}
+
+}  // namespace compiler
+}  // namespace capnp
@@ -0,0 +1,110 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef CAPNP_COMPILER_PROFILER_H_
+#define CAPNP_COMPILER_PROFILER_H_
+
+#include <capnp/common.h>
+#include <kj/memory.h>
+#include <kj/mutex.h>
+#include <kj/string.h>
+#include <kj/vector.h>
+#include <map>
+#include <inttypes.h>
+
+namespace capnp {
+namespace compiler {
+
+class Profiler {
+  // Accumulates the wall time and the allocations (as counted by kj::getAllocationCounts()) spent
+  // in each phase of compilation, per module, for `capnp compile --profile`.  Thread-safe, so that
+  // files parsed on several threads can be profiled.
+
+public:
+  enum class Phase {
+    LEX,
+    PARSE,
+    TRANSLATE,
+    // NodeTranslator:  building schema nodes from declarations, including struct layout.
+    VALIDATE,
+    // SchemaLoader:  validating and loading the translated nodes.
+    GENERATE
+    // Building the CodeGeneratorRequest and running the plugins.
+  };
+
+  Profiler();
+  // Also turns on kj::enableAllocationCounting(), so construct this before starting threads.
+
+  KJ_DISALLOW_COPY(Profiler);
+
+  class Scope {
+    // Charges the time and allocations from construction to destruction to `phase` of `module`,
+    // except for those of any Scope nested within it on the same thread, which are charged to
+    // the nested Scope instead.  Does nothing if `profiler` is null.
+
+  public:
+    Scope(kj::Maybe<Profiler&> profiler, Phase phase, kj::StringPtr module);
+    KJ_DISALLOW_COPY(Scope);
+    ~Scope() noexcept(false);
+
+  private:
+    Profiler* profiler;
+    Phase phase;
+    kj::StringPtr module;
+    Scope* parent;
+
+    uint64_t startNanos;
+    kj::AllocationCounts startAllocations;
+
+    uint64_t childNanos = 0;
+    uint64_t childAllocations = 0;
+    uint64_t childBytes = 0;
+  };
+
+  kj::String summarize() const;
+  // Formats a table of the totals for each phase of each module, then for each phase overall.
+
+private:
+  struct Totals {
+    uint64_t nanos = 0;
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+  };
+
+  struct State {
+    std::map<std::pair<kj::StringPtr, Phase>, Totals> totals;
+    // Keyed by module name, then phase.  The names point into `moduleNames`.
+
+    kj::Vector<kj::String> moduleNames;
+  };
+
+  kj::MutexGuarded<State> state;
+  uint64_t startNanos;
+
+  void add(kj::StringPtr module, Phase phase, const Totals& totals);
+};
+
+}  // namespace compiler
+}  // namespace capnp
+
+#endif  // CAPNP_COMPILER_PROFILER_H_
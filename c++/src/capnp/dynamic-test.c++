@@ -46,6 +46,7 @@
 
 #include "dynamic.h"
 #include "message.h"
+#include "schema-loader.h"
 #include <kj/debug.h>
 #include <gtest/gtest.h>
 #include "test-util.h"
@@ -147,6 +148,116 @@ TEST(DynamicApi, ListListsRead) {
   checkDynamicTestLists(toDynamic(root));
 }
 
+TEST(DynamicApi, Gather) {
+  MallocMessageBuilder builder;
+  auto list = builder.initRoot<TestAllTypes>().initStructList(5);
+  for (uint i = 0; i < list.size(); i++) {
+    list[i].setBoolField(i % 2 == 1);
+    list[i].setUInt8Field(200 + i);
+    list[i].setInt32Field(i * 100 - 3);
+    list[i].setFloat32Field(i * 0.5f);
+    list[i].setFloat64Field(i * -1.5);
+    list[i].setEnumField(static_cast<TestEnum>(i));
+  }
+  auto reader = toDynamic(builder.getRoot<TestAllTypes>().asReader().getStructList());
+
+  auto bools = kj::heapArray<bool>(5);
+  auto bytes = kj::heapArray<uint8_t>(5);
+  auto ints = kj::heapArray<int32_t>(5);
+  auto floats = kj::heapArray<float>(5);
+  auto doubles = kj::heapArray<double>(5);
+  auto enums = kj::heapArray<uint16_t>(5);
+  reader.gather<bool>("boolField", bools);
+  reader.gather<uint8_t>("uInt8Field", bytes);
+  reader.gather<int32_t>(Schema::from<TestAllTypes>().getFieldByName("int32Field"), ints);
+  reader.gather<float>("float32Field", floats);
+  reader.gather<double>("float64Field", doubles);
+  reader.gather<uint16_t>("enumField", enums);
+
+  for (uint i = 0; i < 5; i++) {
+    EXPECT_EQ(i % 2 == 1, bools[i]);
+    EXPECT_EQ(200 + i, bytes[i]);
+    EXPECT_EQ(i * 100 - 3, ints[i]);
+    EXPECT_EQ(i * 0.5f, floats[i]);
+    EXPECT_EQ(i * -1.5, doubles[i]);
+    EXPECT_EQ(i, enums[i]);
+  }
+
+  // Wrong type, wrong size, not a struct list.
+  EXPECT_ANY_THROW(reader.gather<int64_t>("int32Field", kj::heapArray<int64_t>(5)));
+  EXPECT_ANY_THROW(reader.gather<uint16_t>("int16Field", kj::heapArray<uint16_t>(5)));
+  EXPECT_ANY_THROW(reader.gather<int32_t>("int32Field", kj::heapArray<int32_t>(4)));
+  EXPECT_ANY_THROW(reader.gather<int32_t>("noSuchField", kj::heapArray<int32_t>(5)));
+  MallocMessageBuilder other;
+  auto ints2 = toDynamic(other.initRoot<TestAllTypes>().initInt32List(5).asReader());
+  EXPECT_ANY_THROW(ints2.gather<int32_t>("int32Field", kj::heapArray<int32_t>(5)));
+}
+
+TEST(DynamicApi, GatherDefaults) {
+  // Values are XORed with the field's default, like get().
+  MallocMessageBuilder builder;
+  auto list = builder.getOrphanage().newOrphan<List<TestDefaults>>(3);
+  list.get()[1].setInt32Field(5);
+  list.get()[1].setBoolField(false);
+  list.get()[2].setEnumField(TestEnum::GARPLY);
+  auto reader = toDynamic(list.getReader());
+
+  auto bools = kj::heapArray<bool>(3);
+  auto ints = kj::heapArray<int32_t>(3);
+  auto floats = kj::heapArray<float>(3);
+  auto enums = kj::heapArray<uint16_t>(3);
+  reader.gather<bool>("boolField", bools);
+  reader.gather<int32_t>("int32Field", ints);
+  reader.gather<float>("float32Field", floats);
+  reader.gather<uint16_t>("enumField", enums);
+
+  EXPECT_TRUE(bools[0]);
+  EXPECT_FALSE(bools[1]);
+  EXPECT_TRUE(bools[2]);
+  EXPECT_EQ(-12345678, ints[0]);
+  EXPECT_EQ(5, ints[1]);
+  EXPECT_EQ(-12345678, ints[2]);
+  for (float f: floats) {
+    EXPECT_EQ(1234.5, f);
+  }
+  EXPECT_EQ(static_cast<uint16_t>(TestEnum::CORGE), enums[0]);
+  EXPECT_EQ(static_cast<uint16_t>(TestEnum::GARPLY), enums[2]);
+
+  // Elements written with an older version of the struct read the new fields as defaults.
+  MallocMessageBuilder old;
+  auto oldList = old.initRoot<test::TestAnyPointer>().getAnyPointerField()
+      .initAs<List<test::TestOldVersion>>(4);
+  for (auto element: oldList) {
+    element.setOld1(123);
+  }
+  auto newList = toDynamic(old.getRoot<test::TestAnyPointer>().asReader().getAnyPointerField()
+      .getAs<List<test::TestNewVersion>>());
+  auto old1 = kj::heapArray<int64_t>(4);
+  auto new1 = kj::heapArray<int64_t>(4);
+  newList.gather<int64_t>("old1", old1);
+  newList.gather<int64_t>("new1", new1);
+  for (uint i = 0; i < 4; i++) {
+    EXPECT_EQ(123, old1[i]);
+    EXPECT_EQ(987, new1[i]);
+  }
+}
+
+TEST(DynamicApi, GatherUnionsAndGroups) {
+  MallocMessageBuilder builder;
+  auto groups = builder.getOrphanage().newOrphan<List<test::TestGroups>>(2);
+  EXPECT_ANY_THROW(toDynamic(groups.getReader()).gather<bool>("groups", kj::heapArray<bool>(2)));
+
+  auto unions = builder.getOrphanage().newOrphan<List<test::TestUnnamedUnion>>(2);
+  unions.get()[1].setMiddle(12);
+  auto reader = toDynamic(unions.getReader());
+  EXPECT_ANY_THROW(reader.gather<uint16_t>("foo", kj::heapArray<uint16_t>(2)));
+
+  auto middle = kj::heapArray<uint16_t>(2);
+  reader.gather<uint16_t>("middle", middle);
+  EXPECT_EQ(0, middle[0]);
+  EXPECT_EQ(12, middle[1]);
+}
+
 TEST(DynamicApi, AnyPointers) {
   MallocMessageBuilder builder;
   auto root = builder.getRoot<test::TestAnyPointer>();
@@ -254,6 +365,389 @@ TEST(DynamicApi, DynamicAnyPointers) {
     FAIL() << "Maybe was empty."; \
   }
 
+TEST(DynamicApi, Accessor) {
+  MallocMessageBuilder builder;
+  auto root = builder.initRoot<TestAllTypes>();
+  root.setInt32Field(-123);
+  root.setFloat64Field(1.5);
+  root.setTextField("foo");
+  root.setEnumField(TestEnum::GARPLY);
+  root.initInt16List(3).set(2, 456);
+  root.initStructField().setUInt64Field(789);
+  root.getStructField().initStructField().setTextField("nested");
+
+  auto schema = Schema::from<TestAllTypes>();
+  auto reader = toDynamic(root.asReader());
+
+  EXPECT_EQ(-123, DynamicStruct::Accessor(schema, "int32Field").get(reader).as<int32_t>());
+  EXPECT_EQ(1.5, DynamicStruct::Accessor(schema, "float64Field").get(reader).as<double>());
+  EXPECT_EQ("foo", DynamicStruct::Accessor(schema, "textField").get(reader).as<Text>());
+  EXPECT_EQ(TestEnum::GARPLY,
+            DynamicStruct::Accessor(schema, "enumField").get(reader).as<TestEnum>());
+  EXPECT_EQ(456, DynamicStruct::Accessor(schema, "int16List").get(reader)
+                     .as<List<int16_t>>()[2]);
+  EXPECT_EQ(789u, DynamicStruct::Accessor(schema, "structField.uInt64Field").get(reader)
+                      .as<uint64_t>());
+  EXPECT_EQ("nested", DynamicStruct::Accessor(schema, "structField.structField.textField")
+                          .get(reader).as<Text>());
+  EXPECT_EQ(789u, DynamicStruct::Accessor(schema, "structField").get(reader)
+                      .as<TestAllTypes>().getUInt64Field());
+
+  DynamicStruct::Accessor byField(schema.getFieldByName("int32Field"));
+  EXPECT_EQ(-123, byField.get(reader).as<int32_t>());
+
+  EXPECT_ANY_THROW(DynamicStruct::Accessor(schema, "noSuchField"));
+  EXPECT_ANY_THROW(DynamicStruct::Accessor(schema, "int32Field.foo"));
+  EXPECT_ANY_THROW(DynamicStruct::Accessor(schema, "structField.noSuchField"));
+  EXPECT_ANY_THROW(DynamicStruct::Accessor(Schema::from<TestDefaults>(), "int32Field")
+                       .get(reader));
+}
+
+TEST(DynamicApi, AccessorDefaults) {
+  AlignedData<1> nullRoot = {{0, 0, 0, 0, 0, 0, 0, 0}};
+  kj::ArrayPtr<const word> segments[1] = {kj::arrayPtr(nullRoot.words, 1)};
+  SegmentArrayMessageReader reader(kj::arrayPtr(segments, 1));
+  auto schema = Schema::from<TestDefaults>();
+  auto root = reader.getRoot<DynamicStruct>(schema);
+
+  EXPECT_EQ(-12345678, DynamicStruct::Accessor(schema, "int32Field").get(root).as<int32_t>());
+  EXPECT_EQ("foo", DynamicStruct::Accessor(schema, "textField").get(root).as<Text>());
+  EXPECT_EQ(-78901234, DynamicStruct::Accessor(schema, "structField.int32Field").get(root)
+                           .as<int32_t>());
+  EXPECT_EQ("really nested",
+            DynamicStruct::Accessor(schema, "structField.structField.structField.textField")
+                .get(root).as<Text>());
+}
+
+TEST(DynamicApi, AccessorGroupsAndUnions) {
+  MallocMessageBuilder builder;
+  auto root = builder.initRoot<test::TestGroups>();
+  root.getGroups().initBar().setCorge(123);
+
+  auto schema = Schema::from<test::TestGroups>();
+  auto reader = toDynamic(root.asReader());
+
+  DynamicStruct::Accessor barCorge(schema, "groups.bar.corge");
+  DynamicStruct::Accessor fooCorge(schema, "groups.foo.corge");
+  DynamicStruct::Accessor bar(schema, "groups.bar");
+
+  EXPECT_EQ(123, barCorge.get(reader).as<int32_t>());
+  EXPECT_EQ(123, bar.get(reader).as<test::TestGroups::Groups::Bar>().getCorge());
+  EXPECT_ANY_THROW(fooCorge.get(reader));
+
+  root.getGroups().initFoo().setCorge(456);
+  EXPECT_EQ(456, fooCorge.get(reader).as<int32_t>());
+  EXPECT_ANY_THROW(barCorge.get(reader));
+}
+
+TEST(DynamicApi, TranscoderSameType) {
+  DynamicStruct::Transcoder transcoder(Schema::from<TestAllTypes>(), Schema::from<TestAllTypes>());
+  EXPECT_TRUE(transcoder.isSectionCopy());
+
+  MallocMessageBuilder source;
+  initTestMessage(source.initRoot<TestAllTypes>());
+
+  MallocMessageBuilder target;
+  transcoder.copy(source.getRoot<DynamicStruct>(Schema::from<TestAllTypes>()).asReader(),
+                  target.initRoot<DynamicStruct>(Schema::from<TestAllTypes>()));
+  checkTestMessage(target.getRoot<TestAllTypes>());
+}
+
+StructSchema loadWithNewId(SchemaLoader& loader, StructSchema schema, uint64_t id,
+                           kj::Maybe<std::pair<uint, uint>> swapOffsets = nullptr) {
+  // Load a copy of `schema` under a different type ID (including fields which refer to the type
+  // itself), optionally swapping the slot offsets of two of its fields.
+
+  MallocMessageBuilder message;
+  message.setRoot(schema.getProto());
+  auto node = message.getRoot<schema::Node>();
+  node.setId(id);
+  for (auto field: node.getStruct().getFields()) {
+    if (field.isSlot() && field.getSlot().getType().isStruct()) {
+      auto type = field.getSlot().getType().getStruct();
+      if (type.getTypeId() == schema.getProto().getId()) type.setTypeId(id);
+    }
+  }
+  KJ_IF_MAYBE(swap, swapOffsets) {
+    auto fields = node.getStruct().getFields();
+    auto a = fields[swap->first].getSlot();
+    auto b = fields[swap->second].getSlot();
+    uint offset = a.getOffset();
+    a.setOffset(b.getOffset());
+    b.setOffset(offset);
+  }
+  return loader.load(node.asReader()).asStruct();
+}
+
+TEST(DynamicApi, TranscoderSameIdVersions) {
+  // A newer version of test::TestOldVersion, with the same ID.
+  SchemaLoader loader;
+  StructSchema newVersion = loadWithNewId(loader, Schema::from<test::TestNewVersion>(),
+                                          typeId<test::TestOldVersion>());
+  StructSchema oldVersion = Schema::from<test::TestOldVersion>();
+
+  MallocMessageBuilder source;
+  auto root = source.initRoot<test::TestOldVersion>();
+  root.setOld1(123);
+  root.setOld2("foo");
+  root.initOld3().setOld2("bar");
+
+  DynamicStruct::Transcoder upgrade(oldVersion, newVersion);
+  EXPECT_TRUE(upgrade.isSectionCopy());
+
+  MallocMessageBuilder target;
+  auto upgraded = target.initRoot<DynamicStruct>(newVersion);
+  upgrade.copy(toDynamic(root.asReader()), upgraded);
+  EXPECT_EQ(123, upgraded.get("old1").as<int64_t>());
+  EXPECT_EQ("foo", upgraded.get("old2").as<Text>());
+  EXPECT_EQ("bar", upgraded.get("old3").as<DynamicStruct>().get("old2").as<Text>());
+  EXPECT_EQ(987, upgraded.get("new1").as<int64_t>());
+  EXPECT_EQ("baz", upgraded.get("new2").as<Text>());
+
+  upgraded.set("new1", 456);
+  DynamicStruct::Transcoder downgrade(newVersion, oldVersion);
+  EXPECT_TRUE(downgrade.isSectionCopy());
+  MallocMessageBuilder target2;
+  auto downgraded = target2.initRoot<DynamicStruct>(oldVersion);
+  downgrade.copy(upgraded.asReader(), downgraded);
+  EXPECT_EQ(123, downgraded.as<test::TestOldVersion>().getOld1());
+  EXPECT_EQ("bar", downgraded.as<test::TestOldVersion>().getOld3().getOld2());
+}
+
+TEST(DynamicApi, TranscoderByName) {
+  // test::TestOldVersion and test::TestNewVersion have different IDs, so fields are matched by name, and
+  // old3 (whose type differs) gets a nested plan.
+  DynamicStruct::Transcoder transcoder(Schema::from<test::TestOldVersion>(),
+                                       Schema::from<test::TestNewVersion>());
+  EXPECT_FALSE(transcoder.isSectionCopy());
+
+  MallocMessageBuilder source;
+  auto root = source.initRoot<test::TestOldVersion>();
+  root.setOld1(123);
+  root.setOld2("foo");
+  root.initOld3().initOld3().setOld1(456);
+
+  MallocMessageBuilder target;
+  transcoder.copy(toDynamic(root.asReader()), target.initRoot<DynamicStruct>(
+      Schema::from<test::TestNewVersion>()));
+  auto result = target.getRoot<test::TestNewVersion>();
+  EXPECT_EQ(123, result.getOld1());
+  EXPECT_EQ("foo", result.getOld2());
+  EXPECT_TRUE(result.getOld3().hasOld3());
+  EXPECT_FALSE(result.getOld3().hasOld2());
+  EXPECT_EQ(456, result.getOld3().getOld3().getOld1());
+  EXPECT_FALSE(result.getOld3().getOld3().hasOld3());
+  EXPECT_EQ(987, result.getNew1());
+  EXPECT_EQ("baz", result.getNew2());
+}
+
+TEST(DynamicApi, TranscoderChangedDefaults) {
+  // TestDefaults has the same fields as TestAllTypes, but every default differs, so each data
+  // field must be converted rather than copied as raw bits.
+  DynamicStruct::Transcoder there(Schema::from<TestAllTypes>(), Schema::from<TestDefaults>());
+  DynamicStruct::Transcoder back(Schema::from<TestDefaults>(), Schema::from<TestAllTypes>());
+
+  MallocMessageBuilder source;
+  initTestMessage(source.initRoot<TestAllTypes>());
+
+  MallocMessageBuilder middle;
+  there.copy(toDynamic(source.getRoot<TestAllTypes>().asReader()),
+             middle.initRoot<DynamicStruct>(Schema::from<TestDefaults>()));
+  EXPECT_EQ(-12345678, middle.getRoot<TestDefaults>().getInt32Field());
+  EXPECT_EQ(TestEnum::CORGE, middle.getRoot<TestDefaults>().getEnumField());
+  EXPECT_EQ("foo", middle.getRoot<TestDefaults>().getTextField());
+
+  MallocMessageBuilder target;
+  back.copy(toDynamic(middle.getRoot<TestDefaults>().asReader()),
+            target.initRoot<DynamicStruct>(Schema::from<TestAllTypes>()));
+  checkTestMessage(target.getRoot<TestAllTypes>());
+}
+
+TEST(DynamicApi, TranscoderMovedFieldsAndUnions) {
+  // Swap `before` and `after` (both Text) so the layouts no longer match.
+  SchemaLoader loader;
+  StructSchema moved = loadWithNewId(loader, Schema::from<test::TestUnnamedUnion>(), 0xdeadbeef,
+                                     std::make_pair(0u, 4u));
+  DynamicStruct::Transcoder transcoder(Schema::from<test::TestUnnamedUnion>(), moved);
+  EXPECT_FALSE(transcoder.isSectionCopy());
+
+  MallocMessageBuilder source;
+  auto root = source.initRoot<test::TestUnnamedUnion>();
+  root.setBefore("foo");
+  root.setBar(321);
+  root.setMiddle(1234);
+  root.setAfter("bar");
+
+  MallocMessageBuilder target;
+  auto result = target.initRoot<DynamicStruct>(moved);
+  transcoder.copy(toDynamic(root.asReader()), result);
+  EXPECT_EQ("foo", result.get("before").as<Text>());
+  EXPECT_EQ("bar", result.get("after").as<Text>());
+  EXPECT_EQ(1234, result.get("middle").as<uint16_t>());
+  EXPECT_EQ("bar", KJ_ASSERT_NONNULL(result.which()).getProto().getName());
+  EXPECT_EQ(321, result.get("bar").as<uint32_t>());
+
+  // Groups in a union.  The group nodes keep their IDs, but must be loaded too.
+  StructSchema groups = loadWithNewId(loader, Schema::from<test::TestGroups>(), 0xfeedface);
+  loader.load(Schema::from<test::TestGroups::Groups>().getProto());
+  loader.load(Schema::from<test::TestGroups::Groups::Foo>().getProto());
+  loader.load(Schema::from<test::TestGroups::Groups::Bar>().getProto());
+  loader.load(Schema::from<test::TestGroups::Groups::Baz>().getProto());
+  DynamicStruct::Transcoder groupTranscoder(Schema::from<test::TestGroups>(), groups);
+  EXPECT_FALSE(groupTranscoder.isSectionCopy());
+
+  MallocMessageBuilder groupSource;
+  auto bar = groupSource.initRoot<test::TestGroups>().getGroups().initBar();
+  bar.setCorge(12);
+  bar.setGrault("qux");
+  bar.setGarply(34);
+
+  MallocMessageBuilder groupTarget;
+  auto groupResult = groupTarget.initRoot<DynamicStruct>(groups);
+  groupTranscoder.copy(toDynamic(groupSource.getRoot<test::TestGroups>().asReader()),
+                       groupResult);
+  auto resultGroups = groupResult.get("groups").as<DynamicStruct>();
+  EXPECT_EQ("bar", KJ_ASSERT_NONNULL(resultGroups.which()).getProto().getName());
+  auto resultBar = resultGroups.get("bar").as<DynamicStruct>();
+  EXPECT_EQ(12, resultBar.get("corge").as<int32_t>());
+  EXPECT_EQ("qux", resultBar.get("grault").as<Text>());
+  EXPECT_EQ(34, resultBar.get("garply").as<int64_t>());
+}
+
+TEST(DynamicApi, TranscoderIncompatible) {
+  // A test::TestOldVersion whose old2 changed from Text to Int64.
+  MallocMessageBuilder message;
+  message.setRoot(Schema::from<test::TestOldVersion>().getProto());
+  auto node = message.getRoot<schema::Node>();
+  node.setId(0xabcdef);
+  node.getStruct().getFields()[1].getSlot().initType().setInt64();
+  node.getStruct().getFields()[1].getSlot().initDefaultValue().setInt64(0);
+
+  SchemaLoader loader;
+  StructSchema retyped = loader.load(node.asReader()).asStruct();
+  EXPECT_ANY_THROW(DynamicStruct::Transcoder(Schema::from<test::TestOldVersion>(), retyped));
+}
+
+TEST(DynamicApi, Projection) {
+  MallocMessageBuilder source;
+  initTestMessage(source.initRoot<TestAllTypes>());
+  auto reader = toDynamic(source.getRoot<TestAllTypes>().asReader());
+
+  DynamicStruct::Projection projection(Schema::from<TestAllTypes>(),
+      {"int32Field", "int64Field", "textField", "structField.uInt64Field"});
+
+  MallocMessageBuilder target;
+  projection.copy(reader, target);
+  auto result = target.getRoot<TestAllTypes>().asReader();
+
+  EXPECT_EQ(-12345678, result.getInt32Field());
+  EXPECT_EQ(-123456789012345ll, result.getInt64Field());
+  EXPECT_EQ("foo", result.getTextField());
+  EXPECT_EQ(345678901234567890ull, result.getStructField().getUInt64Field());
+
+  // Everything else is left at its default.
+  EXPECT_FALSE(result.getBoolField());
+  EXPECT_EQ(0, result.getInt16Field());
+  EXPECT_FALSE(result.hasDataField());
+  EXPECT_FALSE(result.hasStructList());
+  EXPECT_EQ(0, result.getStructField().getInt32Field());
+  EXPECT_FALSE(result.getStructField().hasTextField());
+
+  // The projection only contains what was selected.
+  EXPECT_LT(target.getSegmentsForOutput()[0].size(),
+            source.getSegmentsForOutput()[0].size() / 4);
+}
+
+TEST(DynamicApi, ProjectionWholeFields) {
+  MallocMessageBuilder source;
+  initTestMessage(source.initRoot<TestAllTypes>());
+  auto reader = source.getRoot<TestAllTypes>().asReader();
+
+  // Selecting a struct whole copies all of it, regardless of sub-paths also being listed.
+  DynamicStruct::Projection projection(Schema::from<TestAllTypes>(),
+      {"structField.int32Field", "structField", "boolList"});
+
+  MallocMessageBuilder target;
+  auto root = target.initRoot<TestAllTypes>();
+  projection.copy(toDynamic(reader), toDynamic(root));
+
+  EXPECT_EQ(-78901234, root.getStructField().getInt32Field());
+  EXPECT_EQ("baz", root.getStructField().getTextField());
+  EXPECT_EQ(5u, root.getStructField().getBoolList().size());
+  EXPECT_FALSE(root.hasTextField());
+  EXPECT_EQ(4u, root.getBoolList().size());
+  EXPECT_FALSE(root.hasInt32List());
+
+  // A null struct along a path is left null.
+  MallocMessageBuilder empty;
+  auto emptyRoot = empty.initRoot<TestAllTypes>();
+  MallocMessageBuilder target2;
+  auto root2 = target2.initRoot<TestAllTypes>();
+  DynamicStruct::Projection(Schema::from<TestAllTypes>(), {"structField.int32Field"})
+      .copy(toDynamic(emptyRoot.asReader()), toDynamic(root2));
+  EXPECT_FALSE(root2.hasStructField());
+
+  // Paths must resolve, and the types must match.
+  EXPECT_ANY_THROW(DynamicStruct::Projection(Schema::from<TestAllTypes>(), {"noSuchField"}));
+  EXPECT_ANY_THROW(DynamicStruct::Projection(Schema::from<TestAllTypes>(), {"int32Field.foo"}));
+  EXPECT_ANY_THROW(projection.copy(toDynamic(emptyRoot.asReader()),
+                                   target2.initRoot<DynamicStruct>(Schema::from<TestDefaults>())));
+}
+
+TEST(DynamicApi, ProjectionGroupsAndUnions) {
+  DynamicStruct::Projection projection(Schema::from<test::TestGroups>(),
+      {"groups.bar.corge", "groups.bar.grault", "groups.baz"});
+
+  {
+    // The active union member is selected.
+    MallocMessageBuilder source;
+    auto bar = source.initRoot<test::TestGroups>().getGroups().initBar();
+    bar.setCorge(12);
+    bar.setGrault("qux");
+    bar.setGarply(34);
+
+    MallocMessageBuilder target;
+    projection.copy(toDynamic(source.getRoot<test::TestGroups>().asReader()), target);
+    auto result = target.getRoot<test::TestGroups>().getGroups();
+    ASSERT_EQ(test::TestGroups::Groups::BAR, result.which());
+    EXPECT_EQ(12, result.getBar().getCorge());
+    EXPECT_EQ("qux", result.getBar().getGrault());
+    EXPECT_EQ(0, result.getBar().getGarply());
+  }
+
+  {
+    // A whole group.
+    MallocMessageBuilder source;
+    auto baz = source.initRoot<test::TestGroups>().getGroups().initBaz();
+    baz.setCorge(56);
+    baz.setGrault("abc");
+    baz.setGarply("def");
+
+    MallocMessageBuilder target;
+    projection.copy(toDynamic(source.getRoot<test::TestGroups>().asReader()), target);
+    auto result = target.getRoot<test::TestGroups>().getGroups();
+    ASSERT_EQ(test::TestGroups::Groups::BAZ, result.which());
+    EXPECT_EQ(56, result.getBaz().getCorge());
+    EXPECT_EQ("abc", result.getBaz().getGrault());
+    EXPECT_EQ("def", result.getBaz().getGarply());
+  }
+
+  {
+    // A member that wasn't selected is active:  nothing is copied.
+    MallocMessageBuilder source;
+    auto foo = source.initRoot<test::TestGroups>().getGroups().initFoo();
+    foo.setCorge(78);
+    foo.setGarply("xyz");
+
+    MallocMessageBuilder target;
+    projection.copy(toDynamic(source.getRoot<test::TestGroups>().asReader()), target);
+    auto result = target.getRoot<test::TestGroups>().getGroups();
+    ASSERT_EQ(test::TestGroups::Groups::FOO, result.which());
+    EXPECT_EQ(0, result.getFoo().getCorge());
+    EXPECT_FALSE(result.getFoo().hasGarply());
+  }
+}
+
 TEST(DynamicApi, UnionsRead) {
   MallocMessageBuilder builder;
   auto root = builder.initRoot<TestUnion>();
@@ -23,6 +23,9 @@
 
 #include "dynamic.h"
 #include <kj/debug.h>
+#include <kj/vector.h>
+#include <algorithm>
+#include <map>
 
 namespace capnp {
 
@@ -98,11 +101,11 @@ _::FieldSize elementSizeFor(schema::Type::Which elementType) {
 }
 
 inline _::StructSize structSizeFromSchema(StructSchema schema) {
-  auto node = schema.getProto().getStruct();
+  auto layout = schema.getLayout();
   return _::StructSize(
-      node.getDataWordCount() * WORDS,
-      node.getPointerCount() * POINTERS,
-      static_cast<_::FieldSize>(node.getPreferredListEncoding()));
+      layout.dataWordCount * WORDS,
+      layout.pointerCount * POINTERS,
+      static_cast<_::FieldSize>(layout.preferredListEncoding));
 }
 
 }  // namespace
@@ -133,7 +136,7 @@ bool DynamicStruct::Reader::isSetInUnion(StructSchema::Field field) const {
   auto proto = field.getProto();
   if (hasDiscriminantValue(proto)) {
     uint16_t discrim = reader.getDataField<uint16_t>(
-        schema.getProto().getStruct().getDiscriminantOffset() * ELEMENTS);
+        schema.getLayout().discriminantOffset * ELEMENTS);
     return discrim == proto.getDiscriminantValue();
   } else {
     return true;
@@ -150,7 +153,7 @@ bool DynamicStruct::Builder::isSetInUnion(StructSchema::Field field) {
   auto proto = field.getProto();
   if (hasDiscriminantValue(proto)) {
     uint16_t discrim = builder.getDataField<uint16_t>(
-        schema.getProto().getStruct().getDiscriminantOffset() * ELEMENTS);
+        schema.getLayout().discriminantOffset * ELEMENTS);
     return discrim == proto.getDiscriminantValue();
   } else {
     return true;
@@ -168,7 +171,7 @@ void DynamicStruct::Builder::setInUnion(StructSchema::Field field) {
   auto proto = field.getProto();
   if (hasDiscriminantValue(proto)) {
     builder.setDataField<uint16_t>(
-        schema.getProto().getStruct().getDiscriminantOffset() * ELEMENTS,
+        schema.getLayout().discriminantOffset * ELEMENTS,
         proto.getDiscriminantValue());
   }
 }
@@ -409,7 +412,7 @@ bool DynamicStruct::Reader::has(StructSchema::Field field) const {
   auto proto = field.getProto();
   if (hasDiscriminantValue(proto)) {
     uint16_t discrim = reader.getDataField<uint16_t>(
-        schema.getProto().getStruct().getDiscriminantOffset() * ELEMENTS);
+        schema.getLayout().discriminantOffset * ELEMENTS);
     if (discrim != proto.getDiscriminantValue()) {
       // Field is not active in the union.
       return false;
@@ -459,22 +462,22 @@ bool DynamicStruct::Reader::has(StructSchema::Field field) const {
 }
 
 kj::Maybe<StructSchema::Field> DynamicStruct::Reader::which() const {
-  auto structProto = schema.getProto().getStruct();
-  if (structProto.getDiscriminantCount() == 0) {
+  auto layout = schema.getLayout();
+  if (layout.discriminantCount == 0) {
     return nullptr;
   }
 
-  uint16_t discrim = reader.getDataField<uint16_t>(structProto.getDiscriminantOffset() * ELEMENTS);
+  uint16_t discrim = reader.getDataField<uint16_t>(layout.discriminantOffset * ELEMENTS);
   return schema.getFieldByDiscriminant(discrim);
 }
 
 kj::Maybe<StructSchema::Field> DynamicStruct::Builder::which() {
-  auto structProto = schema.getProto().getStruct();
-  if (structProto.getDiscriminantCount() == 0) {
+  auto layout = schema.getLayout();
+  if (layout.discriminantCount == 0) {
     return nullptr;
   }
 
-  uint16_t discrim = builder.getDataField<uint16_t>(structProto.getDiscriminantOffset() * ELEMENTS);
+  uint16_t discrim = builder.getDataField<uint16_t>(layout.discriminantOffset * ELEMENTS);
   return schema.getFieldByDiscriminant(discrim);
 }
 
@@ -962,6 +965,924 @@ void DynamicStruct::Builder::clear(kj::StringPtr name) {
   clear(schema.getFieldByName(name));
 }
 
+// -------------------------------------------------------------------
+
+namespace {
+
+kj::Maybe<StructSchema> nestedStructSchema(StructSchema::Field field) {
+  // If `field` is a group or a struct-typed slot, returns the schema of the struct it contains.
+
+  auto proto = field.getProto();
+  switch (proto.which()) {
+    case schema::Field::SLOT: {
+      auto type = proto.getSlot().getType();
+      if (type.isStruct()) {
+        return field.getContainingStruct().getDependency(
+            type.getStruct().getTypeId()).asStruct();
+      } else {
+        return nullptr;
+      }
+    }
+    case schema::Field::GROUP:
+      return field.getContainingStruct().getDependency(proto.getGroup().getTypeId()).asStruct();
+  }
+  return nullptr;
+}
+
+kj::Array<StructSchema::Field> resolvePath(StructSchema schema, kj::StringPtr path) {
+  // Look up each element of a dot-separated path of field names.  Every field but the last must
+  // be of struct or group type.
+
+  kj::Vector<StructSchema::Field> fields;
+  StructSchema current = schema;
+  for (;;) {
+    kj::String name;
+    kj::StringPtr rest;
+    bool more = false;
+    KJ_IF_MAYBE(dot, path.findFirst('.')) {
+      name = kj::heapString(path.begin(), *dot);
+      rest = path.slice(*dot + 1);
+      more = true;
+    } else {
+      name = kj::heapString(path);
+    }
+
+    auto field = current.getFieldByName(name);
+    fields.add(field);
+    if (!more) break;
+
+    KJ_IF_MAYBE(nested, nestedStructSchema(field)) {
+      current = *nested;
+    } else {
+      KJ_FAIL_REQUIRE("Only the last element of a field path may have a non-struct type.",
+                      name, current.getProto().getDisplayName()) {
+        // Drop the rest of the path; the accessor will just read this field.
+        return fields.releaseAsArray();
+      }
+    }
+    path = rest;
+  }
+
+  return fields.releaseAsArray();
+}
+
+}  // namespace
+
+DynamicStruct::Accessor::Accessor(StructSchema schema, kj::StringPtr path): schema(schema) {
+  compile(resolvePath(schema, path));
+}
+
+DynamicStruct::Accessor::Accessor(StructSchema::Field field)
+    : schema(field.getContainingStruct()) {
+  compile(kj::arrayPtr(&field, 1));
+}
+
+void DynamicStruct::Accessor::compile(kj::ArrayPtr<const StructSchema::Field> fields) {
+  auto builder = kj::heapArrayBuilder<Step>(fields.size());
+
+  for (auto field: fields) {
+    auto proto = field.getProto();
+    auto containingStruct = field.getContainingStruct();
+
+    Step step;
+    step.inUnion = hasDiscriminantValue(proto);
+    step.discriminantValue = proto.getDiscriminantValue();
+    step.discriminantOffset = containingStruct.getLayout().discriminantOffset;
+    step.offset = 0;
+    step.defaultBits = 0;
+    step.defaultPointer = nullptr;
+    step.defaultSize = 0;
+    step.field = field;
+
+    switch (proto.which()) {
+      case schema::Field::SLOT: {
+        auto slot = proto.getSlot();
+        auto type = slot.getType();
+        auto dval = slot.getDefaultValue();
+        step.offset = slot.getOffset();
+
+        switch (type.which()) {
+          case schema::Type::VOID:
+            step.kind = Kind::VOID;
+            break;
+
+#define HANDLE_TYPE(discrim, titleCase, type) \
+          case schema::Type::discrim: \
+            step.kind = Kind::discrim; \
+            step.defaultBits = bitCast<_::Mask<type>>(dval.get##titleCase()); \
+            break;
+
+          HANDLE_TYPE(BOOL, Bool, bool)
+          HANDLE_TYPE(INT8, Int8, int8_t)
+          HANDLE_TYPE(INT16, Int16, int16_t)
+          HANDLE_TYPE(INT32, Int32, int32_t)
+          HANDLE_TYPE(INT64, Int64, int64_t)
+          HANDLE_TYPE(UINT8, Uint8, uint8_t)
+          HANDLE_TYPE(UINT16, Uint16, uint16_t)
+          HANDLE_TYPE(UINT32, Uint32, uint32_t)
+          HANDLE_TYPE(UINT64, Uint64, uint64_t)
+          HANDLE_TYPE(FLOAT32, Float32, float)
+          HANDLE_TYPE(FLOAT64, Float64, double)
+
+#undef HANDLE_TYPE
+
+          case schema::Type::ENUM:
+            step.kind = Kind::ENUM;
+            step.defaultBits = dval.getEnum();
+            leafEnum = containingStruct.getDependency(type.getEnum().getTypeId()).asEnum();
+            break;
+
+          case schema::Type::TEXT: {
+            step.kind = Kind::TEXT;
+            Text::Reader typedDval = dval.getText();
+            step.defaultPointer = typedDval.begin();
+            step.defaultSize = typedDval.size();
+            break;
+          }
+
+          case schema::Type::DATA: {
+            step.kind = Kind::DATA;
+            Data::Reader typedDval = dval.getData();
+            step.defaultPointer = typedDval.begin();
+            step.defaultSize = typedDval.size();
+            break;
+          }
+
+          case schema::Type::LIST:
+            step.kind = Kind::LIST;
+            step.defaultPointer = dval.getList().getAs<_::UncheckedMessage>();
+            leafList = ListSchema::of(type.getList().getElementType(), containingStruct);
+            break;
+
+          case schema::Type::STRUCT:
+            step.kind = Kind::STRUCT;
+            step.defaultPointer = dval.getStruct().getAs<_::UncheckedMessage>();
+            leafStruct = containingStruct.getDependency(type.getStruct().getTypeId()).asStruct();
+            break;
+
+          case schema::Type::ANY_POINTER:
+            step.kind = Kind::ANY_POINTER;
+            break;
+
+          case schema::Type::INTERFACE:
+            step.kind = Kind::INTERFACE;
+            leafInterface = containingStruct.getDependency(
+                type.getInterface().getTypeId()).asInterface();
+            break;
+        }
+        break;
+      }
+
+      case schema::Field::GROUP:
+        step.kind = Kind::GROUP;
+        leafStruct = containingStruct.getDependency(proto.getGroup().getTypeId()).asStruct();
+        break;
+    }
+
+    builder.add(step);
+  }
+
+  steps = builder.finish();
+}
+
+inline void DynamicStruct::Accessor::checkUnion(
+    const Step& step, const _::StructReader& reader) const {
+  if (step.inUnion) {
+    KJ_REQUIRE(reader.getDataField<uint16_t>(step.discriminantOffset * ELEMENTS) ==
+                   step.discriminantValue,
+        "Tried to get() a union member which is not currently initialized.",
+        step.field.getProto().getName(),
+        step.field.getContainingStruct().getProto().getDisplayName());
+  }
+}
+
+DynamicValue::Reader DynamicStruct::Accessor::get(DynamicStruct::Reader value) const {
+  KJ_REQUIRE(value.schema == schema, "Accessor was compiled for a different struct type.",
+             schema.getProto().getDisplayName(), value.schema.getProto().getDisplayName());
+  KJ_REQUIRE(steps.size() > 0, "Accessor is not initialized.") {
+    return nullptr;
+  }
+
+  _::StructReader reader = value.reader;
+  const Step* leaf = steps.end() - 1;
+  for (const Step* step = steps.begin(); step != leaf; ++step) {
+    checkUnion(*step, reader);
+    if (step->kind == Kind::STRUCT) {
+      reader = reader.getPointerField(step->offset * POINTERS)
+                     .getStruct(reinterpret_cast<const word*>(step->defaultPointer));
+    }
+  }
+
+  checkUnion(*leaf, reader);
+
+  switch (leaf->kind) {
+    case Kind::VOID:
+      return reader.getDataField<Void>(leaf->offset * ELEMENTS);
+
+#define HANDLE_TYPE(discrim, type) \
+    case Kind::discrim: \
+      return reader.getDataField<type>( \
+          leaf->offset * ELEMENTS, static_cast<_::Mask<type>>(leaf->defaultBits));
+
+    HANDLE_TYPE(BOOL, bool)
+    HANDLE_TYPE(INT8, int8_t)
+    HANDLE_TYPE(INT16, int16_t)
+    HANDLE_TYPE(INT32, int32_t)
+    HANDLE_TYPE(INT64, int64_t)
+    HANDLE_TYPE(UINT8, uint8_t)
+    HANDLE_TYPE(UINT16, uint16_t)
+    HANDLE_TYPE(UINT32, uint32_t)
+    HANDLE_TYPE(UINT64, uint64_t)
+    HANDLE_TYPE(FLOAT32, float)
+    HANDLE_TYPE(FLOAT64, double)
+
+#undef HANDLE_TYPE
+
+    case Kind::ENUM:
+      return DynamicEnum(leafEnum, reader.getDataField<uint16_t>(
+          leaf->offset * ELEMENTS, static_cast<uint16_t>(leaf->defaultBits)));
+
+    case Kind::TEXT:
+      return reader.getPointerField(leaf->offset * POINTERS)
+                   .getBlob<Text>(leaf->defaultPointer, leaf->defaultSize * BYTES);
+
+    case Kind::DATA:
+      return reader.getPointerField(leaf->offset * POINTERS)
+                   .getBlob<Data>(leaf->defaultPointer, leaf->defaultSize * BYTES);
+
+    case Kind::LIST:
+      return DynamicList::Reader(leafList,
+          reader.getPointerField(leaf->offset * POINTERS)
+                .getList(elementSizeFor(leafList.whichElementType()),
+                         reinterpret_cast<const word*>(leaf->defaultPointer)));
+
+    case Kind::STRUCT:
+      return DynamicStruct::Reader(leafStruct,
+          reader.getPointerField(leaf->offset * POINTERS)
+                .getStruct(reinterpret_cast<const word*>(leaf->defaultPointer)));
+
+    case Kind::ANY_POINTER:
+      return AnyPointer::Reader(reader.getPointerField(leaf->offset * POINTERS));
+
+    case Kind::INTERFACE:
+      return DynamicCapability::Client(leafInterface,
+          reader.getPointerField(leaf->offset * POINTERS).getCapability());
+
+    case Kind::GROUP:
+      return DynamicStruct::Reader(leafStruct, reader);
+  }
+
+  KJ_UNREACHABLE;
+}
+
+// -------------------------------------------------------------------
+
+namespace {
+
+bool isPointerType(schema::Type::Which type) {
+  switch (type) {
+    case schema::Type::TEXT:
+    case schema::Type::DATA:
+    case schema::Type::LIST:
+    case schema::Type::STRUCT:
+    case schema::Type::INTERFACE:
+    case schema::Type::ANY_POINTER:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool isNumericType(schema::Type::Which type) {
+  switch (type) {
+    case schema::Type::INT8:
+    case schema::Type::INT16:
+    case schema::Type::INT32:
+    case schema::Type::INT64:
+    case schema::Type::UINT8:
+    case schema::Type::UINT16:
+    case schema::Type::UINT32:
+    case schema::Type::UINT64:
+    case schema::Type::FLOAT32:
+    case schema::Type::FLOAT64:
+      return true;
+    default:
+      return false;
+  }
+}
+
+uint64_t defaultBits(schema::Value::Reader value) {
+  // The default value of a data field, as it would be XOR'd against the data section.
+
+  switch (value.which()) {
+#define HANDLE_TYPE(discrim, titleCase, type) \
+    case schema::Value::discrim: \
+      return bitCast<_::Mask<type>>(value.get##titleCase());
+
+    HANDLE_TYPE(BOOL, Bool, bool)
+    HANDLE_TYPE(INT8, Int8, int8_t)
+    HANDLE_TYPE(INT16, Int16, int16_t)
+    HANDLE_TYPE(INT32, Int32, int32_t)
+    HANDLE_TYPE(INT64, Int64, int64_t)
+    HANDLE_TYPE(UINT8, Uint8, uint8_t)
+    HANDLE_TYPE(UINT16, Uint16, uint16_t)
+    HANDLE_TYPE(UINT32, Uint32, uint32_t)
+    HANDLE_TYPE(UINT64, Uint64, uint64_t)
+    HANDLE_TYPE(FLOAT32, Float32, float)
+    HANDLE_TYPE(FLOAT64, Float64, double)
+
+#undef HANDLE_TYPE
+
+    case schema::Value::ENUM:
+      return value.getEnum();
+
+    default:
+      return 0;
+  }
+}
+
+StructSchema groupSchema(StructSchema parent, schema::Field::Reader proto) {
+  return parent.getDependency(proto.getGroup().getTypeId()).asStruct();
+}
+
+class VersionChecker {
+  // Decides whether two versions of a struct type lay out their common fields identically, so
+  // that one can be copied into the other section by section.  This applies the same per-field
+  // rules as SchemaLoader::CompatibilityChecker, except that it doesn't care which side is newer
+  // (a section copy works in either direction) and it never loads anything.
+
+public:
+  bool structsMatch(StructSchema a, StructSchema b) {
+    if (a == b) return true;
+    if (a.getProto().getId() != b.getProto().getId()) return false;
+
+    for (auto& pair: assumed) {
+      if (pair.a == a && pair.b == b) return true;
+    }
+
+    // Assume the pair matches while checking it, so that recursive types terminate.  If it turns
+    // out not to, also drop any conclusions reached under that assumption.
+    size_t mark = assumed.size();
+    assumed.add(Pair { a, b });
+    bool result = fieldsMatch(a, b);
+    if (!result) assumed.resize(mark);
+    return result;
+  }
+
+  bool typesMatch(StructSchema scopeA, schema::Type::Reader a,
+                  StructSchema scopeB, schema::Type::Reader b) {
+    if (a.which() != b.which()) return false;
+
+    switch (a.which()) {
+      case schema::Type::STRUCT:
+        return structsMatch(scopeA.getDependency(a.getStruct().getTypeId()).asStruct(),
+                            scopeB.getDependency(b.getStruct().getTypeId()).asStruct());
+      case schema::Type::LIST:
+        return typesMatch(scopeA, a.getList().getElementType(),
+                          scopeB, b.getList().getElementType());
+      default:
+        // Enums are copied as numbers, capabilities and AnyPointers as raw pointers.
+        return true;
+    }
+  }
+
+private:
+  struct Pair {
+    StructSchema a;
+    StructSchema b;
+  };
+  kj::Vector<Pair> assumed;
+
+  bool fieldsMatch(StructSchema a, StructSchema b) {
+    auto layoutA = a.getLayout();
+    auto layoutB = b.getLayout();
+    if (layoutA.discriminantCount > 0 && layoutB.discriminantCount > 0 &&
+        layoutA.discriminantOffset != layoutB.discriminantOffset) {
+      return false;
+    }
+
+    // Fields are sorted by ordinal, so shared fields occupy corresponding positions.
+    auto fieldsA = a.getFields();
+    auto fieldsB = b.getFields();
+    uint count = kj::min(fieldsA.size(), fieldsB.size());
+    for (uint i = 0; i < count; i++) {
+      auto protoA = fieldsA[i].getProto();
+      auto protoB = fieldsB[i].getProto();
+
+      // As with SchemaLoader, a field may move into a union as long as it has discriminant 0.
+      uint discriminantA = hasDiscriminantValue(protoA) ? protoA.getDiscriminantValue() : 0;
+      uint discriminantB = hasDiscriminantValue(protoB) ? protoB.getDiscriminantValue() : 0;
+      if (discriminantA != discriminantB || protoA.which() != protoB.which()) return false;
+
+      switch (protoA.which()) {
+        case schema::Field::SLOT: {
+          auto slotA = protoA.getSlot();
+          auto slotB = protoB.getSlot();
+          if (slotA.getOffset() != slotB.getOffset() ||
+              !typesMatch(a, slotA.getType(), b, slotB.getType())) {
+            return false;
+          }
+          if (!isPointerType(slotA.getType().which()) &&
+              defaultBits(slotA.getDefaultValue()) != defaultBits(slotB.getDefaultValue())) {
+            return false;
+          }
+          break;
+        }
+
+        case schema::Field::GROUP:
+          if (!fieldsMatch(groupSchema(a, protoA), groupSchema(b, protoB))) return false;
+          break;
+      }
+    }
+
+    return true;
+  }
+};
+
+void copyDataBits(_::StructReader from, _::StructBuilder to,
+                  uint fromBit, uint toBit, uint bitCount) {
+  // Bits past the end of the source's data section read as zero, and `to` is already zero.
+  uint available = from.getDataSectionSize() / BITS;
+  if (fromBit >= available) return;
+  bitCount = kj::min(bitCount, available - fromBit);
+
+  if (fromBit % 8 == 0 && toBit % 8 == 0 && bitCount % 8 == 0) {
+    memcpy(to.getDataSectionAsBlob().begin() + toBit / 8,
+           from.getDataSectionAsBlob().begin() + fromBit / 8, bitCount / 8);
+  } else {
+    for (uint i = 0; i < bitCount; i++) {
+      to.setDataField<bool>((toBit + i) * ELEMENTS,
+                            from.getDataField<bool>((fromBit + i) * ELEMENTS));
+    }
+  }
+}
+
+}  // namespace
+
+class DynamicStruct::Transcoder::Planner {
+public:
+  kj::Vector<Plan> plans;
+
+  uint planFor(StructSchema from, StructSchema to) {
+    for (uint i = 0; i < plans.size(); i++) {
+      if (plans[i].from == from && plans[i].to == to) return i;
+    }
+
+    // Register the plan before filling it in, so that recursive types refer back to it.
+    uint index = plans.size();
+    Plan& plan = plans.add();
+    plan.from = from;
+    plan.to = to;
+    plan.sectionCopy = !from.getLayout().isGroup && !to.getLayout().isGroup &&
+        checker.structsMatch(from, to);
+
+    if (!plans[index].sectionCopy) {
+      planFields(index);
+    }
+    return index;
+  }
+
+private:
+  VersionChecker checker;
+
+  void planFields(uint index) {
+    // Note that planFor() may grow `plans`, so we must not hold a reference into it.
+    StructSchema from = plans[index].from;
+    StructSchema to = plans[index].to;
+
+    kj::Vector<DataRun> runs;
+    kj::Vector<PointerMove> moves;
+    kj::Vector<Op> ops;
+
+    for (auto toField: to.getFields()) {
+      auto toProto = toField.getProto();
+      KJ_IF_MAYBE(fromField, from.findFieldByName(toProto.getName())) {
+        auto fromProto = fromField->getProto();
+        bool plain = !hasDiscriminantValue(fromProto) && !hasDiscriminantValue(toProto);
+
+        Op op;
+        op.kind = Op::SET;
+        op.fromInUnion = hasDiscriminantValue(fromProto);
+        op.data = DataRun { 0, 0, 0 };
+        op.pointer = PointerMove { 0, 0 };
+        op.nested = 0;
+        op.from = *fromField;
+        op.to = toField;
+
+        if (fromProto.isGroup() && toProto.isGroup()) {
+          op.kind = Op::GROUP;
+          op.nested = planFor(groupSchema(from, fromProto), groupSchema(to, toProto));
+          ops.add(op);
+          continue;
+        }
+
+        KJ_REQUIRE(fromProto.isSlot() && toProto.isSlot(),
+                   "Field changed between group and non-group; can't copy it.",
+                   toProto.getName(), from.getProto().getDisplayName(),
+                   to.getProto().getDisplayName()) {
+          continue;
+        }
+
+        auto fromSlot = fromProto.getSlot();
+        auto toSlot = toProto.getSlot();
+        auto fromType = fromSlot.getType();
+        auto toType = toSlot.getType();
+
+        if (checker.typesMatch(from, fromType, to, toType)) {
+          if (isPointerType(toType.which())) {
+            PointerMove move = { static_cast<uint16_t>(fromSlot.getOffset()),
+                                 static_cast<uint16_t>(toSlot.getOffset()) };
+            if (plain) {
+              moves.add(move);
+            } else {
+              op.kind = Op::POINTER;
+              op.pointer = move;
+              ops.add(op);
+            }
+            continue;
+          }
+
+          if (defaultBits(fromSlot.getDefaultValue()) == defaultBits(toSlot.getDefaultValue())) {
+            uint bits = dataBitsPerElement(elementSizeFor(toType.which())) * ELEMENTS / BITS;
+            if (bits == 0) {
+              // Void.  Nothing to copy, but a union member still needs its discriminant set.
+              if (!plain) ops.add(op);
+              continue;
+            }
+
+            DataRun run = { fromSlot.getOffset() * bits, toSlot.getOffset() * bits, bits };
+            if (plain) {
+              runs.add(run);
+            } else {
+              op.kind = Op::DATA;
+              op.data = run;
+              ops.add(op);
+            }
+            continue;
+          }
+        }
+
+        // The type or default changed, so the value must be converted.
+        auto fromWhich = fromType.which();
+        auto toWhich = toType.which();
+        if (fromWhich == schema::Type::ENUM && toWhich == schema::Type::ENUM) {
+          op.kind = Op::ENUM;
+          op.enumSchema = to.getDependency(toType.getEnum().getTypeId()).asEnum();
+        } else if (fromWhich == schema::Type::STRUCT && toWhich == schema::Type::STRUCT) {
+          op.kind = Op::STRUCT;
+          op.nested = planFor(from.getDependency(fromType.getStruct().getTypeId()).asStruct(),
+                              to.getDependency(toType.getStruct().getTypeId()).asStruct());
+        } else if (fromWhich == schema::Type::LIST && toWhich == schema::Type::LIST &&
+                   fromType.getList().getElementType().isStruct() &&
+                   toType.getList().getElementType().isStruct()) {
+          op.kind = Op::STRUCT_LIST;
+          op.nested = planFor(
+              from.getDependency(
+                  fromType.getList().getElementType().getStruct().getTypeId()).asStruct(),
+              to.getDependency(
+                  toType.getList().getElementType().getStruct().getTypeId()).asStruct());
+        } else if (fromWhich == toWhich || (isNumericType(fromWhich) && isNumericType(toWhich))) {
+          // Same data type with a new default, or a numeric conversion which set() range-checks.
+          KJ_ASSERT(!isPointerType(toWhich));
+          op.kind = Op::SET;
+        } else {
+          KJ_FAIL_REQUIRE("Field type changed incompatibly; can't copy it.",
+                          toProto.getName(), from.getProto().getDisplayName(),
+                          to.getProto().getDisplayName()) {
+            continue;
+          }
+        }
+        ops.add(op);
+      }
+    }
+
+    // Merge runs of adjacent fields which stay adjacent, so that e.g. a block of fields which
+    // all moved by the same amount becomes a single memcpy.
+    std::sort(runs.begin(), runs.end(), [](const DataRun& a, const DataRun& b) {
+      return a.toBit < b.toBit;
+    });
+    kj::Vector<DataRun> merged(runs.size());
+    for (auto& run: runs) {
+      if (merged.size() > 0) {
+        DataRun& last = merged.back();
+        if (last.fromBit + last.bitCount == run.fromBit &&
+            last.toBit + last.bitCount == run.toBit) {
+          last.bitCount += run.bitCount;
+          continue;
+        }
+      }
+      merged.add(run);
+    }
+
+    Plan& plan = plans[index];
+    plan.dataRuns = merged.releaseAsArray();
+    plan.pointerMoves = moves.releaseAsArray();
+    plan.ops = ops.releaseAsArray();
+  }
+};
+
+DynamicStruct::Transcoder::Transcoder(StructSchema from, StructSchema to) {
+  KJ_REQUIRE(!from.getLayout().isGroup && !to.getLayout().isGroup,
+             "Transcoder can't be used on group types directly.");
+
+  Planner planner;
+  planner.planFor(from, to);
+  plans = planner.plans.releaseAsArray();
+}
+
+void DynamicStruct::Transcoder::copy(DynamicStruct::Reader from,
+                                     DynamicStruct::Builder to) const {
+  KJ_REQUIRE(plans.size() > 0, "Transcoder is not initialized.") {
+    return;
+  }
+  KJ_REQUIRE(from.schema == plans[0].from, "Transcoder was planned for a different source type.",
+             plans[0].from.getProto().getDisplayName(), from.schema.getProto().getDisplayName());
+  KJ_REQUIRE(to.schema == plans[0].to, "Transcoder was planned for a different target type.",
+             plans[0].to.getProto().getDisplayName(), to.schema.getProto().getDisplayName());
+
+  copy(plans[0], from, to);
+}
+
+void DynamicStruct::Transcoder::copy(
+    const Plan& plan, DynamicStruct::Reader from, DynamicStruct::Builder to) const {
+  if (plan.sectionCopy) {
+    to.builder.copyContentFrom(from.reader);
+    return;
+  }
+
+  for (auto& run: plan.dataRuns) {
+    copyDataBits(from.reader, to.builder, run.fromBit, run.toBit, run.bitCount);
+  }
+
+  for (auto& move: plan.pointerMoves) {
+    to.builder.getPointerField(move.to * POINTERS)
+        .copyFrom(from.reader.getPointerField(move.from * POINTERS));
+  }
+
+  for (auto& op: plan.ops) {
+    if (op.fromInUnion && !from.isSetInUnion(op.from)) continue;
+
+    switch (op.kind) {
+      case Op::DATA:
+        to.setInUnion(op.to);
+        copyDataBits(from.reader, to.builder, op.data.fromBit, op.data.toBit, op.data.bitCount);
+        break;
+
+      case Op::POINTER:
+        to.setInUnion(op.to);
+        to.builder.getPointerField(op.pointer.to * POINTERS)
+            .copyFrom(from.reader.getPointerField(op.pointer.from * POINTERS));
+        break;
+
+      case Op::SET:
+        to.set(op.to, from.get(op.from));
+        break;
+
+      case Op::ENUM:
+        to.set(op.to, DynamicEnum(op.enumSchema, from.get(op.from).as<DynamicEnum>().getRaw()));
+        break;
+
+      case Op::STRUCT:
+        if (from.has(op.from)) {
+          copy(plans[op.nested], from.get(op.from).as<DynamicStruct>(),
+               to.init(op.to).as<DynamicStruct>());
+        } else {
+          // Null stays null (but still selects the union member).
+          to.clear(op.to);
+        }
+        break;
+
+      case Op::STRUCT_LIST:
+        if (from.has(op.from)) {
+          auto fromList = from.get(op.from).as<DynamicList>();
+          auto toList = to.init(op.to, fromList.size()).as<DynamicList>();
+          for (uint i = 0; i < fromList.size(); i++) {
+            copy(plans[op.nested], fromList[i].as<DynamicStruct>(),
+                 toList[i].as<DynamicStruct>());
+          }
+        } else {
+          to.clear(op.to);
+        }
+        break;
+
+      case Op::GROUP: {
+        // init() selects the group if it's a union member; otherwise there is nothing to clear.
+        auto group = hasDiscriminantValue(op.to.getProto()) ? to.init(op.to) : to.get(op.to);
+        copy(plans[op.nested], from.get(op.from).as<DynamicStruct>(), group.as<DynamicStruct>());
+        break;
+      }
+    }
+  }
+}
+
+// -------------------------------------------------------------------
+
+class DynamicStruct::Projection::Compiler {
+public:
+  typedef kj::ArrayPtr<const StructSchema::Field> Path;
+
+  kj::Vector<Node> nodes;
+
+  uint compile(StructSchema schema, kj::ArrayPtr<const Path> paths) {
+    // Compile a node for `schema` selecting the given paths, which are relative to it.  An empty
+    // path selects the whole struct.
+
+    uint index = nodes.size();
+    nodes.add();
+
+    // Group the paths by their first field, in field order.
+    bool everything = false;
+    std::map<uint, kj::Vector<Path>> byField;
+    for (auto& path: paths) {
+      if (path.size() == 0) {
+        everything = true;
+      } else {
+        byField[path[0].getIndex()].add(path.slice(1, path.size()));
+      }
+    }
+    if (everything) {
+      byField.clear();
+      for (auto field: schema.getFields()) {
+        byField[field.getIndex()].add(nullptr);
+      }
+    }
+
+    kj::Vector<Item> data;
+    kj::Vector<Item> items;
+    auto fields = schema.getFields();
+    for (auto& entry: byField) {
+      auto field = fields[entry.first];
+      auto proto = field.getProto();
+
+      // A field that is selected as a whole makes any longer paths through it redundant.
+      bool whole = false;
+      for (auto& rest: entry.second) {
+        if (rest.size() == 0) whole = true;
+      }
+
+      Item item;
+      item.inUnion = hasDiscriminantValue(proto);
+      item.discriminantValue = proto.getDiscriminantValue();
+      item.discriminantOffset = schema.getLayout().discriminantOffset;
+      item.offset = 0;
+      item.bitCount = 0;
+      item.node = 0;
+
+      switch (proto.which()) {
+        case schema::Field::SLOT: {
+          auto slot = proto.getSlot();
+          auto type = slot.getType().which();
+          switch (type) {
+            case schema::Type::TEXT:
+            case schema::Type::DATA:
+            case schema::Type::LIST:
+            case schema::Type::ANY_POINTER:
+            case schema::Type::INTERFACE:
+              item.kind = Item::POINTER;
+              item.offset = slot.getOffset();
+              break;
+
+            case schema::Type::STRUCT:
+              item.offset = slot.getOffset();
+              if (whole) {
+                item.kind = Item::POINTER;
+              } else {
+                StructSchema nested = KJ_ASSERT_NONNULL(nestedStructSchema(field));
+                item.kind = Item::STRUCT;
+                item.node = compile(nested, entry.second);
+                auto layout = nested.getLayout();
+                item.structSize = _::StructSize(
+                    layout.dataWordCount * WORDS, layout.pointerCount * POINTERS,
+                    static_cast<_::FieldSize>(layout.preferredListEncoding));
+              }
+              break;
+
+            default: {
+              uint bits = dataBitsPerElement(elementSizeFor(type)) * ELEMENTS / BITS;
+              item.kind = Item::DATA;
+              item.offset = slot.getOffset() * bits;
+              item.bitCount = bits;
+              if (!item.inUnion) {
+                // Void fields outside of unions have nothing to copy.
+                if (bits > 0) data.add(item);
+                continue;
+              }
+              break;
+            }
+          }
+          break;
+        }
+
+        case schema::Field::GROUP: {
+          item.kind = Item::GROUP;
+          StructSchema group = KJ_ASSERT_NONNULL(nestedStructSchema(field));
+          if (whole) {
+            Path all = nullptr;
+            item.node = compile(group, kj::arrayPtr(&all, 1));
+          } else {
+            item.node = compile(group, entry.second);
+          }
+          break;
+        }
+      }
+
+      items.add(item);
+    }
+
+    // Merge adjacent data fields, e.g. a block of scalars selected together.
+    std::sort(data.begin(), data.end(), [](const Item& a, const Item& b) {
+      return a.offset < b.offset;
+    });
+    kj::Vector<Item> merged(data.size() + items.size());
+    for (auto& item: data) {
+      if (merged.size() > 0 && merged.back().offset + merged.back().bitCount == item.offset) {
+        merged.back().bitCount += item.bitCount;
+      } else {
+        merged.add(item);
+      }
+    }
+    for (auto& item: items) {
+      merged.add(item);
+    }
+
+    // compile() may have grown `nodes`, so look up our node again.
+    nodes[index].items = merged.releaseAsArray();
+    return index;
+  }
+};
+
+DynamicStruct::Projection::Projection(StructSchema schema, kj::ArrayPtr<const kj::StringPtr> paths)
+    : schema(schema) {
+  KJ_REQUIRE(!schema.getLayout().isGroup, "Projection can't be used on group types directly.");
+
+  auto resolved = KJ_MAP(path, paths) { return resolvePath(schema, path); };
+  auto pathPtrs = KJ_MAP(path, resolved) -> Compiler::Path { return path; };
+
+  Compiler compiler;
+  compiler.compile(schema, pathPtrs);
+  nodes = compiler.nodes.releaseAsArray();
+}
+
+DynamicStruct::Projection::Projection(
+    StructSchema schema, std::initializer_list<kj::StringPtr> paths)
+    : Projection(schema, kj::arrayPtr(paths.begin(), paths.size())) {}
+
+void DynamicStruct::Projection::copy(DynamicStruct::Reader from, DynamicStruct::Builder to) const {
+  KJ_REQUIRE(nodes.size() > 0, "Projection is not initialized.") {
+    return;
+  }
+  KJ_REQUIRE(from.schema == schema, "Projection was compiled for a different struct type.",
+             schema.getProto().getDisplayName(), from.schema.getProto().getDisplayName());
+  KJ_REQUIRE(to.schema == schema, "Projection was compiled for a different struct type.",
+             schema.getProto().getDisplayName(), to.schema.getProto().getDisplayName());
+
+  copy(nodes[0], from.reader, to.builder);
+}
+
+DynamicStruct::Builder DynamicStruct::Projection::copy(
+    DynamicStruct::Reader from, MessageBuilder& message) const {
+  auto root = message.initRoot<DynamicStruct>(schema);
+  copy(from, root);
+  return root;
+}
+
+void DynamicStruct::Projection::copy(
+    const Node& node, _::StructReader from, _::StructBuilder to) const {
+  for (auto& item: node.items) {
+    if (item.inUnion) {
+      if (from.getDataField<uint16_t>(item.discriminantOffset * ELEMENTS) !=
+          item.discriminantValue) {
+        continue;
+      }
+      to.setDataField<uint16_t>(item.discriminantOffset * ELEMENTS, item.discriminantValue);
+    }
+
+    switch (item.kind) {
+      case Item::DATA:
+        copyDataBits(from, to, item.offset, item.offset, item.bitCount);
+        break;
+
+      case Item::POINTER:
+        to.getPointerField(item.offset * POINTERS)
+            .copyFrom(from.getPointerField(item.offset * POINTERS));
+        break;
+
+      case Item::STRUCT: {
+        auto pointer = from.getPointerField(item.offset * POINTERS);
+        if (!pointer.isNull()) {
+          copy(nodes[item.node], pointer.getStruct(nullptr),
+               to.getPointerField(item.offset * POINTERS).initStruct(item.structSize));
+        }
+        break;
+      }
+
+      case Item::GROUP:
+        copy(nodes[item.node], from, to);
+        break;
+    }
+  }
+}
+
 // =======================================================================================
 
 DynamicValue::Reader DynamicList::Reader::operator[](uint index) const {
@@ -1017,6 +1938,97 @@ DynamicValue::Reader DynamicList::Reader::operator[](uint index) const {
   return nullptr;
 }
 
+namespace {
+
+template <typename T> struct GatherType_;
+#define HANDLE_TYPE(discrim, titleCase, type) \
+template <> struct GatherType_<type> { \
+  static constexpr schema::Type::Which which = schema::Type::discrim; \
+  static type defaultValue(schema::Value::Reader value) { return value.get##titleCase(); } \
+};
+
+HANDLE_TYPE(BOOL, Bool, bool)
+HANDLE_TYPE(INT8, Int8, int8_t)
+HANDLE_TYPE(INT16, Int16, int16_t)
+HANDLE_TYPE(INT32, Int32, int32_t)
+HANDLE_TYPE(INT64, Int64, int64_t)
+HANDLE_TYPE(UINT8, Uint8, uint8_t)
+HANDLE_TYPE(UINT32, Uint32, uint32_t)
+HANDLE_TYPE(UINT64, Uint64, uint64_t)
+HANDLE_TYPE(FLOAT32, Float32, float)
+HANDLE_TYPE(FLOAT64, Float64, double)
+#undef HANDLE_TYPE
+
+template <> struct GatherType_<uint16_t> {
+  // Also used for enums.
+  static constexpr schema::Type::Which which = schema::Type::UINT16;
+  static uint16_t defaultValue(schema::Value::Reader value) {
+    return value.isEnum() ? value.getEnum() : value.getUint16();
+  }
+};
+
+schema::Field::Slot::Reader checkGatherField(
+    ListSchema schema, StructSchema::Field field, schema::Type::Which expectedType) {
+  KJ_REQUIRE(schema.whichElementType() == schema::Type::STRUCT,
+             "gather() only works on lists of structs.");
+  KJ_REQUIRE(field.getContainingStruct() == schema.getStructElementType(),
+             "`field` is not a field of this list's element type.");
+
+  auto proto = field.getProto();
+  KJ_REQUIRE(!hasDiscriminantValue(proto), "gather() can't read union members.",
+             proto.getName());
+  KJ_REQUIRE(proto.isSlot(), "gather() can't read groups.", proto.getName());
+
+  auto slot = proto.getSlot();
+  auto type = slot.getType().which();
+  KJ_REQUIRE(type == expectedType ||
+             (expectedType == schema::Type::UINT16 && type == schema::Type::ENUM),
+             "Type mismatch when using DynamicList::Reader::gather().", proto.getName());
+  return slot;
+}
+
+}  // namespace
+
+template <typename T>
+void DynamicList::Reader::gather(StructSchema::Field field, kj::ArrayPtr<T> output) const {
+  KJ_REQUIRE(output.size() == size(), "gather() output must have one element per list element.",
+             output.size(), size()) {
+    return;
+  }
+
+  auto slot = checkGatherField(schema, field, GatherType_<T>::which);
+  reader.gatherDataField<T>(slot.getOffset() * ELEMENTS, output,
+      bitCast<_::Mask<T>>(GatherType_<T>::defaultValue(slot.getDefaultValue())));
+}
+
+template <typename T>
+void DynamicList::Reader::gather(kj::StringPtr fieldName, kj::ArrayPtr<T> output) const {
+  KJ_REQUIRE(schema.whichElementType() == schema::Type::STRUCT,
+             "gather() only works on lists of structs.") {
+    return;
+  }
+  gather(schema.getStructElementType().getFieldByName(fieldName), output);
+}
+
+#define HANDLE_TYPE(type) \
+template void DynamicList::Reader::gather<type>( \
+    StructSchema::Field field, kj::ArrayPtr<type> output) const; \
+template void DynamicList::Reader::gather<type>( \
+    kj::StringPtr fieldName, kj::ArrayPtr<type> output) const;
+
+HANDLE_TYPE(bool)
+HANDLE_TYPE(int8_t)
+HANDLE_TYPE(int16_t)
+HANDLE_TYPE(int32_t)
+HANDLE_TYPE(int64_t)
+HANDLE_TYPE(uint8_t)
+HANDLE_TYPE(uint16_t)
+HANDLE_TYPE(uint32_t)
+HANDLE_TYPE(uint64_t)
+HANDLE_TYPE(float)
+HANDLE_TYPE(double)
+#undef HANDLE_TYPE
+
 DynamicValue::Builder DynamicList::Builder::operator[](uint index) {
   KJ_REQUIRE(index < size(), "List index out-of-bounds.");
 
@@ -1795,26 +2807,26 @@ namespace _ {  // private
 
 DynamicStruct::Reader PointerHelpers<DynamicStruct, Kind::UNKNOWN>::getDynamic(
     PointerReader reader, StructSchema schema) {
-  KJ_REQUIRE(!schema.getProto().getStruct().getIsGroup(),
+  KJ_REQUIRE(!schema.getLayout().isGroup,
              "Cannot form pointer to group type.");
   return DynamicStruct::Reader(schema, reader.getStruct(nullptr));
 }
 DynamicStruct::Builder PointerHelpers<DynamicStruct, Kind::UNKNOWN>::getDynamic(
     PointerBuilder builder, StructSchema schema) {
-  KJ_REQUIRE(!schema.getProto().getStruct().getIsGroup(),
+  KJ_REQUIRE(!schema.getLayout().isGroup,
              "Cannot form pointer to group type.");
   return DynamicStruct::Builder(schema, builder.getStruct(
       structSizeFromSchema(schema), nullptr));
 }
 void PointerHelpers<DynamicStruct, Kind::UNKNOWN>::set(
     PointerBuilder builder, const DynamicStruct::Reader& value) {
-  KJ_REQUIRE(!value.schema.getProto().getStruct().getIsGroup(),
+  KJ_REQUIRE(!value.schema.getLayout().isGroup,
              "Cannot form pointer to group type.");
   builder.setStruct(value.reader);
 }
 DynamicStruct::Builder PointerHelpers<DynamicStruct, Kind::UNKNOWN>::init(
     PointerBuilder builder, StructSchema schema) {
-  KJ_REQUIRE(!schema.getProto().getStruct().getIsGroup(),
+  KJ_REQUIRE(!schema.getLayout().isGroup,
              "Cannot form pointer to group type.");
   return DynamicStruct::Builder(schema,
       builder.initStruct(structSizeFromSchema(schema)));
@@ -79,6 +79,9 @@ struct DynamicStruct {
   class Reader;
   class Builder;
   class Pipeline;
+  class Accessor;
+  class Transcoder;
+  class Projection;
 };
 struct DynamicList {
   DynamicList() = delete;
@@ -117,6 +120,9 @@ public:
   DynamicEnum() = default;
   inline DynamicEnum(EnumSchema::Enumerant enumerant)
       : schema(enumerant.getContainingEnum()), value(enumerant.getOrdinal()) {}
+  inline DynamicEnum(EnumSchema schema, uint16_t value)
+      : schema(schema), value(value) {}
+  // Construct from a raw value, which need not correspond to any enumerant in `schema`.
 
   template <typename T, typename = kj::EnableIf<kind<T>() == Kind::ENUM>>
   inline DynamicEnum(T&& value): DynamicEnum(toDynamic(value)) {}
@@ -139,9 +145,6 @@ private:
   EnumSchema schema;
   uint16_t value;
 
-  inline DynamicEnum(EnumSchema schema, uint16_t value)
-      : schema(schema), value(value) {}
-
   uint16_t asImpl(uint64_t requestedTypeId) const;
 
   friend struct DynamicStruct;
@@ -212,6 +215,9 @@ private:
   friend struct ::capnp::ToDynamic_;
   friend kj::StringTree _::structString(
       _::StructReader reader, const _::RawSchema& schema);
+  friend class DynamicStruct::Accessor;
+  friend class DynamicStruct::Transcoder;
+  friend class DynamicStruct::Projection;
   friend class Orphanage;
   friend class Orphan<DynamicStruct>;
   friend class Orphan<DynamicValue>;
@@ -300,6 +306,8 @@ private:
   friend class MessageBuilder;
   template <typename T, ::capnp::Kind k>
   friend struct ::capnp::ToDynamic_;
+  friend class DynamicStruct::Transcoder;
+  friend class DynamicStruct::Projection;
   friend class Orphanage;
   friend class Orphan<DynamicStruct>;
   friend class Orphan<DynamicValue>;
@@ -334,6 +342,237 @@ private:
   friend class Request<DynamicStruct, DynamicStruct>;
 };
 
+class DynamicStruct::Accessor {
+  // A field (or a path through nested structs and groups, like "engine.horsepower") resolved
+  // ahead of time against a particular StructSchema.  Construction looks up each field by name and
+  // digests its schema node -- slot vs. group, type, offset, default value, union membership --
+  // into a flat plan, so that get() only needs to follow offsets.  Use this instead of
+  // `DynamicStruct::Reader::get()` when reading the same fields out of many messages.
+  //
+  // The Accessor refers to the schema nodes it was compiled from, so it must not outlive them (not
+  // a concern for compiled-in schemas).
+
+public:
+  Accessor() = default;
+
+  Accessor(StructSchema schema, kj::StringPtr path);
+  // Compile the given dot-separated path of field names.  Every field but the last must be of
+  // struct or group type.  Throws if a name can't be resolved.
+
+  explicit Accessor(StructSchema::Field field);
+  // Compile an accessor for a single field of `field.getContainingStruct()`.
+
+  inline StructSchema getSchema() const { return schema; }
+  // The struct type this accessor applies to.
+
+  DynamicValue::Reader get(DynamicStruct::Reader reader) const;
+  // Read the value at the end of the path.  Equivalent to calling `get()` on each path element
+  // in turn, including throwing if some element is a union member which is not currently set.
+  // Null pointers along the way read as their defaults, as usual.
+
+private:
+  enum class Kind: uint8_t {
+    VOID, BOOL, INT8, INT16, INT32, INT64, UINT8, UINT16, UINT32, UINT64, FLOAT32, FLOAT64,
+    TEXT, DATA, LIST, ENUM, STRUCT, INTERFACE, ANY_POINTER, GROUP
+  };
+
+  struct Step {
+    // One path element.
+
+    Kind kind;
+    bool inUnion;
+    uint16_t discriminantValue;
+    uint32_t discriminantOffset;
+    // If `inUnion`, the field is only valid when the discriminant at `discriminantOffset` (in
+    // 16-bit units) equals `discriminantValue`.
+
+    uint32_t offset;
+    // Data offset (in units of the field's size) or pointer index, as for schema::Field::Slot.
+
+    uint64_t defaultBits;
+    // Default value of a primitive field, as it would be XOR'd against the data section.
+
+    const void* defaultPointer;
+    uint32_t defaultSize;
+    // Default value of a pointer field: encoded pointer for struct/list, or blob bytes and size
+    // for text/data.
+
+    StructSchema::Field field;
+    // Only consulted when reporting errors.
+  };
+
+  StructSchema schema;
+  kj::Array<Step> steps;
+
+  StructSchema leafStruct;
+  EnumSchema leafEnum;
+  InterfaceSchema leafInterface;
+  ListSchema leafList;
+  // Schema of the final value, for the kinds that need one.
+
+  void compile(kj::ArrayPtr<const StructSchema::Field> fields);
+  void checkUnion(const Step& step, const _::StructReader& reader) const;
+};
+
+class DynamicStruct::Transcoder {
+  // Copies structs of one type into structs of another -- typically two versions of the same
+  // type, e.g. when migrating stored data to a new schema.  Construction compares the two schemas
+  // once and digests the result into a plan:
+  //
+  // - If both are versions of the same type (same ID) and compatible by the rules SchemaLoader
+  //   applies when one version replaces another, their sections line up, and copy() just copies
+  //   the data and pointer sections wholesale, like setting a struct pointer does.
+  // - Otherwise, fields are matched by name.  Fields outside of unions whose type and default are
+  //   unchanged are copied as raw bits or pointers, with adjacent fields merged into a single
+  //   memcpy.  Union members are copied only if active.  Fields whose numeric type or default
+  //   changed are converted through get()/set(), and struct fields whose types are themselves
+  //   different get a nested plan.  Target fields with no same-named source field are left alone.
+  //
+  // Like Accessor, the Transcoder refers to the schema nodes it was compiled from, so it must not
+  // outlive them.
+
+public:
+  Transcoder() = default;
+
+  Transcoder(StructSchema from, StructSchema to);
+  // Plan copies from `from` to `to`.  Throws if some field present in both cannot be converted,
+  // e.g. because it changed from Text to Int32.
+
+  inline StructSchema getSourceSchema() const { return plans[0].from; }
+  inline StructSchema getTargetSchema() const { return plans[0].to; }
+
+  inline bool isSectionCopy() const { return plans[0].sectionCopy; }
+  // Whether the top-level types were found to be compatible versions, so that copy() copies
+  // whole sections.
+
+  void copy(DynamicStruct::Reader from, DynamicStruct::Builder to) const;
+  // Copy `from` into `to`, which should be newly-initialized.
+
+private:
+  struct DataRun {
+    uint32_t fromBit;
+    uint32_t toBit;
+    uint32_t bitCount;
+  };
+
+  struct PointerMove {
+    uint16_t from;
+    uint16_t to;
+  };
+
+  struct Op {
+    // A field copy that can't be done as part of the raw data runs / pointer moves.
+
+    enum Kind: uint8_t {
+      DATA,         // raw bits, `data`
+      POINTER,      // raw pointer copy, `pointer`
+      SET,          // to.set(to, from.get(from))
+      ENUM,         // raw enumerant number, re-typed as `enumSchema`
+      STRUCT,       // nested plan `nested`
+      STRUCT_LIST,  // nested plan `nested` applied to each element
+      GROUP         // nested plan `nested`
+    };
+
+    Kind kind;
+    bool fromInUnion;
+    // If true, only copy if the source field is the active member of its union.
+
+    DataRun data;
+    PointerMove pointer;
+    uint nested;
+    EnumSchema enumSchema;
+
+    StructSchema::Field from;
+    StructSchema::Field to;
+  };
+
+  struct Plan {
+    StructSchema from;
+    StructSchema to;
+    bool sectionCopy;
+
+    kj::Array<DataRun> dataRuns;
+    kj::Array<PointerMove> pointerMoves;
+    kj::Array<Op> ops;
+  };
+
+  kj::Array<Plan> plans;
+  // plans[0] is the top-level plan; Op::nested indexes into this.
+
+  class Planner;
+
+  void copy(const Plan& plan, DynamicStruct::Reader from, DynamicStruct::Builder to) const;
+};
+
+class DynamicStruct::Projection {
+  // A field mask:  a set of fields (or paths through nested structs and groups, like
+  // "engine.horsepower") resolved ahead of time against a particular StructSchema, which copies
+  // just those fields from one struct into another of the same type.  Use this to forward a few
+  // fields of a large message without deep-copying the rest.  It pays off when the fields left
+  // out hold large lists, text, or data; for a small struct, copying the whole thing (e.g. with
+  // MessageBuilder::setRoot()) is about as fast.
+  //
+  // copy() works directly on the underlying layout:  selected data fields are copied as raw bits
+  // (adjacent ones in a single memcpy), selected pointer fields are deep-copied, and structs along
+  // a path are created in the target only as needed to hold the selected fields.  Union members
+  // are copied (along with the discriminant) only if active in the source.  Selecting a struct or
+  // group field as a whole copies all of it.
+  //
+  // Like Accessor, the Projection refers to the schema nodes it was compiled from, so it must not
+  // outlive them.
+
+public:
+  Projection() = default;
+
+  Projection(StructSchema schema, kj::ArrayPtr<const kj::StringPtr> paths);
+  Projection(StructSchema schema, std::initializer_list<kj::StringPtr> paths);
+  // Compile the given dot-separated paths of field names.  Every field but the last in each path
+  // must be of struct or group type.  Throws if a name can't be resolved.
+
+  inline StructSchema getSchema() const { return schema; }
+
+  void copy(DynamicStruct::Reader from, DynamicStruct::Builder to) const;
+  // Copy the selected fields of `from` into `to`, which must be of the same type and should be
+  // newly-initialized.
+
+  DynamicStruct::Builder copy(DynamicStruct::Reader from, MessageBuilder& message) const;
+  // Initialize the message's root as the projection's type, and copy the selected fields into it.
+
+private:
+  struct Item {
+    enum Kind: uint8_t {
+      DATA,     // `bitCount` bits at bit offset `offset`
+      POINTER,  // deep copy of pointer `offset`
+      STRUCT,   // struct at pointer `offset`, which `node` applies to
+      GROUP     // `node` applies to this same struct
+    };
+
+    Kind kind;
+    bool inUnion;
+    uint16_t discriminantValue;
+    uint32_t discriminantOffset;
+    // If `inUnion`, only copy if the discriminant at `discriminantOffset` (in 16-bit units) equals
+    // `discriminantValue`, and set it to that in the target.
+
+    uint32_t offset;
+    uint32_t bitCount;
+    uint node;
+    _::StructSize structSize;
+  };
+
+  struct Node {
+    kj::Array<Item> items;
+  };
+
+  StructSchema schema;
+  kj::Array<Node> nodes;
+  // nodes[0] applies to the root.
+
+  class Compiler;
+
+  void copy(const Node& node, _::StructReader from, _::StructBuilder to) const;
+};
+
 // -------------------------------------------------------------------
 
 class DynamicList::Reader {
@@ -359,6 +598,16 @@ public:
   inline Iterator begin() const { return Iterator(this, 0); }
   inline Iterator end() const { return Iterator(this, size()); }
 
+  template <typename T>
+  void gather(StructSchema::Field field, kj::ArrayPtr<T> output) const;
+  template <typename T>
+  void gather(kj::StringPtr fieldName, kj::ArrayPtr<T> output) const;
+  // For a list of structs, read the given scalar field of every element into `output`, which must
+  // have exactly size() elements, producing a column that downstream code can process with tight
+  // (vectorizable) loops.  Much faster than calling get() on each element.  T must be exactly the
+  // field's type, or uint16_t for an enum field.  The field must belong to the element type itself
+  // (not to a group within it) and must not be a union member.
+
 private:
   ListSchema schema;
   _::ListReader reader;
@@ -27,6 +27,7 @@
 #include <kj/debug.h>
 #include <gtest/gtest.h>
 #include "test-util.h"
+#include <string.h>
 
 namespace capnp {
 namespace _ {  // private
@@ -1651,6 +1652,303 @@ TEST(Encoding, HasEmptyStructList) {
   EXPECT_EQ(2, root.totalSize().wordCount);
 }
 
+TEST(Encoding, Plain) {
+  MallocMessageBuilder builder;
+  initTestMessage(builder.initRoot<TestAllTypes>());
+
+  TestAllTypes::Plain plain = builder.getRoot<TestAllTypes>().asReader().toPlain();
+  EXPECT_EQ(-12345678, plain.int32Field);
+  EXPECT_EQ("foo", plain.textField);
+  ASSERT_TRUE(plain.structField.get() != nullptr);
+  EXPECT_EQ("baz", plain.structField->textField);
+  ASSERT_TRUE(plain.structField->structField.get() != nullptr);
+  EXPECT_EQ("nested", plain.structField->structField->textField);
+  EXPECT_EQ("x structlist 2", plain.structField->structList[1].textField);
+  EXPECT_EQ(3u, plain.structList.size());
+  EXPECT_EQ("structlist 2", plain.structList[1].textField);
+  EXPECT_EQ(6u, plain.voidList.size());
+
+  MallocMessageBuilder builder2;
+  auto root = builder2.initRoot<TestAllTypes>();
+  root.setFrom(plain);
+  checkTestMessage(root.asReader());
+
+  // setFrom() overwrites everything, including clearing pointers that are empty in the Plain.
+  root.setFrom(TestAllTypes::Plain());
+  checkTestMessageAllZero(root.asReader());
+  EXPECT_FALSE(root.hasTextField());
+  EXPECT_FALSE(root.hasStructField());
+  EXPECT_FALSE(root.hasStructList());
+}
+
+TEST(Encoding, PlainDefaults) {
+  TestDefaults::Plain plain;
+  MallocMessageBuilder builder;
+  auto root = builder.initRoot<TestDefaults>();
+
+  EXPECT_EQ(root.getBoolField(), plain.boolField);
+  EXPECT_EQ(root.getInt64Field(), plain.int64Field);
+  EXPECT_EQ(root.getUInt64Field(), plain.uInt64Field);
+  EXPECT_EQ(root.getFloat32Field(), plain.float32Field);
+  EXPECT_EQ(root.getFloat64Field(), plain.float64Field);
+  EXPECT_EQ(root.getEnumField(), plain.enumField);
+  EXPECT_EQ("foo", plain.textField);
+  EXPECT_EQ(data("bar"), plain.dataField.asPtr());
+
+  // Pointer fields with defaults read their default even when unset.
+  plain = root.asReader().toPlain();
+  EXPECT_EQ("foo", plain.textField);
+  EXPECT_EQ(2u, plain.int32List.size());
+
+  MallocMessageBuilder builder2;
+  auto root2 = builder2.initRoot<TestDefaults>();
+  root2.setFrom(plain);
+  EXPECT_TRUE(root2.hasTextField());
+  checkTestMessage(root2.asReader());
+}
+
+TEST(Encoding, PlainUnionsAndGroups) {
+  {
+    MallocMessageBuilder builder;
+    auto root = builder.initRoot<test::TestUnnamedUnion>();
+    root.setBefore("foo");
+    root.setBar(321);
+    root.setMiddle(123);
+
+    auto plain = root.asReader().toPlain();
+    EXPECT_EQ(test::TestUnnamedUnion::BAR, plain.which);
+    EXPECT_EQ(321u, plain.bar);
+    EXPECT_EQ(0u, plain.foo);
+
+    MallocMessageBuilder builder2;
+    auto root2 = builder2.initRoot<test::TestUnnamedUnion>();
+    root2.setFoo(456);
+    root2.setFrom(plain);
+    EXPECT_EQ(test::TestUnnamedUnion::BAR, root2.which());
+    EXPECT_EQ(321u, root2.getBar());
+    EXPECT_EQ(123u, root2.getMiddle());
+    EXPECT_EQ("foo", root2.getBefore());
+    EXPECT_FALSE(root2.hasAfter());
+  }
+
+  {
+    MallocMessageBuilder builder;
+    auto root = builder.initRoot<test::TestGroups>();
+    auto bar = root.getGroups().initBar();
+    bar.setCorge(23456789);
+    bar.setGrault("barbaz");
+    bar.setGarply(234567890123456ll);
+
+    auto plain = root.asReader().toPlain();
+    EXPECT_EQ(test::TestGroups::Groups::BAR, plain.groups.which);
+    EXPECT_EQ("barbaz", plain.groups.bar.grault);
+
+    MallocMessageBuilder builder2;
+    auto root2 = builder2.initRoot<test::TestGroups>();
+    root2.getGroups().initFoo().setGarply("corge");
+    root2.setFrom(plain);
+    auto bar2 = root2.getGroups().getBar();
+    EXPECT_EQ(23456789, bar2.getCorge());
+    EXPECT_EQ("barbaz", bar2.getGrault());
+    EXPECT_EQ(234567890123456ll, bar2.getGarply());
+  }
+
+  {
+    MallocMessageBuilder builder;
+    auto root = builder.initRoot<test::TestUnionInUnion>();
+    root.getOuter().initInner().setBar(789);
+
+    auto plain = root.asReader().toPlain();
+    MallocMessageBuilder builder2;
+    auto root2 = builder2.initRoot<test::TestUnionInUnion>();
+    root2.setFrom(plain);
+    ASSERT_EQ(test::TestUnionInUnion::Outer::INNER, root2.getOuter().which());
+    ASSERT_EQ(test::TestUnionInUnion::Outer::Inner::BAR, root2.getOuter().getInner().which());
+    EXPECT_EQ(789, root2.getOuter().getInner().getBar());
+  }
+}
+
+struct CheckFieldInfo {
+  StructSchema schema;
+
+  template <typename Field>
+  void operator()(Field) const {
+    auto field = schema.getFields()[Field::index];
+    auto proto = field.getProto();
+    EXPECT_EQ(proto.getName(), Field::name);
+    EXPECT_EQ(proto.getDiscriminantValue(), Field::discriminantValue);
+
+    switch (Field::location) {
+      case FieldLocation::NONE:
+        EXPECT_EQ(schema::Type::VOID, proto.getSlot().getType().which());
+        break;
+      case FieldLocation::DATA:
+        EXPECT_EQ(proto.getSlot().getOffset(), Field::offset);
+        break;
+      case FieldLocation::POINTERS:
+        EXPECT_EQ(proto.getSlot().getOffset(), Field::offset);
+        break;
+      case FieldLocation::GROUP:
+        EXPECT_TRUE(proto.isGroup());
+        break;
+    }
+  }
+};
+
+template <typename Field>
+typename Field::Type sumColumn(typename List<typename Field::Struct>::Reader list) {
+  // A "columnar extractor" specialized at compile time on the field.
+  typename Field::Type result = 0;
+  for (auto element: list) {
+    result += Field::get(element);
+  }
+  return result;
+}
+
+TEST(Encoding, FieldInfo) {
+  EXPECT_EQ(Schema::from<TestAllTypes>().getFields().size(), fieldCount<TestAllTypes>());
+  forEachField<TestAllTypes>(CheckFieldInfo { Schema::from<TestAllTypes>() });
+  forEachField<TestDefaults>(CheckFieldInfo { Schema::from<TestDefaults>() });
+  forEachField<test::TestUnion::Union0>(
+      CheckFieldInfo { Schema::from<test::TestUnion::Union0>() });
+  forEachField<test::TestGroups::Groups>(
+      CheckFieldInfo { Schema::from<test::TestGroups::Groups>() });
+
+  typedef FieldInfo<TestDefaults, 4> Int32Field;
+  static_assert(Int32Field::location == FieldLocation::DATA, "");
+  EXPECT_STREQ("int32Field", Int32Field::name);
+  EXPECT_EQ(-12345678, unmask<int32_t>(0, Int32Field::mask));
+  EXPECT_EQ(1234.5f, unmask<float>(0, FieldInfo<TestDefaults, 10>::mask));
+  EXPECT_EQ(0, (FieldInfo<TestAllTypes, 4>::mask));
+
+  typedef FieldInfo<test::TestGroups::Groups, 2> BarGroup;
+  static_assert(BarGroup::location == FieldLocation::GROUP, "");
+  static_assert(BarGroup::discriminantValue == test::TestGroups::Groups::BAR, "");
+
+  MallocMessageBuilder builder;
+  auto list = builder.initRoot<TestAllTypes>().initStructList(3);
+  for (uint i = 0; i < list.size(); i++) {
+    FieldInfo<TestAllTypes, 8>::set(list[i], i + 10);
+    FieldInfo<TestAllTypes, 4>::set(list[i], -static_cast<int32_t>(i));
+  }
+  EXPECT_EQ(11u, list[1].getUInt32Field());
+  EXPECT_EQ(33u, (sumColumn<FieldInfo<TestAllTypes, 8>>(list.asReader())));
+  EXPECT_EQ(-3, (sumColumn<FieldInfo<TestAllTypes, 4>>(list.asReader())));
+
+  auto groups = builder.initRoot<test::TestGroups>().getGroups();
+  groups.initBar();
+  BarGroup::get(groups).setCorge(123);
+  EXPECT_EQ(test::TestGroups::Groups::BAR, groups.which());
+  EXPECT_EQ(123, (FieldInfo<test::TestGroups::Groups::Bar, 0>::get(groups.asReader().getBar())));
+  EXPECT_EQ("foo", (FieldInfo<TestDefaults, 12>::get(TestDefaults::Reader())));
+}
+
+struct TraceVisitor {
+  kj::Vector<kj::String> trace;
+
+  template <typename Field, typename T>
+  void operator()(Field, T value) {
+    trace.add(kj::str(Field::name));
+  }
+  template <typename Field>
+  void operator()(Field, Text::Reader value) {
+    trace.add(kj::str(Field::name, "=", value));
+  }
+};
+
+void dynamicTrace(DynamicValue::Reader value, kj::Vector<kj::String>& trace);
+
+void dynamicTraceField(DynamicStruct::Reader reader, StructSchema::Field field,
+                       kj::Vector<kj::String>& trace) {
+  auto proto = field.getProto();
+  if (proto.isSlot()) {
+    switch (proto.getSlot().getType().which()) {
+      case schema::Type::INTERFACE:
+        return;
+      case schema::Type::TEXT:
+      case schema::Type::DATA:
+      case schema::Type::LIST:
+      case schema::Type::STRUCT:
+      case schema::Type::ANY_POINTER:
+        if (!reader.has(field)) return;
+        break;
+      default:
+        break;
+    }
+  }
+
+  auto value = reader.get(field);
+  if (value.getType() == DynamicValue::TEXT) {
+    trace.add(kj::str(proto.getName(), "=", value.as<Text>()));
+  } else {
+    trace.add(kj::str(proto.getName()));
+  }
+  dynamicTrace(value, trace);
+}
+
+void dynamicTrace(DynamicValue::Reader value, kj::Vector<kj::String>& trace) {
+  switch (value.getType()) {
+    case DynamicValue::STRUCT: {
+      auto reader = value.as<DynamicStruct>();
+      for (auto field: reader.getSchema().getNonUnionFields()) {
+        dynamicTraceField(reader, field, trace);
+      }
+      KJ_IF_MAYBE(field, reader.which()) {
+        dynamicTraceField(reader, *field, trace);
+      }
+      break;
+    }
+    case DynamicValue::LIST:
+      for (auto element: value.as<DynamicList>()) {
+        dynamicTrace(element, trace);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+template <typename T>
+void expectSameTrace(typename T::Reader reader) {
+  TraceVisitor visitor;
+  visit(reader, visitor);
+
+  kj::Vector<kj::String> expected;
+  dynamicTrace(DynamicStruct::Reader(reader), expected);
+
+  EXPECT_EQ(kj::strArray(expected, ","), kj::strArray(visitor.trace, ","));
+}
+
+TEST(Encoding, Visit) {
+  MallocMessageBuilder builder;
+
+  auto root = builder.initRoot<TestAllTypes>();
+  initTestMessage(root);
+  expectSameTrace<TestAllTypes>(root);
+
+  auto groups = builder.initRoot<test::TestGroups>();
+  groups.getGroups().initBaz().setGrault("grault");
+  expectSameTrace<test::TestGroups>(groups);
+
+  auto unions = builder.initRoot<test::TestUnion>();
+  unions.getUnion0().setU0f0sp("foo");
+  unions.getUnion3().setU3f0s64(123);
+  expectSameTrace<test::TestUnion>(unions);
+
+  TraceVisitor visitor;
+  visit(unions.asReader(), visitor);
+  auto trace = kj::strArray(visitor.trace, ",");
+  EXPECT_TRUE(strstr(trace.cStr(), "u0f0sp=foo,") != nullptr) << trace.cStr();
+  EXPECT_TRUE(strstr(trace.cStr(), ",u3f0s64,") != nullptr) << trace.cStr();
+  EXPECT_TRUE(strstr(trace.cStr(), "u0f1") == nullptr) << trace.cStr();
+
+  auto lists = builder.initRoot<test::TestListDefaults>().initLists();
+  auto structList = lists.initStructListList(2);
+  structList.init(0, 1)[0].setTextField("a");
+  structList.init(1, 2)[1].setTextField("b");
+  expectSameTrace<test::TestLists>(lists);
+}
+
 }  // namespace
 }  // namespace _ (private)
 }  // namespace capnp
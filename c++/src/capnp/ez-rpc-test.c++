@@ -22,7 +22,10 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ez-rpc.h"
+#include "rpc-twoparty.h"
 #include "test-util.h"
+#include <kj/async-io.h>
+#include <kj/vector.h>
 #include <gtest/gtest.h>
 
 namespace capnp {
@@ -53,6 +56,209 @@ TEST(EzRpc, Basic) {
       .getCallSequenceRequest().send().wait(server.getWaitScope()).getN());
 }
 
+TEST(EzRpc, ClientPool) {
+  EzRpcServer server("localhost");
+  int callCount = 0;
+  server.exportCap("cap1", kj::heap<TestInterfaceImpl>(callCount));
+  server.exportCap("cap2", kj::heap<TestCallOrderImpl>());
+  uint port = server.getPort().wait(server.getWaitScope());
+
+  EzRpcClientPool pool;
+  EXPECT_EQ(0u, pool.getConnectionCount());
+
+  auto cap = pool.importCap<test::TestInterface>("localhost", "cap1", port);
+  auto callOrder = pool.importCap<test::TestCallOrder>("localhost", "cap2", port);
+
+  // Both imports share one connection.
+  EXPECT_EQ(1u, pool.getConnectionCount());
+  EXPECT_EQ(1u, pool.getConnectAttempts());
+
+  auto request = cap.fooRequest();
+  request.setI(123);
+  request.setJ(true);
+  EXPECT_EQ("foo", request.send().wait(pool.getWaitScope()).getX());
+  EXPECT_EQ(1, callCount);
+
+  EXPECT_EQ(0, callOrder.getCallSequenceRequest().send().wait(pool.getWaitScope()).getN());
+  EXPECT_EQ(1, pool.importCap<test::TestCallOrder>("localhost", "cap2", port)
+      .getCallSequenceRequest().send().wait(pool.getWaitScope()).getN());
+
+  EXPECT_EQ(1u, pool.getConnectionCount());
+  EXPECT_EQ(1u, pool.getConnectAttempts());
+}
+
+TEST(EzRpc, ClientPoolMultipleConnections) {
+  EzRpcServer server("localhost");
+  int callCount = 0;
+  server.exportCap("cap1", kj::heap<TestInterfaceImpl>(callCount));
+  uint port = server.getPort().wait(server.getWaitScope());
+
+  EzRpcClientPool pool(3);
+
+  kj::Vector<kj::Promise<void>> promises;
+  for (uint i = 0; i < 7; i++) {
+    auto request = pool.importCap<test::TestInterface>("localhost", "cap1", port).fooRequest();
+    request.setI(123);
+    request.setJ(true);
+    promises.add(request.send().then([](Response<test::TestInterface::FooResults>&& response) {
+      EXPECT_EQ("foo", response.getX());
+    }));
+  }
+
+  // Calls are spread over at most three connections.
+  EXPECT_EQ(3u, pool.getConnectionCount());
+  EXPECT_EQ(3u, pool.getConnectAttempts());
+
+  for (auto& promise: promises) {
+    promise.wait(pool.getWaitScope());
+  }
+  EXPECT_EQ(7, callCount);
+}
+
+class TestTextRestorer final: public SturdyRefRestorer<Text> {
+public:
+  TestTextRestorer(int& callCount): callCount(callCount) {}
+
+  Capability::Client restore(Text::Reader name) override {
+    return kj::heap<TestInterfaceImpl>(callCount);
+  }
+
+private:
+  int& callCount;
+};
+
+struct TestServerConnection {
+  // A bare server connection, so that the test can drop it at will.
+
+  kj::Own<kj::AsyncIoStream> stream;
+  TwoPartyVatNetwork network;
+  RpcSystem<rpc::twoparty::SturdyRefHostId> rpcSystem;
+
+  TestServerConnection(kj::Own<kj::AsyncIoStream>&& stream, SturdyRefRestorer<Text>& restorer)
+      : stream(kj::mv(stream)),
+        network(*this->stream, rpc::twoparty::Side::SERVER),
+        rpcSystem(makeRpcServer(network, restorer)) {}
+};
+
+TEST(EzRpc, ClientPoolReconnect) {
+  EzRpcClientPool pool;
+  auto& waitScope = pool.getWaitScope();
+  int callCount = 0;
+  TestTextRestorer restorer(callCount);
+
+  auto listener = pool.getIoProvider().getNetwork().parseAddress("127.0.0.1")
+      .wait(waitScope)->listen();
+  uint port = listener->getPort();
+
+  auto cap = pool.importCap<test::TestInterface>("127.0.0.1", "cap1", port);
+  auto server1 = kj::heap<TestServerConnection>(listener->accept().wait(waitScope), restorer);
+
+  {
+    auto request = cap.fooRequest();
+    request.setI(123);
+    request.setJ(true);
+    EXPECT_EQ("foo", request.send().wait(waitScope).getX());
+  }
+  EXPECT_EQ(1u, pool.getConnectionCount());
+
+  // Drop the connection from the server side.  The old capability is now broken.
+  server1 = nullptr;
+  {
+    auto request = cap.fooRequest();
+    request.setI(123);
+    request.setJ(true);
+    EXPECT_ANY_THROW(request.send().wait(waitScope));
+  }
+  EXPECT_EQ(0u, pool.getConnectionCount());
+
+  // The next import transparently reconnects.
+  auto cap2 = pool.importCap<test::TestInterface>("127.0.0.1", "cap1", port);
+  auto server2 = kj::heap<TestServerConnection>(listener->accept().wait(waitScope), restorer);
+
+  {
+    auto request = cap2.fooRequest();
+    request.setI(123);
+    request.setJ(true);
+    EXPECT_EQ("foo", request.send().wait(waitScope).getX());
+  }
+  EXPECT_EQ(2, callCount);
+  EXPECT_EQ(1u, pool.getConnectionCount());
+  EXPECT_EQ(2u, pool.getConnectAttempts());
+}
+
+TEST(EzRpc, ClientPoolConnectFailure) {
+  EzRpcClientPool pool;
+  auto& waitScope = pool.getWaitScope();
+
+  // Find a port that nothing is listening on.
+  uint port;
+  {
+    auto listener = pool.getIoProvider().getNetwork().parseAddress("127.0.0.1")
+        .wait(waitScope)->listen();
+    port = listener->getPort();
+  }
+
+  // A failed connection only breaks the capabilities imported through it.
+  auto cap = pool.importCap<test::TestInterface>("127.0.0.1", "cap1", port);
+  EXPECT_ANY_THROW(cap.fooRequest().send().wait(waitScope));
+  EXPECT_ANY_THROW(pool.importCap<test::TestInterface>("127.0.0.1", "cap1", port)
+      .fooRequest().send().wait(waitScope));
+  EXPECT_EQ(0u, pool.getConnectionCount());
+  EXPECT_EQ(2u, pool.getConnectAttempts());
+}
+
+TEST(EzRpc, ClientPoolDestroyedWhileConnecting) {
+  EzRpcClientPool pool;
+  auto& waitScope = pool.getWaitScope();
+  int callCount = 0;
+  TestTextRestorer restorer(callCount);
+
+  auto listener = pool.getIoProvider().getNetwork().parseAddress("127.0.0.1")
+      .wait(waitScope)->listen();
+  uint port = listener->getPort();
+
+  auto pool2 = kj::heap<EzRpcClientPool>();
+  auto cap = pool2->importCap<test::TestInterface>("127.0.0.1", "cap1", port);
+  pool2 = nullptr;
+
+  // The connection outlives its pool for as long as the capability is held.
+  auto server = kj::heap<TestServerConnection>(listener->accept().wait(waitScope), restorer);
+  auto request = cap.fooRequest();
+  request.setI(123);
+  request.setJ(true);
+  EXPECT_EQ("foo", request.send().wait(waitScope).getX());
+  EXPECT_EQ(1, callCount);
+}
+
+TEST(EzRpc, ClientPoolReleasesEventLoop) {
+  {
+    EzRpcServer server("localhost");
+    int callCount = 0;
+    server.exportCap("cap1", kj::heap<TestInterfaceImpl>(callCount));
+    uint port = server.getPort().wait(server.getWaitScope());
+
+    EzRpcClientPool pool;
+    auto cap = pool.importCap<test::TestInterface>("localhost", "cap1", port);
+    auto request = cap.fooRequest();
+    request.setI(123);
+    request.setJ(true);
+    EXPECT_EQ("foo", request.send().wait(pool.getWaitScope()).getX());
+
+    // Leave a connection retired but not yet drained, and another still connecting.
+    auto pool2 = kj::heap<EzRpcClientPool>();
+    pool2->importCap<test::TestInterface>("localhost", "cap1", port);
+  }
+
+  // Retired connections must not keep the thread's EventLoop alive once every EzRpc object on the
+  // thread is gone.
+  {
+    kj::EventLoop loop;
+    kj::WaitScope waitScope(loop);
+  }
+  EzRpcServer server("localhost");
+  server.getPort().wait(server.getWaitScope());
+}
+
 }  // namespace
 }  // namespace _
 }  // namespace capnp
@@ -32,9 +32,9 @@ namespace capnp {
 
 static __thread EzRpcContext* threadEzContext = nullptr;
 
-class EzRpcContext: public kj::Refcounted {
+class EzRpcContext: public kj::Refcounted, private kj::TaskSet::ErrorHandler {
 public:
-  EzRpcContext(): ioContext(kj::setupAsyncIo()) {
+  EzRpcContext(): ioContext(kj::setupAsyncIo()), tasks(*this) {
     threadEzContext = this;
   }
 
@@ -58,6 +58,14 @@ public:
     return *ioContext.lowLevelProvider;
   }
 
+  void addTask(kj::Promise<void>&& task) {
+    // Run `task` for as long as the context exists.  `EzRpcClientPool` uses this to keep
+    // connections open until the capabilities imported through them are dropped, which may be
+    // after the pool itself is gone.  `task` must not own the context, or the context would never
+    // be destroyed.
+    tasks.add(kj::mv(task));
+  }
+
   static kj::Own<EzRpcContext> getThreadLocal() {
     EzRpcContext* existing = threadEzContext;
     if (existing != nullptr) {
@@ -69,34 +77,48 @@ public:
 
 private:
   kj::AsyncIoContext ioContext;
+  kj::TaskSet tasks;
+
+  void taskFailed(kj::Exception&& exception) override {
+    KJ_LOG(ERROR, exception);
+  }
 };
 
 // =======================================================================================
 
-struct EzRpcClient::Impl {
-  kj::Own<EzRpcContext> context;
+namespace {
+
+struct ClientContext {
+  // One client connection and the RpcSystem running over it.  Shared by `EzRpcClient` and
+  // `EzRpcClientPool`.
+
+  kj::Own<kj::AsyncIoStream> stream;
+  TwoPartyVatNetwork network;
+  RpcSystem<rpc::twoparty::SturdyRefHostId> rpcSystem;
+
+  ClientContext(kj::Own<kj::AsyncIoStream>&& stream)
+      : stream(kj::mv(stream)),
+        network(*this->stream, rpc::twoparty::Side::CLIENT),
+        rpcSystem(makeRpcClient(network)) {}
+
+  Capability::Client restore(kj::StringPtr name) {
+    word scratch[64];
+    memset(scratch, 0, sizeof(scratch));
+    MallocMessageBuilder message(scratch);
+    auto root = message.getRoot<rpc::SturdyRef>();
+    auto hostId = root.getHostId().getAs<rpc::twoparty::SturdyRefHostId>();
+    hostId.setSide(rpc::twoparty::Side::SERVER);
+    root.getObjectId().setAs<Text>(name);
+    return rpcSystem.restore(hostId, root.getObjectId());
+  }
+};
 
-  struct ClientContext {
-    kj::Own<kj::AsyncIoStream> stream;
-    TwoPartyVatNetwork network;
-    RpcSystem<rpc::twoparty::SturdyRefHostId> rpcSystem;
+}  // namespace
 
-    ClientContext(kj::Own<kj::AsyncIoStream>&& stream)
-        : stream(kj::mv(stream)),
-          network(*this->stream, rpc::twoparty::Side::CLIENT),
-          rpcSystem(makeRpcClient(network)) {}
+// =======================================================================================
 
-    Capability::Client restore(kj::StringPtr name) {
-      word scratch[64];
-      memset(scratch, 0, sizeof(scratch));
-      MallocMessageBuilder message(scratch);
-      auto root = message.getRoot<rpc::SturdyRef>();
-      auto hostId = root.getHostId().getAs<rpc::twoparty::SturdyRefHostId>();
-      hostId.setSide(rpc::twoparty::Side::SERVER);
-      root.getObjectId().setAs<Text>(name);
-      return rpcSystem.restore(hostId, root.getObjectId());
-    }
-  };
+struct EzRpcClient::Impl {
+  kj::Own<EzRpcContext> context;
 
   kj::ForkedPromise<void> setupPromise;
 
@@ -164,6 +186,195 @@ kj::LowLevelAsyncIoProvider& EzRpcClient::getLowLevelIoProvider() {
 
 // =======================================================================================
 
+struct EzRpcClientPool::Impl {
+  kj::Own<EzRpcContext> context;
+  uint connectionsPerAddress;
+  uint64_t connectAttempts = 0;
+
+  struct Connection: public kj::Refcounted {
+    // Refcounted because a pending `importCap()` holds a reference until the connection is set
+    // up, which may be after the pool itself is gone.
+    //
+    // A connection does not own the context: retired connections are owned by a task in the
+    // context's TaskSet, so owning it back would keep the context, and the thread's EventLoop,
+    // alive forever.
+
+    kj::ForkedPromise<void> setupPromise;
+    // Never rejects; on failure, `failure` is filled in instead.
+
+    kj::Maybe<kj::Own<ClientContext>> clientContext;
+    // Filled in before `setupPromise` resolves, if the connection succeeded.
+
+    kj::Maybe<kj::Exception> failure;
+    // Filled in before `setupPromise` resolves, if the connection failed.
+
+    bool disconnected = false;
+    // Set once the connection fails or is lost.  A disconnected connection is replaced on the next
+    // `importCap()` that selects it.
+
+    kj::Promise<void> disconnectWatcher = nullptr;
+
+    explicit Connection(kj::Promise<kj::Own<kj::AsyncIoStream>>&& streamPromise)
+        : setupPromise(streamPromise.then([this](kj::Own<kj::AsyncIoStream>&& stream) {
+            auto client = kj::heap<ClientContext>(kj::mv(stream));
+            disconnectWatcher = client->network.onDisconnect()
+                .then([this]() { disconnected = true; }).eagerlyEvaluate(nullptr);
+            clientContext = kj::mv(client);
+          }, [this](kj::Exception&& exception) {
+            // Only the capabilities imported through this connection should break, so don't let
+            // the exception escape into the event loop.
+            disconnected = true;
+            failure = kj::mv(exception);
+          }).fork()) {}
+
+    Capability::Client restore(kj::StringPtr name) {
+      KJ_IF_MAYBE(client, clientContext) {
+        return client->get()->restore(name);
+      } else KJ_IF_MAYBE(exception, failure) {
+        return Capability::Client(newBrokenCap(kj::cp(*exception)));
+      } else {
+        KJ_FAIL_ASSERT("Connection used before it was set up.");
+      }
+    }
+  };
+
+  struct Endpoint {
+    kj::String key;
+    kj::Array<kj::Maybe<kj::Own<Connection>>> slots;
+    uint next = 0;
+
+    Endpoint(kj::String&& key, uint slotCount)
+        : key(kj::mv(key)), slots(kj::heapArray<kj::Maybe<kj::Own<Connection>>>(slotCount)) {}
+
+    Endpoint() = default;
+    Endpoint(const Endpoint&) = delete;
+    Endpoint(Endpoint&&) = default;
+    Endpoint& operator=(const Endpoint&) = delete;
+    Endpoint& operator=(Endpoint&&) = default;
+    // Make std::map happy...
+  };
+
+  std::map<kj::StringPtr, Endpoint> endpoints;
+
+  explicit Impl(uint connectionsPerAddress)
+      : context(EzRpcContext::getThreadLocal()),
+        connectionsPerAddress(connectionsPerAddress) {
+    KJ_REQUIRE(connectionsPerAddress > 0, "connectionsPerAddress must be positive.") {
+      this->connectionsPerAddress = 1;
+      break;
+    }
+  }
+
+  ~Impl() noexcept(false) {
+    for (auto& entry: endpoints) {
+      for (auto& slot: entry.second.slots) {
+        KJ_IF_MAYBE(connection, slot) {
+          retire(kj::mv(*connection));
+        }
+      }
+    }
+  }
+
+  kj::Own<Connection> getConnection(kj::StringPtr serverAddress, uint defaultPort) {
+    auto key = kj::str(serverAddress, '#', defaultPort);
+    auto iter = endpoints.find(key);
+    if (iter == endpoints.end()) {
+      Endpoint endpoint(kj::mv(key), connectionsPerAddress);
+      kj::StringPtr keyPtr = endpoint.key;
+      iter = endpoints.insert(std::make_pair(keyPtr, kj::mv(endpoint))).first;
+    }
+
+    Endpoint& endpoint = iter->second;
+    kj::Maybe<kj::Own<Connection>>& slot = endpoint.slots[endpoint.next];
+    endpoint.next = (endpoint.next + 1) % endpoint.slots.size();
+
+    KJ_IF_MAYBE(existing, slot) {
+      if (!existing->get()->disconnected) {
+        return kj::addRef(**existing);
+      }
+      retire(kj::mv(*existing));
+    }
+
+    ++connectAttempts;
+    auto connection = kj::refcounted<Connection>(
+        context->getIoProvider().getNetwork().parseAddress(serverAddress, defaultPort)
+        .then([](kj::Own<kj::NetworkAddress>&& addr) {
+          return addr->connect();
+        }));
+    slot = kj::addRef(*connection);
+    return kj::mv(connection);
+  }
+
+  void retire(kj::Own<Connection>&& connection) {
+    // Capabilities imported through this connection may still hold references into its network,
+    // so keep it around until they are dropped, or until the context goes away with the last
+    // EzRpc object on this thread.  If it's still connecting, wait for that first.
+    Connection& ref = *connection;
+    context->addTask(ref.setupPromise.addBranch().then([&ref]() -> kj::Promise<void> {
+      KJ_IF_MAYBE(client, ref.clientContext) {
+        return client->get()->network.onDrained();
+      } else {
+        return kj::READY_NOW;
+      }
+    }).attach(kj::mv(connection)));
+  }
+
+  uint getConnectionCount() {
+    uint count = 0;
+    for (auto& entry: endpoints) {
+      for (auto& slot: entry.second.slots) {
+        KJ_IF_MAYBE(connection, slot) {
+          if (!connection->get()->disconnected) ++count;
+        }
+      }
+    }
+    return count;
+  }
+};
+
+EzRpcClientPool::EzRpcClientPool(uint connectionsPerAddress)
+    : impl(kj::heap<Impl>(connectionsPerAddress)) {}
+
+EzRpcClientPool::~EzRpcClientPool() noexcept(false) {}
+
+Capability::Client EzRpcClientPool::importCap(
+    kj::StringPtr serverAddress, kj::StringPtr name, uint defaultPort) {
+  kj::Own<Impl::Connection> connection = impl->getConnection(serverAddress, defaultPort);
+  if (connection->clientContext != nullptr || connection->failure != nullptr) {
+    return connection->restore(name);
+  } else {
+    // The branch holds its own reference, so that the connection survives even if the pool is
+    // destroyed before setup completes.
+    auto promise = connection->setupPromise.addBranch();
+    return promise.then(kj::mvCapture(kj::heapString(name), kj::mvCapture(kj::mv(connection),
+        [](kj::Own<Impl::Connection>&& connection, kj::String&& name) {
+      return connection->restore(name);
+    })));
+  }
+}
+
+uint EzRpcClientPool::getConnectionCount() {
+  return impl->getConnectionCount();
+}
+
+uint64_t EzRpcClientPool::getConnectAttempts() {
+  return impl->connectAttempts;
+}
+
+kj::WaitScope& EzRpcClientPool::getWaitScope() {
+  return impl->context->getWaitScope();
+}
+
+kj::AsyncIoProvider& EzRpcClientPool::getIoProvider() {
+  return impl->context->getIoProvider();
+}
+
+kj::LowLevelAsyncIoProvider& EzRpcClientPool::getLowLevelIoProvider() {
+  return impl->context->getLowLevelIoProvider();
+}
+
+// =======================================================================================
+
 struct EzRpcServer::Impl final: public SturdyRefRestorer<Text>, public kj::TaskSet::ErrorHandler {
   kj::Own<EzRpcContext> context;
 
@@ -134,6 +134,72 @@ private:
   kj::Own<Impl> impl;
 };
 
+class EzRpcClientPool {
+  // A client that shares connections among many `importCap()` callers.  Where each `EzRpcClient`
+  // opens its own socket and `RpcSystem`, an `EzRpcClientPool` keeps up to `connectionsPerAddress`
+  // connections to each distinct server address and hands out capabilities from them round-robin,
+  // so that any number of callers multiplex over a small, fixed set of connections.  Example:
+  //
+  //     capnp::EzRpcClientPool pool;
+  //     Adder::Client a = pool.importCap<Adder>("localhost:3456", "adder");
+  //     Adder::Client b = pool.importCap<Adder>("localhost:3456", "adder");
+  //     // `a` and `b` share a single connection.
+  //
+  // Connections are formed lazily, on the first `importCap()` for a given address.  If a
+  // connection later disconnects (or fails to connect in the first place), capabilities
+  // previously imported through it become broken, but the next `importCap()` that would have used
+  // it opens a fresh connection in its place.
+  //
+  // Like `EzRpcClient`, the pool shares the thread's `EzRpcContext`, so it may be freely mixed with
+  // `EzRpcClient` and `EzRpcServer` objects in the same thread.
+
+public:
+  explicit EzRpcClientPool(uint connectionsPerAddress = 1);
+  // `connectionsPerAddress` bounds the number of concurrent connections opened to any one server
+  // address.  One is usually best, since calls over a single connection are pipelined anyway; a
+  // larger value spreads load across several sockets, which can help throughput when individual
+  // messages are large.
+
+  ~EzRpcClientPool() noexcept(false);
+  // Connections stay open until the capabilities imported through them have been dropped, so
+  // those capabilities keep working after the pool is gone, as long as some other `EzRpcClient`,
+  // `EzRpcClientPool` or `EzRpcServer` keeps the thread's event loop running.  This includes
+  // connections that are still being set up.  Once the last of them is destroyed, the event loop
+  // goes away and any connections still open are closed.
+
+  template <typename Type>
+  typename Type::Client importCap(kj::StringPtr serverAddress, kj::StringPtr name,
+                                  uint defaultPort = 0);
+  Capability::Client importCap(kj::StringPtr serverAddress, kj::StringPtr name,
+                               uint defaultPort = 0);
+  // Ask the server at `serverAddress` for the capability with the given name, using a pooled
+  // connection to that server.  `serverAddress` and `defaultPort` have the same meaning as in
+  // `EzRpcClient`'s constructor; connections are keyed on both.
+
+  uint getConnectionCount();
+  // Get the number of pooled connections which are currently connected or connecting.
+
+  uint64_t getConnectAttempts();
+  // Get the total number of connections the pool has initiated over its lifetime, including
+  // reconnects.
+
+  kj::WaitScope& getWaitScope();
+  // Get the `WaitScope` for the client's `EventLoop`, which allows you to synchronously wait on
+  // promises.
+
+  kj::AsyncIoProvider& getIoProvider();
+  // Get the underlying AsyncIoProvider set up by the RPC system.  This is useful if you want
+  // to do some non-RPC I/O in asynchronous fashion.
+
+  kj::LowLevelAsyncIoProvider& getLowLevelIoProvider();
+  // Get the underlying LowLevelAsyncIoProvider set up by the RPC system.  This is useful if you
+  // want to do some non-RPC I/O in asynchronous fashion.
+
+private:
+  struct Impl;
+  kj::Own<Impl> impl;
+};
+
 class EzRpcServer {
   // The server counterpart to `EzRpcClient`.  See `EzRpcClient` for an example.
 
@@ -200,6 +266,12 @@ inline typename Type::Client EzRpcClient::importCap(kj::StringPtr name) {
   return importCap(name).castAs<Type>();
 }
 
+template <typename Type>
+inline typename Type::Client EzRpcClientPool::importCap(
+    kj::StringPtr serverAddress, kj::StringPtr name, uint defaultPort) {
+  return importCap(serverAddress, name, defaultPort).castAs<Type>();
+}
+
 }  // namespace capnp
 
 #endif  // CAPNP_EZ_RPC_H_
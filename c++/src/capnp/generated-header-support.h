@@ -98,6 +98,33 @@ struct RawSchema {
     const Initializer* i = __atomic_load_n(&lazyInitializer, __ATOMIC_ACQUIRE);
     if (i != nullptr) i->init(this);
   }
+
+  struct StructLayout {
+    uint16_t dataWordCount;
+    uint16_t pointerCount;
+    uint8_t preferredListEncoding;  // actually a FieldSize
+    bool isGroup;
+    uint16_t discriminantCount;
+    uint32_t discriminantOffset;
+    bool isStruct;
+  };
+
+  StructLayout structLayout;
+  // For struct nodes, a copy of the layout fields of the node's `struct` group, so that the
+  // dynamic API can size and build structs without decoding encodedNode each time.  The generated
+  // code fills this in as a literal; SchemaLoader recomputes it whenever it sets encodedNode.
+  // All zero for non-struct nodes.  Code generated by an older capnpc leaves `isStruct` false even
+  // for structs, so StructSchema::getLayout() decodes the node itself in that case.
+
+  uint32_t memberHashSeed;
+  const uint32_t* memberHashDisplacements;
+  const uint16_t* membersByHash;
+  // Perfect hash of member names, so that name lookup takes constant time.  Hashing a name with
+  // memberHashSeed selects one of memberHashBucketCount(memberCount) buckets; the bucket's
+  // displacement then selects the name's slot among the memberCount entries of membersByHash,
+  // which holds the index of the only member that could have that name.  See makeMemberHash() in
+  // schema.c++.  The generated code fills this in as a literal and SchemaLoader builds it at load
+  // time.  Null if there are no members, in which case name lookup falls back to membersByName.
 };
 
 template <typename T>
@@ -126,6 +153,26 @@ struct UnionParentType_;
 template <typename T>
 using UnionParentType = typename UnionParentType_<T>::Type;
 
+template <typename T>
+struct FieldCount_ {
+  static_assert(sizeof(T) == 0, "FieldInfo is only generated for structs annotated with "
+                "$Cxx.fieldInfo (directly, or on an enclosing scope).");
+};
+template <typename T, uint index>
+struct FieldInfo_;
+// Compile-time description of struct fields.  The generated code specializes FieldInfo_ for
+// every field of every struct annotated with $Cxx.fieldInfo; see FieldInfo, below.
+
+template <typename T, uint index, uint count>
+struct ForEachField_;
+
+template <typename T>
+struct Visit_ {
+  static_assert(sizeof(T) == 0, "visit() needs the struct, and every struct type below it, to be "
+                "annotated with $Cxx.fieldInfo (directly, or on an enclosing scope).");
+};
+// Generated along with FieldInfo_; walks the struct's fields.  See visit(), below.
+
 kj::StringTree structString(StructReader reader, const RawSchema& schema);
 // Declared here so that we can declare inline stringify methods on generated types.
 // Defined in stringify.c++, which depends on dynamic.c++, which is allowed not to be linked in.
@@ -212,8 +259,103 @@ private:
   const word* ptr;
 };
 
+template <typename T, uint index, uint count>
+struct ForEachField_ {
+  template <typename Func>
+  static inline void apply(Func& func) {
+    func(FieldInfo_<T, index>());
+    ForEachField_<T, index + 1, count>::apply(func);
+  }
+};
+template <typename T, uint count>
+struct ForEachField_<T, count, count> {
+  template <typename Func>
+  static inline void apply(Func& func) {}
+};
+
+template <typename T, Kind k = kind<T>()>
+struct VisitChildren_ {
+  // Primitives, blobs, enums, and AnyPointers have no children.
+  template <typename Value, typename Visitor>
+  static inline void apply(Value value, Visitor& visitor) {}
+};
+template <typename T>
+struct VisitChildren_<T, Kind::STRUCT> {
+  template <typename Value, typename Visitor>
+  static inline void apply(Value value, Visitor& visitor) {
+    Visit_<T>::apply(value, visitor);
+  }
+};
+template <typename T>
+struct VisitChildren_<List<T>, Kind::LIST> {
+  template <typename Value, typename Visitor>
+  static inline void apply(Value value, Visitor& visitor) {
+    for (auto element: value) {
+      VisitChildren_<T>::apply(element, visitor);
+    }
+  }
+};
+template <typename Field, typename Value, typename Visitor>
+inline void visitField(Value value, Visitor& visitor) {
+  visitor(Field(), value);
+  VisitChildren_<typename Field::Type>::apply(value, visitor);
+}
+
 }  // namespace _ (private)
 
+enum class FieldLocation: uint8_t {
+  // Where a field's value lives within its struct.  See FieldInfo::location.
+
+  NONE,      // Void field; takes no space.
+  DATA,      // Data section; `offset` is in multiples of the field's size (bits, for Bool).
+  POINTERS,  // Pointer section; `offset` is a pointer index.
+  GROUP      // A group, whose own fields are described by FieldInfo<Type, i>.
+};
+
+template <typename T, uint index>
+using FieldInfo = _::FieldInfo_<T, index>;
+// FieldInfo<MyStruct, i> describes the field of MyStruct at position `i` in the schema's field
+// list (i.e. StructSchema::Field::getIndex()), entirely at compile time, so that generic code
+// (hashers, columnar extractors, serializers) can be specialized for each field instead of going
+// through the dynamic API.  Only available for structs annotated with $Cxx.fieldInfo, or declared
+// in a scope that is.  Members:
+//
+//     typedef MyStruct Struct;
+//     typedef ... Type;             // The field's type, e.g. uint32_t, Text, List<Foo>, or Group.
+//     static constexpr uint index;
+//     static constexpr const char* name;
+//     static constexpr FieldLocation location;
+//     static constexpr uint32_t offset;            // 0 unless location is DATA or POINTERS.
+//     static constexpr uint16_t discriminantValue; // 0xffff if not a union member.
+//     static constexpr _::Mask<Type> mask;         // Default value XOR mask; DATA fields only.
+//     static auto get(MyStruct::Reader or MyStruct::Builder);  // Calls the field's getter.
+//     static void set(MyStruct::Builder, Type);                 // NONE and DATA fields only.
+
+template <typename T>
+inline constexpr uint fieldCount() { return _::FieldCount_<T>::value; }
+// Number of fields in the struct, i.e. the valid range of FieldInfo indexes.
+
+template <typename T, typename Func>
+inline void forEachField(Func&& func) {
+  // Calls `func(FieldInfo<T, i>())` for every field of T, in index order.  `func` is typically a
+  // functor with a templated operator() so that the body is instantiated once per field.
+
+  _::ForEachField_<T, 0, fieldCount<T>()>::apply(func);
+}
+
+template <typename Reader, typename Visitor>
+inline void visit(Reader reader, Visitor& visitor) {
+  // Walks the whole tree below a struct Reader with static types, calling
+  // `visitor(FieldInfo<T, i>(), value)` for every field that is present, and then descending into
+  // it if it is a struct, group, or list of those.  A field is present unless it is an inactive
+  // union member or a null pointer.  Interface fields are skipped.  Since every call has a
+  // statically-known field and value type, a visitor with a templated (or overloaded) operator()
+  // compiles down to direct accessor calls -- much faster than walking with DynamicStruct.  Like
+  // FieldInfo, this needs every struct type in the tree to be annotated with $Cxx.fieldInfo.
+
+  _::Visit_<FromReader<Reader>>::apply(reader, visitor);
+}
+
 template <typename T>
 inline constexpr uint64_t typeId() { return _::TypeId_<T>::typeId; }
 // typeId<MyType>() returns the type ID as defined in the schema.  Works with structs, enums, and
@@ -255,6 +397,65 @@ inline constexpr uint sizeInWords() {
     constexpr StructSize StructSize_<type>::value; \
     constexpr uint64_t TypeId_<type>::typeId
 
+#define CAPNP_DECLARE_FIELDS(type, count) \
+    template <> struct FieldCount_<type> { static constexpr uint value = count; }
+#define CAPNP_DEFINE_FIELDS(type) \
+    constexpr uint FieldCount_<type>::value
+
+#define CAPNP_DECLARE_FIELD_COMMON(type, index_, name_, location_, offset_, discriminant) \
+      typedef type Struct; \
+      static constexpr uint index = index_; \
+      static constexpr const char* name = #name_; \
+      static constexpr ::capnp::FieldLocation location = ::capnp::FieldLocation::location_; \
+      static constexpr uint32_t offset = offset_; \
+      static constexpr uint16_t discriminantValue = discriminant
+#define CAPNP_DECLARE_FIELD_GETTER(Name) \
+      template <typename ReaderOrBuilder> \
+      static inline auto get(ReaderOrBuilder r) -> decltype(r.get##Name()) { \
+        return r.get##Name(); \
+      }
+#define CAPNP_DECLARE_FIELD_SETTER(Name) \
+      template <typename Builder> \
+      static inline void set(Builder b, Type value) { b.set##Name(value); }
+
+#define CAPNP_DECLARE_VOID_FIELD(type, index, name, Name, discriminant) \
+    template <> struct FieldInfo_<type, index> { \
+      typedef ::capnp::Void Type; \
+      CAPNP_DECLARE_FIELD_COMMON(type, index, name, NONE, 0, discriminant); \
+      CAPNP_DECLARE_FIELD_GETTER(Name) \
+      CAPNP_DECLARE_FIELD_SETTER(Name) \
+    }
+#define CAPNP_DECLARE_DATA_FIELD( \
+        type, index, name, Name, discriminant, offset, maskType, mask_, ...) \
+    template <> struct FieldInfo_<type, index> { \
+      typedef __VA_ARGS__ Type; \
+      CAPNP_DECLARE_FIELD_COMMON(type, index, name, DATA, offset, discriminant); \
+      static constexpr maskType mask = mask_; \
+      CAPNP_DECLARE_FIELD_GETTER(Name) \
+      CAPNP_DECLARE_FIELD_SETTER(Name) \
+    }
+#define CAPNP_DECLARE_POINTER_FIELD(type, index, name, Name, discriminant, offset, ...) \
+    template <> struct FieldInfo_<type, index> { \
+      typedef __VA_ARGS__ Type; \
+      CAPNP_DECLARE_FIELD_COMMON(type, index, name, POINTERS, offset, discriminant); \
+      CAPNP_DECLARE_FIELD_GETTER(Name) \
+    }
+#define CAPNP_DECLARE_GROUP_FIELD(type, index, name, Name, discriminant, ...) \
+    template <> struct FieldInfo_<type, index> { \
+      typedef __VA_ARGS__ Type; \
+      CAPNP_DECLARE_FIELD_COMMON(type, index, name, GROUP, 0, discriminant); \
+      CAPNP_DECLARE_FIELD_GETTER(Name) \
+    }
+#define CAPNP_DEFINE_FIELD(type, index_) \
+    constexpr uint FieldInfo_<type, index_>::index; \
+    constexpr const char* FieldInfo_<type, index_>::name; \
+    constexpr ::capnp::FieldLocation FieldInfo_<type, index_>::location; \
+    constexpr uint32_t FieldInfo_<type, index_>::offset; \
+    constexpr uint16_t FieldInfo_<type, index_>::discriminantValue
+#define CAPNP_DEFINE_DATA_FIELD(type, index_) \
+    CAPNP_DEFINE_FIELD(type, index_); \
+    constexpr decltype(FieldInfo_<type, index_>::mask) FieldInfo_<type, index_>::mask
+
 #define CAPNP_DECLARE_UNION(type, parentType, memberIndex) \
     template <> struct Kind_<type> { static constexpr Kind kind = Kind::UNION; }; \
     template <> struct UnionMemberIndex_<type> { static constexpr uint value = memberIndex; }; \
@@ -0,0 +1,263 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "json.h"
+#include "message.h"
+#include <kj/debug.h>
+#include <gtest/gtest.h>
+#include "test-util.h"
+
+namespace kj {
+  inline std::ostream& operator<<(std::ostream& os, const kj::String& s) {
+    return os.write(s.begin(), s.size());
+  }
+}
+
+namespace capnp {
+namespace _ {  // private
+namespace {
+
+TEST(Json, Encode) {
+  MallocMessageBuilder builder;
+  auto root = builder.initRoot<TestAllTypes>();
+  root.setInt32Field(-123);
+  root.setUInt64Field(12345678901234567890ull);
+  root.setFloat32Field(1.5);
+  root.setFloat64Field(kj::inf());
+  root.setTextField("foo \"bar\"\n\x01");
+  root.setDataField(data("\x01\xff"));
+  root.setEnumField(TestEnum::GARPLY);
+  root.initStructField().setBoolField(true);
+  root.setInt16List({1, -2});
+  root.setTextList({"a", "b"});
+
+  EXPECT_EQ(
+      "{\"voidField\":null,\"boolField\":false,\"int8Field\":0,\"int16Field\":0,"
+      "\"int32Field\":-123,\"int64Field\":0,\"uInt8Field\":0,\"uInt16Field\":0,"
+      "\"uInt32Field\":0,\"uInt64Field\":12345678901234567890,"
+      "\"float32Field\":1.5,\"float64Field\":\"Infinity\","
+      "\"textField\":\"foo \\\"bar\\\"\\n\\u0001\",\"dataField\":[1,255],"
+      "\"structField\":{\"voidField\":null,\"boolField\":true,\"int8Field\":0,"
+          "\"int16Field\":0,\"int32Field\":0,\"int64Field\":0,\"uInt8Field\":0,"
+          "\"uInt16Field\":0,\"uInt32Field\":0,\"uInt64Field\":0,\"float32Field\":0,"
+          "\"float64Field\":0,\"enumField\":\"foo\",\"interfaceField\":null},"
+      "\"enumField\":\"garply\",\"interfaceField\":null,"
+      "\"int16List\":[1,-2],\"textList\":[\"a\",\"b\"]}",
+      toJson(root.asReader()));
+}
+
+TEST(Json, RoundTrip) {
+  MallocMessageBuilder builder;
+  initTestMessage(builder.initRoot<TestAllTypes>());
+
+  auto json = toJson(builder.getRoot<TestAllTypes>().asReader());
+
+  MallocMessageBuilder decoded;
+  readJson(json, decoded, Schema::from<TestAllTypes>());
+  checkTestMessage(decoded.getRoot<TestAllTypes>().asReader());
+
+  // Encoding again gives the same text.
+  EXPECT_EQ(json, toJson(decoded.getRoot<TestAllTypes>().asReader()));
+}
+
+TEST(Json, RoundTripUnionsAndGroups) {
+  MallocMessageBuilder builder;
+  auto root = builder.initRoot<test::TestGroups>();
+  root.getGroups().initBaz().setGrault("abc");
+
+  auto json = toJson(root.asReader());
+  EXPECT_EQ("{\"groups\":{\"baz\":{\"corge\":0,\"grault\":\"abc\"}}}", json);
+
+  MallocMessageBuilder decoded;
+  auto decodedRoot = readJson(json, decoded, Schema::from<test::TestGroups>())
+      .as<test::TestGroups>();
+  ASSERT_EQ(test::TestGroups::Groups::BAZ, decodedRoot.getGroups().which());
+  EXPECT_EQ("abc", decodedRoot.getGroups().getBaz().getGrault());
+
+  // A non-default union member which is a null pointer is still written, so that it is
+  // selected when decoding.
+  MallocMessageBuilder builder2;
+  auto root2 = builder2.initRoot<TestUnion>();
+  root2.getUnion1().setU1f1sp(nullptr);
+  root2.getUnion1().disownU1f1sp();
+  EXPECT_TRUE(root2.getUnion1().isU1f1sp());
+
+  MallocMessageBuilder decoded2;
+  readJson(toJson(root2.asReader()), decoded2, Schema::from<TestUnion>());
+  EXPECT_TRUE(decoded2.getRoot<TestUnion>().getUnion1().isU1f1sp());
+}
+
+TEST(Json, Decode) {
+  MallocMessageBuilder builder;
+  auto root = readJson(kj::StringPtr(
+      " { \"int32Field\" : -5, \"float32Field\": 2.5e1, \"float64Field\": \"-Infinity\",\n"
+      "   \"textField\": \"a\\\"\\\\\\/\\b\\f\\n\\r\\t\\u00e9\\ud83d\\ude00\",\n"
+      "   \"enumField\": 7, \"unknownField\": {\"x\": [1, \"]\", {}]},\n"
+      "   \"structField\": null, \"dataField\": [0, 7], \"boolList\": [true, false] } "),
+      builder, Schema::from<TestAllTypes>()).as<TestAllTypes>();
+
+  EXPECT_EQ(-5, root.getInt32Field());
+  EXPECT_EQ(25, root.getFloat32Field());
+  EXPECT_EQ(-kj::inf(), root.getFloat64Field());
+  EXPECT_EQ("a\"\\/\b\f\n\r\t\xc3\xa9\xf0\x9f\x98\x80", root.getTextField());
+  EXPECT_EQ(TestEnum::GARPLY, root.getEnumField());
+  EXPECT_FALSE(root.hasStructField());
+  EXPECT_EQ(Data::Reader(reinterpret_cast<const byte*>("\x00\x07"), 2), root.getDataField());
+  ASSERT_EQ(2u, root.getBoolList().size());
+  EXPECT_TRUE(root.getBoolList()[0]);
+  EXPECT_FALSE(root.getBoolList()[1]);
+}
+
+TEST(Json, DecodeErrors) {
+  auto schema = Schema::from<TestAllTypes>();
+  auto tryDecode = [&](kj::StringPtr json) {
+    MallocMessageBuilder builder;
+    readJson(json, builder, schema);
+  };
+
+  EXPECT_ANY_THROW(tryDecode(""));
+  EXPECT_ANY_THROW(tryDecode("{"));
+  EXPECT_ANY_THROW(tryDecode("{} {}"));
+  EXPECT_ANY_THROW(tryDecode("{\"int32Field\": }"));
+  EXPECT_ANY_THROW(tryDecode("{\"int8Field\": 1000}"));
+  EXPECT_ANY_THROW(tryDecode("{\"uInt32Field\": -1}"));
+  EXPECT_ANY_THROW(tryDecode("{\"boolField\": 1}"));
+  EXPECT_ANY_THROW(tryDecode("{\"textField\": \"abc}"));
+  EXPECT_ANY_THROW(tryDecode("{\"textField\": \"\\q\"}"));
+  EXPECT_ANY_THROW(tryDecode("{\"enumField\": \"notAnEnumerant\"}"));
+  EXPECT_ANY_THROW(tryDecode("{\"int32List\": [1, 2}"));
+  EXPECT_ANY_THROW(tryDecode("{\"dataField\": [256]}"));
+  EXPECT_ANY_THROW(tryDecode("{\"int32List\": [1, 2}}"));
+  EXPECT_ANY_THROW(tryDecode("{\"unknownField\": [1}}"));
+  EXPECT_ANY_THROW(tryDecode("{\"unknownField\": {\"a\": [1}]}"));
+}
+
+TEST(Json, NestingLimit) {
+  auto schema = Schema::from<TestAllTypes>();
+  auto nestedStructs = [](uint depth) {
+    kj::Vector<char> json;
+    for (uint i = 0; i < depth; i++) json.addAll(kj::StringPtr("{\"structField\":"));
+    json.addAll(kj::StringPtr("{}"));
+    for (uint i = 0; i < depth; i++) json.add('}');
+    return json.releaseAsArray();
+  };
+
+  {
+    // The root counts as one level, so this is exactly at the limit.
+    MallocMessageBuilder builder;
+    readJson(nestedStructs(63), builder, schema);
+  }
+  {
+    MallocMessageBuilder builder;
+    EXPECT_ANY_THROW(readJson(nestedStructs(64), builder, schema));
+  }
+  {
+    // Deeply nested values are rejected even when they are only being skipped.
+    kj::Vector<char> json;
+    json.addAll(kj::StringPtr("{\"unknownField\":"));
+    for (uint i = 0; i < 100000; i++) json.add('[');
+    for (uint i = 0; i < 100000; i++) json.add(']');
+    json.add('}');
+    MallocMessageBuilder builder;
+    EXPECT_ANY_THROW(readJson(json, builder, schema));
+  }
+}
+
+TEST(Json, NestedLists) {
+  MallocMessageBuilder builder;
+  auto root = readJson(kj::StringPtr(
+      "{\"int32ListList\": [[1, 2, 3], [], [4, 5]],"
+      " \"structListList\": [[{\"int32List\": [7, 8, 9]}, {}], []]}"),
+      builder, Schema::from<test::TestLists>()).as<test::TestLists>();
+
+  auto int32ListList = root.getInt32ListList();
+  ASSERT_EQ(3u, int32ListList.size());
+  EXPECT_EQ(3u, int32ListList[0].size());
+  EXPECT_EQ(0u, int32ListList[1].size());
+  ASSERT_EQ(2u, int32ListList[2].size());
+  EXPECT_EQ(5, int32ListList[2][1]);
+
+  auto structListList = root.getStructListList();
+  ASSERT_EQ(2u, structListList.size());
+  ASSERT_EQ(2u, structListList[0].size());
+  EXPECT_EQ(0u, structListList[1].size());
+  ASSERT_EQ(3u, structListList[0][0].getInt32List().size());
+  EXPECT_EQ(9, structListList[0][0].getInt32List()[2]);
+}
+
+TEST(Json, ListsArePreSized) {
+  // Lists should be allocated exactly once, so decoding shouldn't leave any garbage behind in
+  // the message: it should be exactly as big as a copy of itself.
+
+  MallocMessageBuilder builder;
+  initTestMessage(builder.initRoot<TestAllTypes>());
+
+  MallocMessageBuilder decoded;
+  readJson(toJson(builder.getRoot<TestAllTypes>().asReader()), decoded,
+           Schema::from<TestAllTypes>());
+
+  MallocMessageBuilder copy;
+  copy.setRoot(decoded.getRoot<TestAllTypes>().asReader());
+
+  EXPECT_EQ(copy.getRoot<TestAllTypes>().totalSize().wordCount,
+            decoded.getRoot<TestAllTypes>().totalSize().wordCount);
+
+  auto messageSize = [](MessageBuilder& message) {
+    size_t words = 0;
+    for (auto segment: message.getSegmentsForOutput()) {
+      words += segment.size();
+    }
+    return words;
+  };
+  EXPECT_EQ(messageSize(copy), messageSize(decoded));
+}
+
+TEST(Json, SmallOutputBuffer) {
+  // Make sure output is assembled correctly when it doesn't fit in the stream's buffer.
+
+  MallocMessageBuilder builder;
+  initTestMessage(builder.initRoot<TestAllTypes>());
+  auto expected = toJson(builder.getRoot<TestAllTypes>().asReader());
+
+  kj::Array<byte> result = kj::heapArray<byte>(expected.size());
+  kj::ArrayOutputStream arrayOutput(result);
+  byte buffer[7];
+  {
+    kj::BufferedOutputStreamWrapper output(arrayOutput, kj::arrayPtr(buffer, sizeof(buffer)));
+    writeJson(output, builder.getRoot<TestAllTypes>().asReader());
+  }
+
+  EXPECT_EQ(expected, kj::heapString(reinterpret_cast<char*>(result.begin()), result.size()));
+}
+
+TEST(Json, List) {
+  MallocMessageBuilder builder;
+  auto root = builder.initRoot<TestAllTypes>();
+  root.setUInt8List({1, 2, 3});
+
+  EXPECT_EQ("[1,2,3]", toJson(root.asReader().getUInt8List()));
+}
+
+}  // namespace
+}  // namespace _ (private)
+}  // namespace capnp
@@ -0,0 +1,630 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "json.h"
+#include "message.h"
+#include "text-scanner.h"
+#include <kj/debug.h>
+#include <kj/vector.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <cmath>
+#include <limits>
+
+namespace capnp {
+
+namespace {
+
+static const char HEXDIGITS[] = "0123456789abcdef";
+
+static schema::Type::Which whichFieldType(const StructSchema::Field& field) {
+  auto proto = field.getProto();
+  switch (proto.which()) {
+    case schema::Field::SLOT:
+      return proto.getSlot().getType().which();
+    case schema::Field::GROUP:
+      return schema::Type::STRUCT;
+  }
+  KJ_UNREACHABLE;
+}
+
+class JsonWriter {
+  // Writes JSON straight into the write buffer of a BufferedOutputStream, handing full buffers
+  // back to the stream as it goes.
+
+public:
+  explicit JsonWriter(kj::BufferedOutputStream& output): output(output) {
+    refill();
+  }
+
+  void flush() {
+    if (pos != start) {
+      output.write(start, pos - start);
+    }
+    refill();
+  }
+
+  void writeValue(const DynamicValue::Reader& value, schema::Type::Which which);
+  void writeStruct(DynamicStruct::Reader value);
+  void writeList(DynamicList::Reader value);
+
+private:
+  kj::BufferedOutputStream& output;
+  char* start;
+  char* pos;
+  char* end;
+
+  void refill() {
+    auto buffer = output.getWriteBuffer();
+    start = pos = reinterpret_cast<char*>(buffer.begin());
+    end = reinterpret_cast<char*>(buffer.end());
+  }
+
+  inline void put(char c) {
+    if (KJ_LIKELY(pos < end)) {
+      *pos++ = c;
+    } else {
+      putSlow(kj::arrayPtr(&c, 1));
+    }
+  }
+
+  inline void put(kj::ArrayPtr<const char> chars) {
+    if (KJ_LIKELY(chars.size() <= size_t(end - pos))) {
+      memcpy(pos, chars.begin(), chars.size());
+      pos += chars.size();
+    } else {
+      putSlow(chars);
+    }
+  }
+
+  template <size_t n>
+  inline void put(const char (&literal)[n]) {
+    put(kj::arrayPtr(literal, n - 1));
+  }
+
+  template <typename T>
+  inline void putNumber(T value) {
+    auto chars = kj::toCharSequence(value);
+    put(kj::arrayPtr(chars.begin(), chars.size()));
+  }
+
+  void putSlow(kj::ArrayPtr<const char> chars) {
+    flush();
+    if (chars.size() <= size_t(end - pos)) {
+      memcpy(pos, chars.begin(), chars.size());
+      pos += chars.size();
+    } else {
+      // Bigger than the stream's buffer (or the stream has no buffer space left at all); let it
+      // deal with the bytes directly.
+      output.write(chars.begin(), chars.size());
+      refill();
+    }
+  }
+
+  void writeFloat(double value, schema::Type::Which which);
+  void writeString(kj::ArrayPtr<const char> chars);
+};
+
+void JsonWriter::writeFloat(double value, schema::Type::Which which) {
+  if (std::isnan(value)) {
+    put("\"NaN\"");
+  } else if (std::isinf(value)) {
+    if (value > 0) {
+      put("\"Infinity\"");
+    } else {
+      put("\"-Infinity\"");
+    }
+  } else if (which == schema::Type::FLOAT32) {
+    putNumber(static_cast<float>(value));
+  } else {
+    putNumber(value);
+  }
+}
+
+void JsonWriter::writeString(kj::ArrayPtr<const char> chars) {
+  put('"');
+
+  const char* runStart = chars.begin();
+  for (const char* p = chars.begin(); p != chars.end(); ++p) {
+    unsigned char c = *p;
+    if (KJ_LIKELY(c >= 0x20 && c != '"' && c != '\\')) continue;
+
+    put(kj::arrayPtr(runStart, p));
+    runStart = p + 1;
+
+    switch (c) {
+      case '"': put("\\\""); break;
+      case '\\': put("\\\\"); break;
+      case '\b': put("\\b"); break;
+      case '\f': put("\\f"); break;
+      case '\n': put("\\n"); break;
+      case '\r': put("\\r"); break;
+      case '\t': put("\\t"); break;
+      default: {
+        char escape[6] = { '\\', 'u', '0', '0', HEXDIGITS[c / 16], HEXDIGITS[c % 16] };
+        put(kj::arrayPtr(escape, sizeof(escape)));
+        break;
+      }
+    }
+  }
+  put(kj::arrayPtr(runStart, chars.end()));
+
+  put('"');
+}
+
+void JsonWriter::writeValue(const DynamicValue::Reader& value, schema::Type::Which which) {
+  switch (value.getType()) {
+    case DynamicValue::UNKNOWN:
+    case DynamicValue::VOID:
+    case DynamicValue::CAPABILITY:
+    case DynamicValue::ANY_POINTER:
+      put("null");
+      return;
+    case DynamicValue::BOOL:
+      if (value.as<bool>()) {
+        put("true");
+      } else {
+        put("false");
+      }
+      return;
+    case DynamicValue::INT:
+      putNumber(value.as<int64_t>());
+      return;
+    case DynamicValue::UINT:
+      putNumber(value.as<uint64_t>());
+      return;
+    case DynamicValue::FLOAT:
+      writeFloat(value.as<double>(), which);
+      return;
+    case DynamicValue::TEXT:
+      writeString(value.as<Text>());
+      return;
+    case DynamicValue::DATA: {
+      put('[');
+      bool first = true;
+      for (byte b: value.as<Data>()) {
+        if (!first) put(',');
+        first = false;
+        putNumber(static_cast<uint>(b));
+      }
+      put(']');
+      return;
+    }
+    case DynamicValue::LIST:
+      writeList(value.as<DynamicList>());
+      return;
+    case DynamicValue::ENUM: {
+      auto enumValue = value.as<DynamicEnum>();
+      KJ_IF_MAYBE(enumerant, enumValue.getEnumerant()) {
+        put('"');
+        put(enumerant->getProto().getName());
+        put('"');
+      } else {
+        // Unknown enum value; output raw number.
+        putNumber(enumValue.getRaw());
+      }
+      return;
+    }
+    case DynamicValue::STRUCT:
+      writeStruct(value.as<DynamicStruct>());
+      return;
+  }
+
+  KJ_UNREACHABLE;
+}
+
+void JsonWriter::writeStruct(DynamicStruct::Reader value) {
+  put('{');
+
+  // Like the text format, write the active union member even if it is a null pointer, unless it
+  // is the default member, so that the reader ends up with the same member selected.
+  uint activeUnionMember = kj::maxValue;
+  KJ_IF_MAYBE(field, value.which()) {
+    if (field->getProto().getDiscriminantValue() != 0) {
+      activeUnionMember = field->getIndex();
+    }
+  }
+
+  bool first = true;
+  for (auto field: value.getSchema().getFields()) {
+    if (field.getIndex() != activeUnionMember && !value.has(field)) continue;
+
+    if (!first) put(',');
+    first = false;
+
+    // Field names are identifiers, so they never need escaping.
+    put('"');
+    put(field.getProto().getName());
+    put("\":");
+    writeValue(value.get(field), whichFieldType(field));
+  }
+
+  put('}');
+}
+
+void JsonWriter::writeList(DynamicList::Reader value) {
+  auto which = value.getSchema().whichElementType();
+
+  put('[');
+  bool first = true;
+  for (auto element: value) {
+    if (!first) put(',');
+    first = false;
+    writeValue(element, which);
+  }
+  put(']');
+}
+
+class StringOutputStream final: public kj::BufferedOutputStream {
+  // Accumulates everything written into a growable buffer.
+
+public:
+  StringOutputStream(): buffer(kj::heapArray<byte>(4096)), fill(0) {}
+
+  kj::String finish() {
+    auto result = kj::heapString(fill);
+    memcpy(result.begin(), buffer.begin(), fill);
+    return result;
+  }
+
+  kj::ArrayPtr<byte> getWriteBuffer() override {
+    if (fill == buffer.size()) {
+      grow(fill + 1);
+    }
+    return buffer.slice(fill, buffer.size());
+  }
+
+  void write(const void* data, size_t size) override {
+    if (data != buffer.begin() + fill) {
+      if (fill + size > buffer.size()) {
+        grow(fill + size);
+      }
+      memcpy(buffer.begin() + fill, data, size);
+    }
+    fill += size;
+  }
+
+private:
+  kj::Array<byte> buffer;
+  size_t fill;
+
+  void grow(size_t minSize) {
+    auto newBuffer = kj::heapArray<byte>(kj::max(minSize, buffer.size() * 2));
+    memcpy(newBuffer.begin(), buffer.begin(), fill);
+    buffer = kj::mv(newBuffer);
+  }
+};
+
+// =======================================================================================
+
+class JsonParser: public _::TextScanner {
+  // Parses JSON text directly into a message.  Before allocating a list or data blob, the parser
+  // looks ahead to count its elements, so that every list is allocated exactly once, at its final
+  // size.
+
+public:
+  explicit JsonParser(kj::ArrayPtr<const char> input): TextScanner(input, Dialect::JSON) {}
+
+  void parseStruct(DynamicStruct::Builder builder);
+
+  void finish() {
+    if (!atEnd()) fail("Unexpected text after JSON value.");
+  }
+
+private:
+  inline bool tryConsumeNull() { return tryConsumeWord("null"); }
+
+  DynamicValue::Reader parseNumber();
+  DynamicValue::Reader parsePrimitive(schema::Type::Which which);
+  DynamicEnum parseEnum(EnumSchema schema);
+
+  void parseField(DynamicStruct::Builder builder, StructSchema::Field field);
+  void parseList(DynamicList::Builder builder);
+  void parseData(Data::Builder builder);
+};
+
+DynamicValue::Reader JsonParser::parseNumber() {
+  skipWhitespace();
+
+  const char* start = pos;
+  bool isFloat = false;
+  if (peek() == '-') ++pos;
+  while (pos < end) {
+    char c = *pos;
+    if ('0' <= c && c <= '9') {
+      // ok
+    } else if (c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+      isFloat = true;
+    } else {
+      break;
+    }
+    ++pos;
+  }
+
+  size_t size = pos - start;
+  if (size == 0) fail("Expected number.");
+
+  char buffer[64];
+  if (size >= sizeof(buffer)) fail("Number is too long.");
+  memcpy(buffer, start, size);
+  buffer[size] = '\0';
+
+  char* numberEnd;
+  errno = 0;
+  if (isFloat) {
+    double value = strtod(buffer, &numberEnd);
+    if (numberEnd != buffer + size) fail("Invalid number.");
+    return value;
+  } else if (buffer[0] == '-') {
+    long long value = strtoll(buffer, &numberEnd, 10);
+    if (numberEnd != buffer + size) fail("Invalid number.");
+    if (errno == ERANGE) fail("Integer is out of range.");
+    return static_cast<int64_t>(value);
+  } else {
+    unsigned long long value = strtoull(buffer, &numberEnd, 10);
+    if (numberEnd != buffer + size) fail("Invalid number.");
+    if (errno == ERANGE) fail("Integer is out of range.");
+    return static_cast<uint64_t>(value);
+  }
+}
+
+DynamicValue::Reader JsonParser::parsePrimitive(schema::Type::Which which) {
+  switch (which) {
+    case schema::Type::BOOL:
+      if (tryConsumeWord("true")) return true;
+      if (tryConsumeWord("false")) return false;
+      fail("Expected true or false.");
+
+    case schema::Type::FLOAT32:
+    case schema::Type::FLOAT64:
+      skipWhitespace();
+      if (peek() == '"') {
+        auto text = parseString();
+        if (text == "NaN") {
+          return std::numeric_limits<double>::quiet_NaN();
+        } else if (text == "Infinity") {
+          return std::numeric_limits<double>::infinity();
+        } else if (text == "-Infinity") {
+          return -std::numeric_limits<double>::infinity();
+        } else {
+          fail("Expected number.");
+        }
+      }
+      return parseNumber();
+
+    default:
+      return parseNumber();
+  }
+}
+
+DynamicEnum JsonParser::parseEnum(EnumSchema schema) {
+  skipWhitespace();
+  if (peek() == '"') {
+    KJ_IF_MAYBE(enumerant, schema.findEnumerantByName(parseString())) {
+      return DynamicEnum(*enumerant);
+    } else {
+      fail("Unknown enumerant name.");
+    }
+  } else {
+    return DynamicEnum(schema, parseNumber().as<uint16_t>());
+  }
+}
+
+void JsonParser::parseStruct(DynamicStruct::Builder builder) {
+  Nested nested(*this);
+  expect('{');
+  if (tryConsume('}')) return;
+
+  StructSchema schema = builder.getSchema();
+  do {
+    KJ_IF_MAYBE(field, schema.findFieldByName(parseString())) {
+      expect(':');
+      parseField(builder, *field);
+    } else {
+      // Unknown field, perhaps from a newer version of the schema.
+      expect(':');
+      skipValue();
+    }
+  } while (tryConsume(','));
+  expect('}');
+}
+
+void JsonParser::parseField(DynamicStruct::Builder builder, StructSchema::Field field) {
+  auto proto = field.getProto();
+  switch (proto.which()) {
+    case schema::Field::SLOT:
+      break;
+    case schema::Field::GROUP:
+      parseStruct(builder.init(field).as<DynamicStruct>());
+      return;
+  }
+
+  auto type = proto.getSlot().getType();
+  switch (type.which()) {
+    case schema::Type::VOID:
+      if (!tryConsumeNull()) fail("Expected null.");
+      builder.set(field, VOID);
+      return;
+
+    case schema::Type::BOOL:
+    case schema::Type::INT8:
+    case schema::Type::INT16:
+    case schema::Type::INT32:
+    case schema::Type::INT64:
+    case schema::Type::UINT8:
+    case schema::Type::UINT16:
+    case schema::Type::UINT32:
+    case schema::Type::UINT64:
+    case schema::Type::FLOAT32:
+    case schema::Type::FLOAT64:
+      builder.set(field, parsePrimitive(type.which()));
+      return;
+
+    case schema::Type::ENUM:
+      builder.set(field, parseEnum(
+          builder.getSchema().getDependency(type.getEnum().getTypeId()).asEnum()));
+      return;
+
+    default:
+      break;
+  }
+
+  // Pointer field.
+  if (tryConsumeNull()) {
+    builder.clear(field);
+    return;
+  }
+
+  switch (type.which()) {
+    case schema::Type::TEXT:
+      builder.set(field, Text::Reader(parseString()));
+      return;
+    case schema::Type::DATA:
+      parseData(builder.init(field, countElements()).as<Data>());
+      return;
+    case schema::Type::LIST:
+      parseList(builder.init(field, countElements()).as<DynamicList>());
+      return;
+    case schema::Type::STRUCT:
+      parseStruct(builder.init(field).as<DynamicStruct>());
+      return;
+    default:
+      fail("Capabilities and AnyPointers can only be null in JSON.");
+  }
+}
+
+void JsonParser::parseList(DynamicList::Builder builder) {
+  Nested nested(*this);
+  auto schema = builder.getSchema();
+  auto which = schema.whichElementType();
+
+  expect('[');
+  for (uint i = 0; i < builder.size(); i++) {
+    if (i > 0) expect(',');
+
+    switch (which) {
+      case schema::Type::VOID:
+        if (!tryConsumeNull()) fail("Expected null.");
+        break;
+
+      case schema::Type::BOOL:
+      case schema::Type::INT8:
+      case schema::Type::INT16:
+      case schema::Type::INT32:
+      case schema::Type::INT64:
+      case schema::Type::UINT8:
+      case schema::Type::UINT16:
+      case schema::Type::UINT32:
+      case schema::Type::UINT64:
+      case schema::Type::FLOAT32:
+      case schema::Type::FLOAT64:
+        builder.set(i, parsePrimitive(which));
+        break;
+
+      case schema::Type::ENUM:
+        builder.set(i, parseEnum(schema.getEnumElementType()));
+        break;
+
+      case schema::Type::STRUCT:
+        parseStruct(builder[i].as<DynamicStruct>());
+        break;
+
+      case schema::Type::TEXT:
+        if (!tryConsumeNull()) {
+          builder.set(i, Text::Reader(parseString()));
+        }
+        break;
+
+      case schema::Type::DATA:
+        if (!tryConsumeNull()) {
+          parseData(builder.init(i, countElements()).as<Data>());
+        }
+        break;
+
+      case schema::Type::LIST:
+        if (!tryConsumeNull()) {
+          parseList(builder.init(i, countElements()).as<DynamicList>());
+        }
+        break;
+
+      case schema::Type::INTERFACE:
+      case schema::Type::ANY_POINTER:
+        if (!tryConsumeNull()) {
+          fail("Capabilities and AnyPointers can only be null in JSON.");
+        }
+        break;
+    }
+  }
+  expect(']');
+}
+
+void JsonParser::parseData(Data::Builder builder) {
+  expect('[');
+  for (uint i = 0; i < builder.size(); i++) {
+    if (i > 0) expect(',');
+    builder[i] = parseNumber().as<uint8_t>();
+  }
+  expect(']');
+}
+
+}  // namespace
+
+void writeJson(kj::BufferedOutputStream& output, DynamicStruct::Reader value) {
+  JsonWriter writer(output);
+  writer.writeStruct(value);
+  writer.flush();
+}
+
+void writeJson(kj::BufferedOutputStream& output, DynamicList::Reader value) {
+  JsonWriter writer(output);
+  writer.writeList(value);
+  writer.flush();
+}
+
+kj::String toJson(DynamicStruct::Reader value) {
+  StringOutputStream output;
+  writeJson(output, value);
+  return output.finish();
+}
+
+kj::String toJson(DynamicList::Reader value) {
+  StringOutputStream output;
+  writeJson(output, value);
+  return output.finish();
+}
+
+void readJson(kj::ArrayPtr<const char> input, DynamicStruct::Builder output) {
+  JsonParser parser(input);
+  parser.parseStruct(output);
+  parser.finish();
+}
+
+DynamicStruct::Builder readJson(kj::ArrayPtr<const char> input, MessageBuilder& message,
+                                StructSchema schema) {
+  auto root = message.initRoot<DynamicStruct>(schema);
+  readJson(input, root);
+  return root;
+}
+
+}  // namespace capnp
@@ -0,0 +1,67 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef CAPNP_JSON_H_
+#define CAPNP_JSON_H_
+
+#include "dynamic.h"
+#include <kj/io.h>
+
+namespace capnp {
+
+void writeJson(kj::BufferedOutputStream& output, DynamicStruct::Reader value);
+void writeJson(kj::BufferedOutputStream& output, DynamicList::Reader value);
+// Write the given struct or list to `output` as compact JSON.  The output is generated directly
+// into the stream's write buffer, without building an intermediate string.  As with the other
+// dynamic API functions, you can pass any struct or list reader or builder.
+//
+// The mapping is:
+// - Structs and groups become objects.  Like the text format, null pointer fields and inactive
+//   union members are omitted.
+// - Lists become arrays.
+// - Integers and floats become numbers.  NaN and infinities, which JSON can't represent, are
+//   written as the strings "NaN", "Infinity", and "-Infinity".  Note that 64-bit integers are
+//   written exactly, which some JSON consumers (e.g. JavaScript) can't represent.
+// - Text becomes a string; Data becomes an array of byte values.
+// - Enums become their enumerant names, or raw numbers if the value is unknown to the schema.
+// - Void, capabilities, and AnyPointers become null.
+
+kj::String toJson(DynamicStruct::Reader value);
+kj::String toJson(DynamicList::Reader value);
+// Convenience wrappers that write to a string.
+
+void readJson(kj::ArrayPtr<const char> input, DynamicStruct::Builder output);
+// Parse the given JSON object into `output`, using the mapping described for writeJson().  Lists
+// are allocated at their final size, so no space is wasted in the message.  Object members which
+// don't match any field are ignored, for forwards-compatibility.  Throws an exception if the
+// input is not valid JSON, does not fit the schema, or nests objects and arrays more than 64 deep
+// (the default ReaderOptions::nestingLimit).  The exception's description starts with the line
+// and column of the problem.
+
+DynamicStruct::Builder readJson(kj::ArrayPtr<const char> input, MessageBuilder& message,
+                                StructSchema schema);
+// Initialize the root of `message` as `schema` and parse `input` into it.
+
+}  // namespace capnp
+
+#endif  // CAPNP_JSON_H_
@@ -662,6 +662,13 @@ public:
 
   StructReader getStructElement(ElementCount index) const;
 
+  template <typename T>
+  void gatherDataField(ElementCount offset, kj::ArrayPtr<T> output, Mask<T> mask) const;
+  // Interpreting the list as a list of structs, read the data field at `offset` of every element
+  // into `output`, which must have exactly size() elements.  Equivalent to calling
+  // getStructElement(i).getDataField<T>(offset, mask) for each i, but the bounds check is done
+  // once for the whole list and the rest is a plain strided loop which the compiler can unroll.
+
 private:
   SegmentReader* segment;  // Memory segment in which the list resides.
 
@@ -1006,6 +1013,57 @@ inline Void ListReader::getDataElement<Void>(ElementCount index) const {
   return VOID;
 }
 
+template <typename T>
+inline void ListReader::gatherDataField(ElementCount offset, kj::ArrayPtr<T> output,
+                                        Mask<T> mask) const {
+  KJ_IREQUIRE(output.size() == elementCount / ELEMENTS, "Output array is the wrong size.");
+
+  T* out = output.begin();
+  T* end = output.end();
+
+  if ((offset + 1 * ELEMENTS) * capnp::bitsPerElement<T>() > structDataSize) {
+    // The elements were written with an older version of the struct which didn't have this field
+    // (or this is a list of smaller primitives), so every element reads as the default.
+    T value = unmask<T>(0, mask);
+    while (out != end) *out++ = value;
+    return;
+  }
+
+  // Struct list steps are always a whole number of words and primitive list steps are at least a
+  // byte here, since the field must fit within each element.
+  const byte* pos = reinterpret_cast<const byte*>(
+      reinterpret_cast<const WireValue<Mask<T>>*>(ptr) + offset / ELEMENTS);
+  size_t stride = 1 * ELEMENTS * step / BITS_PER_BYTE / BYTES;
+  while (out != end) {
+    *out++ = unmask<T>(reinterpret_cast<const WireValue<Mask<T>>*>(pos)->get(), mask);
+    pos += stride;
+  }
+}
+
+template <>
+inline void ListReader::gatherDataField<bool>(ElementCount offset, kj::ArrayPtr<bool> output,
+                                              Mask<bool> mask) const {
+  KJ_IREQUIRE(output.size() == elementCount / ELEMENTS, "Output array is the wrong size.");
+
+  bool* out = output.begin();
+  bool* end = output.end();
+
+  BitCount boffset = offset * (1 * BITS / ELEMENTS);
+  if (boffset >= structDataSize) {
+    while (out != end) *out++ = mask;
+    return;
+  }
+
+  // Unlike getStructElement(), no special case is needed for lists of bits:  the step is one bit
+  // and the only field that fits is at offset zero, so this finds the right bit either way.
+  BitCount bit = boffset;
+  while (out != end) {
+    uint8_t b = ptr[bit / BITS_PER_BYTE];
+    *out++ = ((b >> (bit % BITS_PER_BYTE / BITS)) & 1) ^ mask;
+    bit += 1 * ELEMENTS * step;
+  }
+}
+
 inline PointerReader ListReader::getPointerElement(ElementCount index) const {
   return PointerReader(segment,
       reinterpret_cast<const WirePointer*>(ptr + index * step / BITS_PER_BYTE), nestingLimit);
@@ -195,6 +195,7 @@ kj::ArrayPtr<word> MallocMessageBuilder::allocateSegment(uint minimumSize) {
 
   uint size = std::max(minimumSize, nextSize);
 
+  kj::countAllocation(size * sizeof(word));
   void* result = calloc(size, sizeof(word));
   if (result == nullptr) {
     KJ_FAIL_SYSCALL("calloc(size, sizeof(word))", ENOMEM, size);
@@ -26,6 +26,7 @@
 
 #include "dynamic.h"
 #include <kj/string-tree.h>
+#include <kj/io.h>
 
 namespace capnp {
 
@@ -40,6 +41,12 @@ kj::StringTree prettyPrint(DynamicList::Builder value);
 // If you don't want indentation, just use the value's KJ stringifier (e.g. pass it to kj::str(),
 // any of the KJ debug macros, etc.).
 
+void writeText(kj::OutputStream& output, DynamicStruct::Reader value, bool pretty = true);
+void writeText(kj::OutputStream& output, DynamicList::Reader value, bool pretty = true);
+// Write the same text as prettyPrint() (or, if `pretty` is false, as the KJ stringifier) to
+// `output`, generating it incrementally.  Unlike the functions above, this never holds more than
+// a small buffer of text in memory, so it's suitable for arbitrarily large messages.
+
 }  // namespace capnp
 
 #endif  // PRETTY_PRINT_H_
@@ -0,0 +1,122 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "rpc-instrumentation.h"
+#include <kj/debug.h>
+#include <gtest/gtest.h>
+
+namespace capnp {
+namespace {
+
+TEST(LatencyHistogram, Buckets) {
+  for (uint64_t i = 0; i < 16; i++) {
+    EXPECT_EQ(i, LatencyHistogram::bucketFor(i));
+    EXPECT_EQ(i, LatencyHistogram::bucketLowerBound(i));
+    EXPECT_EQ(i, LatencyHistogram::bucketUpperBound(i));
+  }
+
+  // Buckets must tile the value space with no gaps or overlaps.
+  for (uint i = 0; i + 1 < LatencyHistogram::BUCKET_COUNT; i++) {
+    EXPECT_EQ(LatencyHistogram::bucketUpperBound(i) + 1, LatencyHistogram::bucketLowerBound(i + 1));
+    EXPECT_EQ(i, LatencyHistogram::bucketFor(LatencyHistogram::bucketLowerBound(i)));
+    EXPECT_EQ(i, LatencyHistogram::bucketFor(LatencyHistogram::bucketUpperBound(i)));
+  }
+
+  EXPECT_EQ(LatencyHistogram::BUCKET_COUNT - 1, LatencyHistogram::bucketFor(~uint64_t(0)));
+
+  // Relative error is bounded by the sub-bucket resolution.
+  uint64_t value = 123456789;
+  uint index = LatencyHistogram::bucketFor(value);
+  EXPECT_LE(LatencyHistogram::bucketLowerBound(index), value);
+  EXPECT_GE(LatencyHistogram::bucketUpperBound(index), value);
+  EXPECT_LT(LatencyHistogram::bucketUpperBound(index) - LatencyHistogram::bucketLowerBound(index),
+            value / 16);
+}
+
+TEST(LatencyHistogram, Percentiles) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(0u, histogram.getPercentile(50));
+
+  for (uint64_t i = 1; i <= 1000; i++) {
+    histogram.record(i * 1000);
+  }
+
+  EXPECT_EQ(1000u, histogram.getCount());
+  EXPECT_EQ(500500000u, histogram.getSum());
+  EXPECT_EQ(1000000u, histogram.getMax());
+
+  uint64_t median = histogram.getPercentile(50);
+  EXPECT_GE(median, 500000u * 15 / 16);
+  EXPECT_LE(median, 500000u * 17 / 16);
+
+  uint64_t p99 = histogram.getPercentile(99);
+  EXPECT_GE(p99, 990000u * 15 / 16);
+  EXPECT_LE(p99, 1000000u);
+
+  EXPECT_EQ(1000000u, histogram.getPercentile(100));
+  EXPECT_LE(histogram.getPercentile(0), 1000u * 17 / 16);
+}
+
+TEST(RpcMethodStats, CountsAndLatency) {
+  RpcMethodStats stats;
+  typedef RpcInstrumentation::Direction Direction;
+  typedef RpcInstrumentation::CallOutcome CallOutcome;
+
+  RpcInstrumentation::CallInfo call = { 0x1234, 3, Direction::INCOMING, 1000 };
+  stats.callStarted(call, 10);
+  stats.callEnded(call, CallOutcome::RETURNED, 3000, 7);
+  stats.callStarted(call, 10);
+  stats.callEnded(call, CallOutcome::FAILED, 5000, 0);
+  stats.callStarted(call, 10);
+  stats.callEnded(call, CallOutcome::DISCONNECTED, 9000, 0);
+
+  EXPECT_TRUE(stats.find(0x1234, 3, Direction::OUTGOING) == nullptr);
+  EXPECT_TRUE(stats.find(0x1234, 4, Direction::INCOMING) == nullptr);
+
+  auto& method = KJ_ASSERT_NONNULL(stats.find(0x1234, 3, Direction::INCOMING));
+  EXPECT_EQ(3u, method.getStartedCount());
+  EXPECT_EQ(1u, method.getEndedCount(CallOutcome::RETURNED));
+  EXPECT_EQ(1u, method.getEndedCount(CallOutcome::FAILED));
+  EXPECT_EQ(1u, method.getEndedCount(CallOutcome::DISCONNECTED));
+  EXPECT_EQ(0u, method.getEndedCount(CallOutcome::CANCELED));
+  EXPECT_EQ(30u, method.getParamWords());
+  EXPECT_EQ(7u, method.getResultWords());
+
+  // Disconnects don't count towards latency.
+  EXPECT_EQ(2u, method.latency.getCount());
+  EXPECT_EQ(6000u, method.latency.getSum());
+  EXPECT_EQ(4000u, method.latency.getMax());
+
+  stats.messageSent(2, 100, 0);
+  stats.messageSent(2, 50, 0);
+  stats.messageReceived(3, 20, 0);
+  stats.messageReceived(1000, 1, 0);
+  EXPECT_EQ(2u, stats.getMessagesSent(2));
+  EXPECT_EQ(150u, stats.getWordsSent());
+  EXPECT_EQ(1u, stats.getMessagesReceived(3));
+  EXPECT_EQ(1u, stats.getMessagesReceived(RpcMethodStats::MESSAGE_TYPE_COUNT - 1));
+  EXPECT_EQ(21u, stats.getWordsReceived());
+}
+
+}  // namespace
+}  // namespace capnp
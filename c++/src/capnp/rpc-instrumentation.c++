@@ -0,0 +1,237 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "rpc-instrumentation.h"
+#include <kj/debug.h>
+#include <string.h>
+#include <time.h>
+
+namespace capnp {
+
+namespace {
+
+inline uint64_t atomicLoad(const uint64_t& value) {
+  return __atomic_load_n(&value, __ATOMIC_RELAXED);
+}
+
+inline void atomicAdd(uint64_t& value, uint64_t amount) {
+  __atomic_fetch_add(&value, amount, __ATOMIC_RELAXED);
+}
+
+}  // namespace
+
+// =======================================================================================
+
+LatencyHistogram::LatencyHistogram(): count(0), sum(0), max(0) {
+  memset(buckets, 0, sizeof(buckets));
+}
+
+uint LatencyHistogram::bucketFor(uint64_t value) {
+  if (value < SUB_BUCKET_COUNT) {
+    return value;
+  }
+
+  uint exponent = 63 - __builtin_clzll(value);
+  uint shift = exponent - SUB_BUCKET_BITS;
+  return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT +
+         ((value >> shift) & (SUB_BUCKET_COUNT - 1));
+}
+
+uint64_t LatencyHistogram::bucketLowerBound(uint index) {
+  if (index < SUB_BUCKET_COUNT) {
+    return index;
+  }
+
+  uint shift = index / SUB_BUCKET_COUNT - 1;
+  uint64_t subBucket = index % SUB_BUCKET_COUNT;
+  return (SUB_BUCKET_COUNT + subBucket) << shift;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(uint index) {
+  if (index + 1 >= BUCKET_COUNT) {
+    return kj::maxValue;
+  }
+  return bucketLowerBound(index + 1) - 1;
+}
+
+void LatencyHistogram::record(uint64_t value) const {
+  atomicAdd(buckets[bucketFor(value)], 1);
+  atomicAdd(count, 1);
+  atomicAdd(sum, value);
+
+  uint64_t oldMax = atomicLoad(max);
+  while (value > oldMax) {
+    if (__atomic_compare_exchange_n(&max, &oldMax, value, true,
+                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+      break;
+    }
+  }
+}
+
+uint64_t LatencyHistogram::getCount() const { return atomicLoad(count); }
+uint64_t LatencyHistogram::getSum() const { return atomicLoad(sum); }
+uint64_t LatencyHistogram::getMax() const { return atomicLoad(max); }
+
+uint64_t LatencyHistogram::getBucketCount(uint index) const {
+  KJ_REQUIRE(index < BUCKET_COUNT, "Histogram bucket index out-of-bounds.") { return 0; }
+  return atomicLoad(buckets[index]);
+}
+
+uint64_t LatencyHistogram::getPercentile(double percentile) const {
+  // Sum the buckets rather than trusting `count`, since concurrent writers may have bumped one
+  // but not yet the other.
+  uint64_t total = 0;
+  for (auto& bucket: buckets) {
+    total += atomicLoad(bucket);
+  }
+  if (total == 0) return 0;
+
+  percentile = kj::max(0.0, kj::min(100.0, percentile));
+  uint64_t target = static_cast<uint64_t>(percentile / 100.0 * total + 0.5);
+  if (target == 0) target = 1;
+
+  uint64_t seen = 0;
+  for (uint i = 0; i < BUCKET_COUNT; i++) {
+    seen += atomicLoad(buckets[i]);
+    if (seen >= target) {
+      // Don't report more than the largest value actually recorded.
+      return kj::min(bucketUpperBound(i), kj::max(bucketLowerBound(i), getMax()));
+    }
+  }
+
+  return getMax();
+}
+
+// =======================================================================================
+
+RpcInstrumentation::~RpcInstrumentation() noexcept(false) {}
+
+void RpcInstrumentation::callStarted(const CallInfo& call, uint64_t paramWords) {}
+void RpcInstrumentation::callEnded(const CallInfo& call, CallOutcome outcome, uint64_t endTime,
+                                   uint64_t resultWords) {}
+void RpcInstrumentation::messageSent(uint16_t messageType, uint64_t wordCount, uint64_t time) {}
+void RpcInstrumentation::messageReceived(uint16_t messageType, uint64_t wordCount,
+                                         uint64_t time) {}
+
+uint64_t RpcInstrumentation::now() {
+  struct timespec ts;
+  KJ_SYSCALL(clock_gettime(CLOCK_MONOTONIC, &ts));
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000u + ts.tv_nsec;
+}
+
+// =======================================================================================
+
+RpcMethodStats::Method::Method(uint64_t interfaceId, uint16_t methodId, Direction direction)
+    : interfaceId(interfaceId), methodId(methodId), direction(direction) {}
+
+uint64_t RpcMethodStats::Method::getStartedCount() const {
+  return atomicLoad(started);
+}
+
+uint64_t RpcMethodStats::Method::getEndedCount(CallOutcome outcome) const {
+  return atomicLoad(ended[static_cast<uint>(outcome)]);
+}
+
+uint64_t RpcMethodStats::Method::getParamWords() const {
+  return atomicLoad(paramWords);
+}
+
+uint64_t RpcMethodStats::Method::getResultWords() const {
+  return atomicLoad(resultWords);
+}
+
+RpcMethodStats::RpcMethodStats(): wordsSent(0), wordsReceived(0) {
+  memset(messagesSent, 0, sizeof(messagesSent));
+  memset(messagesReceived, 0, sizeof(messagesReceived));
+}
+
+RpcMethodStats::~RpcMethodStats() noexcept(false) {}
+
+kj::Maybe<const RpcMethodStats::Method&> RpcMethodStats::find(
+    uint64_t interfaceId, uint16_t methodId, Direction direction) const {
+  auto lock = methods.lockShared();
+  auto iter = lock->find(Key { interfaceId, methodId, direction });
+  if (iter == lock->end()) {
+    return nullptr;
+  } else {
+    return *iter->second;
+  }
+}
+
+const RpcMethodStats::Method& RpcMethodStats::getMethod(const CallInfo& call) {
+  Key key { call.interfaceId, call.methodId, call.direction };
+
+  {
+    auto lock = methods.lockShared();
+    auto iter = lock->find(key);
+    if (iter != lock->end()) {
+      return *iter->second;
+    }
+  }
+
+  auto lock = methods.lockExclusive();
+  auto& slot = (*lock)[key];
+  if (slot.get() == nullptr) {
+    slot = kj::heap<Method>(call.interfaceId, call.methodId, call.direction);
+  }
+  return *slot;
+}
+
+uint64_t RpcMethodStats::getMessagesSent(uint16_t messageType) const {
+  return atomicLoad(messagesSent[kj::min(messageType, MESSAGE_TYPE_COUNT - 1)]);
+}
+
+uint64_t RpcMethodStats::getMessagesReceived(uint16_t messageType) const {
+  return atomicLoad(messagesReceived[kj::min(messageType, MESSAGE_TYPE_COUNT - 1)]);
+}
+
+uint64_t RpcMethodStats::getWordsSent() const { return atomicLoad(wordsSent); }
+uint64_t RpcMethodStats::getWordsReceived() const { return atomicLoad(wordsReceived); }
+
+void RpcMethodStats::callStarted(const CallInfo& call, uint64_t paramWords) {
+  auto& method = getMethod(call);
+  atomicAdd(method.started, 1);
+  atomicAdd(method.paramWords, paramWords);
+}
+
+void RpcMethodStats::callEnded(const CallInfo& call, CallOutcome outcome, uint64_t endTime,
+                               uint64_t resultWords) {
+  auto& method = getMethod(call);
+  atomicAdd(method.ended[static_cast<uint>(outcome)], 1);
+  atomicAdd(method.resultWords, resultWords);
+  if (outcome != CallOutcome::DISCONNECTED && endTime >= call.startTime) {
+    method.latency.record(endTime - call.startTime);
+  }
+}
+
+void RpcMethodStats::messageSent(uint16_t messageType, uint64_t wordCount, uint64_t time) {
+  atomicAdd(messagesSent[kj::min(messageType, MESSAGE_TYPE_COUNT - 1)], 1);
+  atomicAdd(wordsSent, wordCount);
+}
+
+void RpcMethodStats::messageReceived(uint16_t messageType, uint64_t wordCount, uint64_t time) {
+  atomicAdd(messagesReceived[kj::min(messageType, MESSAGE_TYPE_COUNT - 1)], 1);
+  atomicAdd(wordsReceived, wordCount);
+}
+
+}  // namespace capnp
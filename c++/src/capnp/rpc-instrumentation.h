@@ -0,0 +1,273 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef CAPNP_RPC_INSTRUMENTATION_H_
+#define CAPNP_RPC_INSTRUMENTATION_H_
+
+#include "common.h"
+#include <kj/mutex.h>
+#include <kj/memory.h>
+#include <map>
+#include <inttypes.h>
+
+namespace capnp {
+
+class LatencyHistogram {
+  // A fixed-size histogram of nanosecond durations, in the style of HdrHistogram.  Values are
+  // bucketed log-linearly:  each power of two is divided into 2^SUB_BUCKET_BITS equal sub-buckets,
+  // so any recorded value can be recovered to within about 6%.  The whole 64-bit range is covered
+  // with no configuration.
+  //
+  // `record()` is lock-free and may be called from any thread concurrently with readers.  Readers
+  // see a consistent-enough view for metrics export, but not an atomic snapshot of all buckets.
+
+public:
+  static constexpr uint SUB_BUCKET_BITS = 4;
+  static constexpr uint SUB_BUCKET_COUNT = 1u << SUB_BUCKET_BITS;
+  static constexpr uint BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+  LatencyHistogram();
+  KJ_DISALLOW_COPY(LatencyHistogram);
+
+  void record(uint64_t value) const;
+  // Record one sample.  This is `const` because it is thread-safe.
+
+  uint64_t getCount() const;
+  uint64_t getSum() const;
+  uint64_t getMax() const;
+  // Totals over all samples recorded so far.
+
+  uint64_t getPercentile(double percentile) const;
+  // Returns a value such that approximately `percentile` percent of recorded samples are less than
+  // or equal to it.  `percentile` ranges from 0 to 100.  Returns zero if the histogram is empty.
+
+  uint64_t getBucketCount(uint index) const;
+  // Number of samples recorded in the given bucket.
+
+  static uint bucketFor(uint64_t value);
+  static uint64_t bucketLowerBound(uint index);
+  static uint64_t bucketUpperBound(uint index);
+  // Map between values and bucket indexes.  Bucket `i` holds values in the inclusive range
+  // [bucketLowerBound(i), bucketUpperBound(i)].
+
+private:
+  mutable uint64_t count;
+  mutable uint64_t sum;
+  mutable uint64_t max;
+  mutable uint64_t buckets[BUCKET_COUNT];
+};
+
+class RpcInstrumentation {
+  // Receives events from an `RpcSystem` for tracing and metrics.  Install an implementation with
+  // `RpcSystem::setInstrumentation()`.  When no instrumentation is installed, the RPC system does
+  // no extra work at all -- it does not even read the clock.
+  //
+  // Callbacks are invoked synchronously from the RPC system's event loop thread, in the middle of
+  // handling a message, so they should be quick and must not throw.  All timestamps are in
+  // nanoseconds as returned by `now()`.
+  //
+  // See `RpcMethodStats`, below, for a ready-made implementation that keeps per-method counters
+  // and latency histograms.
+
+public:
+  enum class Direction: uint8_t {
+    OUTGOING,
+    // A call we made on a capability hosted by the peer.  Latency is measured from when the `Call`
+    // message was sent to when the `Return` arrived.
+
+    INCOMING
+    // A call the peer made on a capability we host.  Latency is measured from when the `Call`
+    // message was received to when our `Return` was sent.
+  };
+
+  enum class CallOutcome: uint8_t {
+    RETURNED,
+    // The call completed with results.
+
+    FAILED,
+    // The call completed with an exception.
+
+    CANCELED,
+    // The caller sent `Finish` before results were available, and the callee honored it.
+
+    RESULTS_SENT_ELSEWHERE,
+    // The call was completed by a tail call, so its results were delivered by way of some other
+    // question rather than in its own `Return`.
+
+    DISCONNECTED
+    // The connection was lost before the call returned.
+  };
+
+  struct CallInfo {
+    uint64_t interfaceId;
+    uint16_t methodId;
+    Direction direction;
+    uint64_t startTime;
+  };
+
+  virtual ~RpcInstrumentation() noexcept(false);
+
+  virtual void callStarted(const CallInfo& call, uint64_t paramWords);
+  // A call has been sent or received.  `paramWords` is the size of the parameter struct, including
+  // everything it points to.
+
+  virtual void callEnded(const CallInfo& call, CallOutcome outcome, uint64_t endTime,
+                         uint64_t resultWords);
+  // A call previously reported to `callStarted()` has completed.  `resultWords` is zero unless
+  // `outcome` is `RETURNED`.
+
+  virtual void messageSent(uint16_t messageType, uint64_t wordCount, uint64_t time);
+  virtual void messageReceived(uint16_t messageType, uint64_t wordCount, uint64_t time);
+  // A protocol message was handed to or received from the `VatNetwork`.  `messageType` is an
+  // `rpc::Message::Which` value.  `wordCount` is the total size of the message body.
+
+  virtual uint64_t now();
+  // Returns the current time in nanoseconds.  The default implementation reads the monotonic
+  // clock.  Tests may override it to make timing deterministic.
+};
+
+struct RpcSystemStats {
+  // A snapshot of an `RpcSystem`'s connection tables.  See `RpcSystem::getStats()`.
+
+  uint connectionCount = 0;
+  // Number of live connections.
+
+  uint questionCount = 0;
+  // Calls we have made which have not yet been finished.
+
+  uint answerCount = 0;
+  // Calls we have received which have not yet been finished.
+
+  uint exportCount = 0;
+  // Capabilities we host which the peers currently hold references to.
+
+  uint importCount = 0;
+  // Capabilities hosted by peers which we currently hold references to.
+
+  uint embargoCount = 0;
+  // Outstanding embargoes waiting for a `Disembargo` to loop back.
+};
+
+class RpcMethodStats final: public RpcInstrumentation {
+  // An `RpcInstrumentation` that counts calls and records latency histograms for each
+  // (interface, method, direction) seen, as well as message counts by type.
+  //
+  // Events arrive on the RPC system's thread, but the statistics may be read from any thread
+  // (e.g. a metrics exporter).  Recording a call to a method that has been seen before takes only
+  // a shared lock on the method table plus a few atomic increments.
+
+public:
+  struct Method {
+    uint64_t interfaceId;
+    uint16_t methodId;
+    Direction direction;
+
+    uint64_t getStartedCount() const;
+    uint64_t getEndedCount(CallOutcome outcome) const;
+    uint64_t getParamWords() const;
+    uint64_t getResultWords() const;
+
+    LatencyHistogram latency;
+    // Latency of calls that ended in any way other than DISCONNECTED.
+
+    Method(uint64_t interfaceId, uint16_t methodId, Direction direction);
+    KJ_DISALLOW_COPY(Method);
+
+  private:
+    mutable uint64_t started = 0;
+    mutable uint64_t ended[5] = {0, 0, 0, 0, 0};
+    mutable uint64_t paramWords = 0;
+    mutable uint64_t resultWords = 0;
+    // Updated atomically; see rpc-instrumentation.c++.
+
+    friend class RpcMethodStats;
+  };
+
+  static constexpr uint MESSAGE_TYPE_COUNT = 16;
+  // Message types at or beyond this number are counted together in the last slot.
+
+  RpcMethodStats();
+  ~RpcMethodStats() noexcept(false);
+  KJ_DISALLOW_COPY(RpcMethodStats);
+
+  kj::Maybe<const Method&> find(uint64_t interfaceId, uint16_t methodId,
+                                Direction direction) const;
+  // Find the stats for a particular method, or null if no call to it has been seen yet.
+
+  template <typename Func>
+  void forEach(Func&& func) const;
+  // Calls `func(const Method&)` for every method seen so far, in order of interface ID, method ID,
+  // and direction.  Holds a shared lock for the duration; `func` must not call back into this
+  // object's event callbacks.
+
+  uint64_t getMessagesSent(uint16_t messageType) const;
+  uint64_t getMessagesReceived(uint16_t messageType) const;
+  uint64_t getWordsSent() const;
+  uint64_t getWordsReceived() const;
+
+  // implements RpcInstrumentation -----------------------------------
+  void callStarted(const CallInfo& call, uint64_t paramWords) override;
+  void callEnded(const CallInfo& call, CallOutcome outcome, uint64_t endTime,
+                 uint64_t resultWords) override;
+  void messageSent(uint16_t messageType, uint64_t wordCount, uint64_t time) override;
+  void messageReceived(uint16_t messageType, uint64_t wordCount, uint64_t time) override;
+
+private:
+  struct Key {
+    uint64_t interfaceId;
+    uint16_t methodId;
+    Direction direction;
+
+    inline bool operator<(const Key& other) const {
+      if (interfaceId != other.interfaceId) return interfaceId < other.interfaceId;
+      if (methodId != other.methodId) return methodId < other.methodId;
+      return direction < other.direction;
+    }
+  };
+
+  kj::MutexGuarded<std::map<Key, kj::Own<Method>>> methods;
+  // Entries are never removed, so `Method` references remain valid for the object's lifetime.
+
+  uint64_t messagesSent[MESSAGE_TYPE_COUNT];
+  uint64_t messagesReceived[MESSAGE_TYPE_COUNT];
+  uint64_t wordsSent;
+  uint64_t wordsReceived;
+  // Updated atomically, like the counters in `Method`.
+
+  const Method& getMethod(const CallInfo& call);
+};
+
+// =======================================================================================
+// inline implementation details
+
+template <typename Func>
+void RpcMethodStats::forEach(Func&& func) const {
+  auto lock = methods.lockShared();
+  for (auto& entry: *lock) {
+    func(static_cast<const Method&>(*entry.second));
+  }
+}
+
+}  // namespace capnp
+
+#endif  // CAPNP_RPC_INSTRUMENTATION_H_
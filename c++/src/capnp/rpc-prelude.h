@@ -33,6 +33,8 @@ namespace capnp {
 
 class OutgoingRpcMessage;
 class IncomingRpcMessage;
+class RpcInstrumentation;
+struct RpcSystemStats;
 
 template <typename SturdyRefHostId>
 class RpcSystem;
@@ -83,6 +85,9 @@ private:
   // TODO(someday):  Maybe define a public API called `TypelessStruct` so we don't have to rely
   // on `_::StructReader` here?
 
+  void baseSetInstrumentation(kj::Maybe<RpcInstrumentation&> instrumentation);
+  RpcSystemStats baseGetStats();
+
   template <typename>
   friend class capnp::RpcSystem;
 };
@@ -823,6 +823,80 @@ TEST(Rpc, Embargo) {
   EXPECT_EQ(5, call5.wait(context.waitScope).getN());
 }
 
+TEST(Rpc, Instrumentation) {
+  TestContext context;
+
+  RpcMethodStats clientStats;
+  RpcMethodStats serverStats;
+  context.rpcClient.setInstrumentation(clientStats);
+  context.rpcServer.setInstrumentation(serverStats);
+
+  auto client = context.connect(test::TestSturdyRefObjectId::Tag::TEST_INTERFACE)
+      .castAs<test::TestInterface>();
+
+  auto request1 = client.fooRequest();
+  request1.setI(123);
+  request1.setJ(true);
+  auto promise1 = request1.send();
+
+  auto request2 = client.barRequest();
+  auto promise2 = request2.send().then(
+      [](Response<test::TestInterface::BarResults>&& response) {
+        ADD_FAILURE() << "Expected bar() call to fail.";
+      }, [&](kj::Exception&& e) {});
+
+  {
+    auto stats = context.rpcClient.getStats();
+    EXPECT_EQ(1u, stats.connectionCount);
+    EXPECT_EQ(3u, stats.questionCount);  // restore + 2 calls
+  }
+
+  EXPECT_EQ("foo", promise1.wait(context.waitScope).getX());
+  promise2.wait(context.waitScope);
+
+  uint64_t interfaceId = typeId<test::TestInterface>();
+  typedef RpcInstrumentation::Direction Direction;
+  typedef RpcInstrumentation::CallOutcome CallOutcome;
+
+  {
+    auto& foo = KJ_ASSERT_NONNULL(clientStats.find(interfaceId, 0, Direction::OUTGOING));
+    EXPECT_EQ(1u, foo.getStartedCount());
+    EXPECT_EQ(1u, foo.getEndedCount(CallOutcome::RETURNED));
+    EXPECT_EQ(1u, foo.latency.getCount());
+    EXPECT_GT(foo.getResultWords(), 0u);
+
+    auto& bar = KJ_ASSERT_NONNULL(clientStats.find(interfaceId, 1, Direction::OUTGOING));
+    EXPECT_EQ(1u, bar.getStartedCount());
+    EXPECT_EQ(1u, bar.getEndedCount(CallOutcome::FAILED));
+
+    EXPECT_TRUE(clientStats.find(interfaceId, 0, Direction::INCOMING) == nullptr);
+    EXPECT_TRUE(clientStats.find(interfaceId, 2, Direction::OUTGOING) == nullptr);
+  }
+
+  {
+    auto& foo = KJ_ASSERT_NONNULL(serverStats.find(interfaceId, 0, Direction::INCOMING));
+    EXPECT_EQ(1u, foo.getStartedCount());
+    EXPECT_EQ(1u, foo.getEndedCount(CallOutcome::RETURNED));
+
+    auto& bar = KJ_ASSERT_NONNULL(serverStats.find(interfaceId, 1, Direction::INCOMING));
+    EXPECT_EQ(1u, bar.getEndedCount(CallOutcome::FAILED));
+
+    uint methodCount = 0;
+    serverStats.forEach([&](const RpcMethodStats::Method& method) { ++methodCount; });
+    EXPECT_EQ(2u, methodCount);
+  }
+
+  EXPECT_EQ(2u, clientStats.getMessagesSent(rpc::Message::CALL));
+  EXPECT_EQ(1u, clientStats.getMessagesSent(rpc::Message::RESTORE));
+  EXPECT_EQ(2u, serverStats.getMessagesReceived(rpc::Message::CALL));
+  EXPECT_EQ(3u, serverStats.getMessagesSent(rpc::Message::RETURN));
+  EXPECT_GT(clientStats.getWordsSent(), 0u);
+  EXPECT_GT(serverStats.getWordsReceived(), 0u);
+
+  context.rpcClient.setInstrumentation(nullptr);
+  context.rpcServer.setInstrumentation(nullptr);
+}
+
 }  // namespace
 }  // namespace _ (private)
 }  // namespace capnp
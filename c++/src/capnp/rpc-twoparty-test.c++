@@ -130,6 +130,83 @@ TEST(TwoPartyNetwork, Basic) {
   EXPECT_TRUE(barFailed);
 }
 
+TEST(TwoPartyNetwork, Stats) {
+  auto ioContext = kj::setupAsyncIo();
+  int callCount = 0;
+
+  auto serverThread = runServer(*ioContext.provider, callCount);
+  TwoPartyVatNetwork network(*serverThread.pipe, rpc::twoparty::Side::CLIENT);
+  auto rpcClient = makeRpcClient(network);
+
+  auto client = getPersistentCap(rpcClient, rpc::twoparty::Side::SERVER,
+      test::TestSturdyRefObjectId::Tag::TEST_INTERFACE).castAs<test::TestInterface>();
+
+  auto request = client.fooRequest();
+  request.setI(123);
+  request.setJ(true);
+  auto promise = request.send();
+
+  {
+    auto stats = network.getStats();
+    EXPECT_EQ(2u, stats.messagesSent);  // restore + call
+    EXPECT_EQ(2u, stats.maxPendingWrites);
+    EXPECT_GE(stats.segmentsSent, stats.messagesSent);
+    EXPECT_EQ(0u, stats.messagesReceived);
+  }
+
+  EXPECT_EQ("foo", promise.wait(ioContext.waitScope).getX());
+
+  auto stats = network.getStats();
+  EXPECT_GE(stats.messagesReceived, 2u);  // restore return + call return
+  EXPECT_EQ(0u, stats.pendingWrites);
+  EXPECT_GT(stats.bytesReceived, 0u);
+
+  auto& streamStats = KJ_ASSERT_NONNULL(stats.stream);
+  EXPECT_EQ(stats.bytesSent, streamStats.bytesWritten);
+  EXPECT_EQ(stats.bytesReceived, streamStats.bytesRead);
+  EXPECT_GE(streamStats.writeCalls, stats.flushes);
+}
+
+TEST(TwoPartyNetwork, BatchedWrites) {
+  auto ioContext = kj::setupAsyncIo();
+  int callCount = 0;
+
+  auto serverThread = runServer(*ioContext.provider, callCount);
+  TwoPartyVatNetwork network(*serverThread.pipe, rpc::twoparty::Side::CLIENT);
+  auto rpcClient = makeRpcClient(network);
+
+  auto client = getPersistentCap(rpcClient, rpc::twoparty::Side::SERVER,
+      test::TestSturdyRefObjectId::Tag::TEST_INTERFACE).castAs<test::TestInterface>();
+
+  RequestBatch<test::TestInterface::FooParams, test::TestInterface::FooResults> batch;
+  for (uint i = 0; i < 10; i++) {
+    auto params = batch.add(client.fooRequest());
+    params.setI(123);
+    params.setJ(true);
+  }
+  auto promises = batch.send();
+
+  {
+    // Nothing has been written yet; the restore and all ten calls are waiting for one flush.
+    auto stats = network.getStats();
+    EXPECT_EQ(11u, stats.messagesSent);
+    EXPECT_EQ(11u, stats.pendingWrites);
+    EXPECT_EQ(0u, stats.flushes);
+  }
+
+  for (auto& promise: promises) {
+    EXPECT_EQ("foo", promise.wait(ioContext.waitScope).getX());
+  }
+  EXPECT_EQ(10, callCount);
+
+  auto stats = network.getStats();
+  EXPECT_EQ(0u, stats.pendingWrites);
+  EXPECT_LT(stats.flushes, stats.messagesSent);
+  auto& streamStats = KJ_ASSERT_NONNULL(stats.stream);
+  EXPECT_EQ(stats.bytesSent, streamStats.bytesWritten);
+  EXPECT_LT(streamStats.writeCalls, stats.messagesSent);
+}
+
 TEST(TwoPartyNetwork, Pipelining) {
   auto ioContext = kj::setupAsyncIo();
   int callCount = 0;
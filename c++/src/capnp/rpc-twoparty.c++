@@ -27,6 +27,23 @@
 
 namespace capnp {
 
+namespace {
+
+inline size_t segmentTableSize(uint segmentCount) {
+  // The segment count and sizes are 32-bit values, padded to a whole word.
+  return (segmentCount / 2 + 1) * sizeof(word);
+}
+
+size_t serializedSize(kj::ArrayPtr<const kj::ArrayPtr<const word>> segments) {
+  size_t result = segmentTableSize(segments.size());
+  for (auto& segment: segments) {
+    result += segment.size() * sizeof(word);
+  }
+  return result;
+}
+
+}  // namespace
+
 TwoPartyVatNetwork::TwoPartyVatNetwork(kj::AsyncIoStream& stream, rpc::twoparty::Side side,
                                        ReaderOptions receiveOptions)
     : stream(stream), side(side), receiveOptions(receiveOptions), previousWrite(kj::READY_NOW) {
@@ -81,15 +98,27 @@ public:
   }
 
   void send() override {
-    network.previousWrite = network.previousWrite.then([&]() {
-      auto promise = writeMessage(network.stream, message).then([]() {
-        // success; do nothing
-      }, [&](kj::Exception&& exception) {
-        // Exception during write!
-        network.disconnectFulfiller->fulfill();
-      }).eagerlyEvaluate(nullptr);
-      return kj::mv(promise);
-    }).attach(kj::addRef(*this));
+    auto segments = message.getSegmentsForOutput();
+    auto& stats = network.stats;
+    ++stats.messagesSent;
+    stats.segmentsSent += segments.size();
+    stats.bytesSent += serializedSize(segments);
+    stats.maxPendingWrites = kj::max(stats.maxPendingWrites, ++stats.pendingWrites);
+
+    // Rather than writing each message individually, queue it up, so that all messages sent
+    // before the write actually starts go out in a single write.
+    network.queuedMessages.add(kj::addRef(*this));
+    if (!network.flushScheduled) {
+      network.flushScheduled = true;
+      auto& networkRef = network;
+      network.previousWrite = network.previousWrite.then([&networkRef]() {
+        return networkRef.flushQueuedMessages();
+      });
+    }
+  }
+
+  kj::ArrayPtr<const kj::ArrayPtr<const word>> getSegmentsForOutput() {
+    return message.getSegmentsForOutput();
   }
 
 private:
@@ -97,6 +126,58 @@ private:
   MallocMessageBuilder message;
 };
 
+kj::Promise<void> TwoPartyVatNetwork::flushQueuedMessages() {
+  flushScheduled = false;
+  auto messages = queuedMessages.releaseAsArray();
+
+  // Build the segment tables for all of the messages in one array, then gather the tables and
+  // segments into one list of pieces to write.  The format is the same as `writeMessage()`'s.
+  size_t tableSize = 0;
+  size_t pieceCount = 0;
+  for (auto& message: messages) {
+    auto segments = kj::downcast<OutgoingMessageImpl>(*message).getSegmentsForOutput();
+    tableSize += (segments.size() + 2) & ~size_t(1);
+    pieceCount += segments.size() + 1;
+  }
+
+  auto table = kj::heapArray<_::WireValue<uint32_t>>(tableSize);
+  auto pieces = kj::heapArrayBuilder<kj::ArrayPtr<const byte>>(pieceCount);
+  auto tablePos = table.begin();
+  for (auto& message: messages) {
+    auto segments = kj::downcast<OutgoingMessageImpl>(*message).getSegmentsForOutput();
+    auto messageTable = tablePos;
+    tablePos += (segments.size() + 2) & ~size_t(1);
+
+    messageTable[0].set(segments.size() - 1);
+    for (uint i = 0; i < segments.size(); i++) {
+      messageTable[i + 1].set(segments[i].size());
+    }
+    if (segments.size() % 2 == 0) {
+      // Set padding.
+      messageTable[segments.size() + 1].set(0);
+    }
+
+    pieces.add(reinterpret_cast<const byte*>(messageTable),
+               reinterpret_cast<const byte*>(tablePos));
+    for (auto& segment: segments) {
+      pieces.add(reinterpret_cast<const byte*>(segment.begin()),
+                 reinterpret_cast<const byte*>(segment.end()));
+    }
+  }
+
+  ++stats.flushes;
+  uint count = messages.size();
+  auto piecesArray = pieces.finish();
+  auto promise = stream.write(piecesArray);
+  return promise.then([this,count]() {
+    stats.pendingWrites -= count;
+  }, [this,count](kj::Exception&& exception) {
+    // Exception during write!
+    stats.pendingWrites -= count;
+    disconnectFulfiller->fulfill();
+  }).attach(kj::mv(messages), kj::mv(table), kj::mv(piecesArray)).eagerlyEvaluate(nullptr);
+}
+
 class TwoPartyVatNetwork::IncomingMessageImpl final: public IncomingRpcMessage {
 public:
   IncomingMessageImpl(kj::Own<MessageReader> message): message(kj::mv(message)) {}
@@ -113,6 +194,12 @@ private:
   kj::Own<MessageReader> message;
 };
 
+TwoPartyVatNetwork::Stats TwoPartyVatNetwork::getStats() {
+  Stats result = stats;
+  result.stream = stream.getStats();
+  return result;
+}
+
 kj::Own<OutgoingRpcMessage> TwoPartyVatNetwork::newOutgoingMessage(uint firstSegmentWordSize) {
   return kj::refcounted<OutgoingMessageImpl>(*this, firstSegmentWordSize);
 }
@@ -123,6 +210,18 @@ kj::Promise<kj::Maybe<kj::Own<IncomingRpcMessage>>> TwoPartyVatNetwork::receiveI
         .then([&](kj::Maybe<kj::Own<MessageReader>>&& message)
               -> kj::Maybe<kj::Own<IncomingRpcMessage>> {
       KJ_IF_MAYBE(m, message) {
+        uint segmentCount = 0;
+        size_t wordCount = 0;
+        for (;;) {
+          auto segment = m->get()->getSegment(segmentCount);
+          if (segment.begin() == nullptr) break;
+          ++segmentCount;
+          wordCount += segment.size();
+        }
+        ++stats.messagesReceived;
+        stats.segmentsReceived += segmentCount;
+        stats.bytesReceived += segmentTableSize(segmentCount) + wordCount * sizeof(word);
+
         return kj::Own<IncomingRpcMessage>(kj::heap<IncomingMessageImpl>(kj::mv(*m)));
       } else {
         disconnectFulfiller->fulfill();
@@ -27,6 +27,7 @@
 #include "rpc.h"
 #include "message.h"
 #include <kj/async-io.h>
+#include <kj/vector.h>
 #include <capnp/rpc-twoparty.capnp.h>
 
 namespace capnp {
@@ -56,6 +57,43 @@ public:
   // is safe to destroy the RpcSystem, if it isn't able to reliably destroy all objects using it
   // directly.
 
+  struct Stats {
+    // Transport statistics for the connection, as returned by `getStats()`.
+
+    uint64_t messagesSent = 0;
+    uint64_t messagesReceived = 0;
+
+    uint64_t bytesSent = 0;
+    uint64_t bytesReceived = 0;
+    // Serialized message sizes, including the segment table.  For sent messages this counts
+    // messages as they are queued, so it may run ahead of `stream.bytesWritten`.
+
+    uint64_t segmentsSent = 0;
+    uint64_t segmentsReceived = 0;
+    // Divide by the message count to get the average segments per message.  If this is much
+    // larger than 1, the first-segment size hints are too small for the messages being sent.
+
+    uint pendingWrites = 0;
+    // Messages queued but not yet completely written to the stream, i.e. the current depth of
+    // the write queue.  If this keeps growing, the peer is not keeping up.
+
+    uint maxPendingWrites = 0;
+    // High-water mark of `pendingWrites`.
+
+    uint64_t flushes = 0;
+    // Writes issued to the stream.  Messages sent during the same turn of the event loop (or while
+    // a previous write is still in progress) are coalesced into a single write, so
+    // `messagesSent / flushes` is the average number of messages per write.
+
+    kj::Maybe<kj::AsyncIoStream::Stats> stream;
+    // Statistics from the underlying stream, if it keeps them.  These include system call counts
+    // and time spent blocked waiting for the stream to become writable.
+  };
+
+  Stats getStats();
+  // Take a snapshot of the connection's transport statistics.  Must be called from the thread
+  // that runs the connection's event loop.
+
   // implements VatNetwork -----------------------------------------------------
 
   kj::Maybe<kj::Own<TwoPartyVatNetworkBase::Connection>> connectToRefHost(
@@ -74,6 +112,16 @@ private:
   kj::Promise<void> previousWrite;
   // Resolves when the previous write completes.  This effectively serves as the write queue.
 
+  kj::Vector<kj::Own<OutgoingRpcMessage>> queuedMessages;
+  // Messages sent since the last flush began.  They will all be written together by the next
+  // flush, which is scheduled to run after `previousWrite`.  (Always `OutgoingMessageImpl`s.)
+
+  bool flushScheduled = false;
+  // True if a flush of `queuedMessages` is already chained onto `previousWrite`.
+
+  Stats stats;
+  // Counters reported by getStats().  `stats.stream` is filled in only in the returned copy.
+
   kj::Own<kj::PromiseFulfiller<kj::Own<TwoPartyVatNetworkBase::Connection>>> acceptFulfiller;
   // Fulfiller for the promise returned by acceptConnectionAsRefHost() on the client side, or the
   // second call on the server side.  Never fulfilled, because there is only one connection.
@@ -90,6 +138,9 @@ private:
   };
   FulfillerDisposer drainedFulfiller;
 
+  kj::Promise<void> flushQueuedMessages();
+  // Write out everything in `queuedMessages` with a single write to the stream.
+
   // implements Connection -----------------------------------------------------
 
   kj::Own<OutgoingRpcMessage> newOutgoingMessage(uint firstSegmentWordSize) override;
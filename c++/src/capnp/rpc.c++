@@ -270,9 +270,11 @@ class RpcConnectionState final: public kj::TaskSet::ErrorHandler, public kj::Ref
 public:
   RpcConnectionState(kj::Maybe<SturdyRefRestorerBase&> restorer,
                      kj::Own<VatNetworkBase::Connection>&& connection,
-                     kj::Own<kj::PromiseFulfiller<void>>&& disconnectFulfiller)
+                     kj::Own<kj::PromiseFulfiller<void>>&& disconnectFulfiller,
+                     kj::Maybe<RpcInstrumentation&> instrumentation)
       : restorer(restorer), connection(kj::mv(connection)),
         disconnectFulfiller(kj::mv(disconnectFulfiller)),
+        instrumentation(instrumentation),
         tasks(*this) {
     tasks.add(messageLoop());
   }
@@ -291,7 +293,7 @@ public:
     paf.promise = paf.promise.attach(kj::addRef(*questionRef));
 
     {
-      auto message = connection->newOutgoingMessage(
+      auto message = newOutgoingMessage(
           objectId.targetSize().wordCount + messageSizeHint<rpc::Restore>());
 
       auto builder = message->getBody().initAs<rpc::Message>().initRestore();
@@ -331,6 +333,8 @@ public:
 
       // All current questions complete with exceptions.
       questions.forEach([&](QuestionId id, Question& question) {
+        traceCallEnd(question.trace, RpcInstrumentation::CallOutcome::DISCONNECTED);
+
         KJ_IF_MAYBE(questionRef, question.selfRef) {
           // QuestionRef still present.
           questionRef->reject(kj::cp(networkException));
@@ -374,7 +378,7 @@ public:
 
     {
       // Send an abort message.
-      auto message = connection->newOutgoingMessage(
+      auto message = newOutgoingMessage(
           messageSizeHint<void>() + exceptionSizeHint(exception));
       fromException(exception, message->getBody().getAs<rpc::Message>().initAbort());
       message->send();
@@ -384,6 +388,25 @@ public:
     disconnectFulfiller->fulfill();
   }
 
+  void setInstrumentation(kj::Maybe<RpcInstrumentation&> instrumentation) {
+    // Calls already in flight when instrumentation is installed are not reported, since we have
+    // no start time for them.
+    this->instrumentation = instrumentation;
+  }
+
+  void addStats(RpcSystemStats& stats) {
+    ++stats.connectionCount;
+    questions.forEach([&](QuestionId id, Question& question) { ++stats.questionCount; });
+    answers.forEach([&](AnswerId id, Answer& answer) {
+      if (answer.active) ++stats.answerCount;
+    });
+    exports.forEach([&](ExportId id, Export& exp) { ++stats.exportCount; });
+    imports.forEach([&](ImportId id, Import& import) {
+      if (import.importClient != nullptr) ++stats.importCount;
+    });
+    embargoes.forEach([&](EmbargoId id, Embargo& embargo) { ++stats.embargoCount; });
+  }
+
 private:
   class RpcClient;
   class ImportClient;
@@ -427,6 +450,9 @@ private:
     bool isTailCall = false;
     // Is this a tail call?  If so, we don't expect to receive results in the `Return`.
 
+    kj::Maybe<RpcInstrumentation::CallInfo> trace;
+    // If the call was reported to the instrumentation, the info needed to report its end.
+
     inline bool operator==(decltype(nullptr)) const {
       return !isAwaitingReturn && selfRef == nullptr;
     }
@@ -530,8 +556,74 @@ private:
   // There are only four tables.  This definitely isn't a fifth table.  I don't know what you're
   // talking about.
 
+  kj::Maybe<RpcInstrumentation&> instrumentation;
+  // If non-null, receives call and message events.  See rpc-instrumentation.h.
+
   kj::TaskSet tasks;
 
+  // =====================================================================================
+  // Instrumentation
+
+  class InstrumentedOutgoingMessage final: public OutgoingRpcMessage {
+    // Wraps an OutgoingRpcMessage in order to report it to the instrumentation when sent.
+
+  public:
+    InstrumentedOutgoingMessage(kj::Own<OutgoingRpcMessage>&& inner,
+                                RpcInstrumentation& instrumentation)
+        : inner(kj::mv(inner)), instrumentation(instrumentation) {}
+
+    AnyPointer::Builder getBody() override {
+      return inner->getBody();
+    }
+
+    kj::ArrayPtr<kj::Maybe<kj::Own<ClientHook>>> getCapTable() override {
+      return inner->getCapTable();
+    }
+
+    void send() override {
+      auto body = inner->getBody();
+      instrumentation.messageSent(body.getAs<rpc::Message>().which(),
+                                  body.targetSize().wordCount, instrumentation.now());
+      inner->send();
+    }
+
+  private:
+    kj::Own<OutgoingRpcMessage> inner;
+    RpcInstrumentation& instrumentation;
+  };
+
+  kj::Own<OutgoingRpcMessage> newOutgoingMessage(uint firstSegmentWordSize) {
+    auto result = connection->newOutgoingMessage(firstSegmentWordSize);
+    KJ_IF_MAYBE(i, instrumentation) {
+      result = kj::heap<InstrumentedOutgoingMessage>(kj::mv(result), *i);
+    }
+    return kj::mv(result);
+  }
+
+  kj::Maybe<RpcInstrumentation::CallInfo> traceCallStart(
+      RpcInstrumentation::Direction direction, uint64_t interfaceId, uint16_t methodId,
+      AnyPointer::Reader params) {
+    KJ_IF_MAYBE(i, instrumentation) {
+      RpcInstrumentation::CallInfo info = { interfaceId, methodId, direction, i->now() };
+      i->callStarted(info, params.targetSize().wordCount);
+      return info;
+    } else {
+      return nullptr;
+    }
+  }
+
+  void traceCallEnd(kj::Maybe<RpcInstrumentation::CallInfo>& trace,
+                    RpcInstrumentation::CallOutcome outcome, uint64_t resultWords = 0) {
+    // Report the end of a call previously started with traceCallStart(), if it was traced.  Only
+    // reports once; `trace` is nulled out.
+    KJ_IF_MAYBE(t, trace) {
+      KJ_IF_MAYBE(i, instrumentation) {
+        i->callEnded(*t, outcome, i->now(), resultWords);
+      }
+      trace = nullptr;
+    }
+  }
+
   // =====================================================================================
   // ClientHook implementations
 
@@ -625,7 +717,7 @@ private:
 
         // Send a message releasing our remote references.
         if (remoteRefcount > 0) {
-          auto message = connectionState->connection->newOutgoingMessage(
+          auto message = connectionState->newOutgoingMessage(
               messageSizeHint<rpc::Release>());
           rpc::Release::Builder builder = message->getBody().initAs<rpc::Message>().initRelease();
           builder.setId(importId);
@@ -828,7 +920,7 @@ private:
         // calls to go directly to the local capability, so we need to set a local embargo and send
         // a `Disembargo` to echo through the peer.
 
-        auto message = connectionState->connection->newOutgoingMessage(
+        auto message = connectionState->newOutgoingMessage(
             messageSizeHint<rpc::Disembargo>() + MESSAGE_TARGET_SIZE_HINT);
 
         auto disembargo = message->getBody().initAs<rpc::Message>().initDisembargo();
@@ -1007,7 +1099,7 @@ private:
       }
 
       // OK, we have to send a `Resolve` message.
-      auto message = connection->newOutgoingMessage(
+      auto message = newOutgoingMessage(
           messageSizeHint<rpc::Resolve>() + sizeInWords<rpc::CapDescriptor>() + 16);
       auto resolve = message->getBody().initAs<rpc::Message>().initResolve();
       resolve.setPromiseId(exportId);
@@ -1017,7 +1109,7 @@ private:
       return kj::READY_NOW;
     }, [this,exportId](kj::Exception&& exception) {
       // send error resolution
-      auto message = connection->newOutgoingMessage(
+      auto message = newOutgoingMessage(
           messageSizeHint<rpc::Resolve>() + exceptionSizeHint(exception) + 8);
       auto resolve = message->getBody().initAs<rpc::Message>().initResolve();
       resolve.setPromiseId(exportId);
@@ -1144,7 +1236,7 @@ private:
       unwindDetector.catchExceptionsIfUnwinding([&]() {
         // Send the "Finish" message (if the connection is not already broken).
         if (connectionState->networkException == nullptr) {
-          auto message = connectionState->connection->newOutgoingMessage(
+          auto message = connectionState->newOutgoingMessage(
               messageSizeHint<rpc::Finish>());
           auto builder = message->getBody().getAs<rpc::Message>().initFinish();
           builder.setQuestionId(id);
@@ -1194,7 +1286,7 @@ private:
                kj::Own<RpcClient>&& target)
         : connectionState(kj::addRef(connectionState)),
           target(kj::mv(target)),
-          message(connectionState.connection->newOutgoingMessage(
+          message(connectionState.newOutgoingMessage(
               firstSegmentSize(sizeHint, messageSizeHint<rpc::Call>() +
                   sizeInWords<rpc::Payload>() + MESSAGE_TARGET_SIZE_HINT))),
           callBuilder(message->getBody().getAs<rpc::Message>().initCall()),
@@ -1317,6 +1409,9 @@ private:
       if (isTailCall) {
         callBuilder.getSendResultsTo().setYourself();
       }
+      question.trace = connectionState->traceCallStart(
+          RpcInstrumentation::Direction::OUTGOING, callBuilder.getInterfaceId(),
+          callBuilder.getMethodId(), paramsBuilder.asReader());
       message->send();
 
       // Make the result promise.
@@ -1526,14 +1621,16 @@ private:
   public:
     RpcCallContext(RpcConnectionState& connectionState, AnswerId answerId,
                    kj::Own<IncomingRpcMessage>&& request, const AnyPointer::Reader& params,
-                   bool redirectResults, kj::Own<kj::PromiseFulfiller<void>>&& cancelFulfiller)
+                   bool redirectResults, kj::Own<kj::PromiseFulfiller<void>>&& cancelFulfiller,
+                   kj::Maybe<RpcInstrumentation::CallInfo> trace)
         : connectionState(kj::addRef(connectionState)),
           answerId(answerId),
           request(kj::mv(request)),
           params(params),
           returnMessage(nullptr),
           redirectResults(redirectResults),
-          cancelFulfiller(kj::mv(cancelFulfiller)) {}
+          cancelFulfiller(kj::mv(cancelFulfiller)),
+          trace(trace) {}
 
     ~RpcCallContext() noexcept(false) {
       if (isFirstResponder()) {
@@ -1541,7 +1638,7 @@ private:
         unwindDetector.catchExceptionsIfUnwinding([&]() {
           // Don't send anything if the connection is broken.
           if (connectionState->networkException == nullptr) {
-            auto message = connectionState->connection->newOutgoingMessage(
+            auto message = connectionState->newOutgoingMessage(
                 messageSizeHint<rpc::Return>() + sizeInWords<rpc::Payload>());
             auto builder = message->getBody().initAs<rpc::Message>().initReturn();
 
@@ -1557,6 +1654,12 @@ private:
             }
 
             message->send();
+
+            connectionState->traceCallEnd(trace, redirectResults
+                ? RpcInstrumentation::CallOutcome::RESULTS_SENT_ELSEWHERE
+                : RpcInstrumentation::CallOutcome::CANCELED);
+          } else {
+            connectionState->traceCallEnd(trace, RpcInstrumentation::CallOutcome::DISCONNECTED);
           }
 
           cleanupAnswerTable(nullptr, true);
@@ -1585,7 +1688,12 @@ private:
         returnMessage.setAnswerId(answerId);
         returnMessage.setReleaseParamCaps(false);
 
-        auto exports = kj::downcast<RpcServerResponseImpl>(*KJ_ASSERT_NONNULL(response)).send();
+        auto& responseImpl = kj::downcast<RpcServerResponseImpl>(*KJ_ASSERT_NONNULL(response));
+        uint64_t resultWords = trace == nullptr ? 0 :
+            responseImpl.getResultsBuilder().targetSize().wordCount;
+        auto exports = responseImpl.send();
+        connectionState->traceCallEnd(
+            trace, RpcInstrumentation::CallOutcome::RETURNED, resultWords);
         KJ_IF_MAYBE(e, exports) {
           // Caps were returned, so we can't free the pipeline yet.
           cleanupAnswerTable(kj::mv(*e), false);
@@ -1598,7 +1706,7 @@ private:
     void sendErrorReturn(kj::Exception&& exception) {
       KJ_ASSERT(!redirectResults);
       if (isFirstResponder()) {
-        auto message = connectionState->connection->newOutgoingMessage(
+        auto message = connectionState->newOutgoingMessage(
             messageSizeHint<rpc::Return>() + exceptionSizeHint(exception));
         auto builder = message->getBody().initAs<rpc::Message>().initReturn();
 
@@ -1607,6 +1715,7 @@ private:
         fromException(exception, builder.initException());
 
         message->send();
+        connectionState->traceCallEnd(trace, RpcInstrumentation::CallOutcome::FAILED);
 
         // Do not allow releasing the pipeline because we want pipelined calls to propagate the
         // exception rather than fail with a "no such field" exception.
@@ -1649,7 +1758,7 @@ private:
         if (redirectResults) {
           response = kj::refcounted<LocallyRedirectedRpcResponse>(sizeHint);
         } else {
-          auto message = connectionState->connection->newOutgoingMessage(
+          auto message = connectionState->newOutgoingMessage(
               firstSegmentSize(sizeHint, messageSizeHint<rpc::Return>() +
                                sizeInWords<rpc::Payload>()));
           returnMessage = message->getBody().initAs<rpc::Message>().initReturn();
@@ -1679,7 +1788,7 @@ private:
 
         KJ_IF_MAYBE(tailInfo, kj::downcast<RpcRequest>(*request).tailSend()) {
           if (isFirstResponder()) {
-            auto message = connectionState->connection->newOutgoingMessage(
+            auto message = connectionState->newOutgoingMessage(
                 messageSizeHint<rpc::Return>());
             auto builder = message->getBody().initAs<rpc::Message>().initReturn();
 
@@ -1688,6 +1797,8 @@ private:
             builder.setTakeFromOtherQuestion(tailInfo->questionId);
 
             message->send();
+            connectionState->traceCallEnd(
+                trace, RpcInstrumentation::CallOutcome::RESULTS_SENT_ELSEWHERE);
 
             // There are no caps in our return message, but of course the tail results could have
             // caps, so we must continue to honor pipeline calls (and just bounce them back).
@@ -1761,6 +1872,11 @@ private:
     // exclusive-joined with the outermost promise waiting on the call return, so fulfilling it
     // cancels that promise.
 
+    // Instrumentation -------------------------------------
+
+    kj::Maybe<RpcInstrumentation::CallInfo> trace;
+    // Non-null if the call was reported to the instrumentation and has not yet ended.
+
     kj::UnwindDetector unwindDetector;
 
     // -----------------------------------------------------
@@ -1814,17 +1930,25 @@ private:
             __FILE__, __LINE__, kj::str("Peer disconnected.")));
       }
     }).then([this]() {
-      // No exceptions; continue loop.
+      // No exceptions; continue loop, unless the connection is now dead.  (If capabilities
+      // still refer to this connection, it outlives the disconnect, and reading again would
+      // only spin on EOF.)
       //
       // (We do this in a separate continuation to handle the case where exceptions are
       // disabled.)
-      tasks.add(messageLoop());
+      if (networkException == nullptr) {
+        tasks.add(messageLoop());
+      }
     });
   }
 
   void handleMessage(kj::Own<IncomingRpcMessage> message) {
     auto reader = message->getBody().getAs<rpc::Message>();
 
+    KJ_IF_MAYBE(i, instrumentation) {
+      i->messageReceived(reader.which(), message->getBody().targetSize().wordCount, i->now());
+    }
+
     switch (reader.which()) {
       case rpc::Message::UNIMPLEMENTED:
         handleUnimplemented(reader.getUnimplemented());
@@ -1863,7 +1987,7 @@ private:
         break;
 
       default: {
-        auto message = connection->newOutgoingMessage(
+        auto message = newOutgoingMessage(
             firstSegmentSize(reader.totalSize(), messageSizeHint<void>()));
         message->getBody().initAs<rpc::Message>().setUnimplemented(reader);
         message->send();
@@ -1938,9 +2062,12 @@ private:
 
     AnswerId answerId = call.getQuestionId();
 
+    auto trace = traceCallStart(RpcInstrumentation::Direction::INCOMING,
+        call.getInterfaceId(), call.getMethodId(), payload.getContent());
+
     auto context = kj::refcounted<RpcCallContext>(
         *this, answerId, kj::mv(message), payload.getContent(),
-        redirectResults, kj::mv(cancelPaf.fulfiller));
+        redirectResults, kj::mv(cancelPaf.fulfiller), trace);
 
     // No more using `call` after this point, as it now belongs to the context.
 
@@ -2060,6 +2187,10 @@ private:
       KJ_REQUIRE(question->isAwaitingReturn, "Duplicate Return.") { return; }
       question->isAwaitingReturn = false;
 
+      if (question->trace != nullptr) {
+        traceReturn(question->trace, ret);
+      }
+
       if (ret.getReleaseParamCaps()) {
         exportsToRelease = kj::mv(question->paramExports);
       } else {
@@ -2139,6 +2270,28 @@ private:
     }
   }
 
+  void traceReturn(kj::Maybe<RpcInstrumentation::CallInfo>& trace, const rpc::Return::Reader& ret) {
+    switch (ret.which()) {
+      case rpc::Return::RESULTS:
+        traceCallEnd(trace, RpcInstrumentation::CallOutcome::RETURNED,
+                     ret.getResults().getContent().targetSize().wordCount);
+        break;
+      case rpc::Return::EXCEPTION:
+        traceCallEnd(trace, RpcInstrumentation::CallOutcome::FAILED);
+        break;
+      case rpc::Return::CANCELED:
+        traceCallEnd(trace, RpcInstrumentation::CallOutcome::CANCELED);
+        break;
+      case rpc::Return::RESULTS_SENT_ELSEWHERE:
+      case rpc::Return::TAKE_FROM_OTHER_QUESTION:
+        traceCallEnd(trace, RpcInstrumentation::CallOutcome::RESULTS_SENT_ELSEWHERE);
+        break;
+      default:
+        // Invalid; handleReturn() will complain.
+        break;
+    }
+  }
+
   void handleFinish(const rpc::Finish::Reader& finish) {
     // Delay release of these things until return so that transitive destructors don't accidentally
     // modify the answer table and invalidate our pointer into it.
@@ -2270,7 +2423,7 @@ private:
             target, [this,embargoId](kj::Own<ClientHook>&& target) {
           RpcClient& downcasted = kj::downcast<RpcClient>(*target);
 
-          auto message = connection->newOutgoingMessage(
+          auto message = newOutgoingMessage(
               messageSizeHint<rpc::Disembargo>() + MESSAGE_TARGET_SIZE_HINT);
           auto builder = message->getBody().initAs<rpc::Message>().initDisembargo();
 
@@ -2340,7 +2493,7 @@ private:
   void handleRestore(kj::Own<IncomingRpcMessage>&& message, const rpc::Restore::Reader& restore) {
     AnswerId answerId = restore.getQuestionId();
 
-    auto response = connection->newOutgoingMessage(
+    auto response = newOutgoingMessage(
         messageSizeHint<rpc::Return>() + sizeInWords<rpc::CapDescriptor>() + 32);
 
     rpc::Return::Builder ret = response->getBody().getAs<rpc::Message>().initReturn();
@@ -2404,6 +2557,7 @@ public:
             kj::Exception::Nature::LOCAL_BUG, kj::Exception::Durability::PERMANENT,
             __FILE__, __LINE__, kj::str("RpcSystem was destroyed."));
         for (auto& entry: connections) {
+          entry.second->setInstrumentation(nullptr);
           entry.second->disconnect(kj::cp(shutdownException));
           deleteMe.add(kj::mv(entry.second));
         }
@@ -2423,6 +2577,21 @@ public:
     }
   }
 
+  void setInstrumentation(kj::Maybe<RpcInstrumentation&> instrumentation) {
+    this->instrumentation = instrumentation;
+    for (auto& entry: connections) {
+      entry.second->setInstrumentation(instrumentation);
+    }
+  }
+
+  RpcSystemStats getStats() {
+    RpcSystemStats result;
+    for (auto& entry: connections) {
+      entry.second->addStats(result);
+    }
+    return result;
+  }
+
   void taskFailed(kj::Exception&& exception) override {
     KJ_LOG(ERROR, exception);
   }
@@ -2430,6 +2599,7 @@ public:
 private:
   VatNetworkBase& network;
   kj::Maybe<SturdyRefRestorerBase&> restorer;
+  kj::Maybe<RpcInstrumentation&> instrumentation;
   kj::TaskSet tasks;
 
   typedef std::unordered_map<VatNetworkBase::Connection*, kj::Own<RpcConnectionState>>
@@ -2447,7 +2617,7 @@ private:
         connections.erase(connectionPtr);
       }));
       auto newState = kj::refcounted<RpcConnectionState>(
-          restorer, kj::mv(connection), kj::mv(onDisconnect.fulfiller));
+          restorer, kj::mv(connection), kj::mv(onDisconnect.fulfiller), instrumentation);
       RpcConnectionState& result = *newState;
       connections.insert(std::make_pair(connectionPtr, kj::mv(newState)));
       return result;
@@ -2481,5 +2651,13 @@ Capability::Client RpcSystemBase::baseRestore(
   return impl->restore(hostId, objectId);
 }
 
+void RpcSystemBase::baseSetInstrumentation(kj::Maybe<RpcInstrumentation&> instrumentation) {
+  impl->setInstrumentation(instrumentation);
+}
+
+RpcSystemStats RpcSystemBase::baseGetStats() {
+  return impl->getStats();
+}
+
 }  // namespace _ (private)
 }  // namespace capnp
@@ -239,9 +239,13 @@ static const ::capnp::_::RawSchema* const d_91b79f1f808db032[] = {
 };
 static const uint16_t m_91b79f1f808db032[] = {1, 11, 2, 9, 13, 4, 12, 10, 6, 5, 8, 3, 7, 0};
 static const uint16_t i_91b79f1f808db032[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13};
+static const uint32_t p_91b79f1f808db032[] = {196616, 458763, 1769472};
+static const uint16_t h_91b79f1f808db032[] = {1, 13, 11, 9, 10, 12, 2, 3, 4, 0, 6, 7, 8, 5};
 const ::capnp::_::RawSchema s_91b79f1f808db032 = {
   0x91b79f1f808db032, b_91b79f1f808db032.words, 214, d_91b79f1f808db032, m_91b79f1f808db032,
-  14, 14, i_91b79f1f808db032, nullptr, nullptr
+  14, 14, i_91b79f1f808db032, nullptr, nullptr,
+  { 1, 1, 7, false, 14, 0, true },
+  0, p_91b79f1f808db032, h_91b79f1f808db032
 };
 static const ::capnp::_::AlignedData<114> b_836a53ce789d4cd4 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -366,9 +370,13 @@ static const ::capnp::_::RawSchema* const d_836a53ce789d4cd4[] = {
 };
 static const uint16_t m_836a53ce789d4cd4[] = {6, 2, 3, 4, 0, 5, 1};
 static const uint16_t i_836a53ce789d4cd4[] = {0, 1, 2, 3, 4, 5, 6};
+static const uint32_t p_836a53ce789d4cd4[] = {327680, 65539};
+static const uint16_t h_836a53ce789d4cd4[] = {4, 5, 2, 1, 0, 6, 3};
 const ::capnp::_::RawSchema s_836a53ce789d4cd4 = {
   0x836a53ce789d4cd4, b_836a53ce789d4cd4.words, 114, d_836a53ce789d4cd4, m_836a53ce789d4cd4,
-  3, 7, i_836a53ce789d4cd4, nullptr, nullptr
+  3, 7, i_836a53ce789d4cd4, nullptr, nullptr,
+  { 3, 3, 7, false, 0, 0, true },
+  0, p_836a53ce789d4cd4, h_836a53ce789d4cd4
 };
 static const ::capnp::_::AlignedData<61> b_dae8b0f61aab5f99 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -438,9 +446,13 @@ static const ::capnp::_::RawSchema* const d_dae8b0f61aab5f99[] = {
 };
 static const uint16_t m_dae8b0f61aab5f99[] = {0, 2, 1};
 static const uint16_t i_dae8b0f61aab5f99[] = {0, 1, 2};
+static const uint32_t p_dae8b0f61aab5f99[] = {327680};
+static const uint16_t h_dae8b0f61aab5f99[] = {1, 0, 2};
 const ::capnp::_::RawSchema s_dae8b0f61aab5f99 = {
   0xdae8b0f61aab5f99, b_dae8b0f61aab5f99.words, 61, d_dae8b0f61aab5f99, m_dae8b0f61aab5f99,
-  1, 3, i_dae8b0f61aab5f99, nullptr, nullptr
+  1, 3, i_dae8b0f61aab5f99, nullptr, nullptr,
+  { 3, 3, 7, true, 3, 3, true },
+  0, p_dae8b0f61aab5f99, h_dae8b0f61aab5f99
 };
 static const ::capnp::_::AlignedData<139> b_9e19b28d3db3573a = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -589,9 +601,13 @@ static const ::capnp::_::RawSchema* const d_9e19b28d3db3573a[] = {
 };
 static const uint16_t m_9e19b28d3db3573a[] = {7, 0, 4, 3, 1, 2, 5, 6};
 static const uint16_t i_9e19b28d3db3573a[] = {2, 3, 4, 5, 6, 7, 0, 1};
+static const uint32_t p_9e19b28d3db3573a[] = {589824, 327680};
+static const uint16_t h_9e19b28d3db3573a[] = {4, 0, 3, 7, 2, 1, 6, 5};
 const ::capnp::_::RawSchema s_9e19b28d3db3573a = {
   0x9e19b28d3db3573a, b_9e19b28d3db3573a.words, 139, d_9e19b28d3db3573a, m_9e19b28d3db3573a,
-  2, 8, i_9e19b28d3db3573a, nullptr, nullptr
+  2, 8, i_9e19b28d3db3573a, nullptr, nullptr,
+  { 2, 1, 7, false, 6, 3, true },
+  0, p_9e19b28d3db3573a, h_9e19b28d3db3573a
 };
 static const ::capnp::_::AlignedData<47> b_d37d2eb2c2f80e63 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -644,9 +660,13 @@ static const ::capnp::_::AlignedData<47> b_d37d2eb2c2f80e63 = {
 };
 static const uint16_t m_d37d2eb2c2f80e63[] = {0, 1};
 static const uint16_t i_d37d2eb2c2f80e63[] = {0, 1};
+static const uint32_t p_d37d2eb2c2f80e63[] = {0};
+static const uint16_t h_d37d2eb2c2f80e63[] = {1, 0};
 const ::capnp::_::RawSchema s_d37d2eb2c2f80e63 = {
   0xd37d2eb2c2f80e63, b_d37d2eb2c2f80e63.words, 47, nullptr, m_d37d2eb2c2f80e63,
-  0, 2, i_d37d2eb2c2f80e63, nullptr, nullptr
+  0, 2, i_d37d2eb2c2f80e63, nullptr, nullptr,
+  { 1, 0, 5, false, 0, 0, true },
+  0, p_d37d2eb2c2f80e63, h_d37d2eb2c2f80e63
 };
 static const ::capnp::_::AlignedData<60> b_bbc29655fa89086e = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -716,9 +736,13 @@ static const ::capnp::_::RawSchema* const d_bbc29655fa89086e[] = {
 };
 static const uint16_t m_bbc29655fa89086e[] = {1, 2, 0};
 static const uint16_t i_bbc29655fa89086e[] = {1, 2, 0};
+static const uint32_t p_bbc29655fa89086e[] = {0};
+static const uint16_t h_bbc29655fa89086e[] = {1, 2, 0};
 const ::capnp::_::RawSchema s_bbc29655fa89086e = {
   0xbbc29655fa89086e, b_bbc29655fa89086e.words, 60, d_bbc29655fa89086e, m_bbc29655fa89086e,
-  2, 3, i_bbc29655fa89086e, nullptr, nullptr
+  2, 3, i_bbc29655fa89086e, nullptr, nullptr,
+  { 1, 1, 7, false, 2, 2, true },
+  0, p_bbc29655fa89086e, h_bbc29655fa89086e
 };
 static const ::capnp::_::AlignedData<45> b_ad1a6c0d7dd07497 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -769,9 +793,13 @@ static const ::capnp::_::AlignedData<45> b_ad1a6c0d7dd07497 = {
 };
 static const uint16_t m_ad1a6c0d7dd07497[] = {0, 1};
 static const uint16_t i_ad1a6c0d7dd07497[] = {0, 1};
+static const uint32_t p_ad1a6c0d7dd07497[] = {393216};
+static const uint16_t h_ad1a6c0d7dd07497[] = {1, 0};
 const ::capnp::_::RawSchema s_ad1a6c0d7dd07497 = {
   0xad1a6c0d7dd07497, b_ad1a6c0d7dd07497.words, 45, nullptr, m_ad1a6c0d7dd07497,
-  0, 2, i_ad1a6c0d7dd07497, nullptr, nullptr
+  0, 2, i_ad1a6c0d7dd07497, nullptr, nullptr,
+  { 1, 0, 5, false, 0, 0, true },
+  0, p_ad1a6c0d7dd07497, h_ad1a6c0d7dd07497
 };
 static const ::capnp::_::AlignedData<39> b_f964368b0fbd3711 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -820,9 +848,13 @@ static const ::capnp::_::RawSchema* const d_f964368b0fbd3711[] = {
 };
 static const uint16_t m_f964368b0fbd3711[] = {1, 0};
 static const uint16_t i_f964368b0fbd3711[] = {0, 1};
+static const uint32_t p_f964368b0fbd3711[] = {131072};
+static const uint16_t h_f964368b0fbd3711[] = {1, 0};
 const ::capnp::_::RawSchema s_f964368b0fbd3711 = {
   0xf964368b0fbd3711, b_f964368b0fbd3711.words, 39, d_f964368b0fbd3711, m_f964368b0fbd3711,
-  2, 2, i_f964368b0fbd3711, nullptr, nullptr
+  2, 2, i_f964368b0fbd3711, nullptr, nullptr,
+  { 1, 1, 7, false, 0, 0, true },
+  0, p_f964368b0fbd3711, h_f964368b0fbd3711
 };
 static const ::capnp::_::AlignedData<76> b_d562b4df655bdd4d = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -907,9 +939,13 @@ static const ::capnp::_::RawSchema* const d_d562b4df655bdd4d[] = {
 };
 static const uint16_t m_d562b4df655bdd4d[] = {2, 3, 1, 0};
 static const uint16_t i_d562b4df655bdd4d[] = {0, 1, 2, 3};
+static const uint32_t p_d562b4df655bdd4d[] = {1900544};
+static const uint16_t h_d562b4df655bdd4d[] = {0, 3, 2, 1};
 const ::capnp::_::RawSchema s_d562b4df655bdd4d = {
   0xd562b4df655bdd4d, b_d562b4df655bdd4d.words, 76, d_d562b4df655bdd4d, m_d562b4df655bdd4d,
-  1, 4, i_d562b4df655bdd4d, nullptr, nullptr
+  1, 4, i_d562b4df655bdd4d, nullptr, nullptr,
+  { 1, 1, 7, true, 4, 2, true },
+  0, p_d562b4df655bdd4d, h_d562b4df655bdd4d
 };
 static const ::capnp::_::AlignedData<45> b_e40ef0b4b02e882c = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -963,9 +999,13 @@ static const ::capnp::_::RawSchema* const d_e40ef0b4b02e882c[] = {
 };
 static const uint16_t m_e40ef0b4b02e882c[] = {0, 1};
 static const uint16_t i_e40ef0b4b02e882c[] = {0, 1};
+static const uint32_t p_e40ef0b4b02e882c[] = {65536};
+static const uint16_t h_e40ef0b4b02e882c[] = {1, 0};
 const ::capnp::_::RawSchema s_e40ef0b4b02e882c = {
   0xe40ef0b4b02e882c, b_e40ef0b4b02e882c.words, 45, d_e40ef0b4b02e882c, m_e40ef0b4b02e882c,
-  1, 2, i_e40ef0b4b02e882c, nullptr, nullptr
+  1, 2, i_e40ef0b4b02e882c, nullptr, nullptr,
+  { 1, 1, 7, false, 0, 0, true },
+  0, p_e40ef0b4b02e882c, h_e40ef0b4b02e882c
 };
 static const ::capnp::_::AlignedData<46> b_ec0c922151b8b0a8 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1017,9 +1057,13 @@ static const ::capnp::_::AlignedData<46> b_ec0c922151b8b0a8 = {
 };
 static const uint16_t m_ec0c922151b8b0a8[] = {1, 0};
 static const uint16_t i_ec0c922151b8b0a8[] = {0, 1};
+static const uint32_t p_ec0c922151b8b0a8[] = {65536};
+static const uint16_t h_ec0c922151b8b0a8[] = {1, 0};
 const ::capnp::_::RawSchema s_ec0c922151b8b0a8 = {
   0xec0c922151b8b0a8, b_ec0c922151b8b0a8.words, 46, nullptr, m_ec0c922151b8b0a8,
-  0, 2, i_ec0c922151b8b0a8, nullptr, nullptr
+  0, 2, i_ec0c922151b8b0a8, nullptr, nullptr,
+  { 1, 1, 7, false, 0, 0, true },
+  0, p_ec0c922151b8b0a8, h_ec0c922151b8b0a8
 };
 static const ::capnp::_::AlignedData<46> b_86267432565dee97 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1071,9 +1115,13 @@ static const ::capnp::_::AlignedData<46> b_86267432565dee97 = {
 };
 static const uint16_t m_86267432565dee97[] = {1, 0};
 static const uint16_t i_86267432565dee97[] = {0, 1};
+static const uint32_t p_86267432565dee97[] = {65536};
+static const uint16_t h_86267432565dee97[] = {1, 0};
 const ::capnp::_::RawSchema s_86267432565dee97 = {
   0x86267432565dee97, b_86267432565dee97.words, 46, nullptr, m_86267432565dee97,
-  0, 2, i_86267432565dee97, nullptr, nullptr
+  0, 2, i_86267432565dee97, nullptr, nullptr,
+  { 1, 1, 7, false, 0, 0, true },
+  0, p_86267432565dee97, h_86267432565dee97
 };
 static const ::capnp::_::AlignedData<60> b_9c6a046bfbc1ac5a = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1142,9 +1190,13 @@ static const ::capnp::_::RawSchema* const d_9c6a046bfbc1ac5a[] = {
 };
 static const uint16_t m_9c6a046bfbc1ac5a[] = {0, 2, 1};
 static const uint16_t i_9c6a046bfbc1ac5a[] = {0, 1, 2};
+static const uint32_t p_9c6a046bfbc1ac5a[] = {65536};
+static const uint16_t h_9c6a046bfbc1ac5a[] = {1, 2, 0};
 const ::capnp::_::RawSchema s_9c6a046bfbc1ac5a = {
   0x9c6a046bfbc1ac5a, b_9c6a046bfbc1ac5a.words, 60, d_9c6a046bfbc1ac5a, m_9c6a046bfbc1ac5a,
-  1, 3, i_9c6a046bfbc1ac5a, nullptr, nullptr
+  1, 3, i_9c6a046bfbc1ac5a, nullptr, nullptr,
+  { 1, 2, 7, false, 0, 0, true },
+  0, p_9c6a046bfbc1ac5a, h_9c6a046bfbc1ac5a
 };
 static const ::capnp::_::AlignedData<60> b_d4c9b56290554016 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1210,9 +1262,13 @@ static const ::capnp::_::AlignedData<60> b_d4c9b56290554016 = {
 };
 static const uint16_t m_d4c9b56290554016[] = {2, 1, 0};
 static const uint16_t i_d4c9b56290554016[] = {0, 1, 2};
+static const uint32_t p_d4c9b56290554016[] = {0};
+static const uint16_t h_d4c9b56290554016[] = {2, 1, 0};
 const ::capnp::_::RawSchema s_d4c9b56290554016 = {
   0xd4c9b56290554016, b_d4c9b56290554016.words, 60, nullptr, m_d4c9b56290554016,
-  0, 3, i_d4c9b56290554016, nullptr, nullptr
+  0, 3, i_d4c9b56290554016, nullptr, nullptr,
+  { 1, 1, 7, false, 0, 0, true },
+  0, p_d4c9b56290554016, h_d4c9b56290554016
 };
 static const ::capnp::_::AlignedData<59> b_fbe1980490e001af = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1280,9 +1336,13 @@ static const ::capnp::_::RawSchema* const d_fbe1980490e001af[] = {
 };
 static const uint16_t m_fbe1980490e001af[] = {2, 0, 1};
 static const uint16_t i_fbe1980490e001af[] = {0, 1, 2};
+static const uint32_t p_fbe1980490e001af[] = {0};
+static const uint16_t h_fbe1980490e001af[] = {2, 1, 0};
 const ::capnp::_::RawSchema s_fbe1980490e001af = {
   0xfbe1980490e001af, b_fbe1980490e001af.words, 59, d_fbe1980490e001af, m_fbe1980490e001af,
-  1, 3, i_fbe1980490e001af, nullptr, nullptr
+  1, 3, i_fbe1980490e001af, nullptr, nullptr,
+  { 1, 2, 7, false, 0, 0, true },
+  0, p_fbe1980490e001af, h_fbe1980490e001af
 };
 static const ::capnp::_::AlignedData<47> b_95bc14545813fbc1 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1338,9 +1398,13 @@ static const ::capnp::_::RawSchema* const d_95bc14545813fbc1[] = {
 };
 static const uint16_t m_95bc14545813fbc1[] = {0, 1};
 static const uint16_t i_95bc14545813fbc1[] = {0, 1};
+static const uint32_t p_95bc14545813fbc1[] = {0};
+static const uint16_t h_95bc14545813fbc1[] = {0, 1};
 const ::capnp::_::RawSchema s_95bc14545813fbc1 = {
   0x95bc14545813fbc1, b_95bc14545813fbc1.words, 47, d_95bc14545813fbc1, m_95bc14545813fbc1,
-  1, 2, i_95bc14545813fbc1, nullptr, nullptr
+  1, 2, i_95bc14545813fbc1, nullptr, nullptr,
+  { 1, 1, 7, false, 2, 2, true },
+  0, p_95bc14545813fbc1, h_95bc14545813fbc1
 };
 static const ::capnp::_::AlignedData<48> b_9a0e61223d96743b = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1397,9 +1461,13 @@ static const ::capnp::_::RawSchema* const d_9a0e61223d96743b[] = {
 };
 static const uint16_t m_9a0e61223d96743b[] = {1, 0};
 static const uint16_t i_9a0e61223d96743b[] = {0, 1};
+static const uint32_t p_9a0e61223d96743b[] = {65536};
+static const uint16_t h_9a0e61223d96743b[] = {1, 0};
 const ::capnp::_::RawSchema s_9a0e61223d96743b = {
   0x9a0e61223d96743b, b_9a0e61223d96743b.words, 48, d_9a0e61223d96743b, m_9a0e61223d96743b,
-  1, 2, i_9a0e61223d96743b, nullptr, nullptr
+  1, 2, i_9a0e61223d96743b, nullptr, nullptr,
+  { 0, 2, 7, false, 0, 0, true },
+  0, p_9a0e61223d96743b, h_9a0e61223d96743b
 };
 static const ::capnp::_::AlignedData<107> b_8523ddc40b86b8b0 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1516,9 +1584,13 @@ static const ::capnp::_::RawSchema* const d_8523ddc40b86b8b0[] = {
 };
 static const uint16_t m_8523ddc40b86b8b0[] = {0, 4, 3, 1, 2, 5};
 static const uint16_t i_8523ddc40b86b8b0[] = {0, 1, 2, 3, 4, 5};
+static const uint32_t p_8523ddc40b86b8b0[] = {65536, 589829};
+static const uint16_t h_8523ddc40b86b8b0[] = {3, 2, 0, 5, 1, 4};
 const ::capnp::_::RawSchema s_8523ddc40b86b8b0 = {
   0x8523ddc40b86b8b0, b_8523ddc40b86b8b0.words, 107, d_8523ddc40b86b8b0, m_8523ddc40b86b8b0,
-  2, 6, i_8523ddc40b86b8b0, nullptr, nullptr
+  2, 6, i_8523ddc40b86b8b0, nullptr, nullptr,
+  { 1, 1, 7, false, 6, 0, true },
+  0, p_8523ddc40b86b8b0, h_8523ddc40b86b8b0
 };
 static const ::capnp::_::AlignedData<53> b_d800b1d6cd6f1ca0 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1580,9 +1652,13 @@ static const ::capnp::_::RawSchema* const d_d800b1d6cd6f1ca0[] = {
 };
 static const uint16_t m_d800b1d6cd6f1ca0[] = {0, 1};
 static const uint16_t i_d800b1d6cd6f1ca0[] = {0, 1};
+static const uint32_t p_d800b1d6cd6f1ca0[] = {0};
+static const uint16_t h_d800b1d6cd6f1ca0[] = {1, 0};
 const ::capnp::_::RawSchema s_d800b1d6cd6f1ca0 = {
   0xd800b1d6cd6f1ca0, b_d800b1d6cd6f1ca0.words, 53, d_d800b1d6cd6f1ca0, m_d800b1d6cd6f1ca0,
-  1, 2, i_d800b1d6cd6f1ca0, nullptr, nullptr
+  1, 2, i_d800b1d6cd6f1ca0, nullptr, nullptr,
+  { 1, 1, 7, false, 0, 0, true },
+  0, p_d800b1d6cd6f1ca0, h_d800b1d6cd6f1ca0
 };
 static const ::capnp::_::AlignedData<47> b_f316944415569081 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1635,9 +1711,13 @@ static const ::capnp::_::AlignedData<47> b_f316944415569081 = {
 };
 static const uint16_t m_f316944415569081[] = {1, 0};
 static const uint16_t i_f316944415569081[] = {0, 1};
+static const uint32_t p_f316944415569081[] = {0};
+static const uint16_t h_f316944415569081[] = {1, 0};
 const ::capnp::_::RawSchema s_f316944415569081 = {
   0xf316944415569081, b_f316944415569081.words, 47, nullptr, m_f316944415569081,
-  0, 2, i_f316944415569081, nullptr, nullptr
+  0, 2, i_f316944415569081, nullptr, nullptr,
+  { 1, 0, 4, false, 2, 0, true },
+  0, p_f316944415569081, h_f316944415569081
 };
 static const ::capnp::_::AlignedData<46> b_ce8c7a90684b48ff = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1689,9 +1769,13 @@ static const ::capnp::_::AlignedData<46> b_ce8c7a90684b48ff = {
 };
 static const uint16_t m_ce8c7a90684b48ff[] = {0, 1};
 static const uint16_t i_ce8c7a90684b48ff[] = {0, 1};
+static const uint32_t p_ce8c7a90684b48ff[] = {65536};
+static const uint16_t h_ce8c7a90684b48ff[] = {1, 0};
 const ::capnp::_::RawSchema s_ce8c7a90684b48ff = {
   0xce8c7a90684b48ff, b_ce8c7a90684b48ff.words, 46, nullptr, m_ce8c7a90684b48ff,
-  0, 2, i_ce8c7a90684b48ff, nullptr, nullptr
+  0, 2, i_ce8c7a90684b48ff, nullptr, nullptr,
+  { 0, 2, 7, false, 0, 0, true },
+  0, p_ce8c7a90684b48ff, h_ce8c7a90684b48ff
 };
 static const ::capnp::_::AlignedData<46> b_d37007fde1f0027d = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1743,9 +1827,13 @@ static const ::capnp::_::AlignedData<46> b_d37007fde1f0027d = {
 };
 static const uint16_t m_d37007fde1f0027d[] = {0, 1};
 static const uint16_t i_d37007fde1f0027d[] = {0, 1};
+static const uint32_t p_d37007fde1f0027d[] = {0};
+static const uint16_t h_d37007fde1f0027d[] = {0, 1};
 const ::capnp::_::RawSchema s_d37007fde1f0027d = {
   0xd37007fde1f0027d, b_d37007fde1f0027d.words, 46, nullptr, m_d37007fde1f0027d,
-  0, 2, i_d37007fde1f0027d, nullptr, nullptr
+  0, 2, i_d37007fde1f0027d, nullptr, nullptr,
+  { 1, 1, 7, false, 0, 0, true },
+  0, p_d37007fde1f0027d, h_d37007fde1f0027d
 };
 static const ::capnp::_::AlignedData<65> b_d625b7063acf691a = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1819,9 +1907,13 @@ static const ::capnp::_::RawSchema* const d_d625b7063acf691a[] = {
 };
 static const uint16_t m_d625b7063acf691a[] = {2, 1, 0};
 static const uint16_t i_d625b7063acf691a[] = {0, 1, 2};
+static const uint32_t p_d625b7063acf691a[] = {589824};
+static const uint16_t h_d625b7063acf691a[] = {2, 0, 1};
 const ::capnp::_::RawSchema s_d625b7063acf691a = {
   0xd625b7063acf691a, b_d625b7063acf691a.words, 65, d_d625b7063acf691a, m_d625b7063acf691a,
-  1, 3, i_d625b7063acf691a, nullptr, nullptr
+  1, 3, i_d625b7063acf691a, nullptr, nullptr,
+  { 1, 1, 7, false, 0, 0, true },
+  0, p_d625b7063acf691a, h_d625b7063acf691a
 };
 static const ::capnp::_::AlignedData<33> b_bbaeda2607b6f958 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1859,9 +1951,13 @@ static const ::capnp::_::AlignedData<33> b_bbaeda2607b6f958 = {
     101, 100,   0,   0,   0,   0,   0,   0, }
 };
 static const uint16_t m_bbaeda2607b6f958[] = {2, 0, 1};
+static const uint32_t p_bbaeda2607b6f958[] = {0};
+static const uint16_t h_bbaeda2607b6f958[] = {0, 1, 2};
 const ::capnp::_::RawSchema s_bbaeda2607b6f958 = {
   0xbbaeda2607b6f958, b_bbaeda2607b6f958.words, 33, nullptr, m_bbaeda2607b6f958,
-  0, 3, nullptr, nullptr, nullptr
+  0, 3, nullptr, nullptr, nullptr,
+  { 0, 0, 0, false, 0, 0, false },
+  0, p_bbaeda2607b6f958, h_bbaeda2607b6f958
 };
 }  // namespace schemas
 namespace _ {  // private
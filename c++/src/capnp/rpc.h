@@ -26,6 +26,7 @@
 
 #include "capability.h"
 #include "rpc-prelude.h"
+#include "rpc-instrumentation.h"
 
 namespace capnp {
 
@@ -64,6 +65,16 @@ public:
   //
   // `hostId` identifies the host from which to request the ref, in the format specified by the
   // `VatNetwork` in use.  `objectId` is the object ID in whatever format is expected by said host.
+
+  void setInstrumentation(kj::Maybe<RpcInstrumentation&> instrumentation);
+  // Install (or, with nullptr, remove) a hook that receives call and message events from all
+  // connections, current and future.  See `rpc-instrumentation.h`.  The instrumentation object
+  // must outlive the `RpcSystem` or be removed first.  Calls already in flight when it is
+  // installed are not reported.
+
+  RpcSystemStats getStats();
+  // Count the entries currently in the question, answer, export, and import tables across all
+  // connections.  This walks the tables, so it is meant for occasional polling, not per-call use.
 };
 
 template <typename SturdyRefHostId, typename LocalSturdyRefObjectId,
@@ -343,6 +354,17 @@ Capability::Client RpcSystem<SturdyRefHostId>::restore(
   return baseRestore(_::PointerHelpers<SturdyRefHostId>::getInternalReader(hostId), objectId);
 }
 
+template <typename SturdyRefHostId>
+inline void RpcSystem<SturdyRefHostId>::setInstrumentation(
+    kj::Maybe<RpcInstrumentation&> instrumentation) {
+  baseSetInstrumentation(instrumentation);
+}
+
+template <typename SturdyRefHostId>
+inline RpcSystemStats RpcSystem<SturdyRefHostId>::getStats() {
+  return baseGetStats();
+}
+
 template <typename SturdyRefHostId, typename LocalSturdyRefObjectId,
           typename ProvisionId, typename RecipientId, typename ThirdPartyCapId, typename JoinResult>
 RpcSystem<SturdyRefHostId> makeRpcServer(
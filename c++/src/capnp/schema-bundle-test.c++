@@ -0,0 +1,123 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "schema-bundle.h"
+#include "message.h"
+#include <kj/debug.h>
+#include <kj/vector.h>
+#include <gtest/gtest.h>
+#include "test-util.h"
+
+namespace capnp {
+namespace _ {  // private
+namespace {
+
+class WordOutputStream: public kj::OutputStream {
+public:
+  void write(const void* buffer, size_t size) override {
+    bytes.addAll(reinterpret_cast<const char*>(buffer),
+                 reinterpret_cast<const char*>(buffer) + size);
+  }
+
+  kj::Array<const word> finish() {
+    KJ_ASSERT(bytes.size() % sizeof(word) == 0);
+    auto result = kj::heapArray<word>(bytes.size() / sizeof(word));
+    memcpy(result.begin(), bytes.begin(), bytes.size());
+    return kj::mv(result);
+  }
+
+private:
+  kj::Vector<char> bytes;
+};
+
+kj::Array<const word> makeTestBundle() {
+  // Bundle everything reachable from a few test types.
+  SchemaLoader source;
+  source.loadCompiledTypeAndDependencies<TestAllTypes>();
+  source.loadCompiledTypeAndDependencies<TestDefaults>();
+  source.loadCompiledTypeAndDependencies<TestUnion>();
+  source.loadCompiledTypeAndDependencies<test::TestGroups>();
+  auto schemas = source.getAllLoaded();
+
+  MallocMessageBuilder message;
+  auto request = message.initRoot<schema::CodeGeneratorRequest>();
+  auto nodes = request.initNodes(schemas.size());
+  for (uint i = 0; i < schemas.size(); i++) {
+    nodes.setWithCaveats(i, schemas[i].getProto());
+  }
+  auto file = request.initRequestedFiles(1)[0];
+  file.setId(0x8000000000001234ull);
+  file.setFilename("foo/test.capnp");
+
+  WordOutputStream output;
+  writeSchemaBundle(output, request.asReader());
+  return output.finish();
+}
+
+TEST(SchemaBundle, Find) {
+  SchemaBundle bundle(makeTestBundle());
+  EXPECT_GE(bundle.size(), 5u);
+
+  KJ_IF_MAYBE(node, bundle.find(typeId<TestAllTypes>())) {
+    EXPECT_EQ(Schema::from<TestAllTypes>().getProto().getDisplayName(), node->getDisplayName());
+  } else {
+    ADD_FAILURE() << "TestAllTypes not found";
+  }
+  EXPECT_TRUE(bundle.find(typeId<TestEnum>()) != nullptr);
+  EXPECT_TRUE(bundle.find(typeId<test::TestGroups>()) != nullptr);
+  EXPECT_TRUE(bundle.find(typeId<test::TestInterleavedGroups>()) == nullptr);
+  EXPECT_TRUE(bundle.find(0) == nullptr);
+  EXPECT_TRUE(bundle.find(kj::maxValue) == nullptr);
+
+  EXPECT_EQ(0x8000000000001234ull, KJ_ASSERT_NONNULL(bundle.findFile("foo/test.capnp")));
+  EXPECT_TRUE(bundle.findFile("test.capnp") == nullptr);
+}
+
+TEST(SchemaBundle, LazyLoad) {
+  SchemaBundle bundle(makeTestBundle());
+  SchemaLoader loader(bundle);
+
+  EXPECT_EQ(0u, loader.getAllLoaded().size());
+
+  StructSchema schema = loader.get(typeId<TestDefaults>()).asStruct();
+  EXPECT_EQ(1u, loader.getAllLoaded().size());
+
+  // Dependencies are only loaded from the bundle when used.
+  StructSchema dep = schema.getDependency(typeId<TestAllTypes>()).asStruct();
+  EXPECT_EQ(2u, loader.getAllLoaded().size());
+  EXPECT_TRUE(dep == loader.get(typeId<TestAllTypes>()));
+
+  // The loaded schemas work with the dynamic API.
+  MallocMessageBuilder builder;
+  auto root = builder.initRoot<DynamicStruct>(dep);
+  root.set("int32Field", 123);
+  root.set("enumField", "garply");
+  EXPECT_EQ(123, builder.getRoot<TestAllTypes>().getInt32Field());
+  EXPECT_EQ(TestEnum::GARPLY, builder.getRoot<TestAllTypes>().getEnumField());
+
+  EXPECT_TRUE(loader.tryGet(typeId<test::TestInterleavedGroups>()) == nullptr);
+}
+
+}  // namespace
+}  // namespace _ (private)
+}  // namespace capnp
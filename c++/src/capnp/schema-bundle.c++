@@ -0,0 +1,133 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "schema-bundle.h"
+#include "message.h"
+#include <kj/debug.h>
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace capnp {
+
+namespace {
+
+class MmapDisposer: public kj::ArrayDisposer {
+protected:
+  void disposeImpl(void* firstElement, size_t elementSize, size_t elementCount,
+                   size_t capacity, void (*destroyElement)(void*)) const {
+    munmap(firstElement, elementSize * elementCount);
+  }
+};
+
+constexpr MmapDisposer mmapDisposer = MmapDisposer();
+
+ReaderOptions bundleReaderOptions() {
+  ReaderOptions options;
+  options.traversalLimitInWords = kj::maxValue;
+  return options;
+}
+
+}  // namespace
+
+SchemaBundle::SchemaBundle(kj::Array<const word> bundleParam)
+    : bundle(kj::mv(bundleParam)),
+      reader(bundle, bundleReaderOptions()),
+      request(reader.getRoot<schema::CodeGeneratorRequest>()),
+      nodes(request.getNodes()) {}
+
+kj::Own<SchemaBundle> SchemaBundle::open(kj::StringPtr path) {
+  int fd;
+  KJ_SYSCALL(fd = ::open(path.cStr(), O_RDONLY), path);
+  kj::AutoCloseFd closer(fd);
+
+  struct stat stats;
+  KJ_SYSCALL(fstat(fd, &stats), path);
+  KJ_REQUIRE(stats.st_size > 0 && stats.st_size % sizeof(word) == 0,
+             "not a schema bundle", path);
+
+  const void* mapping = mmap(NULL, stats.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  if (mapping == MAP_FAILED) {
+    KJ_FAIL_SYSCALL("mmap", errno, path);
+  }
+
+  return kj::heap<SchemaBundle>(kj::Array<const word>(
+      reinterpret_cast<const word*>(mapping), stats.st_size / sizeof(word), mmapDisposer));
+}
+
+kj::Maybe<schema::Node::Reader> SchemaBundle::find(uint64_t id) const {
+  uint lower = 0;
+  uint upper = nodes.size();
+  while (lower < upper) {
+    uint mid = lower + (upper - lower) / 2;
+    auto node = nodes[mid];
+    uint64_t midId = node.getId();
+    if (midId == id) {
+      return node;
+    } else if (midId < id) {
+      lower = mid + 1;
+    } else {
+      upper = mid;
+    }
+  }
+  return nullptr;
+}
+
+kj::Maybe<uint64_t> SchemaBundle::findFile(kj::StringPtr filename) const {
+  for (auto file: request.getRequestedFiles()) {
+    if (file.getFilename() == filename) {
+      return file.getId();
+    }
+  }
+  return nullptr;
+}
+
+void SchemaBundle::load(const SchemaLoader& loader, uint64_t id) const {
+  KJ_IF_MAYBE(node, find(id)) {
+    loader.loadOnce(*node);
+  }
+}
+
+void writeSchemaBundle(kj::OutputStream& output, schema::CodeGeneratorRequest::Reader request) {
+  auto nodes = KJ_MAP(node, request.getNodes()) { return node; };
+  std::sort(nodes.begin(), nodes.end(),
+      [](const schema::Node::Reader& a, const schema::Node::Reader& b) {
+        return a.getId() < b.getId();
+      });
+
+  // Allocate enough space up front that the bundle is a single segment.
+  MallocMessageBuilder message(request.totalSize().wordCount + 1);
+  auto bundle = message.initRoot<schema::CodeGeneratorRequest>();
+  auto bundleNodes = bundle.initNodes(nodes.size());
+  for (uint i = 0; i < nodes.size(); i++) {
+    bundleNodes.setWithCaveats(i, nodes[i]);
+  }
+  bundle.setRequestedFiles(request.getRequestedFiles());
+
+  writeMessage(output, message);
+}
+
+}  // namespace capnp
@@ -0,0 +1,84 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef CAPNP_SCHEMA_BUNDLE_H_
+#define CAPNP_SCHEMA_BUNDLE_H_
+
+#include "schema-loader.h"
+#include "serialize.h"
+#include <kj/io.h>
+
+namespace capnp {
+
+class SchemaBundle final: public SchemaLoader::LazyLoadCallback {
+  // A precompiled set of schema nodes, as written by `capnp compile -obundle`, from which a
+  // SchemaLoader can load nodes on demand.  This lets a program that needs schemas at runtime
+  // skip parsing and compiling `.capnp` files at startup:
+  //
+  //     auto bundle = SchemaBundle::open("my-schemas.bundle");
+  //     SchemaLoader loader(*bundle);
+  //     Schema foo = loader.get(0xabcdef0123456789ull);
+  //
+  // Opening a bundle maps the file into memory without reading it.  A node is looked up (by binary
+  // search over the bundle's ID-sorted node list) and copied into the loader only when the loader
+  // first needs it -- that is, when it is requested by ID or first used as a dependency -- so
+  // startup cost is proportional to the number of nodes actually used.
+  //
+  // A bundle is an ordinary Cap'n Proto message (written with writeMessage()) whose root is a
+  // schema::CodeGeneratorRequest with its nodes sorted by ID.  Since bundles are produced by the
+  // compiler, they are trusted not to be maliciously large, and no traversal limit is applied.
+
+public:
+  explicit SchemaBundle(kj::Array<const word> bundle);
+  // Read a bundle from the given bytes.
+
+  static kj::Own<SchemaBundle> open(kj::StringPtr path);
+  // mmap() the bundle at the given path.  Throws an exception if the file can't be opened.
+
+  kj::Maybe<schema::Node::Reader> find(uint64_t id) const;
+  // Find the node with the given ID, or return null if the bundle doesn't contain it.
+
+  kj::Maybe<uint64_t> findFile(kj::StringPtr filename) const;
+  // Find the ID of the file with the given name, as it was given on the compiler's command line
+  // (minus any --src-prefix).  Only files that were compiled directly, not their imports, can be
+  // found this way.
+
+  inline uint size() const { return nodes.size(); }
+  // Number of nodes in the bundle.
+
+  void load(const SchemaLoader& loader, uint64_t id) const override;
+
+private:
+  kj::Array<const word> bundle;
+  FlatArrayMessageReader reader;
+  schema::CodeGeneratorRequest::Reader request;
+  List<schema::Node>::Reader nodes;
+};
+
+void writeSchemaBundle(kj::OutputStream& output, schema::CodeGeneratorRequest::Reader request);
+// Write `request`'s nodes and requested files as a bundle which SchemaBundle can read.  The nodes
+// may be in any order.
+
+}  // namespace capnp
+
+#endif  // CAPNP_SCHEMA_BUNDLE_H_
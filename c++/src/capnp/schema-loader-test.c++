@@ -25,9 +25,28 @@
 #include <gtest/gtest.h>
 #include "test-util.h"
 #include <kj/debug.h>
+#include <kj/thread.h>
 
 namespace capnp {
 namespace _ {  // private
+
+struct StaleUnnamedUnion {};
+// Stands in for TestUnnamedUnion as compiled by a capnpc that predates RawSchema::structLayout,
+// which leaves the layout zero-filled.
+
+template <> struct Kind_<StaleUnnamedUnion> { static constexpr Kind kind = Kind::STRUCT; };
+constexpr Kind Kind_<StaleUnnamedUnion>::kind;
+template <> struct RawSchema_<StaleUnnamedUnion> {
+  static const RawSchema& get() {
+    static const RawSchema result = []() {
+      RawSchema raw = rawSchema<test::TestUnnamedUnion>();
+      memset(&raw.structLayout, 0, sizeof(raw.structLayout));
+      return raw;
+    }();
+    return result;
+  }
+};
+
 namespace {
 
 TEST(SchemaLoader, Load) {
@@ -226,6 +245,90 @@ TEST(SchemaLoader, Downgrade) {
   schema.requireUsableAs<test::TestNewVersion>();
 }
 
+void expectLayoutMatchesProto(StructSchema schema) {
+  auto proto = schema.getProto().getStruct();
+  auto layout = schema.getLayout();
+  EXPECT_EQ(proto.getDataWordCount(), layout.dataWordCount);
+  EXPECT_EQ(proto.getPointerCount(), layout.pointerCount);
+  EXPECT_EQ(static_cast<uint>(proto.getPreferredListEncoding()),
+            static_cast<uint>(layout.preferredListEncoding));
+  EXPECT_EQ(proto.getIsGroup(), layout.isGroup);
+  EXPECT_EQ(proto.getDiscriminantCount(), layout.discriminantCount);
+  EXPECT_EQ(proto.getDiscriminantOffset(), layout.discriminantOffset);
+}
+
+TEST(SchemaLoader, StructLayout) {
+  // Compiled-in.
+  expectLayoutMatchesProto(Schema::from<test::TestAllTypes>());
+  expectLayoutMatchesProto(Schema::from<test::TestUnion>());
+  expectLayoutMatchesProto(Schema::from<test::TestUnion::Union0>());
+  EXPECT_TRUE(Schema::from<test::TestUnion::Union0>().getLayout().isGroup);
+  EXPECT_NE(0u, Schema::from<test::TestUnion::Union0>().getLayout().discriminantCount);
+
+  // Dynamically loaded.
+  SchemaLoader loader;
+  StructSchema loaded = loader.load(Schema::from<test::TestUnion>().getProto()).asStruct();
+  expectLayoutMatchesProto(loaded);
+
+  // Upgraded in place:  the cached layout must follow the new node.
+  loader.loadCompiledTypeAndDependencies<test::TestOldVersion>();
+  StructSchema schema = loader.get(typeId<test::TestOldVersion>()).asStruct();
+  expectLayoutMatchesProto(schema);
+  loadUnderAlternateTypeId<test::TestNewVersion>(loader, typeId<test::TestOldVersion>());
+  expectLayoutMatchesProto(schema);
+  EXPECT_EQ(Schema::from<test::TestNewVersion>().getProto().getStruct().getPointerCount(),
+            schema.getLayout().pointerCount);
+}
+
+TEST(SchemaLoader, StructLayoutFromOldGeneratedCode) {
+  StructSchema schema = Schema::from<StaleUnnamedUnion>();
+  ASSERT_FALSE(rawSchema<StaleUnnamedUnion>().structLayout.isStruct);
+  expectLayoutMatchesProto(schema);
+
+  // The dynamic API must still size the struct and find its union.
+  MallocMessageBuilder builder;
+  auto root = builder.initRoot<DynamicStruct>(schema);
+  root.set("before", "foo");
+  root.set("bar", 321);
+  root.set("after", "baz");
+  EXPECT_EQ("bar", KJ_ASSERT_NONNULL(root.which()).getProto().getName());
+
+  auto typed = builder.getRoot<test::TestUnnamedUnion>().asReader();
+  EXPECT_EQ("foo", typed.getBefore());
+  ASSERT_TRUE(typed.isBar());
+  EXPECT_EQ(321u, typed.getBar());
+  EXPECT_EQ("baz", typed.getAfter());
+}
+
+TEST(SchemaLoader, MemberHash) {
+  // Loaded schemas get their own perfect hash of member names.
+  SchemaLoader loader;
+
+  StructSchema structSchema =
+      loader.load(Schema::from<test::TestAllTypes>().getProto()).asStruct();
+  for (auto field: structSchema.getFields()) {
+    KJ_IF_MAYBE(found, structSchema.findFieldByName(field.getProto().getName())) {
+      EXPECT_TRUE(*found == field);
+    } else {
+      ADD_FAILURE() << "not found: " << field.getProto().getName().cStr();
+    }
+  }
+  EXPECT_TRUE(structSchema.findFieldByName("noSuchField") == nullptr);
+
+  EnumSchema enumSchema = loader.load(Schema::from<test::TestEnum>().getProto()).asEnum();
+  for (auto enumerant: enumSchema.getEnumerants()) {
+    KJ_IF_MAYBE(found, enumSchema.findEnumerantByName(enumerant.getProto().getName())) {
+      EXPECT_TRUE(*found == enumerant);
+    } else {
+      ADD_FAILURE() << "not found: " << enumerant.getProto().getName().cStr();
+    }
+  }
+  EXPECT_TRUE(enumSchema.findEnumerantByName("noSuchEnumerant") == nullptr);
+
+  StructSchema empty = loader.load(Schema::from<test::TestEmptyStruct>().getProto()).asStruct();
+  EXPECT_TRUE(empty.findFieldByName("") == nullptr);
+}
+
 TEST(SchemaLoader, Incompatible) {
   SchemaLoader loader;
   loader.loadCompiledTypeAndDependencies<test::TestListDefaults>();
@@ -330,6 +433,69 @@ TEST(SchemaLoader, LazyLoadGetDependency) {
   EXPECT_EQ(dep, loader.get(typeId<TestAllTypes>()));
 }
 
+Schema loadEmptyStruct(SchemaLoader& loader, uint64_t id) {
+  MallocMessageBuilder builder;
+  auto node = builder.initRoot<schema::Node>();
+  node.setId(id);
+  node.setDisplayName(kj::str("Struct", id));
+  node.initStruct();
+  return loader.load(node);
+}
+
+TEST(SchemaLoader, ManySchemas) {
+  // Enough schemas to make the lookup table grow several times.
+  SchemaLoader loader;
+  for (uint64_t i = 0; i < 1000; i++) {
+    loadEmptyStruct(loader, 0x8000000000000000ull | (i * 0x123456789ull));
+  }
+
+  for (uint64_t i = 0; i < 1000; i++) {
+    uint64_t id = 0x8000000000000000ull | (i * 0x123456789ull);
+    EXPECT_EQ(id, loader.get(id).getProto().getId());
+  }
+  EXPECT_TRUE(loader.tryGet(0x8000000000000000ull | 1) == nullptr);
+  EXPECT_EQ(1000u, loader.getAllLoaded().size());
+}
+
+TEST(SchemaLoader, ConcurrentLookup) {
+  // Look up schemas from several threads while another thread keeps loading more.
+  SchemaLoader loader;
+  loader.loadCompiledTypeAndDependencies<TestAllTypes>();
+  volatile bool done = false;
+
+  {
+    kj::Vector<kj::Own<kj::Thread>> readers;
+    for (uint t = 0; t < 4; t++) {
+      readers.add(kj::heap<kj::Thread>([&]() {
+        uint64_t count = 0;
+        while (!done) {
+          EXPECT_EQ(typeId<TestAllTypes>(), loader.get(typeId<TestAllTypes>()).getProto().getId());
+
+          // IDs are loaded in order, so we should find a prefix of them which never shrinks.
+          uint64_t i = 0;
+          for (;;) {
+            KJ_IF_MAYBE(schema, loader.tryGet(0x8000000000000000ull | i)) {
+              EXPECT_EQ(0x8000000000000000ull | i, schema->getProto().getId());
+              ++i;
+            } else {
+              break;
+            }
+          }
+          EXPECT_GE(i, count);
+          count = i;
+        }
+      }));
+    }
+
+    for (uint64_t i = 0; i < 2000; i++) {
+      loadEmptyStruct(loader, 0x8000000000000000ull | i);
+    }
+    done = true;
+  }
+
+  EXPECT_EQ(2002u, loader.getAllLoaded().size());
+}
+
 }  // namespace
 }  // namespace _ (private)
 }  // namespace capnp
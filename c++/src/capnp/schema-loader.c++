@@ -56,11 +56,100 @@ private:
   kj::Maybe<const LazyLoadCallback&> callback;
 };
 
+class SchemaLoader::LookupTable {
+  // Open-addressed hash table mapping type IDs to RawSchemas.  Entries are only ever added -- once
+  // the loader allocates a RawSchema for some ID, that RawSchema keeps its address for the life of
+  // the loader -- which lets readers probe the table without any lock while a writer (serialized
+  // by the loader's mutex) inserts.  When the table gets too full, the writer copies it into a
+  // bigger one and publishes that with a release-store.  Old tables are kept until the loader is
+  // destroyed, since readers may still be probing them.
+
+public:
+  LookupTable() {
+    auto table = kj::heap<Table>(64);
+    current = table.get();
+    tables.add(kj::mv(table));
+  }
+  KJ_DISALLOW_COPY(LookupTable);
+
+  const _::RawSchema* find(uint64_t id) const {
+    const Table* table = __atomic_load_n(&current, __ATOMIC_ACQUIRE);
+    for (uint i = hash(id);; i++) {
+      const Entry& entry = table->entries[i & table->mask];
+      const _::RawSchema* schema = __atomic_load_n(&entry.schema, __ATOMIC_ACQUIRE);
+      if (schema == nullptr) return nullptr;
+      if (entry.id == id) return schema;
+    }
+  }
+
+  void insert(const _::RawSchema* schema) {
+    // Add `schema` if it isn't present already.  The caller must hold the loader's exclusive lock.
+
+    Table* table = current;
+    if (!table->insert(schema->id, schema)) return;
+
+    if (++table->count * 4 > table->entries.size() * 3) {
+      // Getting full; grow.
+      auto newTable = kj::heap<Table>(table->entries.size() * 2);
+      for (auto& entry: table->entries) {
+        if (entry.schema != nullptr) {
+          newTable->insert(entry.id, entry.schema);
+        }
+      }
+      newTable->count = table->count;
+      __atomic_store_n(&current, newTable.get(), __ATOMIC_RELEASE);
+      tables.add(kj::mv(newTable));
+    }
+  }
+
+private:
+  struct Entry {
+    uint64_t id;
+    const _::RawSchema* schema;
+    // Null if the entry is empty.  Written last, with a release-store, so that a reader which
+    // sees a non-null schema also sees the ID.
+  };
+
+  struct Table {
+    kj::Array<Entry> entries;
+    uint mask;
+    uint count = 0;
+
+    explicit Table(uint capacity)
+        : entries(kj::heapArray<Entry>(capacity)), mask(capacity - 1) {
+      memset(entries.begin(), 0, entries.size() * sizeof(Entry));
+    }
+
+    bool insert(uint64_t id, const _::RawSchema* schema) {
+      // Returns false if the ID was already present.
+      for (uint i = hash(id);; i++) {
+        Entry& entry = entries[i & mask];
+        if (entry.schema == nullptr) {
+          entry.id = id;
+          __atomic_store_n(&entry.schema, schema, __ATOMIC_RELEASE);
+          return true;
+        }
+        if (entry.id == id) return false;
+      }
+    }
+  };
+
+  Table* current;
+  kj::Vector<kj::Own<Table>> tables;
+
+  static inline uint hash(uint64_t id) {
+    // Type IDs are already random, apart from the high bit, which is always set.
+    return static_cast<uint>(id ^ (id >> 32));
+  }
+};
+
 class SchemaLoader::Impl {
 public:
-  inline explicit Impl(const SchemaLoader& loader): initializer(loader) {}
-  inline Impl(const SchemaLoader& loader, const LazyLoadCallback& callback)
-      : initializer(loader, callback) {}
+  inline Impl(const SchemaLoader& loader, LookupTable& lookupTable)
+      : lookupTable(lookupTable), initializer(loader) {}
+  inline Impl(const SchemaLoader& loader, LookupTable& lookupTable,
+              const LazyLoadCallback& callback)
+      : lookupTable(lookupTable), initializer(loader, callback) {}
 
   _::RawSchema* load(const schema::Node::Reader& reader, bool isPlaceholder);
 
@@ -91,6 +180,9 @@ public:
 private:
   std::unordered_map<uint64_t, _::RawSchema*> schemas;
 
+  LookupTable& lookupTable;
+  // Lock-free mirror of `schemas`.  Each schema is added once it is fully initialized.
+
   struct RequiredSize {
     uint16_t dataWordCount;
     uint16_t pointerCount;
@@ -192,6 +284,27 @@ public:
     return membersByDiscriminant.begin();
   }
 
+  void makeMemberHash(_::RawSchema* raw) {
+    // Fills in raw->memberHashSeed, memberHashDisplacements, and membersByHash.
+    raw->memberHashSeed = 0;
+    raw->memberHashDisplacements = nullptr;
+    raw->membersByHash = nullptr;
+    if (members.empty()) return;
+
+    auto names = kj::heapArray<kj::StringPtr>(members.size());
+    for (auto& member: members) {
+      names[member.second] = member.first;
+    }
+
+    kj::ArrayPtr<uint32_t> displacements =
+        loader.arena.allocateArray<uint32_t>(_::memberHashBucketCount(names.size()));
+    kj::ArrayPtr<uint16_t> membersByHash = loader.arena.allocateArray<uint16_t>(names.size());
+    if (_::makeMemberHash(names, raw->memberHashSeed, displacements, membersByHash)) {
+      raw->memberHashDisplacements = displacements.begin();
+      raw->membersByHash = membersByHash.begin();
+    }
+  }
+
 private:
   SchemaLoader::Impl& loader;
   Text::Reader nodeName;
@@ -1126,6 +1239,25 @@ private:
 
 // =======================================================================================
 
+static void initStructLayout(_::RawSchema* raw) {
+  // Fill in raw->structLayout from raw->encodedNode.  Must be called whenever encodedNode changes.
+
+  auto node = readMessageUnchecked<schema::Node>(raw->encodedNode);
+  if (node.isStruct()) {
+    auto structNode = node.getStruct();
+    raw->structLayout.dataWordCount = structNode.getDataWordCount();
+    raw->structLayout.pointerCount = structNode.getPointerCount();
+    raw->structLayout.preferredListEncoding =
+        static_cast<uint8_t>(structNode.getPreferredListEncoding());
+    raw->structLayout.isGroup = structNode.getIsGroup();
+    raw->structLayout.isStruct = true;
+    raw->structLayout.discriminantCount = structNode.getDiscriminantCount();
+    raw->structLayout.discriminantOffset = structNode.getDiscriminantOffset();
+  } else {
+    memset(&raw->structLayout, 0, sizeof(raw->structLayout));
+  }
+}
+
 _::RawSchema* SchemaLoader::Impl::load(const schema::Node::Reader& reader, bool isPlaceholder) {
   // Make a copy of the node which can be used unchecked.
   kj::ArrayPtr<word> validated = makeUncheckedNodeEnforcingSizeRequirements(reader);
@@ -1175,7 +1307,9 @@ _::RawSchema* SchemaLoader::Impl::load(const schema::Node::Reader& reader, bool
     slot->encodedSize = validated.size();
     slot->dependencies = validator.makeDependencyArray(&slot->dependencyCount);
     slot->membersByName = validator.makeMemberInfoArray(&slot->memberCount);
+    validator.makeMemberHash(slot);
     slot->membersByDiscriminant = validator.makeMembersByDiscriminantArray();
+    initStructLayout(slot);
   }
 
   if (isPlaceholder) {
@@ -1187,6 +1321,7 @@ _::RawSchema* SchemaLoader::Impl::load(const schema::Node::Reader& reader, bool
     __atomic_store_n(&slot->lazyInitializer, nullptr, __ATOMIC_RELEASE);
   }
 
+  lookupTable.insert(slot);
   return slot;
 }
 
@@ -1260,6 +1395,7 @@ _::RawSchema* SchemaLoader::Impl::loadNative(const _::RawSchema* nativeSchema) {
   // a release-store here.
   __atomic_store_n(&result->lazyInitializer, nullptr, __ATOMIC_RELEASE);
 
+  lookupTable.insert(result);
   return result;
 }
 
@@ -1393,6 +1529,7 @@ void SchemaLoader::Impl::applyStructSizeRequirement(
     // invalidated it.  Just remake the unchecked message.
     raw->encodedNode = words.begin();
     raw->encodedSize = words.size();
+    initStructLayout(raw);
   }
 }
 
@@ -1421,9 +1558,11 @@ void SchemaLoader::InitializerImpl::init(const _::RawSchema* schema) const {
 
 // =======================================================================================
 
-SchemaLoader::SchemaLoader(): impl(kj::heap<Impl>(*this)) {}
+SchemaLoader::SchemaLoader()
+    : lookupTable(kj::heap<LookupTable>()), impl(kj::heap<Impl>(*this, *lookupTable)) {}
 SchemaLoader::SchemaLoader(const LazyLoadCallback& callback)
-    : impl(kj::heap<Impl>(*this, callback)) {}
+    : lookupTable(kj::heap<LookupTable>()),
+      impl(kj::heap<Impl>(*this, *lookupTable, callback)) {}
 SchemaLoader::~SchemaLoader() noexcept(false) {}
 
 Schema SchemaLoader::get(uint64_t id) const {
@@ -1435,6 +1574,12 @@ Schema SchemaLoader::get(uint64_t id) const {
 }
 
 kj::Maybe<Schema> SchemaLoader::tryGet(uint64_t id) const {
+  const _::RawSchema* schema = lookupTable->find(id);
+  if (schema != nullptr && __atomic_load_n(&schema->lazyInitializer, __ATOMIC_ACQUIRE) == nullptr) {
+    // Already loaded; no need to lock.
+    return Schema(schema);
+  }
+
   auto getResult = impl.lockShared()->get()->tryGet(id);
   if (getResult.schema == nullptr || getResult.schema->lazyInitializer != nullptr) {
     KJ_IF_MAYBE(c, getResult.callback) {
@@ -75,6 +75,9 @@ public:
 
   kj::Maybe<Schema> tryGet(uint64_t id) const;
   // Like get() but doesn't throw.
+  //
+  // Looking up a schema that is already loaded does not take any lock, so get() and tryGet() are
+  // cheap to call from many threads at once.
 
   Schema load(const schema::Node::Reader& reader);
   // Loads the given schema node.  Validates the node and throws an exception if invalid.  This
@@ -136,6 +139,11 @@ private:
   class CompatibilityChecker;
   class Impl;
   class InitializerImpl;
+  class LookupTable;
+  kj::Own<LookupTable> lookupTable;
+  // Index of loaded schemas which readers can search without locking.  Only modified while
+  // holding `impl`'s exclusive lock.
+
   kj::MutexGuarded<kj::Own<Impl>> impl;
 
   void loadNative(const _::RawSchema* nativeSchema);
@@ -24,6 +24,7 @@
 #include "schema.h"
 #include <gtest/gtest.h>
 #include "test-util.h"
+#include <string.h>
 
 namespace capnp {
 namespace _ {  // private
@@ -309,6 +310,76 @@ TEST(Schema, Interfaces) {
   EXPECT_TRUE(params.getFieldByName("c").getProto().getSlot().getHadExplicitDefault());
 }
 
+template <typename Schema>
+void expectFieldsFound(Schema schema) {
+  for (auto field: schema.getFields()) {
+    KJ_IF_MAYBE(found, schema.findFieldByName(field.getProto().getName())) {
+      EXPECT_TRUE(*found == field);
+    } else {
+      ADD_FAILURE() << "not found: " << field.getProto().getName().cStr();
+    }
+  }
+  EXPECT_TRUE(schema.findFieldByName("noSuchField") == nullptr);
+  EXPECT_TRUE(schema.findFieldByName("") == nullptr);
+}
+
+TEST(Schema, MemberHash) {
+  // Compiled-in schemas carry a perfect hash of their member names.
+  EXPECT_TRUE(rawSchema<test::TestAllTypes>().membersByHash != nullptr);
+  EXPECT_TRUE(rawSchema<test::TestEnum>().membersByHash != nullptr);
+  EXPECT_TRUE(rawSchema<test::TestMoreStuff>().membersByHash != nullptr);
+  EXPECT_TRUE(rawSchema<test::TestEmptyStruct>().membersByHash == nullptr);
+
+  expectFieldsFound(Schema::from<test::TestAllTypes>());
+  expectFieldsFound(Schema::from<test::TestUnion>());
+  expectFieldsFound(Schema::from<test::TestUnnamedUnion>());
+  expectFieldsFound(Schema::from<test::TestEmptyStruct>());
+
+  EnumSchema enumSchema = Schema::from<test::TestEnum>();
+  for (auto enumerant: enumSchema.getEnumerants()) {
+    KJ_IF_MAYBE(found, enumSchema.findEnumerantByName(enumerant.getProto().getName())) {
+      EXPECT_TRUE(*found == enumerant);
+    } else {
+      ADD_FAILURE() << "not found: " << enumerant.getProto().getName().cStr();
+    }
+  }
+
+  InterfaceSchema interfaceSchema = Schema::from<test::TestMoreStuff>();
+  for (auto method: interfaceSchema.getMethods()) {
+    KJ_IF_MAYBE(found, interfaceSchema.findMethodByName(method.getProto().getName())) {
+      EXPECT_TRUE(*found == method);
+    } else {
+      ADD_FAILURE() << "not found: " << method.getProto().getName().cStr();
+    }
+  }
+}
+
+TEST(Schema, MakeMemberHash) {
+  for (uint size: {1u, 2u, 3u, 5u, 6u, 17u, 100u, 1000u, 10000u}) {
+    auto strings = KJ_MAP(i, kj::range(0u, size)) { return kj::str("member", i); };
+    auto names = KJ_MAP(s, strings) -> kj::StringPtr { return s; };
+    auto displacements = kj::heapArray<uint32_t>(memberHashBucketCount(size));
+    auto membersByHash = kj::heapArray<uint16_t>(size);
+    uint32_t seed;
+    ASSERT_TRUE(makeMemberHash(names, seed, displacements, membersByHash)) << size;
+
+    // Every member occupies exactly one slot.
+    auto seen = kj::heapArray<bool>(size);
+    memset(seen.begin(), 0, size * sizeof(bool));
+    for (uint16_t member: membersByHash) {
+      ASSERT_LT(member, size);
+      EXPECT_FALSE(seen[member]);
+      seen[member] = true;
+    }
+  }
+
+  kj::StringPtr duplicates[] = {"foo", "bar", "foo"};
+  uint32_t displacements[1];
+  uint16_t membersByHash[3];
+  uint32_t seed;
+  EXPECT_FALSE(makeMemberHash(duplicates, seed, displacements, membersByHash));
+}
+
 }  // namespace
 }  // namespace _ (private)
 }  // namespace capnp
@@ -24,6 +24,8 @@
 #include "schema.h"
 #include "message.h"
 #include <kj/debug.h>
+#include <algorithm>
+#include <string.h>
 
 namespace capnp {
 
@@ -85,7 +87,9 @@ static const AlignedData<13> NULL_SCHEMA_BYTES = {{
 }};
 const RawSchema NULL_SCHEMA = {
   0x0000000000000000, NULL_SCHEMA_BYTES.words, 13,
-  nullptr, nullptr, 0, 0, nullptr, nullptr, nullptr
+  nullptr, nullptr, 0, 0, nullptr, nullptr, nullptr,
+  { 0, 0, 0, false, 0, 0, false },
+  0, nullptr, nullptr
 };
 
 static const AlignedData<14> NULL_STRUCT_SCHEMA_BYTES = {{
@@ -106,7 +110,9 @@ static const AlignedData<14> NULL_STRUCT_SCHEMA_BYTES = {{
 }};
 const RawSchema NULL_STRUCT_SCHEMA = {
   0x0000000000000001, NULL_STRUCT_SCHEMA_BYTES.words, 14,
-  nullptr, nullptr, 0, 0, nullptr, nullptr, nullptr
+  nullptr, nullptr, 0, 0, nullptr, nullptr, nullptr,
+  { 0, 0, 0, false, 0, 0, true },
+  0, nullptr, nullptr
 };
 
 static const AlignedData<14> NULL_ENUM_SCHEMA_BYTES = {{
@@ -127,7 +133,9 @@ static const AlignedData<14> NULL_ENUM_SCHEMA_BYTES = {{
 }};
 const RawSchema NULL_ENUM_SCHEMA = {
   0x0000000000000002, NULL_ENUM_SCHEMA_BYTES.words, 14,
-  nullptr, nullptr, 0, 0, nullptr, nullptr, nullptr
+  nullptr, nullptr, 0, 0, nullptr, nullptr, nullptr,
+  { 0, 0, 0, false, 0, 0, false },
+  0, nullptr, nullptr
 };
 
 static const AlignedData<14> NULL_INTERFACE_SCHEMA_BYTES = {{
@@ -148,7 +156,9 @@ static const AlignedData<14> NULL_INTERFACE_SCHEMA_BYTES = {{
 }};
 const RawSchema NULL_INTERFACE_SCHEMA = {
   0x0000000000000003, NULL_INTERFACE_SCHEMA_BYTES.words, 14,
-  nullptr, nullptr, 0, 0, nullptr, nullptr, nullptr
+  nullptr, nullptr, 0, 0, nullptr, nullptr, nullptr,
+  { 0, 0, 0, false, 0, 0, false },
+  0, nullptr, nullptr
 };
 
 static const AlignedData<20> NULL_CONST_SCHEMA_BYTES = {{
@@ -175,7 +185,9 @@ static const AlignedData<20> NULL_CONST_SCHEMA_BYTES = {{
 }};
 const RawSchema NULL_CONST_SCHEMA = {
   0x0000000000000004, NULL_CONST_SCHEMA_BYTES.words, 20,
-  nullptr, nullptr, 0, 0, nullptr, nullptr, nullptr
+  nullptr, nullptr, 0, 0, nullptr, nullptr, nullptr,
+  { 0, 0, 0, false, 0, 0, false },
+  0, nullptr, nullptr
 };
 
 }  // namespace _ (private)
@@ -288,9 +300,67 @@ uint32_t Schema::getSchemaOffset(const schema::Value::Reader& value) const {
 
 namespace {
 
+struct MemberHash {
+  uint32_t bucket;
+  uint32_t f1;
+  uint32_t f2;
+};
+
+inline uint64_t mix64(uint64_t h) {
+  // MurmurHash3's 64-bit finalizer.
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ull;
+  h ^= h >> 33;
+  return h;
+}
+
+inline MemberHash hashMemberName(kj::StringPtr name, uint32_t seed) {
+  // Seeded FNV-1a, mixed to spread it across all 64 bits, then mixed again for a third word.
+  uint64_t h = 0xcbf29ce484222325ull ^ seed;
+  for (char c: name) {
+    h = (h ^ static_cast<uint8_t>(c)) * 0x100000001b3ull;
+  }
+  h = mix64(h);
+  return { static_cast<uint32_t>(h >> 32), static_cast<uint32_t>(h),
+           static_cast<uint32_t>(mix64(h)) };
+}
+
+inline uint scale(uint32_t value, uint size) {
+  // Maps `value` into [0, size) using its high bits, which unlike `value % size` depend on all of
+  // the bits of `value`.
+  return (static_cast<uint64_t>(value) * size) >> 32;
+}
+
+inline uint memberHashSlot(const MemberHash& hash, uint32_t displacement, uint size) {
+  // The displacement packs two 16-bit values, as in the "hash and displace" (CHD) scheme:  d1
+  // decides how a bucket's members are spread over the table, and d2 (< size) rotates them.
+  uint slot = scale(hash.f1 * (displacement >> 16) + hash.f2, size) + (displacement & 0xffff);
+  return slot < size ? slot : slot - size;
+}
+
+inline uint memberHashSlot(const _::RawSchema* raw, kj::StringPtr name) {
+  MemberHash hash = hashMemberName(name, raw->memberHashSeed);
+  uint bucket = scale(hash.bucket, _::memberHashBucketCount(raw->memberCount));
+  return memberHashSlot(hash, raw->memberHashDisplacements[bucket], raw->memberCount);
+}
+
+static constexpr uint32_t MAX_MEMBER_HASH_SEEDS = 64;
+// With distinct names the first seed almost always works; small tables occasionally need a few.
+
 template <typename List>
 auto findSchemaMemberByName(const _::RawSchema* raw, kj::StringPtr name, List&& list)
     -> kj::Maybe<decltype(list[0])> {
+  if (raw->membersByHash != nullptr) {
+    auto candidate = list[raw->membersByHash[memberHashSlot(raw, name)]];
+    if (candidate.getProto().getName() == name) {
+      return candidate;
+    } else {
+      return nullptr;
+    }
+  }
+
   uint lower = 0;
   uint upper = raw->memberCount;
   List unnamedUnionMembers;
@@ -316,6 +386,101 @@ auto findSchemaMemberByName(const _::RawSchema* raw, kj::StringPtr name, List&&
 
 }  // namespace
 
+bool _::makeMemberHash(kj::ArrayPtr<const kj::StringPtr> names, uint32_t& seed,
+                       kj::ArrayPtr<uint32_t> displacements,
+                       kj::ArrayPtr<uint16_t> membersByHash) {
+  // Each bucket, largest first, gets the first displacement which puts all of its members in
+  // unused slots.  If some bucket has none, try the next seed.
+
+  uint size = names.size();
+  uint bucketCount = memberHashBucketCount(size);
+  KJ_REQUIRE(displacements.size() == bucketCount && membersByHash.size() == size &&
+             size <= 0xffff);
+
+  {
+    // Members with the same name would always collide.
+    auto sorted = kj::heapArray(names);
+    std::sort(sorted.begin(), sorted.end());
+    if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) {
+      return false;
+    }
+  }
+
+  auto hashes = kj::heapArray<MemberHash>(size);
+  auto bucketSizes = kj::heapArray<uint>(bucketCount);
+  auto order = kj::heapArray<uint>(size);
+  auto used = kj::heapArray<bool>(size);
+  auto slots = kj::heapArray<uint>(size);
+
+  auto place = [&](kj::ArrayPtr<const uint> bucket) {
+    auto bucketSlots = slots.slice(0, bucket.size());
+    for (uint32_t d1 = 0; d1 <= 0xffff; d1++) {
+      // Rotating by d2 can't make members of the bucket collide with each other, so check that
+      // once per d1.
+      bool distinct = true;
+      for (uint i = 0; distinct && i < bucket.size(); i++) {
+        bucketSlots[i] = memberHashSlot(hashes[bucket[i]], d1 << 16, size);
+        for (uint j = 0; j < i; j++) {
+          if (bucketSlots[j] == bucketSlots[i]) distinct = false;
+        }
+      }
+      if (!distinct) continue;
+
+      for (uint32_t d2 = 0; d2 < size; d2++) {
+        bool fits = true;
+        for (uint slot: bucketSlots) {
+          if (used[slot + d2 < size ? slot + d2 : slot + d2 - size]) {
+            fits = false;
+            break;
+          }
+        }
+        if (!fits) continue;
+
+        uint32_t displacement = (d1 << 16) | d2;
+        displacements[hashes[bucket[0]].bucket] = displacement;
+        for (uint member: bucket) {
+          uint slot = memberHashSlot(hashes[member], displacement, size);
+          used[slot] = true;
+          membersByHash[slot] = member;
+        }
+        return true;
+      }
+    }
+    return false;
+  };
+
+  for (seed = 0; seed < MAX_MEMBER_HASH_SEEDS; seed++) {
+    memset(bucketSizes.begin(), 0, bucketSizes.size() * sizeof(uint));
+    for (uint i = 0; i < size; i++) {
+      hashes[i] = hashMemberName(names[i], seed);
+      hashes[i].bucket = scale(hashes[i].bucket, bucketCount);
+      ++bucketSizes[hashes[i].bucket];
+      order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](uint a, uint b) {
+      uint bucketA = hashes[a].bucket, bucketB = hashes[b].bucket;
+      if (bucketSizes[bucketA] != bucketSizes[bucketB]) {
+        return bucketSizes[bucketA] > bucketSizes[bucketB];
+      }
+      return bucketA != bucketB ? bucketA < bucketB : a < b;
+    });
+
+    memset(displacements.begin(), 0, displacements.size() * sizeof(uint32_t));
+    memset(used.begin(), 0, used.size() * sizeof(bool));
+
+    bool ok = true;
+    for (uint start = 0; ok && start < size;) {
+      auto bucket = order.slice(start, start + bucketSizes[hashes[order[start]].bucket]);
+      start += bucket.size();
+      ok = place(bucket);
+    }
+
+    if (ok) return true;
+  }
+
+  return false;
+}
+
 StructSchema::FieldList StructSchema::getFields() const {
   return FieldList(*this, getProto().getStruct().getFields());
 }
@@ -356,6 +521,19 @@ kj::Maybe<StructSchema::Field> StructSchema::getFieldByDiscriminant(uint16_t dis
   }
 }
 
+_::RawSchema::StructLayout StructSchema::decodeLayout() const {
+  auto proto = getProto().getStruct();
+  _::RawSchema::StructLayout result;
+  result.dataWordCount = proto.getDataWordCount();
+  result.pointerCount = proto.getPointerCount();
+  result.preferredListEncoding = static_cast<uint8_t>(proto.getPreferredListEncoding());
+  result.isGroup = proto.getIsGroup();
+  result.isStruct = true;
+  result.discriminantCount = proto.getDiscriminantCount();
+  result.discriminantOffset = proto.getDiscriminantOffset();
+  return result;
+}
+
 uint32_t StructSchema::Field::getDefaultValueSchemaOffset() const {
   return parent.getSchemaOffset(proto.getSlot().getDefaultValue());
 }
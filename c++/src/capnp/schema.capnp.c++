@@ -189,9 +189,13 @@ static const ::capnp::_::RawSchema* const d_e682ab4cf923a417[] = {
 };
 static const uint16_t m_e682ab4cf923a417[] = {11, 5, 10, 1, 2, 8, 6, 0, 9, 4, 3, 7};
 static const uint16_t i_e682ab4cf923a417[] = {6, 7, 8, 9, 10, 11, 0, 1, 2, 3, 4, 5};
+static const uint32_t p_e682ab4cf923a417[] = {10, 131072, 4};
+static const uint16_t h_e682ab4cf923a417[] = {5, 1, 3, 7, 2, 6, 8, 11, 9, 4, 10, 0};
 const ::capnp::_::RawSchema s_e682ab4cf923a417 = {
   0xe682ab4cf923a417, b_e682ab4cf923a417.words, 171, d_e682ab4cf923a417, m_e682ab4cf923a417,
-  7, 12, i_e682ab4cf923a417, nullptr, nullptr
+  7, 12, i_e682ab4cf923a417, nullptr, nullptr,
+  { 5, 5, 7, false, 6, 6, true },
+  0, p_e682ab4cf923a417, h_e682ab4cf923a417
 };
 static const ::capnp::_::AlignedData<46> b_debf55bbfa0fc242 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -243,9 +247,13 @@ static const ::capnp::_::AlignedData<46> b_debf55bbfa0fc242 = {
 };
 static const uint16_t m_debf55bbfa0fc242[] = {1, 0};
 static const uint16_t i_debf55bbfa0fc242[] = {0, 1};
+static const uint32_t p_debf55bbfa0fc242[] = {0};
+static const uint16_t h_debf55bbfa0fc242[] = {1, 0};
 const ::capnp::_::RawSchema s_debf55bbfa0fc242 = {
   0xdebf55bbfa0fc242, b_debf55bbfa0fc242.words, 46, nullptr, m_debf55bbfa0fc242,
-  0, 2, i_debf55bbfa0fc242, nullptr, nullptr
+  0, 2, i_debf55bbfa0fc242, nullptr, nullptr,
+  { 1, 1, 7, false, 0, 0, true },
+  0, p_debf55bbfa0fc242, h_debf55bbfa0fc242
 };
 static const ::capnp::_::AlignedData<125> b_9ea0b19b37fb4435 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -381,9 +389,13 @@ static const ::capnp::_::RawSchema* const d_9ea0b19b37fb4435[] = {
 };
 static const uint16_t m_9ea0b19b37fb4435[] = {0, 4, 5, 6, 3, 1, 2};
 static const uint16_t i_9ea0b19b37fb4435[] = {0, 1, 2, 3, 4, 5, 6};
+static const uint32_t p_9ea0b19b37fb4435[] = {6, 458752};
+static const uint16_t h_9ea0b19b37fb4435[] = {2, 4, 0, 5, 3, 6, 1};
 const ::capnp::_::RawSchema s_9ea0b19b37fb4435 = {
   0x9ea0b19b37fb4435, b_9ea0b19b37fb4435.words, 125, d_9ea0b19b37fb4435, m_9ea0b19b37fb4435,
-  3, 7, i_9ea0b19b37fb4435, nullptr, nullptr
+  3, 7, i_9ea0b19b37fb4435, nullptr, nullptr,
+  { 5, 5, 7, true, 0, 0, true },
+  0, p_9ea0b19b37fb4435, h_9ea0b19b37fb4435
 };
 static const ::capnp::_::AlignedData<34> b_b54ab3364333f598 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -427,9 +439,13 @@ static const ::capnp::_::RawSchema* const d_b54ab3364333f598[] = {
 };
 static const uint16_t m_b54ab3364333f598[] = {0};
 static const uint16_t i_b54ab3364333f598[] = {0};
+static const uint32_t p_b54ab3364333f598[] = {0};
+static const uint16_t h_b54ab3364333f598[] = {0};
 const ::capnp::_::RawSchema s_b54ab3364333f598 = {
   0xb54ab3364333f598, b_b54ab3364333f598.words, 34, d_b54ab3364333f598, m_b54ab3364333f598,
-  2, 1, i_b54ab3364333f598, nullptr, nullptr
+  2, 1, i_b54ab3364333f598, nullptr, nullptr,
+  { 5, 5, 7, true, 0, 0, true },
+  0, p_b54ab3364333f598, h_b54ab3364333f598
 };
 static const ::capnp::_::AlignedData<51> b_e82753cff0c2218f = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -490,9 +506,13 @@ static const ::capnp::_::RawSchema* const d_e82753cff0c2218f[] = {
 };
 static const uint16_t m_e82753cff0c2218f[] = {1, 0};
 static const uint16_t i_e82753cff0c2218f[] = {0, 1};
+static const uint32_t p_e82753cff0c2218f[] = {0};
+static const uint16_t h_e82753cff0c2218f[] = {0, 1};
 const ::capnp::_::RawSchema s_e82753cff0c2218f = {
   0xe82753cff0c2218f, b_e82753cff0c2218f.words, 51, d_e82753cff0c2218f, m_e82753cff0c2218f,
-  2, 2, i_e82753cff0c2218f, nullptr, nullptr
+  2, 2, i_e82753cff0c2218f, nullptr, nullptr,
+  { 5, 5, 7, true, 0, 0, true },
+  0, p_e82753cff0c2218f, h_e82753cff0c2218f
 };
 static const ::capnp::_::AlignedData<44> b_b18aa5ac7a0d9420 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -547,9 +567,13 @@ static const ::capnp::_::RawSchema* const d_b18aa5ac7a0d9420[] = {
 };
 static const uint16_t m_b18aa5ac7a0d9420[] = {0, 1};
 static const uint16_t i_b18aa5ac7a0d9420[] = {0, 1};
+static const uint32_t p_b18aa5ac7a0d9420[] = {0};
+static const uint16_t h_b18aa5ac7a0d9420[] = {0, 1};
 const ::capnp::_::RawSchema s_b18aa5ac7a0d9420 = {
   0xb18aa5ac7a0d9420, b_b18aa5ac7a0d9420.words, 44, d_b18aa5ac7a0d9420, m_b18aa5ac7a0d9420,
-  3, 2, i_b18aa5ac7a0d9420, nullptr, nullptr
+  3, 2, i_b18aa5ac7a0d9420, nullptr, nullptr,
+  { 5, 5, 7, true, 0, 0, true },
+  0, p_b18aa5ac7a0d9420, h_b18aa5ac7a0d9420
 };
 static const ::capnp::_::AlignedData<214> b_ec1619d4400a0290 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -773,9 +797,13 @@ static const ::capnp::_::RawSchema* const d_ec1619d4400a0290[] = {
 };
 static const uint16_t m_ec1619d4400a0290[] = {12, 2, 3, 4, 6, 1, 8, 9, 10, 11, 5, 7, 0};
 static const uint16_t i_ec1619d4400a0290[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+static const uint32_t p_ec1619d4400a0290[] = {2228224, 131077, 196620};
+static const uint16_t h_ec1619d4400a0290[] = {1, 3, 7, 0, 12, 9, 11, 5, 4, 8, 6, 2, 10};
 const ::capnp::_::RawSchema s_ec1619d4400a0290 = {
   0xec1619d4400a0290, b_ec1619d4400a0290.words, 214, d_ec1619d4400a0290, m_ec1619d4400a0290,
-  2, 13, i_ec1619d4400a0290, nullptr, nullptr
+  2, 13, i_ec1619d4400a0290, nullptr, nullptr,
+  { 5, 5, 7, true, 0, 0, true },
+  0, p_ec1619d4400a0290, h_ec1619d4400a0290
 };
 static const ::capnp::_::AlignedData<108> b_9aad50a41f4af45f = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -895,9 +923,13 @@ static const ::capnp::_::RawSchema* const d_9aad50a41f4af45f[] = {
 };
 static const uint16_t m_9aad50a41f4af45f[] = {2, 1, 3, 5, 0, 6, 4};
 static const uint16_t i_9aad50a41f4af45f[] = {4, 5, 0, 1, 2, 3, 6};
+static const uint32_t p_9aad50a41f4af45f[] = {720898, 131072};
+static const uint16_t h_9aad50a41f4af45f[] = {3, 5, 1, 2, 0, 4, 6};
 const ::capnp::_::RawSchema s_9aad50a41f4af45f = {
   0x9aad50a41f4af45f, b_9aad50a41f4af45f.words, 108, d_9aad50a41f4af45f, m_9aad50a41f4af45f,
-  4, 7, i_9aad50a41f4af45f, nullptr, nullptr
+  4, 7, i_9aad50a41f4af45f, nullptr, nullptr,
+  { 3, 4, 7, false, 2, 4, true },
+  0, p_9aad50a41f4af45f, h_9aad50a41f4af45f
 };
 static const ::capnp::_::AlignedData<23> b_97b14cbe7cfec712 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -926,7 +958,9 @@ static const ::capnp::_::AlignedData<23> b_97b14cbe7cfec712 = {
 };
 const ::capnp::_::RawSchema s_97b14cbe7cfec712 = {
   0x97b14cbe7cfec712, b_97b14cbe7cfec712.words, 23, nullptr, nullptr,
-  0, 0, nullptr, nullptr, nullptr
+  0, 0, nullptr, nullptr, nullptr,
+  { 0, 0, 0, false, 0, 0, false },
+  0, nullptr, nullptr
 };
 static const ::capnp::_::AlignedData<75> b_c42305476bb4746f = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1012,9 +1046,13 @@ static const ::capnp::_::RawSchema* const d_c42305476bb4746f[] = {
 };
 static const uint16_t m_c42305476bb4746f[] = {2, 3, 0, 1};
 static const uint16_t i_c42305476bb4746f[] = {0, 1, 2, 3};
+static const uint32_t p_c42305476bb4746f[] = {1114112};
+static const uint16_t h_c42305476bb4746f[] = {1, 2, 3, 0};
 const ::capnp::_::RawSchema s_c42305476bb4746f = {
   0xc42305476bb4746f, b_c42305476bb4746f.words, 75, d_c42305476bb4746f, m_c42305476bb4746f,
-  3, 4, i_c42305476bb4746f, nullptr, nullptr
+  3, 4, i_c42305476bb4746f, nullptr, nullptr,
+  { 3, 4, 7, true, 0, 0, true },
+  0, p_c42305476bb4746f, h_c42305476bb4746f
 };
 static const ::capnp::_::AlignedData<30> b_cafccddb68db1d11 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1053,9 +1091,13 @@ static const ::capnp::_::RawSchema* const d_cafccddb68db1d11[] = {
 };
 static const uint16_t m_cafccddb68db1d11[] = {0};
 static const uint16_t i_cafccddb68db1d11[] = {0};
+static const uint32_t p_cafccddb68db1d11[] = {0};
+static const uint16_t h_cafccddb68db1d11[] = {0};
 const ::capnp::_::RawSchema s_cafccddb68db1d11 = {
   0xcafccddb68db1d11, b_cafccddb68db1d11.words, 30, d_cafccddb68db1d11, m_cafccddb68db1d11,
-  1, 1, i_cafccddb68db1d11, nullptr, nullptr
+  1, 1, i_cafccddb68db1d11, nullptr, nullptr,
+  { 3, 4, 7, true, 0, 0, true },
+  0, p_cafccddb68db1d11, h_cafccddb68db1d11
 };
 static const ::capnp::_::AlignedData<47> b_bb90d5c287870be6 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1111,9 +1153,13 @@ static const ::capnp::_::RawSchema* const d_bb90d5c287870be6[] = {
 };
 static const uint16_t m_bb90d5c287870be6[] = {1, 0};
 static const uint16_t i_bb90d5c287870be6[] = {0, 1};
+static const uint32_t p_bb90d5c287870be6[] = {0};
+static const uint16_t h_bb90d5c287870be6[] = {0, 1};
 const ::capnp::_::RawSchema s_bb90d5c287870be6 = {
   0xbb90d5c287870be6, b_bb90d5c287870be6.words, 47, d_bb90d5c287870be6, m_bb90d5c287870be6,
-  1, 2, i_bb90d5c287870be6, nullptr, nullptr
+  1, 2, i_bb90d5c287870be6, nullptr, nullptr,
+  { 3, 4, 7, true, 2, 5, true },
+  0, p_bb90d5c287870be6, h_bb90d5c287870be6
 };
 static const ::capnp::_::AlignedData<64> b_978a7cebdc549a4d = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1186,9 +1232,13 @@ static const ::capnp::_::RawSchema* const d_978a7cebdc549a4d[] = {
 };
 static const uint16_t m_978a7cebdc549a4d[] = {2, 1, 0};
 static const uint16_t i_978a7cebdc549a4d[] = {0, 1, 2};
+static const uint32_t p_978a7cebdc549a4d[] = {0};
+static const uint16_t h_978a7cebdc549a4d[] = {2, 1, 0};
 const ::capnp::_::RawSchema s_978a7cebdc549a4d = {
   0x978a7cebdc549a4d, b_978a7cebdc549a4d.words, 64, d_978a7cebdc549a4d, m_978a7cebdc549a4d,
-  1, 3, i_978a7cebdc549a4d, nullptr, nullptr
+  1, 3, i_978a7cebdc549a4d, nullptr, nullptr,
+  { 1, 2, 7, false, 0, 0, true },
+  0, p_978a7cebdc549a4d, h_978a7cebdc549a4d
 };
 static const ::capnp::_::AlignedData<95> b_9500cce23b334d80 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1292,9 +1342,13 @@ static const ::capnp::_::RawSchema* const d_9500cce23b334d80[] = {
 };
 static const uint16_t m_9500cce23b334d80[] = {4, 1, 0, 2, 3};
 static const uint16_t i_9500cce23b334d80[] = {0, 1, 2, 3, 4};
+static const uint32_t p_9500cce23b334d80[] = {5308416};
+static const uint16_t h_9500cce23b334d80[] = {0, 3, 1, 2, 4};
 const ::capnp::_::RawSchema s_9500cce23b334d80 = {
   0x9500cce23b334d80, b_9500cce23b334d80.words, 95, d_9500cce23b334d80, m_9500cce23b334d80,
-  1, 5, i_9500cce23b334d80, nullptr, nullptr
+  1, 5, i_9500cce23b334d80, nullptr, nullptr,
+  { 3, 2, 7, false, 0, 0, true },
+  0, p_9500cce23b334d80, h_9500cce23b334d80
 };
 static const ::capnp::_::AlignedData<260> b_d07378ede1f9cc60 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1566,9 +1620,13 @@ static const ::capnp::_::RawSchema* const d_d07378ede1f9cc60[] = {
 };
 static const uint16_t m_d07378ede1f9cc60[] = {18, 1, 13, 15, 10, 11, 3, 4, 5, 2, 17, 14, 16, 12, 7, 8, 9, 6, 0};
 static const uint16_t i_d07378ede1f9cc60[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18};
+static const uint32_t p_d07378ede1f9cc60[] = {589824, 1703941, 18, 458765};
+static const uint16_t h_d07378ede1f9cc60[] = {13, 5, 8, 15, 4, 9, 10, 7, 0, 18, 16, 14, 1, 17, 6, 2, 3, 12, 11};
 const ::capnp::_::RawSchema s_d07378ede1f9cc60 = {
   0xd07378ede1f9cc60, b_d07378ede1f9cc60.words, 260, d_d07378ede1f9cc60, m_d07378ede1f9cc60,
-  4, 19, i_d07378ede1f9cc60, nullptr, nullptr
+  4, 19, i_d07378ede1f9cc60, nullptr, nullptr,
+  { 2, 1, 7, false, 19, 0, true },
+  0, p_d07378ede1f9cc60, h_d07378ede1f9cc60
 };
 static const ::capnp::_::AlignedData<31> b_87e739250a60ea97 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1608,9 +1666,13 @@ static const ::capnp::_::RawSchema* const d_87e739250a60ea97[] = {
 };
 static const uint16_t m_87e739250a60ea97[] = {0};
 static const uint16_t i_87e739250a60ea97[] = {0};
+static const uint32_t p_87e739250a60ea97[] = {0};
+static const uint16_t h_87e739250a60ea97[] = {0};
 const ::capnp::_::RawSchema s_87e739250a60ea97 = {
   0x87e739250a60ea97, b_87e739250a60ea97.words, 31, d_87e739250a60ea97, m_87e739250a60ea97,
-  1, 1, i_87e739250a60ea97, nullptr, nullptr
+  1, 1, i_87e739250a60ea97, nullptr, nullptr,
+  { 2, 1, 7, true, 0, 0, true },
+  0, p_87e739250a60ea97, h_87e739250a60ea97
 };
 static const ::capnp::_::AlignedData<30> b_9e0e78711a7f87a9 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1649,9 +1711,13 @@ static const ::capnp::_::RawSchema* const d_9e0e78711a7f87a9[] = {
 };
 static const uint16_t m_9e0e78711a7f87a9[] = {0};
 static const uint16_t i_9e0e78711a7f87a9[] = {0};
+static const uint32_t p_9e0e78711a7f87a9[] = {0};
+static const uint16_t h_9e0e78711a7f87a9[] = {0};
 const ::capnp::_::RawSchema s_9e0e78711a7f87a9 = {
   0x9e0e78711a7f87a9, b_9e0e78711a7f87a9.words, 30, d_9e0e78711a7f87a9, m_9e0e78711a7f87a9,
-  1, 1, i_9e0e78711a7f87a9, nullptr, nullptr
+  1, 1, i_9e0e78711a7f87a9, nullptr, nullptr,
+  { 2, 1, 7, true, 0, 0, true },
+  0, p_9e0e78711a7f87a9, h_9e0e78711a7f87a9
 };
 static const ::capnp::_::AlignedData<30> b_ac3a6f60ef4cc6d3 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1690,9 +1756,13 @@ static const ::capnp::_::RawSchema* const d_ac3a6f60ef4cc6d3[] = {
 };
 static const uint16_t m_ac3a6f60ef4cc6d3[] = {0};
 static const uint16_t i_ac3a6f60ef4cc6d3[] = {0};
+static const uint32_t p_ac3a6f60ef4cc6d3[] = {0};
+static const uint16_t h_ac3a6f60ef4cc6d3[] = {0};
 const ::capnp::_::RawSchema s_ac3a6f60ef4cc6d3 = {
   0xac3a6f60ef4cc6d3, b_ac3a6f60ef4cc6d3.words, 30, d_ac3a6f60ef4cc6d3, m_ac3a6f60ef4cc6d3,
-  1, 1, i_ac3a6f60ef4cc6d3, nullptr, nullptr
+  1, 1, i_ac3a6f60ef4cc6d3, nullptr, nullptr,
+  { 2, 1, 7, true, 0, 0, true },
+  0, p_ac3a6f60ef4cc6d3, h_ac3a6f60ef4cc6d3
 };
 static const ::capnp::_::AlignedData<31> b_ed8bca69f7fb0cbf = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -1732,9 +1802,13 @@ static const ::capnp::_::RawSchema* const d_ed8bca69f7fb0cbf[] = {
 };
 static const uint16_t m_ed8bca69f7fb0cbf[] = {0};
 static const uint16_t i_ed8bca69f7fb0cbf[] = {0};
+static const uint32_t p_ed8bca69f7fb0cbf[] = {0};
+static const uint16_t h_ed8bca69f7fb0cbf[] = {0};
 const ::capnp::_::RawSchema s_ed8bca69f7fb0cbf = {
   0xed8bca69f7fb0cbf, b_ed8bca69f7fb0cbf.words, 31, d_ed8bca69f7fb0cbf, m_ed8bca69f7fb0cbf,
-  1, 1, i_ed8bca69f7fb0cbf, nullptr, nullptr
+  1, 1, i_ed8bca69f7fb0cbf, nullptr, nullptr,
+  { 2, 1, 7, true, 0, 0, true },
+  0, p_ed8bca69f7fb0cbf, h_ed8bca69f7fb0cbf
 };
 static const ::capnp::_::AlignedData<285> b_ce23dcd2d7b00c9b = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -2025,9 +2099,13 @@ static const ::capnp::_::AlignedData<285> b_ce23dcd2d7b00c9b = {
 };
 static const uint16_t m_ce23dcd2d7b00c9b[] = {18, 1, 13, 15, 10, 11, 3, 4, 5, 2, 17, 14, 16, 12, 7, 8, 9, 6, 0};
 static const uint16_t i_ce23dcd2d7b00c9b[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18};
+static const uint32_t p_ce23dcd2d7b00c9b[] = {589824, 1703941, 18, 458765};
+static const uint16_t h_ce23dcd2d7b00c9b[] = {13, 5, 8, 15, 4, 9, 10, 7, 0, 18, 16, 14, 1, 17, 6, 2, 3, 12, 11};
 const ::capnp::_::RawSchema s_ce23dcd2d7b00c9b = {
   0xce23dcd2d7b00c9b, b_ce23dcd2d7b00c9b.words, 285, nullptr, m_ce23dcd2d7b00c9b,
-  0, 19, i_ce23dcd2d7b00c9b, nullptr, nullptr
+  0, 19, i_ce23dcd2d7b00c9b, nullptr, nullptr,
+  { 2, 1, 7, false, 19, 0, true },
+  0, p_ce23dcd2d7b00c9b, h_ce23dcd2d7b00c9b
 };
 static const ::capnp::_::AlignedData<45> b_f1c8950dab257542 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -2081,9 +2159,13 @@ static const ::capnp::_::RawSchema* const d_f1c8950dab257542[] = {
 };
 static const uint16_t m_f1c8950dab257542[] = {0, 1};
 static const uint16_t i_f1c8950dab257542[] = {0, 1};
+static const uint32_t p_f1c8950dab257542[] = {0};
+static const uint16_t h_f1c8950dab257542[] = {0, 1};
 const ::capnp::_::RawSchema s_f1c8950dab257542 = {
   0xf1c8950dab257542, b_f1c8950dab257542.words, 45, d_f1c8950dab257542, m_f1c8950dab257542,
-  1, 2, i_f1c8950dab257542, nullptr, nullptr
+  1, 2, i_f1c8950dab257542, nullptr, nullptr,
+  { 1, 1, 7, false, 0, 0, true },
+  0, p_f1c8950dab257542, h_f1c8950dab257542
 };
 static const ::capnp::_::AlignedData<53> b_d1958f7dba521926 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -2141,9 +2223,13 @@ static const ::capnp::_::AlignedData<53> b_d1958f7dba521926 = {
     109, 112, 111, 115, 105, 116, 101,   0, }
 };
 static const uint16_t m_d1958f7dba521926[] = {1, 2, 5, 0, 4, 7, 6, 3};
+static const uint32_t p_d1958f7dba521926[] = {720903, 393216};
+static const uint16_t h_d1958f7dba521926[] = {4, 6, 7, 2, 0, 3, 5, 1};
 const ::capnp::_::RawSchema s_d1958f7dba521926 = {
   0xd1958f7dba521926, b_d1958f7dba521926.words, 53, nullptr, m_d1958f7dba521926,
-  0, 8, nullptr, nullptr, nullptr
+  0, 8, nullptr, nullptr, nullptr,
+  { 0, 0, 0, false, 0, 0, false },
+  0, p_d1958f7dba521926, h_d1958f7dba521926
 };
 static const ::capnp::_::AlignedData<57> b_bfc546f6210ad7ce = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -2210,9 +2296,13 @@ static const ::capnp::_::RawSchema* const d_bfc546f6210ad7ce[] = {
 };
 static const uint16_t m_bfc546f6210ad7ce[] = {0, 1};
 static const uint16_t i_bfc546f6210ad7ce[] = {0, 1};
+static const uint32_t p_bfc546f6210ad7ce[] = {65536};
+static const uint16_t h_bfc546f6210ad7ce[] = {0, 1};
 const ::capnp::_::RawSchema s_bfc546f6210ad7ce = {
   0xbfc546f6210ad7ce, b_bfc546f6210ad7ce.words, 57, d_bfc546f6210ad7ce, m_bfc546f6210ad7ce,
-  2, 2, i_bfc546f6210ad7ce, nullptr, nullptr
+  2, 2, i_bfc546f6210ad7ce, nullptr, nullptr,
+  { 0, 2, 7, false, 0, 0, true },
+  0, p_bfc546f6210ad7ce, h_bfc546f6210ad7ce
 };
 static const ::capnp::_::AlignedData<69> b_cfea0eb02e810062 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -2290,9 +2380,13 @@ static const ::capnp::_::RawSchema* const d_cfea0eb02e810062[] = {
 };
 static const uint16_t m_cfea0eb02e810062[] = {1, 0, 2};
 static const uint16_t i_cfea0eb02e810062[] = {0, 1, 2};
+static const uint32_t p_cfea0eb02e810062[] = {0};
+static const uint16_t h_cfea0eb02e810062[] = {0, 2, 1};
 const ::capnp::_::RawSchema s_cfea0eb02e810062 = {
   0xcfea0eb02e810062, b_cfea0eb02e810062.words, 69, d_cfea0eb02e810062, m_cfea0eb02e810062,
-  1, 3, i_cfea0eb02e810062, nullptr, nullptr
+  1, 3, i_cfea0eb02e810062, nullptr, nullptr,
+  { 1, 2, 7, false, 0, 0, true },
+  0, p_cfea0eb02e810062, h_cfea0eb02e810062
 };
 static const ::capnp::_::AlignedData<49> b_ae504193122357e5 = {
   {   0,   0,   0,   0,   5,   0,   5,   0,
@@ -2347,9 +2441,13 @@ static const ::capnp::_::AlignedData<49> b_ae504193122357e5 = {
 };
 static const uint16_t m_ae504193122357e5[] = {0, 1};
 static const uint16_t i_ae504193122357e5[] = {0, 1};
+static const uint32_t p_ae504193122357e5[] = {0};
+static const uint16_t h_ae504193122357e5[] = {0, 1};
 const ::capnp::_::RawSchema s_ae504193122357e5 = {
   0xae504193122357e5, b_ae504193122357e5.words, 49, nullptr, m_ae504193122357e5,
-  0, 2, i_ae504193122357e5, nullptr, nullptr
+  0, 2, i_ae504193122357e5, nullptr, nullptr,
+  { 1, 1, 7, false, 0, 0, true },
+  0, p_ae504193122357e5, h_ae504193122357e5
 };
 }  // namespace schemas
 namespace _ {  // private
@@ -55,6 +55,16 @@ extern const RawSchema NULL_INTERFACE_SCHEMA;
 extern const RawSchema NULL_CONST_SCHEMA;
 // The schema types default to these null (empty) schemas in case of error, especially when
 // exceptions are disabled.
+
+inline uint memberHashBucketCount(uint memberCount) { return (memberCount + 4) / 5; }
+// Size of RawSchema::memberHashDisplacements.
+
+bool makeMemberHash(kj::ArrayPtr<const kj::StringPtr> names, uint32_t& seed,
+                    kj::ArrayPtr<uint32_t> displacements, kj::ArrayPtr<uint16_t> membersByHash);
+// Build the perfect hash of member names stored in a RawSchema, where `names[i]` is the name of
+// member i.  `displacements` must have memberHashBucketCount(names.size()) elements and
+// `membersByHash` names.size().  Returns false if no perfect hash could be found, which can only
+// happen if there are duplicate names.
 }  // namespace _ (private)
 
 class Schema {
@@ -180,8 +190,18 @@ public:
   // there is no such field.  (If the schema does not represent a union or a struct containing
   // an unnamed union, then this always returns null.)
 
+  inline _::RawSchema::StructLayout getLayout() const {
+    return KJ_LIKELY(raw->structLayout.isStruct) ? raw->structLayout : decodeLayout();
+  }
+  // Get the sizes, preferred list encoding, and discriminant location of this struct.  This is
+  // the same information found in `getProto().getStruct()`, but cached at load time so that it
+  // can be read without decoding the schema node.  Mainly useful for code which builds many
+  // structs dynamically.  (Generated code from an older compiler lacks the cached copy; for
+  // those types the node is decoded on each call.)
+
 private:
   StructSchema(const _::RawSchema* raw): Schema(raw) {}
+  _::RawSchema::StructLayout decodeLayout() const;
   template <typename T> static inline StructSchema fromImpl() {
     return StructSchema(&_::rawSchema<T>());
   }
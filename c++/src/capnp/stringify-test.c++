@@ -48,6 +48,7 @@
 #include "dynamic.h"
 #include "pretty-print.h"
 #include <kj/debug.h>
+#include <kj/vector.h>
 #include <gtest/gtest.h>
 #include "test-util.h"
 
@@ -721,6 +722,120 @@ TEST(Stringify, MoreValues) {
   EXPECT_EQ("(123)", kj::str(DynamicValue::Reader(static_cast<TestEnum>(123))));
 }
 
+class StringOutputStream: public kj::OutputStream {
+public:
+  void write(const void* buffer, size_t size) override {
+    chars.addAll(reinterpret_cast<const char*>(buffer),
+                 reinterpret_cast<const char*>(buffer) + size);
+  }
+
+  kj::String take() {
+    auto result = kj::heapString(chars.begin(), chars.size());
+    chars.resize(0);
+    return result;
+  }
+
+private:
+  kj::Vector<char> chars;
+};
+
+template <typename T>
+void expectWriteTextMatches(T&& value) {
+  // writeText() should produce exactly what the StringTree-based printers do.
+  StringOutputStream output;
+
+  writeText(output, value);
+  EXPECT_EQ(prettyPrint(value).flatten(), output.take());
+
+  writeText(output, value, false);
+  EXPECT_EQ(kj::str(value), output.take());
+}
+
+TEST(Stringify, WriteText) {
+  {
+    MallocMessageBuilder builder;
+    auto root = builder.initRoot<TestAllTypes>();
+    expectWriteTextMatches(root.asReader());
+    initTestMessage(root);
+    expectWriteTextMatches(root.asReader());
+    expectWriteTextMatches(toDynamic(root.asReader().getStructList()));
+    root.setTextField("\a\b\n\t\"\x01\xff'\\ foo");
+    expectWriteTextMatches(root.asReader());
+  }
+
+  {
+    MallocMessageBuilder builder;
+    auto root = builder.initRoot<test::TestPrintInlineStructs>();
+    auto list = root.initStructList(3);
+    list[0].setInt32Field(123);
+    list[0].setTextField("foo");
+    list[1].setInt32Field(456);
+    list[1].setTextField("bar");
+    list[2].setInt32Field(789);
+    list[2].setTextField("baz");
+    expectWriteTextMatches(root.asReader());
+
+    // Just long enough, then just too long, to be printed inline.
+    list[0].setTextField("0123456789");
+    expectWriteTextMatches(root.asReader());
+    list[0].setTextField("01234567890");
+    expectWriteTextMatches(root.asReader());
+
+    root.setSomeText("foo");
+    expectWriteTextMatches(root.asReader());
+  }
+
+  {
+    MallocMessageBuilder builder;
+    auto root = builder.initRoot<test::TestUnnamedUnion>();
+    root.setBar(123);
+    expectWriteTextMatches(root.asReader());
+    root.setAfter("foooooooooooooooooooooooooooooooo");
+    expectWriteTextMatches(root.asReader());
+    root.setBefore("before");
+    root.setFoo(0);
+    expectWriteTextMatches(root.asReader());
+  }
+
+  {
+    MallocMessageBuilder builder;
+    auto root = builder.initRoot<TestUnion>();
+    root.getUnion0().setU0f0s16(0);
+    root.getUnion1().setU1f0sp("foo");
+    root.getUnion3().setU3f0s1(true);
+    expectWriteTextMatches(root.asReader());
+  }
+
+  {
+    MallocMessageBuilder builder;
+    auto root = builder.initRoot<test::TestStructUnion>();
+    auto s = root.getUn().initStruct();
+    s.setSomeText("foo");
+    s.setMoreText("baaaaaaaaaaaaaaaaaaaaaaaaaaaaaar");
+    expectWriteTextMatches(root.asReader());
+  }
+}
+
+TEST(Stringify, WriteTextLarge) {
+  // Output much bigger than the internal buffer, including single values bigger than it.
+  MallocMessageBuilder builder;
+  auto root = builder.initRoot<TestAllTypes>();
+  auto texts = root.initTextList(5000);
+  for (uint i = 0; i < texts.size(); i++) {
+    texts.set(i, kj::str("item", i));
+  }
+  auto longText = kj::heapString(20000);
+  memset(longText.begin(), 'x', longText.size());
+  root.setTextField(longText);
+  auto structs = root.initStructList(1000);
+  for (uint i = 0; i < structs.size(); i++) {
+    structs[i].setInt32Field(i);
+    structs[i].setUInt16List({1, 2, 3});
+  }
+
+  expectWriteTextMatches(root.asReader());
+}
+
 }  // namespace
 }  // namespace _ (private)
 }  // namespace capnp
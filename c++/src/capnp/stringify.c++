@@ -22,6 +22,7 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "dynamic.h"
+#include "pretty-print.h"
 #include <kj/debug.h>
 #include <kj/vector.h>
 
@@ -48,6 +49,11 @@ enum class PrintKind {
   RECORD
 };
 
+static constexpr size_t maxInlineValueSize = 24;
+static constexpr size_t maxInlineRecordSize = 64;
+// A list or struct is printed on one line if each of its items fits in maxInlineValueSize
+// characters and, for structs, all of them together fit in maxInlineRecordSize.
+
 class Indent {
 public:
   explicit Indent(bool enable): amount(enable ? 1 : 0) {}
@@ -79,9 +85,6 @@ private:
 
   explicit Indent(uint amount): amount(amount) {}
 
-  static constexpr size_t maxInlineValueSize = 24;
-  static constexpr size_t maxInlineRecordSize = 64;
-
   static bool canPrintInline(const kj::StringTree& text) {
     if (text.size() > maxInlineValueSize) {
       return false;
@@ -121,6 +124,78 @@ static schema::Type::Which whichFieldType(const StructSchema::Field& field) {
   KJ_UNREACHABLE;
 }
 
+template <typename Func>
+static void escapeText(kj::ArrayPtr<const char> chars, Func&& output) {
+  // Escapes `chars` for printing inside double quotes, passing the result to `output` as a series
+  // of kj::ArrayPtr<const char>.
+
+  const char* runStart = chars.begin();
+  for (const char* pos = chars.begin(); pos != chars.end(); ++pos) {
+    char c = *pos;
+    kj::StringPtr escape;
+    switch (c) {
+      case '\a': escape = "\\a"; break;
+      case '\b': escape = "\\b"; break;
+      case '\f': escape = "\\f"; break;
+      case '\n': escape = "\\n"; break;
+      case '\r': escape = "\\r"; break;
+      case '\t': escape = "\\t"; break;
+      case '\v': escape = "\\v"; break;
+      case '\'': escape = "\\\'"; break;
+      case '\"': escape = "\\\""; break;
+      case '\\': escape = "\\\\"; break;
+      default:
+        if (c >= 0x20) continue;
+        break;
+    }
+
+    output(kj::arrayPtr(runStart, pos));
+    runStart = pos + 1;
+
+    if (escape == nullptr) {
+      uint8_t c2 = c;
+      char hex[4] = { '\\', 'x', HEXDIGITS[c2 / 16], HEXDIGITS[c2 % 16] };
+      output(kj::arrayPtr(hex, 4));
+    } else {
+      output(escape.asArray());
+    }
+  }
+  output(kj::arrayPtr(runStart, chars.end()));
+}
+
+template <typename Func>
+static void forEachPrintedField(const DynamicStruct::Reader& value, Func&& func) {
+  // Calls func(field) for each field of `value` that should be printed, in order.  Stops early if
+  // `func` returns false.
+
+  // We try to write the union field, if any, in proper order with the rest.
+  auto which = value.which();
+
+  KJ_IF_MAYBE(field, which) {
+    // Even if the union field has its default value, if it is not the default field of the
+    // union then we have to print it anyway.
+    if (field->getProto().getDiscriminantValue() == 0 && !value.has(*field)) {
+      which = nullptr;
+    }
+  }
+
+  for (auto field: value.getSchema().getNonUnionFields()) {
+    KJ_IF_MAYBE(unionField, which) {
+      if (unionField->getIndex() < field.getIndex()) {
+        if (!func(*unionField)) return;
+        which = nullptr;
+      }
+    }
+    if (value.has(field)) {
+      if (!func(field)) return;
+    }
+  }
+  KJ_IF_MAYBE(unionField, which) {
+    // Union value is last.
+    func(*unionField);
+  }
+}
+
 static kj::StringTree print(const DynamicValue::Reader& value,
                             schema::Type::Which which, Indent indent,
                             PrintMode mode) {
@@ -153,32 +228,7 @@ static kj::StringTree print(const DynamicValue::Reader& value,
       }
 
       kj::Vector<char> escaped(chars.size());
-
-      for (char c: chars) {
-        switch (c) {
-          case '\a': escaped.addAll(kj::StringPtr("\\a")); break;
-          case '\b': escaped.addAll(kj::StringPtr("\\b")); break;
-          case '\f': escaped.addAll(kj::StringPtr("\\f")); break;
-          case '\n': escaped.addAll(kj::StringPtr("\\n")); break;
-          case '\r': escaped.addAll(kj::StringPtr("\\r")); break;
-          case '\t': escaped.addAll(kj::StringPtr("\\t")); break;
-          case '\v': escaped.addAll(kj::StringPtr("\\v")); break;
-          case '\'': escaped.addAll(kj::StringPtr("\\\'")); break;
-          case '\"': escaped.addAll(kj::StringPtr("\\\"")); break;
-          case '\\': escaped.addAll(kj::StringPtr("\\\\")); break;
-          default:
-            if (c < 0x20) {
-              escaped.add('\\');
-              escaped.add('x');
-              uint8_t c2 = c;
-              escaped.add(HEXDIGITS[c2 / 16]);
-              escaped.add(HEXDIGITS[c2 % 16]);
-            } else {
-              escaped.add(c);
-            }
-            break;
-        }
-      }
+      escapeText(chars, [&](kj::ArrayPtr<const char> part) { escaped.addAll(part); });
       return kj::strTree('"', escaped, '"');
     }
     case DynamicValue::LIST: {
@@ -201,45 +251,13 @@ static kj::StringTree print(const DynamicValue::Reader& value,
     }
     case DynamicValue::STRUCT: {
       auto structValue = value.as<DynamicStruct>();
-      auto unionFields = structValue.getSchema().getUnionFields();
-      auto nonUnionFields = structValue.getSchema().getNonUnionFields();
-
-      kj::Vector<kj::StringTree> printedFields(nonUnionFields.size() + (unionFields.size() != 0));
-
-      // We try to write the union field, if any, in proper order with the rest.
-      auto which = structValue.which();
-
-      kj::StringTree unionValue;
-      KJ_IF_MAYBE(field, which) {
-        // Even if the union field has its default value, if it is not the default field of the
-        // union then we have to print it anyway.
-        auto fieldProto = field->getProto();
-        if (fieldProto.getDiscriminantValue() != 0 || structValue.has(*field)) {
-          unionValue = kj::strTree(
-              fieldProto.getName(), " = ",
-              print(structValue.get(*field), whichFieldType(*field), indent.next(), PREFIXED));
-        } else {
-          which = nullptr;
-        }
-      }
-
-      for (auto field: nonUnionFields) {
-        KJ_IF_MAYBE(unionField, which) {
-          if (unionField->getIndex() < field.getIndex()) {
-            printedFields.add(kj::mv(unionValue));
-            which = nullptr;
-          }
-        }
-        if (structValue.has(field)) {
-          printedFields.add(kj::strTree(
-              field.getProto().getName(), " = ",
-              print(structValue.get(field), whichFieldType(field), indent.next(), PREFIXED)));
-        }
-      }
-      if (which != nullptr) {
-        // Union value is last.
-        printedFields.add(kj::mv(unionValue));
-      }
+      kj::Vector<kj::StringTree> printedFields(structValue.getSchema().getFields().size());
+      forEachPrintedField(structValue, [&](StructSchema::Field field) {
+        printedFields.add(kj::strTree(
+            field.getProto().getName(), " = ",
+            print(structValue.get(field), whichFieldType(field), indent.next(), PREFIXED)));
+        return true;
+      });
 
       if (mode == PARENTHESIZED) {
         return indent.delimit(printedFields.releaseAsArray(), mode, PrintKind::RECORD);
@@ -257,6 +275,261 @@ static kj::StringTree print(const DynamicValue::Reader& value,
   KJ_UNREACHABLE;
 }
 
+// -------------------------------------------------------------------
+
+class TextWriter {
+  // Writes the same text as print(), above, but incrementally to an OutputStream, so memory use
+  // doesn't grow with the size of the message.
+  //
+  // print() decides whether to put a list or struct on one line by first printing all of its
+  // items.  Instead, TextWriter first runs each item through a "measuring" TextWriter which only
+  // counts characters, and which gives up as soon as the item is too long to go inline.  Since
+  // that limit is small, this costs a bounded amount of work per item.
+  //
+  // Note that an item's flat text is at most maxInlineValueSize long only if everything inside
+  // it fits inline too, so measuring flat text suffices.
+
+public:
+  TextWriter(kj::OutputStream& output, kj::ArrayPtr<char> buffer)
+      : output(&output), buffer(buffer), pos(buffer.begin()), limit(0), count(0) {}
+
+  void write(const DynamicValue::Reader& value, schema::Type::Which which,
+             uint indent, PrintMode mode);
+  // `indent` is the indentation level of `value`'s contents, or zero to print everything inline.
+
+  void flush() {
+    if (pos != buffer.begin()) {
+      output->write(buffer.begin(), pos - buffer.begin());
+      pos = buffer.begin();
+    }
+  }
+
+private:
+  kj::OutputStream* output;
+  // Null when measuring.
+
+  kj::ArrayPtr<char> buffer;
+  char* pos;
+
+  size_t limit;
+  size_t count;
+  // When measuring, the number of characters so far, and the most we care about.
+
+  explicit TextWriter(size_t limit)
+      : output(nullptr), pos(nullptr), limit(limit), count(0) {}
+
+  inline bool gaveUp() { return output == nullptr && count > limit; }
+
+  void put(kj::ArrayPtr<const char> chars) {
+    if (output == nullptr) {
+      count += chars.size();
+    } else if (chars.size() <= size_t(buffer.end() - pos)) {
+      memcpy(pos, chars.begin(), chars.size());
+      pos += chars.size();
+    } else {
+      flush();
+      if (chars.size() < buffer.size()) {
+        memcpy(pos, chars.begin(), chars.size());
+        pos += chars.size();
+      } else {
+        output->write(chars.begin(), chars.size());
+      }
+    }
+  }
+
+  inline void put(char c) { put(kj::arrayPtr(&c, 1)); }
+
+  template <size_t n>
+  inline void put(const char (&literal)[n]) { put(kj::arrayPtr(literal, n - 1)); }
+
+  template <typename T>
+  inline void putValue(T value) {
+    auto chars = kj::toCharSequence(value);
+    put(kj::arrayPtr(chars.begin(), chars.size()));
+  }
+
+  void putLineBreak(uint indent) {
+    put('\n');
+    for (uint i = 0; i < indent; i++) {
+      put("  ");
+    }
+  }
+
+  static size_t measure(const DynamicValue::Reader& value, schema::Type::Which which,
+                        size_t limit) {
+    // Returns the length of `value` printed inline, or something greater than `limit` if that's
+    // greater than `limit`.
+    TextWriter measurer(limit);
+    measurer.write(value, which, 0, BARE);
+    return measurer.count;
+  }
+
+  bool canPrintListInline(const DynamicList::Reader& value, schema::Type::Which which);
+  bool canPrintStructInline(const DynamicStruct::Reader& value);
+
+  void beginItems(uint indent, PrintMode mode, bool inlined) {
+    // Like Indent::delimit(): if the outer value isn't being printed on its own line, we need to
+    // add a newline/indent before the first item, otherwise we only add a space on the
+    // assumption that it is preceded by an open bracket or parenthesis.
+    if (!inlined) {
+      if (mode == BARE) {
+        put(' ');
+      } else {
+        putLineBreak(indent);
+      }
+    }
+  }
+
+  void separateItems(uint indent, bool inlined) {
+    if (inlined) {
+      put(", ");
+    } else {
+      put(',');
+      putLineBreak(indent);
+    }
+  }
+
+  void endItems(bool inlined) {
+    if (!inlined) put(' ');
+  }
+};
+
+bool TextWriter::canPrintListInline(
+    const DynamicList::Reader& value, schema::Type::Which which) {
+  for (auto element: value) {
+    if (measure(element, which, maxInlineValueSize) > maxInlineValueSize) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TextWriter::canPrintStructInline(const DynamicStruct::Reader& value) {
+  bool result = true;
+  size_t totalSize = 0;
+  forEachPrintedField(value, [&](StructSchema::Field field) {
+    size_t prefixSize = field.getProto().getName().size() + 3;  // "name = "
+    size_t size = prefixSize;
+    if (size <= maxInlineValueSize) {
+      size += measure(value.get(field), whichFieldType(field), maxInlineValueSize - size);
+    }
+    totalSize += size;
+    if (size > maxInlineValueSize || totalSize > maxInlineRecordSize) {
+      result = false;
+    }
+    return result;
+  });
+  return result;
+}
+
+void TextWriter::write(const DynamicValue::Reader& value, schema::Type::Which which,
+                       uint indent, PrintMode mode) {
+  switch (value.getType()) {
+    case DynamicValue::UNKNOWN:
+      put('?');
+      return;
+    case DynamicValue::VOID:
+      put("void");
+      return;
+    case DynamicValue::BOOL:
+      put(value.as<bool>() ? kj::StringPtr("true") : kj::StringPtr("false"));
+      return;
+    case DynamicValue::INT:
+      putValue(value.as<int64_t>());
+      return;
+    case DynamicValue::UINT:
+      putValue(value.as<uint64_t>());
+      return;
+    case DynamicValue::FLOAT:
+      if (which == schema::Type::FLOAT32) {
+        putValue(value.as<float>());
+      } else {
+        putValue(value.as<double>());
+      }
+      return;
+    case DynamicValue::TEXT:
+    case DynamicValue::DATA: {
+      kj::ArrayPtr<const char> chars;
+      if (value.getType() == DynamicValue::DATA) {
+        auto reader = value.as<Data>();
+        chars = kj::arrayPtr(reinterpret_cast<const char*>(reader.begin()), reader.size());
+      } else {
+        chars = value.as<Text>();
+      }
+
+      put('"');
+      if (output == nullptr) {
+        // Escaping can only make text longer.
+        count += chars.size();
+        if (gaveUp()) return;
+      }
+      escapeText(chars, [this](kj::ArrayPtr<const char> part) { put(part); });
+      if (output == nullptr) count -= chars.size();
+      put('"');
+      return;
+    }
+    case DynamicValue::LIST: {
+      auto listValue = value.as<DynamicList>();
+      auto elementWhich = listValue.getSchema().whichElementType();
+      bool inlined = indent == 0 || canPrintListInline(listValue, elementWhich);
+      uint nextIndent = indent == 0 ? 0 : indent + 1;
+
+      put('[');
+      beginItems(indent, mode, inlined);
+      bool first = true;
+      for (auto element: listValue) {
+        if (gaveUp()) return;
+        if (!first) separateItems(indent, inlined);
+        first = false;
+        write(element, elementWhich, nextIndent, BARE);
+      }
+      endItems(inlined);
+      put(']');
+      return;
+    }
+    case DynamicValue::ENUM: {
+      auto enumValue = value.as<DynamicEnum>();
+      KJ_IF_MAYBE(enumerant, enumValue.getEnumerant()) {
+        put(enumerant->getProto().getName());
+      } else {
+        // Unknown enum value; output raw number.
+        put('(');
+        putValue(enumValue.getRaw());
+        put(')');
+      }
+      return;
+    }
+    case DynamicValue::STRUCT: {
+      auto structValue = value.as<DynamicStruct>();
+      bool inlined = indent == 0 || canPrintStructInline(structValue);
+      uint nextIndent = indent == 0 ? 0 : indent + 1;
+
+      if (mode != PARENTHESIZED) put('(');
+      beginItems(indent, mode, inlined);
+      bool first = true;
+      forEachPrintedField(structValue, [&](StructSchema::Field field) {
+        if (!first) separateItems(indent, inlined);
+        first = false;
+        put(field.getProto().getName());
+        put(" = ");
+        write(structValue.get(field), whichFieldType(field), nextIndent, PREFIXED);
+        return !gaveUp();
+      });
+      endItems(inlined);
+      if (mode != PARENTHESIZED) put(')');
+      return;
+    }
+    case DynamicValue::CAPABILITY:
+      put("<external capability>");
+      return;
+    case DynamicValue::ANY_POINTER:
+      put("<opaque pointer>");
+      return;
+  }
+
+  KJ_UNREACHABLE;
+}
+
 kj::StringTree stringify(DynamicValue::Reader value) {
   return print(value, schema::Type::STRUCT, Indent(false), BARE);
 }
@@ -271,6 +544,20 @@ kj::StringTree prettyPrint(DynamicList::Reader value) {
   return print(value, schema::Type::LIST, Indent(true), BARE);
 }
 
+void writeText(kj::OutputStream& output, DynamicStruct::Reader value, bool pretty) {
+  char buffer[8192];
+  TextWriter writer(output, kj::arrayPtr(buffer, sizeof(buffer)));
+  writer.write(value, schema::Type::STRUCT, pretty ? 1 : 0, BARE);
+  writer.flush();
+}
+
+void writeText(kj::OutputStream& output, DynamicList::Reader value, bool pretty) {
+  char buffer[8192];
+  TextWriter writer(output, kj::arrayPtr(buffer, sizeof(buffer)));
+  writer.write(value, schema::Type::LIST, pretty ? 1 : 0, BARE);
+  writer.flush();
+}
+
 kj::StringTree prettyPrint(DynamicStruct::Builder value) { return prettyPrint(value.asReader()); }
 kj::StringTree prettyPrint(DynamicList::Builder value) { return prettyPrint(value.asReader()); }
 
@@ -0,0 +1,214 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "text-parser.h"
+#include "message.h"
+#include "pretty-print.h"
+#include <kj/debug.h>
+#include <gtest/gtest.h>
+#include "test-util.h"
+
+namespace kj {
+  inline std::ostream& operator<<(std::ostream& os, const kj::String& s) {
+    return os.write(s.begin(), s.size());
+  }
+}
+
+namespace capnp {
+namespace _ {  // private
+namespace {
+
+TEST(TextParser, RoundTrip) {
+  MallocMessageBuilder builder;
+  initTestMessage(builder.initRoot<TestAllTypes>());
+  auto root = builder.getRoot<TestAllTypes>().asReader();
+
+  {
+    auto text = kj::str(root);
+    MallocMessageBuilder decoded;
+    readText(text, decoded, Schema::from<TestAllTypes>());
+    checkTestMessage(decoded.getRoot<TestAllTypes>().asReader());
+    EXPECT_EQ(text, kj::str(decoded.getRoot<TestAllTypes>().asReader()));
+  }
+
+  {
+    auto text = prettyPrint(root).flatten();
+    MallocMessageBuilder decoded;
+    readText(text, decoded, Schema::from<TestAllTypes>());
+    checkTestMessage(decoded.getRoot<TestAllTypes>().asReader());
+  }
+}
+
+TEST(TextParser, RoundTripUnionsAndGroups) {
+  MallocMessageBuilder builder;
+  auto root = builder.initRoot<test::TestGroups>();
+  root.getGroups().initBaz().setGrault("abc");
+
+  auto text = kj::str(root.asReader());
+  MallocMessageBuilder decoded;
+  auto decodedRoot = readText(text, decoded, Schema::from<test::TestGroups>())
+      .as<test::TestGroups>();
+  ASSERT_EQ(test::TestGroups::Groups::BAZ, decodedRoot.getGroups().which());
+  EXPECT_EQ("abc", decodedRoot.getGroups().getBaz().getGrault());
+
+  MallocMessageBuilder builder2;
+  auto root2 = builder2.initRoot<TestUnion>();
+  root2.getUnion0().setU0f1s32(123);
+  root2.getUnion1().setU1f0sp("foo");
+  root2.getUnion3().setU3f0s64(-5);
+
+  MallocMessageBuilder decoded2;
+  auto decodedRoot2 = readText(kj::str(root2.asReader()), decoded2, Schema::from<TestUnion>())
+      .as<TestUnion>();
+  ASSERT_TRUE(decodedRoot2.getUnion0().isU0f1s32());
+  EXPECT_EQ(123, decodedRoot2.getUnion0().getU0f1s32());
+  ASSERT_TRUE(decodedRoot2.getUnion1().isU1f0sp());
+  EXPECT_EQ("foo", decodedRoot2.getUnion1().getU1f0sp());
+  ASSERT_TRUE(decodedRoot2.getUnion3().isU3f0s64());
+  EXPECT_EQ(-5, decodedRoot2.getUnion3().getU3f0s64());
+}
+
+TEST(TextParser, Literals) {
+  MallocMessageBuilder builder;
+  auto root = readText(kj::StringPtr(
+      "  # comment (with brackets\n"
+      "  ( int8Field = - 128, int16Field = 0x7fff, int32Field = 017,\n"
+      "    uInt64Field = 18446744073709551615, int64Field = -9223372036854775808,\n"
+      "    float32Field = 25, float64Field = -inf,  # [\"\n"
+      "    textField = \"a\\\"\\\\\\a\\x41\\101\\0end\", dataField = \"\\xff\\x00\",\n"
+      "    enumField = garply, structField = (),\n"
+      "    float32List = [nan, inf, 1.5e3, -2], structList = [(int8Field = 1), ()],\n"
+      "    textList = [\"]\", \"#\"], voidList = [void, void], boolList = [] )  "),
+      builder, Schema::from<TestAllTypes>()).as<TestAllTypes>();
+
+  EXPECT_EQ(-128, root.getInt8Field());
+  EXPECT_EQ(0x7fff, root.getInt16Field());
+  EXPECT_EQ(15, root.getInt32Field());
+  EXPECT_EQ(18446744073709551615ull, root.getUInt64Field());
+  EXPECT_EQ(int64_t(kj::minValue), root.getInt64Field());
+  EXPECT_EQ(25, root.getFloat32Field());
+  EXPECT_EQ(-kj::inf(), root.getFloat64Field());
+  EXPECT_EQ(kj::StringPtr("a\"\\\aAA\0end", 10), root.getTextField());
+  EXPECT_EQ(Data::Reader(reinterpret_cast<const byte*>("\xff\x00"), 2), root.getDataField());
+  EXPECT_EQ(TestEnum::GARPLY, root.getEnumField());
+  EXPECT_TRUE(root.hasStructField());
+
+  auto floats = root.getFloat32List();
+  ASSERT_EQ(4u, floats.size());
+  EXPECT_TRUE(floats[0] != floats[0]);
+  EXPECT_EQ(kj::inf(), floats[1]);
+  EXPECT_EQ(1500, floats[2]);
+  EXPECT_EQ(-2, floats[3]);
+
+  ASSERT_EQ(2u, root.getStructList().size());
+  EXPECT_EQ(1, root.getStructList()[0].getInt8Field());
+  ASSERT_EQ(2u, root.getTextList().size());
+  EXPECT_EQ("]", root.getTextList()[0]);
+  EXPECT_EQ("#", root.getTextList()[1]);
+  EXPECT_EQ(2u, root.getVoidList().size());
+  EXPECT_TRUE(root.hasBoolList());
+  EXPECT_EQ(0u, root.getBoolList().size());
+}
+
+TEST(TextParser, Sequence) {
+  TextParser parser(kj::StringPtr("(int32Field = 1)\n(int32Field = 2) # done\n"));
+
+  for (int i = 1; i <= 2; i++) {
+    ASSERT_FALSE(parser.atEnd());
+    MallocMessageBuilder builder;
+    parser.parseStruct(builder.initRoot<DynamicStruct>(Schema::from<TestAllTypes>()));
+    EXPECT_EQ(i, builder.getRoot<TestAllTypes>().getInt32Field());
+  }
+  EXPECT_TRUE(parser.atEnd());
+}
+
+void expectError(kj::StringPtr input, kj::StringPtr expectedMessage, size_t expectedPosition) {
+  TextParser parser(input);
+  MallocMessageBuilder builder;
+  auto root = builder.initRoot<DynamicStruct>(Schema::from<TestAllTypes>());
+
+  KJ_IF_MAYBE(e, kj::runCatchingExceptions([&]() { parser.parseStruct(root); })) {
+    EXPECT_EQ(kj::str("1:", expectedPosition + 1, ": ", expectedMessage), e->getDescription())
+        << input.cStr();
+    EXPECT_EQ(expectedPosition, parser.getPosition()) << input.cStr();
+  } else {
+    ADD_FAILURE() << "Expected error: " << input.cStr();
+  }
+}
+
+TEST(TextParser, Errors) {
+  expectError("(int8Field = 128)", "Integer value out of range.", 13);
+  expectError("(uInt8Field = -1)", "Integer value out of range.", 14);
+  expectError("(int32Field = 1.5)", "Type mismatch; expected Int32.", 14);
+  expectError("(int32Field = 12a)", "Invalid number.", 16);
+  expectError("(int32Field = 018)", "Invalid octal digit.", 16);
+  expectError("(uInt64Field = 18446744073709551616)", "Integer is too big.", 35);
+  expectError("(noSuchField = 1)", "Struct has no field named 'noSuchField'.", 1);
+  expectError("(enumField = nope)", "Not defined: nope", 13);
+  expectError("(textField = \"abc)", "Unterminated string.", 18);
+  expectError("(textField = \"\\q\")", "Invalid escape sequence.", 15);
+  expectError("(boolField = yes)", "Expected true or false.", 13);
+  expectError("(structField = 1)", "Type mismatch; expected struct.", 15);
+  expectError("(int32List = [1, 2)", "Expected ']'.", 18);
+  expectError("(int32Field = 1", "Expected ')'.", 15);
+  expectError("(structList = [(int32Field = 1]])", "Expected ')'.", 30);
+}
+
+TEST(TextParser, NestingLimit) {
+  auto nestedStructs = [](uint depth) {
+    kj::Vector<char> text;
+    for (uint i = 0; i < depth; i++) text.addAll(kj::StringPtr("(structField = "));
+    text.addAll(kj::StringPtr("()"));
+    for (uint i = 0; i < depth; i++) text.add(')');
+    return text.releaseAsArray();
+  };
+
+  MallocMessageBuilder builder;
+  auto root = builder.initRoot<DynamicStruct>(Schema::from<TestAllTypes>());
+  {
+    auto text = nestedStructs(9);
+    TextParser parser(text, 10);
+    parser.parseStruct(root);
+  }
+  {
+    auto text = nestedStructs(10);
+    TextParser parser(text, 10);
+    EXPECT_ANY_THROW(parser.parseStruct(root));
+  }
+}
+
+TEST(TextParser, ErrorLocation) {
+  TextParser parser("(int8Field = 1,\n # comment\n  int16Field = 12a)");
+  MallocMessageBuilder builder;
+  auto root = builder.initRoot<DynamicStruct>(Schema::from<TestAllTypes>());
+
+  KJ_IF_MAYBE(e, kj::runCatchingExceptions([&]() { parser.parseStruct(root); })) {
+    EXPECT_EQ("3:18: Invalid number.", e->getDescription());
+  } else {
+    ADD_FAILURE() << "Expected error.";
+  }
+}
+
+}  // namespace
+}  // namespace _ (private)
+}  // namespace capnp
@@ -0,0 +1,403 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "text-parser.h"
+#include <kj/debug.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace capnp {
+
+namespace {
+
+inline bool isIdentifierStart(char c) {
+  return ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || c == '_';
+}
+
+inline bool isIdentifierChar(char c) {
+  return isIdentifierStart(c) || ('0' <= c && c <= '9');
+}
+
+inline int hexDigitValue(char c) {
+  if ('0' <= c && c <= '9') return c - '0';
+  if ('a' <= c && c <= 'f') return c - 'a' + 10;
+  if ('A' <= c && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+const char* primitiveTypeName(schema::Type::Which which) {
+  switch (which) {
+    case schema::Type::VOID: return "Void";
+    case schema::Type::BOOL: return "Bool";
+    case schema::Type::INT8: return "Int8";
+    case schema::Type::INT16: return "Int16";
+    case schema::Type::INT32: return "Int32";
+    case schema::Type::INT64: return "Int64";
+    case schema::Type::UINT8: return "UInt8";
+    case schema::Type::UINT16: return "UInt16";
+    case schema::Type::UINT32: return "UInt32";
+    case schema::Type::UINT64: return "UInt64";
+    case schema::Type::FLOAT32: return "Float32";
+    case schema::Type::FLOAT64: return "Float64";
+    case schema::Type::TEXT: return "Text";
+    case schema::Type::DATA: return "Data";
+    case schema::Type::LIST: return "List";
+    case schema::Type::ENUM: return "enum";
+    case schema::Type::STRUCT: return "struct";
+    case schema::Type::INTERFACE: return "interface";
+    case schema::Type::ANY_POINTER: return "AnyPointer";
+  }
+  return "(unknown)";
+}
+
+}  // namespace
+
+TextParser::TextParser(kj::ArrayPtr<const char> input, uint nestingLimit)
+    : TextScanner(input, Dialect::TEXT, nestingLimit) {}
+
+// -----------------------------------------------------------------------------------------------
+// Tokens
+
+kj::StringPtr TextParser::parseIdentifier() {
+  // Returns a pointer into `scratch`, valid until the next call.
+
+  skipWhitespace();
+  const char* start = pos;
+  if (pos < end && isIdentifierStart(*pos)) {
+    ++pos;
+    while (pos < end && isIdentifierChar(*pos)) ++pos;
+  } else {
+    fail("Expected identifier.");
+  }
+
+  scratch.resize(0);
+  scratch.addAll(start, pos);
+  scratch.add('\0');
+  return kj::StringPtr(scratch.begin(), scratch.size() - 1);
+}
+
+DynamicValue::Reader TextParser::parseNumber() {
+  // Returns an INT (if negative), UINT, or FLOAT value.
+
+  bool negative = tryConsume('-');
+  if (negative) {
+    if (tryConsumeWord("inf")) return -kj::inf();
+    skipWhitespace();
+  }
+
+  const char* start = pos;
+  if (pos == end || *pos < '0' || *pos > '9') fail("Expected number.");
+
+  uint64_t value = 0;
+  bool overflow = false;
+  if (end - pos > 1 && pos[0] == '0' && pos[1] == 'x') {
+    pos += 2;
+    int digit;
+    while (pos < end && (digit = hexDigitValue(*pos)) >= 0) {
+      overflow = overflow || value > (uint64_t(kj::maxValue) >> 4);
+      value = (value << 4) | digit;
+      ++pos;
+    }
+  } else {
+    while (pos < end && '0' <= *pos && *pos <= '9') ++pos;
+
+    if (pos < end && (*pos == '.' || *pos == 'e' || *pos == 'E')) {
+      // Floating-point.
+      if (*pos == '.') {
+        ++pos;
+        while (pos < end && '0' <= *pos && *pos <= '9') ++pos;
+      }
+      if (pos < end && (*pos == 'e' || *pos == 'E')) {
+        ++pos;
+        if (pos < end && (*pos == '+' || *pos == '-')) ++pos;
+        while (pos < end && '0' <= *pos && *pos <= '9') ++pos;
+      }
+      if (pos < end && (isIdentifierChar(*pos) || *pos == '.')) fail("Invalid number.");
+
+      char buffer[64];
+      size_t size = pos - start;
+      if (size >= sizeof(buffer)) fail("Number is too long.");
+      memcpy(buffer, start, size);
+      buffer[size] = '\0';
+      double result = strtod(buffer, nullptr);
+      return negative ? -result : result;
+    }
+
+    uint base = start[0] == '0' ? 8 : 10;
+    for (const char* p = start; p < pos; ++p) {
+      uint digit = *p - '0';
+      if (digit >= base) {
+        pos = p;
+        fail("Invalid octal digit.");
+      }
+      overflow = overflow || value > (uint64_t(kj::maxValue) - digit) / base;
+      value = value * base + digit;
+    }
+  }
+
+  if (pos < end && (isIdentifierChar(*pos) || *pos == '.')) fail("Invalid number.");
+  if (overflow) fail("Integer is too big.");
+
+  if (negative) {
+    if (value > (uint64_t(kj::maxValue) >> 1) + 1) fail("Integer is too big to be negative.");
+    return -static_cast<int64_t>(value - 1) - 1;
+  } else {
+    return value;
+  }
+}
+
+DynamicValue::Reader TextParser::parsePrimitive(schema::Type::Which which) {
+  switch (which) {
+    case schema::Type::VOID:
+      if (!tryConsumeWord("void")) fail("Expected void.");
+      return VOID;
+
+    case schema::Type::BOOL:
+      if (tryConsumeWord("true")) return true;
+      if (tryConsumeWord("false")) return false;
+      fail("Expected true or false.");
+
+    case schema::Type::FLOAT32:
+    case schema::Type::FLOAT64: {
+      if (tryConsumeWord("inf")) return kj::inf();
+      if (tryConsumeWord("nan")) return kj::nan();
+      auto value = parseNumber();
+      switch (value.getType()) {
+        case DynamicValue::INT: return static_cast<double>(value.as<int64_t>());
+        case DynamicValue::UINT: return static_cast<double>(value.as<uint64_t>());
+        default: return value;
+      }
+    }
+
+    default:
+      break;
+  }
+
+  // Integer.
+  const char* start = pos;
+  auto value = parseNumber();
+  if (value.getType() == DynamicValue::FLOAT) {
+    pos = start;
+    fail(kj::str("Type mismatch; expected ", primitiveTypeName(which), "."));
+  }
+
+  int64_t minValue = 0;
+  uint64_t maxValue = 0;
+  switch (which) {
+    case schema::Type::INT8: minValue = (int8_t)kj::minValue; maxValue = (int8_t)kj::maxValue; break;
+    case schema::Type::INT16: minValue = (int16_t)kj::minValue; maxValue = (int16_t)kj::maxValue; break;
+    case schema::Type::INT32: minValue = (int32_t)kj::minValue; maxValue = (int32_t)kj::maxValue; break;
+    case schema::Type::INT64: minValue = (int64_t)kj::minValue; maxValue = (int64_t)kj::maxValue; break;
+    case schema::Type::UINT8: maxValue = (uint8_t)kj::maxValue; break;
+    case schema::Type::UINT16: maxValue = (uint16_t)kj::maxValue; break;
+    case schema::Type::UINT32: maxValue = (uint32_t)kj::maxValue; break;
+    case schema::Type::UINT64: maxValue = (uint64_t)kj::maxValue; break;
+    default:
+      pos = start;
+      fail(kj::str("Type mismatch; expected ", primitiveTypeName(which), "."));
+  }
+
+  if (value.getType() == DynamicValue::INT ? value.as<int64_t>() < minValue
+                                           : value.as<uint64_t>() > maxValue) {
+    pos = start;
+    fail("Integer value out of range.");
+  }
+  return value;
+}
+
+DynamicEnum TextParser::parseEnum(EnumSchema schema) {
+  const char* start = pos;
+  auto name = parseIdentifier();
+  KJ_IF_MAYBE(enumerant, schema.findEnumerantByName(name)) {
+    return DynamicEnum(*enumerant);
+  } else {
+    pos = start;
+    fail(kj::str("Not defined: ", name));
+  }
+}
+
+// -----------------------------------------------------------------------------------------------
+// Values
+
+void TextParser::parseStruct(DynamicStruct::Builder builder) {
+  Nested nested(*this);
+  expect('(');
+  if (tryConsume(')')) return;
+
+  StructSchema schema = builder.getSchema();
+  do {
+    skipWhitespace();
+    const char* start = pos;
+    auto name = parseIdentifier();
+    KJ_IF_MAYBE(field, schema.findFieldByName(name)) {
+      expect('=');
+      parseField(builder, *field);
+    } else {
+      pos = start;
+      fail(kj::str("Struct has no field named '", name, "'."));
+    }
+  } while (tryConsume(','));
+  expect(')');
+}
+
+void TextParser::parseField(DynamicStruct::Builder builder, StructSchema::Field field) {
+  auto proto = field.getProto();
+  switch (proto.which()) {
+    case schema::Field::SLOT:
+      break;
+    case schema::Field::GROUP:
+      skipWhitespace();
+      if (peek() != '(') fail("Type mismatch; expected group.");
+      parseStruct(builder.init(field).as<DynamicStruct>());
+      return;
+  }
+
+  skipWhitespace();
+  auto type = proto.getSlot().getType();
+  switch (type.which()) {
+    case schema::Type::VOID:
+    case schema::Type::BOOL:
+    case schema::Type::INT8:
+    case schema::Type::INT16:
+    case schema::Type::INT32:
+    case schema::Type::INT64:
+    case schema::Type::UINT8:
+    case schema::Type::UINT16:
+    case schema::Type::UINT32:
+    case schema::Type::UINT64:
+    case schema::Type::FLOAT32:
+    case schema::Type::FLOAT64:
+      builder.set(field, parsePrimitive(type.which()));
+      return;
+
+    case schema::Type::ENUM:
+      builder.set(field, parseEnum(
+          builder.getSchema().getDependency(type.getEnum().getTypeId()).asEnum()));
+      return;
+
+    case schema::Type::TEXT:
+      builder.set(field, Text::Reader(parseString()));
+      return;
+
+    case schema::Type::DATA: {
+      auto text = parseString();
+      builder.set(field, Data::Reader(reinterpret_cast<const byte*>(text.begin()), text.size()));
+      return;
+    }
+
+    case schema::Type::LIST:
+      if (peek() != '[') fail("Type mismatch; expected List.");
+      parseList(builder.init(field, countElements()).as<DynamicList>());
+      return;
+
+    case schema::Type::STRUCT:
+      if (peek() != '(') fail("Type mismatch; expected struct.");
+      parseStruct(builder.init(field).as<DynamicStruct>());
+      return;
+
+    case schema::Type::INTERFACE:
+    case schema::Type::ANY_POINTER:
+      fail(kj::str("Type mismatch; ", primitiveTypeName(type.which()),
+                   " fields can't have literal values."));
+  }
+
+  fail("Unknown field type.");
+}
+
+void TextParser::parseList(DynamicList::Builder builder) {
+  Nested nested(*this);
+  auto schema = builder.getSchema();
+  auto which = schema.whichElementType();
+
+  expect('[');
+  for (uint i = 0; i < builder.size(); i++) {
+    if (i > 0) expect(',');
+    skipWhitespace();
+
+    switch (which) {
+      case schema::Type::VOID:
+      case schema::Type::BOOL:
+      case schema::Type::INT8:
+      case schema::Type::INT16:
+      case schema::Type::INT32:
+      case schema::Type::INT64:
+      case schema::Type::UINT8:
+      case schema::Type::UINT16:
+      case schema::Type::UINT32:
+      case schema::Type::UINT64:
+      case schema::Type::FLOAT32:
+      case schema::Type::FLOAT64:
+        builder.set(i, parsePrimitive(which));
+        break;
+
+      case schema::Type::ENUM:
+        builder.set(i, parseEnum(schema.getEnumElementType()));
+        break;
+
+      case schema::Type::TEXT:
+        builder.set(i, Text::Reader(parseString()));
+        break;
+
+      case schema::Type::DATA: {
+        auto text = parseString();
+        builder.set(i, Data::Reader(reinterpret_cast<const byte*>(text.begin()), text.size()));
+        break;
+      }
+
+      case schema::Type::LIST:
+        if (peek() != '[') fail("Type mismatch; expected List.");
+        parseList(builder.init(i, countElements()).as<DynamicList>());
+        break;
+
+      case schema::Type::STRUCT:
+        if (peek() != '(') fail("Type mismatch; expected struct.");
+        parseStruct(builder[i].as<DynamicStruct>());
+        break;
+
+      case schema::Type::INTERFACE:
+      case schema::Type::ANY_POINTER:
+        fail(kj::str("Type mismatch; ", primitiveTypeName(which),
+                     " lists can't have literal values."));
+    }
+  }
+  expect(']');
+}
+
+// -----------------------------------------------------------------------------------------------
+
+void readText(kj::ArrayPtr<const char> input, DynamicStruct::Builder output) {
+  TextParser parser(input);
+  parser.parseStruct(output);
+  if (!parser.atEnd()) {
+    KJ_FAIL_REQUIRE("Unexpected text after struct value.", parser.getPosition());
+  }
+}
+
+DynamicStruct::Builder readText(kj::ArrayPtr<const char> input, MessageBuilder& message,
+                                StructSchema schema) {
+  auto root = message.initRoot<DynamicStruct>(schema);
+  readText(input, root);
+  return root;
+}
+
+}  // namespace capnp
@@ -0,0 +1,83 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef CAPNP_TEXT_PARSER_H_
+#define CAPNP_TEXT_PARSER_H_
+
+#include "dynamic.h"
+#include "text-scanner.h"
+
+namespace capnp {
+
+class TextParser: private _::TextScanner {
+  // Parses Cap'n Proto text format -- the format written by prettyPrint(), kj::str(), and
+  // writeText(), which is also the syntax of struct literals in the schema language -- directly
+  // into message builders, in a single pass and without tokenizing the input first.
+  //
+  // The accepted values are literals: numbers (decimal, hex, octal, and floating-point, plus
+  // `inf`, `-inf`, and `nan`), `true`, `false`, `void`, enumerant names, quoted strings (for both
+  // Text and Data), bracketed lists, and parenthesized struct literals with named fields.  `#`
+  // starts a comment which runs to the end of the line.  References to constants are not
+  // supported, since there is no schema file to resolve them against.
+  //
+  // Lists are allocated at their final size, so parsing does not waste space in the message.
+
+public:
+  explicit TextParser(kj::ArrayPtr<const char> input,
+                      uint nestingLimit = DEFAULT_NESTING_LIMIT);
+  // Lists and structs may nest at most `nestingLimit` deep, like ReaderOptions::nestingLimit.
+
+  using TextScanner::atEnd;
+  // Skips whitespace and comments, then returns true if there is no more input.
+
+  void parseStruct(DynamicStruct::Builder builder);
+  // Parses one parenthesized struct literal, like `(foo = 123, bar = "baz")`, into `builder`.
+  // Call repeatedly (until atEnd()) to parse a sequence of values.  Throws an exception if the
+  // input is malformed or does not fit the schema.  The exception's description starts with the
+  // line and column of the problem, as in "3:14: Invalid number.", and getPosition() then points
+  // at it.
+
+  using TextScanner::getPosition;
+  // Byte offset of the next character to be parsed.
+
+private:
+  kj::StringPtr parseIdentifier();
+  DynamicValue::Reader parseNumber();
+  DynamicValue::Reader parsePrimitive(schema::Type::Which which);
+  DynamicEnum parseEnum(EnumSchema schema);
+
+  void parseField(DynamicStruct::Builder builder, StructSchema::Field field);
+  void parseList(DynamicList::Builder builder);
+};
+
+void readText(kj::ArrayPtr<const char> input, DynamicStruct::Builder output);
+// Parse a single struct literal into `output`.  Throws an exception if the input is malformed,
+// does not fit the schema, or contains anything after the value.
+
+DynamicStruct::Builder readText(kj::ArrayPtr<const char> input, MessageBuilder& message,
+                                StructSchema schema);
+// Initialize the root of `message` as `schema` and parse `input` into it.
+
+}  // namespace capnp
+
+#endif  // CAPNP_TEXT_PARSER_H_
@@ -0,0 +1,371 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "text-scanner.h"
+#include <kj/debug.h>
+#include <string.h>
+
+namespace capnp {
+namespace _ {  // private
+
+namespace {
+
+inline bool isIdentifierChar(char c) {
+  return ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || c == '_' || ('0' <= c && c <= '9');
+}
+
+inline bool isWhitespace(char c, TextScanner::Dialect dialect) {
+  switch (c) {
+    case ' ': case '\t': case '\n': case '\r':
+      return true;
+    case '\f': case '\v':
+      return dialect == TextScanner::Dialect::TEXT;
+    default:
+      return false;
+  }
+}
+
+inline int hexDigitValue(char c) {
+  if ('0' <= c && c <= '9') return c - '0';
+  if ('a' <= c && c <= 'f') return c - 'a' + 10;
+  if ('A' <= c && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+}  // namespace
+
+constexpr uint TextScanner::DEFAULT_NESTING_LIMIT;
+
+TextScanner::TextScanner(kj::ArrayPtr<const char> input, Dialect dialect, uint nestingLimit)
+    : begin(input.begin()), pos(input.begin()), end(input.end()), dialect(dialect),
+      remainingNesting(nestingLimit) {}
+
+TextScanner::Nested::Nested(TextScanner& scanner): scanner(scanner) {
+  if (scanner.remainingNesting == 0) {
+    scanner.fail("Exceeded nesting limit.");
+  }
+  --scanner.remainingNesting;
+}
+
+void TextScanner::fail(kj::StringPtr problem) {
+  const char* location = kj::min(pos, end);
+  uint line = 1;
+  const char* lineStart = begin;
+  for (const char* p = begin; p < location; ++p) {
+    if (*p == '\n') {
+      ++line;
+      lineStart = p + 1;
+    }
+  }
+
+  kj::throwFatalException(kj::Exception(
+      kj::Exception::Nature::PRECONDITION, kj::Exception::Durability::PERMANENT,
+      __FILE__, __LINE__, kj::str(line, ':', location - lineStart + 1, ": ", problem)));
+}
+
+void TextScanner::skipWhitespace() {
+  while (pos < end) {
+    if (isWhitespace(*pos, dialect)) {
+      ++pos;
+    } else if (*pos == '#' && dialect == Dialect::TEXT) {
+      while (pos < end && *pos != '\n') ++pos;
+    } else {
+      return;
+    }
+  }
+}
+
+bool TextScanner::atEnd() {
+  skipWhitespace();
+  return pos == end;
+}
+
+void TextScanner::expect(char c) {
+  skipWhitespace();
+  if (peek() != c) {
+    char problem[] = "Expected 'x'.";
+    problem[10] = c;
+    fail(problem);
+  }
+  ++pos;
+}
+
+bool TextScanner::tryConsume(char c) {
+  skipWhitespace();
+  if (peek() == c) {
+    ++pos;
+    return true;
+  } else {
+    return false;
+  }
+}
+
+bool TextScanner::tryConsumeWord(kj::StringPtr word) {
+  skipWhitespace();
+  if (size_t(end - pos) >= word.size() && memcmp(pos, word.begin(), word.size()) == 0 &&
+      (size_t(end - pos) == word.size() || !isIdentifierChar(pos[word.size()]))) {
+    pos += word.size();
+    return true;
+  } else {
+    return false;
+  }
+}
+
+// -----------------------------------------------------------------------------------------------
+// Strings
+
+kj::StringPtr TextScanner::parseString() {
+  expect('"');
+  scratch.resize(0);
+
+  bool newlineEndsString = dialect == Dialect::TEXT;
+  for (;;) {
+    const char* runStart = pos;
+    while (pos < end && *pos != '"' && *pos != '\\' && !(newlineEndsString && *pos == '\n')) {
+      ++pos;
+    }
+    scratch.addAll(runStart, pos);
+
+    if (pos == end || *pos == '\n') fail("Unterminated string.");
+    if (*pos++ == '"') break;
+
+    if (pos == end) fail("Unterminated string.");
+    switch (dialect) {
+      case Dialect::JSON: parseJsonEscape(); break;
+      case Dialect::TEXT: parseTextEscape(); break;
+    }
+  }
+
+  scratch.add('\0');
+  return kj::StringPtr(scratch.begin(), scratch.size() - 1);
+}
+
+void TextScanner::skipString() {
+  ++pos;  // opening quote
+  while (pos < end) {
+    char c = *pos++;
+    if (c == '"') return;
+    if (c == '\n' && dialect == Dialect::TEXT) break;
+    if (c == '\\') ++pos;
+  }
+  fail("Unterminated string.");
+}
+
+uint TextScanner::parseHexQuad() {
+  if (end - pos < 4) fail("Invalid unicode escape.");
+  uint result = 0;
+  for (uint i = 0; i < 4; i++) {
+    int digit = hexDigitValue(*pos++);
+    if (digit < 0) fail("Invalid unicode escape.");
+    result = (result << 4) | digit;
+  }
+  return result;
+}
+
+void TextScanner::parseJsonEscape() {
+  // Handles the character(s) after a backslash in a JSON string.
+
+  switch (char c = *pos++) {
+    case '"': case '\\': case '/': scratch.add(c); return;
+    case 'b': scratch.add('\b'); return;
+    case 'f': scratch.add('\f'); return;
+    case 'n': scratch.add('\n'); return;
+    case 'r': scratch.add('\r'); return;
+    case 't': scratch.add('\t'); return;
+    case 'u': break;
+    default:
+      --pos;
+      fail("Invalid escape sequence.");
+  }
+
+  uint codePoint = parseHexQuad();
+  if (0xd800 <= codePoint && codePoint < 0xdc00 &&
+      end - pos >= 6 && pos[0] == '\\' && pos[1] == 'u') {
+    // Possibly a surrogate pair.
+    const char* save = pos;
+    pos += 2;
+    uint low = parseHexQuad();
+    if (0xdc00 <= low && low < 0xe000) {
+      codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (low - 0xdc00);
+    } else {
+      pos = save;
+    }
+  }
+
+  // Encode as UTF-8.
+  if (codePoint < 0x80) {
+    scratch.add(codePoint);
+  } else if (codePoint < 0x800) {
+    scratch.add(0xc0 | (codePoint >> 6));
+    scratch.add(0x80 | (codePoint & 0x3f));
+  } else if (codePoint < 0x10000) {
+    scratch.add(0xe0 | (codePoint >> 12));
+    scratch.add(0x80 | ((codePoint >> 6) & 0x3f));
+    scratch.add(0x80 | (codePoint & 0x3f));
+  } else {
+    scratch.add(0xf0 | (codePoint >> 18));
+    scratch.add(0x80 | ((codePoint >> 12) & 0x3f));
+    scratch.add(0x80 | ((codePoint >> 6) & 0x3f));
+    scratch.add(0x80 | (codePoint & 0x3f));
+  }
+}
+
+void TextScanner::parseTextEscape() {
+  // Handles the character(s) after a backslash, with the same escapes as the schema language.
+
+  switch (char c = *pos++) {
+    case 'a': scratch.add('\a'); break;
+    case 'b': scratch.add('\b'); break;
+    case 'f': scratch.add('\f'); break;
+    case 'n': scratch.add('\n'); break;
+    case 'r': scratch.add('\r'); break;
+    case 't': scratch.add('\t'); break;
+    case 'v': scratch.add('\v'); break;
+    case '\'': case '\"': case '\\': case '?': scratch.add(c); break;
+
+    case 'x': {
+      int high = end - pos >= 2 ? hexDigitValue(pos[0]) : -1;
+      int low = high >= 0 ? hexDigitValue(pos[1]) : -1;
+      if (low < 0) fail("Invalid hex escape.");
+      scratch.add((high << 4) | low);
+      pos += 2;
+      break;
+    }
+
+    case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7': {
+      uint value = c - '0';
+      for (uint i = 0; i < 2 && pos < end && '0' <= *pos && *pos <= '7'; i++) {
+        value = value * 8 + (*pos++ - '0');
+      }
+      scratch.add(value);
+      break;
+    }
+
+    default:
+      --pos;
+      fail("Invalid escape sequence.");
+  }
+}
+
+// -----------------------------------------------------------------------------------------------
+// Lookahead
+
+void TextScanner::skipValue() {
+  skipWhitespace();
+  char structOpen = dialect == Dialect::JSON ? '{' : '(';
+  char structClose = dialect == Dialect::JSON ? '}' : ')';
+
+  char c = peek();
+  if (c == '"') {
+    skipString();
+  } else if (c == '[' || c == structOpen) {
+    scanGroup(false);
+  } else {
+    // Number or bare word.
+    const char* start = pos;
+    while (pos < end && *pos != ',' && *pos != ']' && *pos != structClose &&
+           !isWhitespace(*pos, dialect)) {
+      ++pos;
+    }
+    if (pos == start) fail("Expected value.");
+  }
+}
+
+uint TextScanner::countElements() {
+  skipWhitespace();
+  auto iter = listSizes.find(pos);
+  if (iter != listSizes.end()) {
+    uint result = iter->second;
+    listSizes.erase(iter);
+    return result;
+  }
+
+  if (peek() != '[') fail("Expected '['.");
+  const char* start = pos;
+  uint result = scanGroup(true);
+  pos = start;
+  return result;
+}
+
+uint TextScanner::scanGroup(bool recordListSizes) {
+  // Skips the list or struct starting at `pos`, checking that its brackets match and that it
+  // doesn't nest too deeply.  Returns its number of elements (or fields), which is zero if it is
+  // empty and otherwise one more than the number of top-level commas.  With `recordListSizes`,
+  // also fills in `listSizes` for each list nested inside it.
+  //
+  // This doesn't otherwise validate the contents, which will be parsed properly later (or are
+  // being discarded).  Only strings and comments need care, since they may contain brackets.
+
+  char structOpen = dialect == Dialect::JSON ? '{' : '(';
+  char structClose = dialect == Dialect::JSON ? '}' : ')';
+
+  groups.resize(0);
+  for (;;) {
+    if (pos == end) {
+      fail(dialect == Dialect::JSON ? "Unterminated object or array." :
+                                      "Unterminated list or struct.");
+    }
+
+    char c = *pos;
+    if (c == '"') {
+      groups.back().empty = false;
+      skipString();
+      continue;
+    } else if (c == '#' && dialect == Dialect::TEXT) {
+      skipWhitespace();
+      continue;
+    } else if (c == '[' || c == structOpen) {
+      if (groups.size() > 0) {
+        groups.back().empty = false;
+      }
+      if (groups.size() >= remainingNesting) {
+        fail("Exceeded nesting limit.");
+      }
+      groups.add(Group { c == '[' ? ']' : structClose, pos, 0, true });
+    } else if (c == ']' || c == structClose) {
+      Group& group = groups.back();
+      if (c != group.closer) {
+        char problem[] = "Expected 'x'.";
+        problem[10] = group.closer;
+        fail(problem);
+      }
+      uint count = group.empty ? 0 : group.commas + 1;
+      if (groups.size() == 1) {
+        ++pos;
+        return count;
+      }
+      if (recordListSizes && group.closer == ']') {
+        listSizes[group.start] = count;
+      }
+      groups.removeLast();
+    } else if (c == ',') {
+      ++groups.back().commas;
+    } else if (!isWhitespace(c, dialect)) {
+      groups.back().empty = false;
+    }
+    ++pos;
+  }
+}
+
+}  // namespace _ (private)
+}  // namespace capnp
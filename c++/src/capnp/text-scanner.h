@@ -0,0 +1,137 @@
+// Copyright (c) 2013, Kenton Varda <temporal@gmail.com>
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef CAPNP_TEXT_SCANNER_H_
+#define CAPNP_TEXT_SCANNER_H_
+
+#include "common.h"
+#include <kj/string.h>
+#include <kj/vector.h>
+#include <unordered_map>
+
+namespace capnp {
+namespace _ {  // private
+
+class TextScanner {
+  // Lexical scanning shared by the JSON parser (json.c++) and the text-format parser
+  // (text-parser.c++).  Both formats are made of bracketed lists and structs, quoted strings, and
+  // bare words, and both parsers work directly on the input without tokenizing it first; they
+  // differ only in the details selected by `Dialect`.
+
+public:
+  enum class Dialect {
+    JSON,
+    // Structs are `{...}`.  Strings use JSON escapes and may span lines.  No comments.
+
+    TEXT
+    // Structs are `(...)`.  Strings use the schema language's escapes and end at a newline.
+    // `#` starts a comment which runs to the end of the line.
+  };
+
+  static constexpr uint DEFAULT_NESTING_LIMIT = 64;
+  // Same as ReaderOptions::nestingLimit.
+
+  TextScanner(kj::ArrayPtr<const char> input, Dialect dialect,
+              uint nestingLimit = DEFAULT_NESTING_LIMIT);
+  KJ_DISALLOW_COPY(TextScanner);
+
+  inline size_t getPosition() const { return pos - begin; }
+  // Byte offset of the next character to be parsed.
+
+  bool atEnd();
+  // Skips whitespace (and comments), then returns true if there is no more input.
+
+  void fail(kj::StringPtr problem) KJ_NORETURN;
+  // Throws an exception whose description is `problem` prefixed with the 1-based line and column
+  // of `pos`, as in "3:14: Invalid number.".
+
+protected:
+  const char* begin;
+  const char* pos;
+  const char* end;
+  Dialect dialect;
+
+  kj::Vector<char> scratch;
+  // Holds the most recently parsed string.
+
+  class Nested {
+    // Construct one on the stack for each level of struct or list being parsed.  Fails if the
+    // input nests more deeply than the nesting limit, which would otherwise let hostile input
+    // overflow the parser's stack.
+
+  public:
+    explicit Nested(TextScanner& scanner);
+    inline ~Nested() { ++scanner.remainingNesting; }
+    KJ_DISALLOW_COPY(Nested);
+
+  private:
+    TextScanner& scanner;
+  };
+
+  inline char peek() const { return pos < end ? *pos : '\0'; }
+
+  void skipWhitespace();
+  void expect(char c);
+  bool tryConsume(char c);
+  bool tryConsumeWord(kj::StringPtr word);
+  // Consumes `word` if it comes next and is not just the start of a longer word.
+
+  kj::StringPtr parseString();
+  // Parses a quoted string, returning a pointer into `scratch` which is valid until the next call.
+
+  void skipValue();
+  // Skips a value without interpreting it.  Lists and structs are checked only for balanced
+  // brackets.
+
+  uint countElements();
+  // Counts the elements of the list starting at `pos`, without consuming it, so that the list can
+  // be allocated at its final size before it is parsed.
+
+private:
+  uint remainingNesting;
+
+  struct Group {
+    char closer;
+    const char* start;
+    uint commas;
+    bool empty;
+  };
+  kj::Vector<Group> groups;
+  // Stack of brackets opened by scanGroup().  Kept here only to reuse its space.
+
+  std::unordered_map<const char*, uint> listSizes;
+  // Element counts of lists nested inside lists that have already been counted, keyed by the
+  // position of their opening bracket.  Counting a list means scanning everything inside it, so
+  // remembering these makes counting linear in the input size rather than in size times depth.
+
+  uint scanGroup(bool recordListSizes);
+  void skipString();
+  void parseJsonEscape();
+  void parseTextEscape();
+  uint parseHexQuad();
+};
+
+}  // namespace _ (private)
+}  // namespace capnp
+
+#endif  // CAPNP_TEXT_SCANNER_H_
@@ -137,6 +137,7 @@ void* Arena::allocateBytesInternal(size_t amount, uint alignment) {
   }
 
   // Allocate.
+  countAllocation(nextChunkSize);
   byte* bytes = reinterpret_cast<byte*>(operator new(nextChunkSize));
 
   // Set up the ChunkHeader at the beginning of the allocation.
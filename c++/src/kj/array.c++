@@ -23,6 +23,7 @@
 
 #include "array.h"
 #include "exception.h"
+#include "memory.h"
 
 namespace kj {
 
@@ -73,6 +74,7 @@ struct AutoDeleter {
 void* HeapArrayDisposer::allocateImpl(size_t elementSize, size_t elementCount, size_t capacity,
                                       void (*constructElement)(void*),
                                       void (*destroyElement)(void*)) {
+  countAllocation(elementSize * capacity);
   AutoDeleter result(operator new(elementSize * capacity));
 
   if (constructElement == nullptr) {
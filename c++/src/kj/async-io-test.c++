@@ -141,6 +141,34 @@ TEST(AsyncIo, TwoWayPipe) {
   EXPECT_EQ("bar", result2);
 }
 
+TEST(AsyncIo, StreamStats) {
+  auto ioContext = setupAsyncIo();
+
+  auto pipe = ioContext.provider->newTwoWayPipe();
+  char receiveBuffer[16];
+
+  ArrayPtr<const byte> pieces[2] = {
+    arrayPtr(reinterpret_cast<const byte*>("foo"), 3),
+    arrayPtr(reinterpret_cast<const byte*>("bar"), 3)
+  };
+  pipe.ends[0]->write(pieces).wait(ioContext.waitScope);
+  pipe.ends[0]->write("baz", 3).wait(ioContext.waitScope);
+
+  EXPECT_EQ(9u, pipe.ends[1]->read(receiveBuffer, 9, sizeof(receiveBuffer))
+      .wait(ioContext.waitScope));
+  EXPECT_EQ("foobarbaz", heapString(receiveBuffer, 9));
+
+  auto writerStats = KJ_ASSERT_NONNULL(pipe.ends[0]->getStats());
+  EXPECT_EQ(9u, writerStats.bytesWritten);
+  EXPECT_EQ(2u, writerStats.writeCalls);
+  EXPECT_EQ(0u, writerStats.bytesRead);
+
+  auto readerStats = KJ_ASSERT_NONNULL(pipe.ends[1]->getStats());
+  EXPECT_EQ(9u, readerStats.bytesRead);
+  EXPECT_EQ(0u, readerStats.bytesWritten);
+  EXPECT_GE(readerStats.readCalls, 1u);
+}
+
 TEST(AsyncIo, PipeThread) {
   auto ioContext = setupAsyncIo();
 
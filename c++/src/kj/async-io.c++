@@ -39,6 +39,7 @@
 #include <stdlib.h>
 #include <arpa/inet.h>
 #include <netdb.h>
+#include <time.h>
 #include <set>
 
 #ifndef POLLRDHUP
@@ -66,6 +67,12 @@ void setCloseOnExec(int fd) {
   }
 }
 
+uint64_t monotonicNanos() {
+  struct timespec ts;
+  KJ_SYSCALL(clock_gettime(CLOCK_MONOTONIC, &ts));
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000u + ts.tv_nsec;
+}
+
 static constexpr uint NEW_FD_FLAGS =
 #if __linux__
     LowLevelAsyncIoProvider::ALREADY_CLOEXEC || LowLevelAsyncIoProvider::ALREADY_NONBLOCK ||
@@ -135,12 +142,14 @@ public:
 
   Promise<void> write(const void* buffer, size_t size) override {
     ssize_t writeResult;
+    ++stats.writeCalls;
     KJ_NONBLOCKING_SYSCALL(writeResult = ::write(fd, buffer, size)) {
       return READY_NOW;
     }
 
     // A negative result means EAGAIN, which we can treat the same as having written zero bytes.
     size_t n = writeResult < 0 ? 0 : writeResult;
+    stats.bytesWritten += n;
 
     if (n == size) {
       return READY_NOW;
@@ -149,7 +158,7 @@ public:
       size -= n;
     }
 
-    return eventPort.onFdEvent(fd, POLLOUT).then([=](short) {
+    return waitWritable().then([=]() {
       return write(buffer, size);
     });
   }
@@ -168,9 +177,27 @@ public:
     KJ_SYSCALL(shutdown(fd, SHUT_WR));
   }
 
+  Maybe<Stats> getStats() override {
+    return stats;
+  }
+
 private:
   UnixEventPort& eventPort;
   bool gotHup = false;
+  Stats stats;
+
+  Promise<void> waitWritable() {
+    ++stats.writeWaits;
+    uint64_t start = monotonicNanos();
+    return eventPort.onFdEvent(fd, POLLOUT).then([this,start](short) {
+      stats.writeWaitNanos += monotonicNanos() - start;
+    });
+  }
+
+  Promise<short> waitReadable() {
+    ++stats.readWaits;
+    return eventPort.onFdEvent(fd, POLLIN | POLLRDHUP);
+  }
 
   Promise<size_t> tryReadInternal(void* buffer, size_t minBytes, size_t maxBytes,
                                   size_t alreadyRead) {
@@ -179,13 +206,18 @@ private:
     // be included in the final return value.
 
     ssize_t n;
+    ++stats.readCalls;
     KJ_NONBLOCKING_SYSCALL(n = ::read(fd, buffer, maxBytes)) {
       return alreadyRead;
     }
 
+    if (n > 0) {
+      stats.bytesRead += n;
+    }
+
     if (n < 0) {
       // Read would block.
-      return eventPort.onFdEvent(fd, POLLIN | POLLRDHUP).then([=](short events) {
+      return waitReadable().then([=](short events) {
         gotHup = events & (POLLHUP | POLLRDHUP);
         return tryReadInternal(buffer, minBytes, maxBytes, alreadyRead);
       });
@@ -210,7 +242,7 @@ private:
         minBytes -= n;
         maxBytes -= n;
         alreadyRead += n;
-        return eventPort.onFdEvent(fd, POLLIN | POLLRDHUP).then([=](short events) {
+        return waitReadable().then([=](short events) {
           gotHup = events & (POLLHUP | POLLRDHUP);
           return tryReadInternal(buffer, minBytes, maxBytes, alreadyRead);
         });
@@ -234,6 +266,7 @@ private:
     }
 
     ssize_t writeResult;
+    ++stats.writeCalls;
     KJ_NONBLOCKING_SYSCALL(writeResult = ::writev(fd, iov.begin(), iov.size())) {
       // Error.
 
@@ -250,13 +283,14 @@ private:
 
     // A negative result means EAGAIN, which we can treat the same as having written zero bytes.
     size_t n = writeResult < 0 ? 0 : writeResult;
+    stats.bytesWritten += n;
 
     // Discard all data that was written, then issue a new write for what's left (if any).
     for (;;) {
       if (n < firstPiece.size()) {
         // Only part of the first piece was consumed.  Wait for POLLOUT and then write again.
         firstPiece = firstPiece.slice(n, firstPiece.size());
-        return eventPort.onFdEvent(fd, POLLOUT).then([=](short) {
+        return waitWritable().then([=]() {
           return writeInternal(firstPiece, morePieces);
         });
       } else if (morePieces.size() == 0) {
@@ -955,6 +989,10 @@ Promise<void> AsyncInputStream::read(void* buffer, size_t bytes) {
   return read(buffer, bytes, bytes).then([](size_t) {});
 }
 
+Maybe<AsyncIoStream::Stats> AsyncIoStream::getStats() {
+  return nullptr;
+}
+
 Own<AsyncIoProvider> newAsyncIoProvider(LowLevelAsyncIoProvider& lowLevel) {
   return kj::heap<AsyncIoProviderImpl>(lowLevel);
 }
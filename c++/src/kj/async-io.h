@@ -27,6 +27,7 @@
 #include "async.h"
 #include "function.h"
 #include "thread.h"
+#include <inttypes.h>
 
 namespace kj {
 
@@ -54,6 +55,29 @@ class AsyncIoStream: public AsyncInputStream, public AsyncOutputStream {
 public:
   virtual void shutdownWrite() = 0;
   // Cleanly shut down just the write end of the stream, while keeping the read end open.
+
+  struct Stats {
+    // Counters describing the traffic on a stream since it was created.
+
+    uint64_t bytesRead = 0;
+    uint64_t bytesWritten = 0;
+
+    uint64_t readCalls = 0;
+    uint64_t writeCalls = 0;
+    // Number of read or write system calls (including writev()) made.
+
+    uint64_t readWaits = 0;
+    uint64_t writeWaits = 0;
+    // Number of times the stream had to wait for the OS to report it readable or writable.  A
+    // high `writeWaits` means the peer is not consuming data as fast as we produce it.
+
+    uint64_t writeWaitNanos = 0;
+    // Total time spent waiting for the stream to become writable, in nanoseconds.
+  };
+
+  virtual Maybe<Stats> getStats();
+  // Returns traffic statistics, if the implementation keeps them.  The default implementation
+  // returns null.  Call only from the thread that owns the stream.
 };
 
 class ConnectionReceiver {
@@ -67,6 +67,23 @@ TEST(Memory, AssignNested) {
   EXPECT_TRUE(destroyed1 && destroyed2);
 }
 
+TEST(Memory, AllocationCounting) {
+  enableAllocationCounting();
+
+  AllocationCounts before = getAllocationCounts();
+  Own<int> i = heap<int>(1);
+  Array<int> array = heapArray<int>(10);
+  AllocationCounts after = getAllocationCounts();
+  EXPECT_EQ(before.count + 2, after.count);
+  EXPECT_EQ(before.bytes + sizeof(int) * 11, after.bytes);
+
+  countAllocation(1000);
+  i = nullptr;  // Frees are not counted.
+  AllocationCounts end = getAllocationCounts();
+  EXPECT_EQ(after.count + 1, end.count);
+  EXPECT_EQ(after.bytes + 1000, end.bytes);
+}
+
 // TODO(test):  More tests.
 
 }  // namespace
@@ -27,4 +27,26 @@ namespace kj {
 
 const NullDisposer NullDisposer::instance = NullDisposer();
 
+namespace _ {  // private
+
+bool allocationCountingEnabled = false;
+
+static __thread unsigned long long threadAllocationCount = 0;
+static __thread unsigned long long threadAllocationBytes = 0;
+
+void countAllocationSlow(size_t bytes) {
+  ++threadAllocationCount;
+  threadAllocationBytes += bytes;
+}
+
+}  // namespace _ (private)
+
+void enableAllocationCounting() {
+  __atomic_store_n(&_::allocationCountingEnabled, true, __ATOMIC_RELAXED);
+}
+
+AllocationCounts getAllocationCounts() {
+  return AllocationCounts { _::threadAllocationCount, _::threadAllocationBytes };
+}
+
 }  // namespace kj
@@ -308,6 +308,43 @@ const HeapDisposer<T> HeapDisposer<T>::instance = HeapDisposer<T>();
 
 }  // namespace _ (private)
 
+// =======================================================================================
+// Allocation counting
+
+struct AllocationCounts {
+  unsigned long long count;
+  unsigned long long bytes;
+};
+
+void enableAllocationCounting();
+// Starts counting the heap allocations made through KJ -- by heap(), heapArray() (and so by
+// Vector, String, and friends), and Arena -- plus any that other code reports through
+// countAllocation().  Counting is off by default, in which case it costs one predictable branch
+// per allocation.  Call this before starting the threads whose allocations you want counted.
+
+AllocationCounts getAllocationCounts();
+// Returns the number and total size of the allocations counted so far on the calling thread.
+// The counts are per-thread so that they can be attributed to whatever the thread was doing:
+// subtract the results of two calls to measure the code between them.  Frees are not tracked.
+
+namespace _ {  // private
+
+extern bool allocationCountingEnabled;
+void countAllocationSlow(size_t bytes);
+
+}  // namespace _ (private)
+
+inline void countAllocation(size_t bytes) {
+  // Adds an allocation of `bytes` bytes to the counts, if counting is enabled.  Allocators outside
+  // of KJ, like capnp::MallocMessageBuilder, call this so that their allocations are included.
+
+  if (__atomic_load_n(&_::allocationCountingEnabled, __ATOMIC_RELAXED)) {
+    _::countAllocationSlow(bytes);
+  }
+}
+
+// =======================================================================================
+
 template <typename T, typename... Params>
 Own<T> heap(Params&&... params) {
   // heap<T>(...) allocates a T on the heap, forwarding the parameters to its constructor.  The
@@ -315,6 +352,7 @@ Own<T> heap(Params&&... params) {
   // assume this.  (Since we know the object size at delete time, we could actually implement an
   // allocator that is more efficient than operator new.)
 
+  countAllocation(sizeof(T));
   return Own<T>(new T(kj::fwd<Params>(params)...), _::HeapDisposer<T>::instance);
 }
 
@@ -326,6 +364,7 @@ Own<Decay<T>> heap(T&& orig) {
   // one argument and the purpose is to copy it.
 
   typedef Decay<T> T2;
+  countAllocation(sizeof(T2));
   return Own<T2>(new T2(kj::fwd<T>(orig)), _::HeapDisposer<T2>::instance);
 }
 